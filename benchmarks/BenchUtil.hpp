@@ -0,0 +1,44 @@
+#ifndef FTB_BENCH_UTIL_HPP
+#define FTB_BENCH_UTIL_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace FTB::Bench {
+
+// 运行 fn 若干次，返回耗时中位数（毫秒）
+inline double MedianMs(int runs, const std::function<void()>& fn) {
+    std::vector<double> samples;
+    samples.reserve(runs);
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// 在系统临时目录下创建唯一的工作目录
+inline std::filesystem::path MakeScratchDir(const std::string& tag) {
+    auto dir = std::filesystem::temp_directory_path() /
+               ("ftb_bench_" + tag + "_" + std::to_string(
+                    std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+inline void PrintRow(const std::string& label, double ms, size_t items) {
+    std::printf("  %-34s %10.2f ms  %10.0f entries/s\n", label.c_str(), ms,
+                ms > 0 ? items / (ms / 1000.0) : 0.0);
+}
+
+}  // namespace FTB::Bench
+
+#endif  // FTB_BENCH_UTIL_HPP
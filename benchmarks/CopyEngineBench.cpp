@@ -0,0 +1,230 @@
+// CopyEngineBench.cpp - 复制引擎基准：旧的 ifstream/ofstream 复制 vs FileCopier 各方式
+//
+// 用法: CopyEngineBench [目录...] [--big-mb N] [--small N] [--tree N]
+//   在每个目录（默认系统临时目录）下分别测试：
+//     big    1 个大文件（默认 1024MB；--big-mb 10240 即 1 × 10GB）
+//     small  N 个 4KB 文件（默认 100000）
+//     tree   N 个 1KB 文件分布在 node_modules 式的两层目录中（默认 100000），
+//            比较串行递归复制与 TreeCopier 的单线程 / 多线程流水线
+//   建议分别给出 tmpfs（如 /dev/shm）与 ext4 / btrfs / XFS 上的目录。
+//   大文件会先写入并 fsync，各方式的结果为页缓存命中时的吞吐量（每项 3 次取中位数）。
+
+#include "browser/FileCopier.hpp"
+#include "browser/TreeCopier.hpp"
+#include "BenchUtil.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace FTB::Bench;
+using Method = FTB::FileCopier::Method;
+
+namespace {
+
+constexpr size_t kSmallFileSize = 4096;
+constexpr size_t kTreeFileSize = 1024;
+constexpr size_t kTreeFilesPerDir = 25;
+
+void WriteFile(const fs::path& path, uintmax_t size) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    std::vector<char> block(1 << 20);
+    for (size_t i = 0; i < block.size(); ++i) block[i] = static_cast<char>(i * 131 + (i >> 12));
+    for (uintmax_t done = 0; done < size;) {
+        size_t n = static_cast<size_t>(std::min<uintmax_t>(block.size(), size - done));
+        if (::write(fd, block.data(), n) != static_cast<ssize_t>(n)) break;
+        done += n;
+    }
+    ::fsync(fd);
+    ::close(fd);
+}
+
+// 重构前 copy_file_chunked 的复制方式
+bool LegacyCopy(const fs::path& src, const fs::path& dst) {
+    constexpr size_t CHUNK = 65536;
+    std::ifstream in(src, std::ios::binary);
+    std::ofstream out(dst, std::ios::binary);
+    if (!in || !out) return false;
+    static char buf[CHUNK];
+    while (in.read(buf, CHUNK) || in.gcount() > 0) {
+        out.write(buf, in.gcount());
+        if (!out) return false;
+    }
+    return true;
+}
+
+struct Variant {
+    const char* name;
+    bool        legacy;
+    Method      method;
+};
+
+const Variant kVariants[] = {
+    {"ifstream/ofstream (old)", true, Method::Buffered},
+    {"buffered pread/pwrite", false, Method::Buffered},
+    {"sendfile", false, Method::Sendfile},
+    {"copy_file_range", false, Method::CopyFileRange},
+    {"auto (reflink first)", false, Method::Reflink},
+};
+
+bool CopyOne(const Variant& v, const fs::path& src, const fs::path& dst, Method* used = nullptr) {
+    if (v.legacy) return LegacyCopy(src, dst);
+    auto result = FTB::FileCopier::copyFile(src.string(), dst.string(), {}, v.method);
+    if (used) *used = result.method;
+    return result.ok;
+}
+
+void PrintThroughput(const std::string& label, double ms, uintmax_t bytes, size_t files) {
+    double secs = ms / 1000.0;
+    std::printf("  %-34s %10.2f ms  %9.1f MB/s  %10.0f files/s\n", label.c_str(), ms,
+                secs > 0 ? bytes / secs / (1 << 20) : 0.0, secs > 0 ? files / secs : 0.0);
+}
+
+void BenchBigFile(const fs::path& root, uintmax_t size) {
+    std::printf("\n== %s: 1 x %ju MB ==\n", root.c_str(), size >> 20);
+    auto dir = root / ("ftb_copy_big_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    auto src = dir / "big.bin";
+    WriteFile(src, size);
+    for (const auto& v : kVariants) {
+        ::sync();  // 上一项留下的脏页不计入本项
+        Method used = v.method;
+        double ms = MedianMs(3, [&] {
+            fs::remove(dir / "copy.bin");
+            CopyOne(v, src, dir / "copy.bin", &used);
+        });
+        std::string label = v.name;
+        if (!v.legacy && used != v.method) label += std::string(" -> ") + FTB::FileCopier::methodName(used);
+        PrintThroughput(label, ms, size, 1);
+    }
+    fs::remove_all(dir);
+}
+
+void BenchSmallFiles(const fs::path& root, size_t count) {
+    std::printf("\n== %s: %zu x 4KB ==\n", root.c_str(), count);
+    auto dir = root / ("ftb_copy_small_" + std::to_string(::getpid()));
+    fs::create_directories(dir / "src");
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "f_%08zu", i);
+        names.emplace_back(name);
+        WriteFile(dir / "src" / name, kSmallFileSize);
+    }
+    for (const auto& v : kVariants) {
+        // 删除上一轮的目标并落盘不计入耗时，只测复制本身
+        std::vector<double> samples;
+        for (int run = 0; run < 3; ++run) {
+            fs::remove_all(dir / "dst");
+            fs::create_directories(dir / "dst");
+            ::sync();
+            samples.push_back(MedianMs(1, [&] {
+                for (const auto& name : names) CopyOne(v, dir / "src" / name, dir / "dst" / name);
+            }));
+        }
+        std::sort(samples.begin(), samples.end());
+        PrintThroughput(v.name, samples[1], uintmax_t(count) * kSmallFileSize, count);
+    }
+    fs::remove_all(dir);
+}
+
+// 重构前 execute_copy 处理目录的方式：单个 recursive_directory_iterator 逐个复制
+bool SerialTreeCopy(const fs::path& src, const fs::path& dst) {
+    fs::create_directories(dst);
+    for (const auto& entry : fs::recursive_directory_iterator(src)) {
+        auto target = dst / fs::relative(entry.path(), src);
+        if (entry.is_directory()) {
+            fs::create_directories(target);
+        } else if (entry.is_regular_file()) {
+            if (!FTB::FileCopier::copyFile(entry.path().string(), target.string()).ok) return false;
+        }
+    }
+    return true;
+}
+
+void BenchTree(const fs::path& root, size_t count) {
+    auto dir = root / ("ftb_copy_tree_" + std::to_string(::getpid()));
+    size_t dirs = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % kTreeFilesPerDir == 0) {
+            fs::create_directories(dir / "src" / ("pkg" + std::to_string(i / 1000)) /
+                                   ("m" + std::to_string(i / kTreeFilesPerDir)));
+            ++dirs;
+        }
+        WriteFile(dir / "src" / ("pkg" + std::to_string(i / 1000)) /
+                      ("m" + std::to_string(i / kTreeFilesPerDir)) / ("f" + std::to_string(i)),
+                  kTreeFileSize);
+    }
+    std::printf("\n== %s: tree of %zu x 1KB in %zu dirs ==\n", root.c_str(), count, dirs);
+
+    struct TreeVariant {
+        std::string name;
+        size_t      workers;  // 0 表示串行递归复制
+    };
+    std::vector<TreeVariant> variants = {
+        {"serial recursive_directory_iterator", 0},
+        {"TreeCopier 1 worker", 1},
+        {"TreeCopier " + std::to_string(FTB::TreeCopier::defaultWorkers()) + " workers",
+         FTB::TreeCopier::defaultWorkers()},
+    };
+    for (const auto& v : variants) {
+        std::vector<double> samples;
+        for (int run = 0; run < 3; ++run) {
+            fs::remove_all(dir / "dst");
+            ::sync();
+            samples.push_back(MedianMs(1, [&] {
+                if (v.workers == 0) {
+                    SerialTreeCopy(dir / "src", dir / "dst");
+                    return;
+                }
+                Progress prog;
+                std::atomic<bool> cancel{false}, pause{false};
+                FTB::TreeCopier::Options options;
+                options.workers = v.workers;
+                FTB::TreeCopier::copy((dir / "src").string(), (dir / "dst").string(), prog, cancel, pause,
+                                      options);
+            }));
+        }
+        std::sort(samples.begin(), samples.end());
+        PrintThroughput(v.name, samples[1], uintmax_t(count) * kTreeFileSize, count);
+    }
+    fs::remove_all(dir);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<fs::path> roots;
+    uintmax_t big_mb = 1024;
+    size_t small_count = 100000;
+    size_t tree_count = 100000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--big-mb") == 0 && i + 1 < argc) {
+            big_mb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--small") == 0 && i + 1 < argc) {
+            small_count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--tree") == 0 && i + 1 < argc) {
+            tree_count = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            roots.emplace_back(argv[i]);
+        }
+    }
+    if (roots.empty()) roots.push_back(fs::temp_directory_path());
+
+    std::printf("CopyEngineBench: FileCopier methods vs the old stream copy\n");
+    for (const auto& root : roots) {
+        if (big_mb > 0) BenchBigFile(root, big_mb << 20);
+        if (small_count > 0) BenchSmallFiles(root, small_count);
+        if (tree_count > 0) BenchTree(root, tree_count);
+    }
+    return 0;
+}
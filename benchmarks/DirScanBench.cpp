@@ -0,0 +1,155 @@
+// DirScanBench.cpp - 目录枚举基准：std::filesystem 旧路径 vs getdents64 扫描器
+//
+// 用法: DirScanBench [条目数...] [--huge]
+//   默认测试 10k / 100k 条目，--huge 额外测试 1M 条目。
+//   每个规模会在临时目录下生成普通文件、子目录与符号链接的混合目录，测试结束后删除。
+//   结果为热 dentry 缓存下的中位数耗时。
+
+#include "browser/DirScanner.hpp"
+#include "browser/DirectoryLoader.hpp"
+#include "browser/EntryTable.hpp"
+#include "browser/FileManager.hpp"
+#include "browser/SortMode.hpp"
+#include "browser/StatFanout.hpp"
+#include "BenchUtil.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace fs = std::filesystem;
+using namespace FTB::Bench;
+
+namespace {
+
+// 生成 count 个条目：约 90% 普通文件、9% 子目录、1% 符号链接
+void PopulateDirectory(const fs::path& dir, size_t count) {
+    int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    char name[64];
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 100 == 0 && i > 0) {
+            std::snprintf(name, sizeof(name), "link_%08zu", i);
+            ::symlinkat("file_00000001.txt", dirfd, name);
+        } else if (i % 11 == 0) {
+            std::snprintf(name, sizeof(name), "dir_%08zu", i);
+            ::mkdirat(dirfd, name, 0755);
+        } else {
+            std::snprintf(name, sizeof(name), "file_%08zu.txt", i);
+            int fd = ::openat(dirfd, name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+            if (fd >= 0) {
+                if (i % 7 == 0) (void)::write(fd, name, std::strlen(name));
+                ::close(fd);
+            }
+        }
+    }
+    ::close(dirfd);
+}
+
+// 重构前 getDirectoryEntries 的枚举方式（不含图标解析）
+size_t LegacyDirectoryIterator(const std::string& path) {
+    size_t n = 0;
+    for (const auto& entry : fs::directory_iterator(path, fs::directory_options::skip_permission_denied)) {
+        auto sft = entry.symlink_status();
+        bool is_regular = sft.type() == fs::file_type::regular;
+        if (sft.type() == fs::file_type::symlink)
+            is_regular = entry.status().type() == fs::file_type::regular;
+        volatile uintmax_t size = is_regular ? entry.file_size() : 0;
+        (void)size;
+        auto ftime = entry.last_write_time();
+        auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+        std::time_t cftime = std::chrono::system_clock::to_time_t(sctp);
+        char buf[20];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", std::localtime(&cftime));
+        ++n;
+    }
+    return n;
+}
+
+// 重构前 getDirectoryContents 的枚举方式：仅名称
+size_t LegacyNamesOnly(const std::string& path) {
+    std::vector<std::string> names;
+    for (const auto& entry : fs::directory_iterator(path))
+        names.push_back(entry.path().filename().string());
+    return names.size();
+}
+
+size_t ScannerNamesOnly(const std::string& path) {
+    return FTB::DirScanner::readAll(path).size();
+}
+
+size_t ScannerWithStatx(const std::string& path) {
+    FTB::DirScanner scanner(path);
+    std::vector<FTB::RawDirEntry> entries;
+    while (scanner.next(entries)) {
+    }
+    FTB::EntryStat st;
+    constexpr unsigned kFields = FTB::DirScanner::kStatMode | FTB::DirScanner::kStatSize |
+                                 FTB::DirScanner::kStatMtime;
+    for (const auto& e : entries)
+        FTB::DirScanner::statAt(scanner.fd(), e.name.c_str(), kFields, st);
+    return entries.size();
+}
+
+size_t ScannerWithParallelStatx(const std::string& path) {
+    FTB::DirScanner scanner(path);
+    std::vector<FTB::RawDirEntry> entries;
+    while (scanner.next(entries)) {
+    }
+    std::vector<FTB::EntryStat> stats(entries.size());
+    constexpr unsigned kFields = FTB::DirScanner::kStatMode | FTB::DirScanner::kStatSize |
+                                 FTB::DirScanner::kStatMtime;
+    FTB::StatFanout::run(entries.size(), [&](size_t i) {
+        FTB::DirScanner::statAt(scanner.fd(), entries[i].name.c_str(), kFields, stats[i]);
+    });
+    return entries.size();
+}
+
+void RunSize(size_t count) {
+    fs::path dir = MakeScratchDir(std::to_string(count));
+    std::printf("\n== %zu entries (%s) ==\n", count, dir.c_str());
+    PopulateDirectory(dir, count);
+
+    const std::string path = dir.string();
+    const int runs = count >= 1000000 ? 3 : 7;
+
+    PrintRow("directory_iterator names", MedianMs(runs, [&] { LegacyNamesOnly(path); }), count);
+    PrintRow("getdents64 names", MedianMs(runs, [&] { ScannerNamesOnly(path); }), count);
+    PrintRow("directory_iterator + status", MedianMs(runs, [&] { LegacyDirectoryIterator(path); }), count);
+    PrintRow("getdents64 + statx", MedianMs(runs, [&] { ScannerWithStatx(path); }), count);
+    PrintRow("getdents64 + parallel statx", MedianMs(runs, [&] { ScannerWithParallelStatx(path); }), count);
+    PrintRow("FileManager::getEntryTable", MedianMs(runs, [&] {
+        FileManager::lru_entry_cache->erase(path);
+        FileManager::getEntryTable(path, FTB::SortMode::NameAsc);
+    }), count);
+    // 流式加载的首批名称到达时间，即 UI 首帧可绘制的时刻
+    std::printf("  %-34s %10.2f ms\n", "DirectoryLoader first chunk", MedianMs(runs, [&] {
+        FTB::DirectoryLoader loader(path, /*stream=*/true, nullptr);
+        loader.waitForFirstResult(std::chrono::seconds(10));
+    }));
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    bool huge = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--huge") == 0)
+            huge = true;
+        else
+            sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) sizes = {10000, 100000};
+    if (huge) sizes.push_back(1000000);
+
+    for (size_t n : sizes) RunSize(n);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// DiskUsageBench.cpp - 目录树大小统计基准：旧的单线程遍历 vs DiskUsage vs 复用 SizeIndex vs du -s
+//
+// 用法: DiskUsageBench [--files N] [目录...]
+//   不给目录时在临时目录下生成约 N 个文件（默认 200k）的多层目录树，其中 1% 为硬链接，测试结束后删除。
+//   给出目录时直接统计这些目录（例如 $HOME），不做任何修改。
+//   结果为热 dentry / inode 缓存下的中位数耗时；du 使用 -s -B1，其结果应与 DiskUsage 的占用空间一致。
+//   SizeIndex 一行先统计一次建立索引（保存在临时目录，不影响 ~/.config），再测复用时的耗时。
+//   生成的目录树会把目录 mtime 调到一小时前，否则刚创建的目录不会写入索引。
+
+#include "browser/DiskUsage.hpp"
+#include "browser/SizeIndex.hpp"
+#include "BenchUtil.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fs = std::filesystem;
+using namespace FTB::Bench;
+
+namespace {
+
+// 每个目录 100 个文件、10 个子目录，逐层展开直到达到 count 个文件
+void PopulateTree(const fs::path& root, size_t count) {
+    std::vector<fs::path> dirs{root};
+    size_t made = 0;
+    char name[64];
+    for (size_t d = 0; made < count; ++d) {
+        const fs::path dir = dirs[d];
+        int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        for (int i = 0; i < 100 && made < count; ++i, ++made) {
+            std::snprintf(name, sizeof(name), "file_%03d.dat", i);
+            if (made % 100 == 99) {
+                ::linkat(dirfd, "file_000.dat", dirfd, name, 0);
+                continue;
+            }
+            int fd = ::openat(dirfd, name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+            if (fd >= 0) {
+                std::string data(made % 4096, 'x');
+                (void)::write(fd, data.data(), data.size());
+                ::close(fd);
+            }
+        }
+        for (int i = 0; i < 10; ++i) {
+            std::snprintf(name, sizeof(name), "dir_%02d", i);
+            ::mkdirat(dirfd, name, 0755);
+            dirs.push_back(dir / name);
+        }
+        ::close(dirfd);
+    }
+}
+
+void AgeDirectories(const fs::path& root) {
+    const auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    std::error_code ec;
+    fs::last_write_time(root, past, ec);
+    for (auto it = fs::recursive_directory_iterator(root, ec); it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory(ec) && !it->is_symlink(ec)) fs::last_write_time(it->path(), past, ec);
+    }
+}
+
+// 重构前 calculateDirectorySize 的方式：recursive_directory_iterator + file_size，硬链接重复计算
+uintmax_t LegacyIterator(const std::string& path) {
+    uintmax_t total = 0;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(path, fs::directory_options::skip_permission_denied, ec);
+         it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (!it->is_directory(ec)) total += it->file_size(ec);
+    }
+    return total;
+}
+
+// du -s -B1 的输出（占用空间，字节）；du 不可用时返回 0
+uintmax_t RunDu(const std::string& path) {
+    std::string cmd = "du -s -B1 '" + path + "' 2>/dev/null";
+    FILE* pipe = ::popen(cmd.c_str(), "r");
+    if (!pipe) return 0;
+    unsigned long long bytes = 0;
+    if (std::fscanf(pipe, "%llu", &bytes) != 1) bytes = 0;
+    ::pclose(pipe);
+    return bytes;
+}
+
+void RunTree(const std::string& path, int runs) {
+    FTB::DiskUsage::Options single;
+    single.threads = 1;
+    auto report = FTB::DiskUsage::measure(path);
+    const size_t items = report.total.files + report.total.dirs;
+    std::printf("\n== %s: %llu files, %llu dirs, apparent %llu B, disk %llu B ==\n", path.c_str(),
+                static_cast<unsigned long long>(report.total.files),
+                static_cast<unsigned long long>(report.total.dirs),
+                static_cast<unsigned long long>(report.total.apparent),
+                static_cast<unsigned long long>(report.total.disk));
+
+    PrintRow("recursive_directory_iterator (old)", MedianMs(runs, [&] { LegacyIterator(path); }), items);
+    PrintRow("DiskUsage, 1 thread", MedianMs(runs, [&] { FTB::DiskUsage::measure(path, single); }), items);
+    PrintRow("DiskUsage, " + std::to_string(FTB::DiskUsage::defaultThreads()) + " threads",
+             MedianMs(runs, [&] { FTB::DiskUsage::measure(path); }), items);
+
+    fs::path index_dir = MakeScratchDir("du-index");
+    FTB::SizeIndex index((index_dir / "size-index").string());
+    FTB::DiskUsage::Options indexed;
+    indexed.index = &index;
+    FTB::DiskUsage::measure(path, indexed);
+    auto reused = FTB::DiskUsage::measure(path, indexed);
+    PrintRow("DiskUsage, warm SizeIndex", MedianMs(runs, [&] { FTB::DiskUsage::measure(path, indexed); }), items);
+    std::printf("  SizeIndex reused %llu of %llu dirs, apparent %s\n",
+                static_cast<unsigned long long>(reused.reused_dirs),
+                static_cast<unsigned long long>(reused.total.dirs),
+                reused.total.apparent == report.total.apparent ? "matches" : "DIFFERS");
+    std::error_code ec;
+    fs::remove_all(index_dir, ec);
+
+    uintmax_t du = RunDu(path);
+    if (du == 0) {
+        std::printf("  du not available\n");
+        return;
+    }
+    PrintRow("du -s -B1", MedianMs(runs, [&] { RunDu(path); }), items);
+    std::printf("  du disk %llu B %s DiskUsage\n", static_cast<unsigned long long>(du),
+                du == report.total.disk ? "==" : "!=");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> roots;
+    size_t files = 200000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            roots.emplace_back(argv[i]);
+        }
+    }
+
+    std::printf("DiskUsageBench: recursive size of a directory tree\n");
+    if (!roots.empty()) {
+        for (const auto& root : roots) RunTree(root, 3);
+        return 0;
+    }
+
+    fs::path dir = MakeScratchDir("du");
+    PopulateTree(dir, files);
+    AgeDirectories(dir);
+    RunTree(dir.string(), 5);
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// EntryTableBench.cpp - 条目存储基准：std::vector<DirEntryInfo> vs 列式 EntryTable
+//
+// 用法: EntryTableBench [条目数...]
+//   默认测试 10k / 100k / 1M 条目。条目在内存中合成（不访问文件系统），
+//   名称长度、类型比例与 DirScanBench 生成的目录相近。
+//   内存按容量统计：vector 计入每个超出 SSO 的字符串的堆分配。
+//   拷贝对应 lru_entry_cache 命中时按值返回的开销。
+
+#include "browser/EntryTable.hpp"
+#include "browser/FileManager.hpp"
+#include "browser/SortMode.hpp"
+#include "BenchUtil.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace FTB::Bench;
+
+namespace {
+
+size_t StringHeapBytes(const std::string& s) {
+    // libstdc++ 的 SSO 容量为 15 字节
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+size_t VectorMemory(const std::vector<FileManager::DirEntryInfo>& entries) {
+    size_t bytes = entries.capacity() * sizeof(FileManager::DirEntryInfo);
+    for (const auto& e : entries) {
+        bytes += StringHeapBytes(e.name) + StringHeapBytes(e.mod_time) +
+                 StringHeapBytes(e.permissions) + StringHeapBytes(e.icon);
+    }
+    return bytes;
+}
+
+// 约 90% 普通文件、9% 子目录、1% 符号链接，名称乱序
+FTB::EntryTable MakeTable(size_t count) {
+    FTB::EntryTable table;
+    table.reserve(count, count * 18);
+    char name[64];
+    uint64_t seed = 88172645463325252ull;
+    for (size_t i = 0; i < count; ++i) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        size_t id = seed % (count * 10);
+        size_t pos;
+        if (i % 100 == 0 && i > 0) {
+            std::snprintf(name, sizeof(name), "link_%08zu", id);
+            pos = table.appendPending(name, DT_LNK);
+            table.setStat(pos, S_IFLNK | 0777, 1700000000 + static_cast<int64_t>(id), 0, S_IFREG | 0644);
+        } else if (i % 11 == 0) {
+            std::snprintf(name, sizeof(name), "dir_%08zu", id);
+            pos = table.appendPending(name, DT_DIR);
+            table.setStat(pos, S_IFDIR | 0755, 1700000000 + static_cast<int64_t>(id), 0, 0);
+        } else {
+            std::snprintf(name, sizeof(name), "file_%08zu.txt", id);
+            pos = table.appendPending(name, DT_REG);
+            table.setStat(pos, S_IFREG | 0644, 1700000000 + static_cast<int64_t>(id), id % 65536, 0);
+        }
+    }
+    return table;
+}
+
+void RunSize(size_t count) {
+    std::printf("\n== %zu entries ==\n", count);
+    const int runs = count >= 1000000 ? 3 : 7;
+
+    auto table = MakeTable(count);
+    auto entries = table.toEntries();
+
+    size_t vec_bytes = VectorMemory(entries);
+    size_t table_bytes = table.memoryUsage();
+    std::printf("  %-34s %10.2f MiB  %6.1f B/entry\n", "vector<DirEntryInfo> memory",
+                vec_bytes / 1048576.0, static_cast<double>(vec_bytes) / count);
+    std::printf("  %-34s %10.2f MiB  %6.1f B/entry\n", "EntryTable memory",
+                table_bytes / 1048576.0, static_cast<double>(table_bytes) / count);
+
+    PrintRow("vector<DirEntryInfo> copy", MedianMs(runs, [&] {
+        auto copy = entries;
+        (void)copy;
+    }), count);
+    PrintRow("EntryTable copy", MedianMs(runs, [&] {
+        auto copy = table;
+        (void)copy;
+    }), count);
+
+    for (auto mode : {FTB::SortMode::NameAsc, FTB::SortMode::SizeDesc}) {
+        std::string tag = FTB::SortModeToString(mode);
+        PrintRow("vector sort " + tag, MedianMs(runs, [&] {
+            auto copy = entries;
+            FTB::SortEntries(copy, mode);
+        }), count);
+        PrintRow("EntryTable sort " + tag, MedianMs(runs, [&] {
+            auto copy = table;
+            copy.sort(mode);
+        }), count);
+    }
+
+    // 只展开一屏可见行，对应渲染当前列的开销
+    table.sort(FTB::SortMode::NameAsc);
+    PrintRow("EntryTable expand 60 visible rows", MedianMs(runs, [&] {
+        for (size_t i = 0; i < 60 && i < table.size(); ++i) {
+            auto info = table.entry(i);
+            (void)info;
+        }
+    }), 60);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {10000, 100000, 1000000};
+
+    for (size_t n : sizes) RunSize(n);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// FileWalkerBench.cpp - 模糊查找的文件遍历基准：旧的单线程递归 vs SearchEngine（FileWalker）vs fd
+//
+// 用法: FileWalkerBench [--files N] [--query Q] [目录...]
+//   不给目录时在临时目录下生成约 N 个文件（默认 200k）的多层目录树，测试结束后删除。
+//   给出目录时直接在这些目录中搜索（例如一个大型源码仓库），不做任何修改。
+//   "first result" 为 Stream 交出首批结果的耗时，即查找面板开始显示结果的时间。
+//   fd 只在系统安装了 fd / fdfind 时测量，参数与旧的外部搜索一致（-t f --max-depth 8）。
+
+#include "core/FuzzyFinder.hpp"
+#include "browser/FileWalker.hpp"
+#include "BenchUtil.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+using namespace FTB::Bench;
+
+namespace {
+
+// 每个目录 100 个文件、10 个子目录，逐层展开直到达到 count 个文件
+void PopulateTree(const fs::path& root, size_t count) {
+    static const char* const kExts[] = {".cpp", ".hpp", ".txt", ".md", ".json"};
+    std::vector<fs::path> dirs{root};
+    size_t made = 0;
+    char name[64];
+    for (size_t d = 0; made < count; ++d) {
+        const fs::path dir = dirs[d];
+        int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        for (int i = 0; i < 100 && made < count; ++i, ++made) {
+            std::snprintf(name, sizeof(name), "source_%03d%s", i, kExts[made % 5]);
+            int fd = ::openat(dirfd, name, O_CREAT | O_WRONLY | O_CLOEXEC, 0644);
+            if (fd >= 0) ::close(fd);
+        }
+        for (int i = 0; i < 10; ++i) {
+            std::snprintf(name, sizeof(name), "module_%02d", i);
+            ::mkdirat(dirfd, name, 0755);
+            dirs.push_back(dir / name);
+        }
+        ::close(dirfd);
+    }
+}
+
+// 重构前 BuiltinSearch 的方式：std::function 递归 + directory_iterator，单线程，最后一次性返回
+size_t LegacyWalk(const std::string& query, const std::string& base_path) {
+    static const std::unordered_set<std::string> skip = {".git", "node_modules", "build", "target", "dist"};
+    std::string q;
+    for (char c : query) q += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    const std::string base = fs::absolute(base_path).string() + "/";
+    size_t found = 0;
+    std::error_code ec;
+    std::function<void(const fs::path&, int)> walk = [&](const fs::path& dir, int depth) {
+        if (depth > 8) return;
+        for (auto it = fs::directory_iterator(dir, ec); it != fs::end(it); it.increment(ec)) {
+            if (ec) { ec.clear(); continue; }
+            auto name = it->path().filename().string();
+            if (name.empty() || name[0] == '.') continue;
+            bool is_dir = it->is_directory(ec);
+            if (ec) { ec.clear(); continue; }
+            if (is_dir) {
+                if (!skip.count(name)) walk(it->path(), depth + 1);
+                continue;
+            }
+            if (FuzzyMatch(q, it->path().string().substr(base.size()))) ++found;
+        }
+    };
+    walk(base, 0);
+    return found;
+}
+
+bool HasFd() {
+    return std::system("command -v fdfind >/dev/null 2>&1 || command -v fd >/dev/null 2>&1") == 0;
+}
+
+size_t RunFd(const std::string& query, const std::string& path) {
+    std::string cmd = "(fdfind -t f --color never --max-depth 8 '" + query + "' '" + path +
+                      "' 2>/dev/null || fd -t f --color never --max-depth 8 '" + query + "' '" + path +
+                      "' 2>/dev/null)";
+    FILE* pipe = ::popen(cmd.c_str(), "r");
+    if (!pipe) return 0;
+    size_t lines = 0;
+    char buf[16384];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), pipe)) > 0) {
+        for (size_t i = 0; i < n; ++i) lines += buf[i] == '\n';
+    }
+    ::pclose(pipe);
+    return lines;
+}
+
+void RunTree(const std::string& path, const std::string& query, int runs) {
+    size_t entries = 0;
+    FTB::FileWalker::Options count_options;
+    count_options.max_depth = 8;
+    std::atomic<size_t> counted{0};
+    FTB::FileWalker::walk(path, count_options, [&](const FTB::FileWalker::Entry&) { counted.fetch_add(1); });
+    entries = counted.load();
+
+    size_t matches = SearchEngine::Search(query, path).size();
+    std::printf("\n== %s: %zu entries, query \"%s\" -> %zu matches ==\n", path.c_str(), entries, query.c_str(),
+                matches);
+
+    PrintRow("recursive directory_iterator (old)", MedianMs(runs, [&] { LegacyWalk(query, path); }), entries);
+    PrintRow("SearchEngine::Search", MedianMs(runs, [&] { SearchEngine::Search(query, path); }), entries);
+
+    double first = MedianMs(runs, [&] {
+        std::atomic<bool> cancel{false};
+        SearchEngine::Stream(query, path, [&](std::vector<FdResult>&&) { cancel.store(true); }, &cancel);
+    });
+    std::printf("  %-34s %10.2f ms\n", "SearchEngine::Stream first result", first);
+
+    if (HasFd()) {
+        PrintRow("fd -t f --max-depth 8", MedianMs(runs, [&] { RunFd(query, path); }), entries);
+    } else {
+        std::printf("  fd not available\n");
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> roots;
+    size_t files = 200000;
+    std::string query = "src7md";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            query = argv[++i];
+        } else {
+            roots.emplace_back(argv[i]);
+        }
+    }
+
+    std::printf("FileWalkerBench: fuzzy file search over a directory tree\n");
+    if (!roots.empty()) {
+        for (const auto& root : roots) RunTree(root, query, 3);
+        return 0;
+    }
+
+    fs::path dir = MakeScratchDir("walk");
+    PopulateTree(dir, files);
+    RunTree(dir.string(), query, 5);
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    return 0;
+}
@@ -0,0 +1,176 @@
+// FuzzyMatchBench.cpp - 模糊匹配基准：旧的逐字符 tolower 子序列判断 vs SIMD 预筛 vs 打分 + 前 K 堆
+//
+// 用法: FuzzyMatchBench [--paths N] [--top K] [--list 文件] [查询...]
+//   默认在内存中生成 N 条（默认 1M）多层路径，混合 snake_case / camelCase / kebab-case 命名。
+//   --list 从文件读取路径（每行一条，例如 git ls-files 或 find 的输出）代替生成的语料。
+//   "score + sort all" 为不用前 K 堆、复制并排序所有匹配的做法，对比堆只复制前 K 条的收益。
+//   单线程测量；搜索时 FileWalker 的各工作线程各自打分。
+
+#include "core/FuzzyMatcher.hpp"
+#include "BenchUtil.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string_view>
+
+using namespace FTB::Bench;
+
+namespace {
+
+struct Corpus {
+    std::string                   buffer;
+    std::vector<std::string_view> paths;
+};
+
+void Finish(Corpus& corpus, const std::vector<size_t>& ends) {
+    size_t begin = 0;
+    corpus.paths.reserve(ends.size());
+    for (size_t end : ends) {
+        corpus.paths.emplace_back(corpus.buffer.data() + begin, end - begin);
+        begin = end;
+    }
+}
+
+Corpus Generate(size_t count) {
+    static const char* const kWords[] = {
+        "src", "lib", "core", "util", "file", "manager", "widget", "config", "render", "main",
+        "test", "bench", "parser", "token", "buffer", "cache", "index", "search", "fuzzy", "matcher",
+        "tree", "node", "view", "model", "event", "handler", "image", "preview", "theme", "plugin",
+    };
+    static const char* const kExts[] = {".cpp", ".hpp", ".md", ".json", ".txt", ".rs", ".py", ".go"};
+    constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+    std::mt19937 rng(20241017);
+    Corpus corpus;
+    std::vector<size_t> ends;
+    corpus.buffer.reserve(count * 64);
+    ends.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const int depth = 1 + static_cast<int>(rng() % 6);
+        for (int d = 0; d < depth; ++d) {
+            corpus.buffer += kWords[rng() % kWordCount];
+            if (rng() % 4 == 0) corpus.buffer += std::to_string(rng() % 100);
+            corpus.buffer += '/';
+        }
+        // 文件名：1~3 个单词，随机一种命名风格
+        const int parts = 1 + static_cast<int>(rng() % 3);
+        const int style = static_cast<int>(rng() % 3);
+        for (int p = 0; p < parts; ++p) {
+            std::string word = kWords[rng() % kWordCount];
+            if (p > 0 && style == 0) corpus.buffer += '_';
+            if (p > 0 && style == 2) corpus.buffer += '-';
+            if (style == 1) word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+            corpus.buffer += word;
+        }
+        corpus.buffer += kExts[rng() % (sizeof(kExts) / sizeof(kExts[0]))];
+        ends.push_back(corpus.buffer.size());
+    }
+    Finish(corpus, ends);
+    return corpus;
+}
+
+Corpus Load(const std::string& file) {
+    Corpus corpus;
+    std::vector<size_t> ends;
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        corpus.buffer += line;
+        ends.push_back(corpus.buffer.size());
+    }
+    Finish(corpus, ends);
+    return corpus;
+}
+
+// 重构前的 FuzzyMatch：逐字符对两边做 tolower，只回答是否匹配
+bool LegacyMatch(std::string_view query, std::string_view str) {
+    size_t qi = 0;
+    for (size_t si = 0; si < str.size() && qi < query.size(); si++) {
+        char sc = static_cast<char>(std::tolower(static_cast<unsigned char>(str[si])));
+        char qc = static_cast<char>(std::tolower(static_cast<unsigned char>(query[qi])));
+        if (sc == qc) qi++;
+    }
+    return qi == query.size();
+}
+
+void RunQuery(const Corpus& corpus, const std::string& query, size_t top_k, int runs) {
+    const FuzzyPattern pattern(query);
+    const auto& paths = corpus.paths;
+
+    size_t matched = 0;
+    for (auto p : paths) matched += pattern.matches(p);
+    std::printf("\n== query \"%s\": %zu / %zu paths match (%.1f%% rejected by prefilter) ==\n", query.c_str(),
+                matched, paths.size(), 100.0 * (paths.size() - matched) / std::max<size_t>(paths.size(), 1));
+
+    size_t sink = 0;
+    PrintRow("tolower subsequence (old)", MedianMs(runs, [&] {
+        for (auto p : paths) sink += LegacyMatch(query, p);
+    }), paths.size());
+    PrintRow("SIMD prefilter", MedianMs(runs, [&] {
+        for (auto p : paths) sink += pattern.matches(p);
+    }), paths.size());
+    PrintRow("prefilter + score", MedianMs(runs, [&] {
+        for (auto p : paths) sink += static_cast<size_t>(pattern.score(p) + 1);
+    }), paths.size());
+
+    PrintRow("score + sort all", MedianMs(runs, [&] {
+        std::vector<FuzzyTopK::Item> all;
+        for (auto p : paths) {
+            int score = pattern.score(p);
+            if (score != FuzzyPattern::kNoMatch) all.push_back({score, std::string(p)});
+        }
+        std::sort(all.begin(), all.end(), [](const FuzzyTopK::Item& a, const FuzzyTopK::Item& b) {
+            return FuzzyTopK::better(a.score, a.text, b.score, b.text);
+        });
+        sink += all.size();
+    }), paths.size());
+
+    std::vector<FuzzyTopK::Item> best;
+    double heap_ms = MedianMs(runs, [&] {
+        FuzzyTopK top(top_k);
+        for (auto p : paths) {
+            int score = pattern.score(p);
+            if (score != FuzzyPattern::kNoMatch && score >= top.threshold()) top.offer(score, p);
+        }
+        best = top.sorted();
+    });
+    char label[64];
+    std::snprintf(label, sizeof(label), "score + top-%zu heap", top_k);
+    PrintRow(label, heap_ms, paths.size());
+
+    for (size_t i = 0; i < std::min<size_t>(best.size(), 3); ++i) {
+        std::printf("    #%zu %5d  %s\n", i + 1, best[i].score, best[i].text.c_str());
+    }
+    if (sink == static_cast<size_t>(-1)) std::printf("\n");   // 防止循环被优化掉
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 1000000;
+    size_t top_k = 100;
+    std::string list;
+    std::vector<std::string> queries;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--paths") == 0 && i + 1 < argc) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top_k = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            list = argv[++i];
+        } else {
+            queries.emplace_back(argv[i]);
+        }
+    }
+    if (queries.empty()) queries = {"fm", "srcmain", "WidgetCfg", "fuzzymatcherhpp", "qzx"};
+
+    Corpus corpus = list.empty() ? Generate(count) : Load(list);
+    std::printf("FuzzyMatchBench: %zu paths, %.1f MB\n", corpus.paths.size(), corpus.buffer.size() / 1e6);
+    for (const auto& q : queries) RunQuery(corpus, q, top_k, 5);
+    return 0;
+}
@@ -0,0 +1,211 @@
+// IoRingBench.cpp - 逐条系统调用 vs IoRing 批量提交
+//
+// 用法: IoRingBench [目录...] [--files N] [--depth D]
+//   在每个目录（默认系统临时目录）下创建 N 个 4KB 文件（默认 20000），分别测试：
+//     statx          逐个 statx
+//     open+close     打开再关闭
+//     open+read+close 整个读入（每阶段一批）
+//     unlink         删除全部文件
+//   每项比较三种执行方式：
+//     syscall        直接调用 statx / openat / pread / unlinkat（原有代码的做法）
+//     sync IoRing    IoRing 同步模式，衡量封装本身的开销
+//     io_uring xD    IoRing 批量提交，每批 D 个请求（默认 64）
+//   io_uring 不可用（内核过旧、被禁用或 seccomp 拒绝）时第三种方式跳过。
+
+#include "browser/IoRing.hpp"
+#include "BenchUtil.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace FTB::Bench;
+using FTB::IoRing;
+
+namespace {
+
+constexpr size_t kFileSize = 4096;
+
+struct Workload {
+    std::vector<std::string> paths;
+    std::vector<int>         fds;
+    std::vector<char>        buffer;   // paths.size() × kFileSize
+    std::vector<struct statx> stats;
+};
+
+void CreateFiles(Workload& w) {
+    std::vector<char> block(kFileSize, 'x');
+    for (const auto& path : w.paths) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) continue;
+        if (::write(fd, block.data(), block.size()) < 0) std::perror("write");
+        ::close(fd);
+    }
+}
+
+// ---- 逐条系统调用 ----
+
+void SyscallStatx(Workload& w) {
+    for (size_t i = 0; i < w.paths.size(); ++i) {
+        ::statx(AT_FDCWD, w.paths[i].c_str(), 0, STATX_TYPE | STATX_SIZE, &w.stats[i]);
+    }
+}
+
+void SyscallOpenClose(Workload& w) {
+    for (const auto& path : w.paths) {
+        int fd = ::openat(AT_FDCWD, path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+void SyscallRead(Workload& w) {
+    for (size_t i = 0; i < w.paths.size(); ++i) {
+        int fd = ::openat(AT_FDCWD, w.paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (::pread(fd, w.buffer.data() + i * kFileSize, kFileSize, 0) < 0) std::perror("pread");
+        ::close(fd);
+    }
+}
+
+void SyscallUnlink(Workload& w) {
+    for (const auto& path : w.paths) ::unlinkat(AT_FDCWD, path.c_str(), 0);
+}
+
+// ---- IoRing：每 depth 个请求一批，每批内各阶段依次提交 ----
+
+template <typename Fn>
+void InBatches(size_t count, size_t depth, const Fn& fn) {
+    for (size_t begin = 0; begin < count; begin += depth) fn(begin, std::min(count, begin + depth));
+}
+
+void RingStatx(IoRing& ring, Workload& w, size_t depth) {
+    std::vector<IoRing::Completion> done;
+    InBatches(w.paths.size(), depth, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ring.push(IoRing::statx(IoRing::kCwd, w.paths[i].c_str(), 0, STATX_TYPE | STATX_SIZE, &w.stats[i], i));
+        }
+        ring.drain(done);
+        done.clear();
+    });
+}
+
+void RingOpen(IoRing& ring, Workload& w, size_t begin, size_t end, std::vector<IoRing::Completion>& done) {
+    for (size_t i = begin; i < end; ++i) {
+        ring.push(IoRing::openAt(IoRing::kCwd, w.paths[i].c_str(), O_RDONLY | O_CLOEXEC, 0, i));
+    }
+    ring.drain(done);
+    for (const auto& c : done) w.fds[c.user_data] = c.result;
+    done.clear();
+}
+
+void RingClose(IoRing& ring, Workload& w, size_t begin, size_t end, std::vector<IoRing::Completion>& done) {
+    for (size_t i = begin; i < end; ++i) {
+        if (w.fds[i] >= 0) ring.push(IoRing::close(w.fds[i], i));
+    }
+    ring.drain(done);
+    done.clear();
+}
+
+void RingOpenClose(IoRing& ring, Workload& w, size_t depth) {
+    std::vector<IoRing::Completion> done;
+    InBatches(w.paths.size(), depth, [&](size_t begin, size_t end) {
+        RingOpen(ring, w, begin, end, done);
+        RingClose(ring, w, begin, end, done);
+    });
+}
+
+void RingRead(IoRing& ring, Workload& w, size_t depth) {
+    std::vector<IoRing::Completion> done;
+    InBatches(w.paths.size(), depth, [&](size_t begin, size_t end) {
+        RingOpen(ring, w, begin, end, done);
+        for (size_t i = begin; i < end; ++i) {
+            if (w.fds[i] >= 0) ring.push(IoRing::read(w.fds[i], w.buffer.data() + i * kFileSize, kFileSize, 0, i));
+        }
+        ring.drain(done);
+        done.clear();
+        RingClose(ring, w, begin, end, done);
+    });
+}
+
+void RingUnlink(IoRing& ring, Workload& w, size_t depth) {
+    std::vector<IoRing::Completion> done;
+    InBatches(w.paths.size(), depth, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) ring.push(IoRing::unlinkAt(IoRing::kCwd, w.paths[i].c_str(), 0, i));
+        ring.drain(done);
+        done.clear();
+    });
+}
+
+void BenchRoot(const fs::path& root, size_t count, size_t depth) {
+    auto dir = root / ("ftb_ioring_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+    Workload w;
+    for (size_t i = 0; i < count; ++i) w.paths.push_back((dir / ("f_" + std::to_string(i))).string());
+    w.fds.assign(count, -1);
+    w.buffer.resize(count * kFileSize);
+    w.stats.resize(count);
+    CreateFiles(w);
+    std::printf("\n== %s: %zu x 4KB, depth %zu ==\n", root.c_str(), count, depth);
+
+    IoRing sync_ring(static_cast<unsigned>(depth), false);
+    IoRing ring(static_cast<unsigned>(depth));
+    const std::string ring_label = "io_uring x" + std::to_string(depth);
+
+    struct Case {
+        const char* name;
+        void (*syscall)(Workload&);
+        void (*batched)(IoRing&, Workload&, size_t);
+    };
+    const Case cases[] = {
+        {"statx", SyscallStatx, RingStatx},
+        {"open+close", SyscallOpenClose, RingOpenClose},
+        {"open+read+close", SyscallRead, RingRead},
+    };
+    for (const auto& c : cases) {
+        std::printf(" %s\n", c.name);
+        PrintRow("  syscall", MedianMs(5, [&] { c.syscall(w); }), count);
+        PrintRow("  sync IoRing", MedianMs(5, [&] { c.batched(sync_ring, w, depth); }), count);
+        if (ring.active()) PrintRow("  " + ring_label, MedianMs(5, [&] { c.batched(ring, w, depth); }), count);
+    }
+
+    // 删除只能执行一次：每种方式之前重新创建文件
+    std::printf(" unlink\n");
+    PrintRow("  syscall", MedianMs(1, [&] { SyscallUnlink(w); }), count);
+    CreateFiles(w);
+    PrintRow("  sync IoRing", MedianMs(1, [&] { RingUnlink(sync_ring, w, depth); }), count);
+    if (ring.active()) {
+        CreateFiles(w);
+        PrintRow("  " + ring_label, MedianMs(1, [&] { RingUnlink(ring, w, depth); }), count);
+    }
+    fs::remove_all(dir);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<fs::path> roots;
+    size_t count = 20000;
+    size_t depth = 64;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            depth = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else {
+            roots.emplace_back(argv[i]);
+        }
+    }
+    if (roots.empty()) roots.push_back(fs::temp_directory_path());
+
+    std::printf("IoRingBench: per-op syscalls vs IoRing submission (io_uring %s)\n",
+                IoRing::available() ? "available" : "unavailable");
+    for (const auto& root : roots) BenchRoot(root, count, depth);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef BLOCK_DEVICE_HPP
+#define BLOCK_DEVICE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace FTB {
+
+/**
+ * @class BlockDevice
+ * @brief 按 st_dev 识别路径所在的块设备类型，供 TaskSystem 限制同一设备上的并发任务
+ *
+ * 通过 /sys/dev/block/<major>:<minor> 找到设备（分区取其所属磁盘），读取
+ * queue/rotational 与 removable；设备路径经过 USB 总线时视为可移动设备。
+ * tmpfs、overlay、网络文件系统等没有对应块设备的 st_dev 归为 Unknown。
+ */
+class BlockDevice {
+public:
+    enum class Kind { Unknown, SolidState, Rotational, Removable };
+
+    /**
+     * @brief path 所在文件系统的 st_dev；path 不存在时（如复制目标）取最近的已存在上级目录
+     * @return 0 表示无法确定
+     */
+    static uint64_t deviceOf(const std::string& path);
+
+    /**
+     * @brief 判断设备类型
+     * @param sysfs_root sysfs 挂载点（测试时可指向伪造的目录树）
+     */
+    static Kind classify(uint64_t dev, const std::string& sysfs_root = "/sys");
+};
+
+}  // namespace FTB
+
+#endif  // BLOCK_DEVICE_HPP
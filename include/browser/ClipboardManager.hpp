@@ -27,6 +27,9 @@ public:
     // force_overwrite=true: overwrite existing files, false: auto-rename
     std::string paste(const std::string& targetPath, bool force_overwrite = false);
 
+    // 从中断任务留下的进度日志（CopyJournal）继续复制 / 移动，返回任务 ID；日志不可用时返回空
+    std::string resume(const std::string& journal_path);
+
 private:
     ClipboardManager() = default;
     std::vector<std::string> items;
@@ -0,0 +1,143 @@
+#ifndef COPY_JOURNAL_HPP
+#define COPY_JOURNAL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @class CopyJournal
+ * @brief 复制 / 移动任务的进度日志，进程被杀后可从中断处继续
+ *
+ * 每个任务一个文件 ~/.config/ftb/journal/<id>.journal：
+ *   第一行  JSON 头部：标题、是否移动、是否覆盖、顶层条目（源、解析后的目标、是否改名）与总量
+ *   之后    每行一条追加记录
+ *             F <大小> <目标>            文件已完整复制
+ *             P <偏移> <目标>            大文件已复制到该偏移（每 kCheckpointBytes 一条）
+ *             E <序号> <文件数> <字节数> 顶层条目已完成（移动时源已删除）
+ * F 记录先进入内存缓冲，超过 kFlushBytes 或距上次写出超过 kFlushInterval 时一次 write()，
+ * P / E 记录立即写出；进程被杀不丢页缓存，最多重做最后一个缓冲周期内完成的文件。
+ *
+ * 恢复时已完成的文件仍核对源与目标的大小，部分文件的偏移不超过目标的实际长度，
+ * 所以日志比数据新（如断电）时只会多复制而不会遗漏。查询只反映打开日志时的内容。
+ * 任务运行期间日志持有 flock，pending() 不会列出其他实例（或本实例）正在执行的任务。
+ */
+class CopyJournal {
+public:
+    struct Entry {
+        std::string src;
+        std::string dst;
+        bool        rename = false;
+    };
+
+    struct Header {
+        std::string        title;
+        bool               move = false;
+        bool               force_overwrite = false;
+        std::vector<Entry> entries;
+        int                total_files = 0;
+        uintmax_t          total_bytes = 0;
+    };
+
+    /// 大文件每复制这么多字节记录一次偏移
+    static constexpr uintmax_t kCheckpointBytes = 64u << 20;
+
+    static constexpr size_t kFlushBytes = 64u << 10;
+    static constexpr std::chrono::milliseconds kFlushInterval{1000};
+
+    /// ~/.config/ftb/journal
+    static std::string defaultDirectory();
+
+    /// 在 dir 下新建日志并写入头部；失败返回 nullptr（任务照常执行，只是不可恢复）
+    static std::unique_ptr<CopyJournal> create(const Header& header,
+                                               const std::string& dir = defaultDirectory());
+
+    /// 打开已有日志以继续任务；无法读取或正被其他任务持有时返回 nullptr
+    static std::unique_ptr<CopyJournal> open(const std::string& path);
+
+    /// dir 下可恢复（未被持有）的日志路径，按文件名（即创建时间）排序
+    static std::vector<std::string> pending(const std::string& dir = defaultDirectory());
+
+    /// 只读取头部，供任务面板显示
+    static bool readHeader(const std::string& path, Header& header);
+
+    ~CopyJournal();
+    CopyJournal(const CopyJournal&) = delete;
+    CopyJournal& operator=(const CopyJournal&) = delete;
+
+    const Header&      header() const { return header_; }
+    const std::string& path() const { return path_; }
+
+    /// dst 已记录完成且源与目标大小都与记录一致；size 返回文件大小
+    bool completed(const std::string& src, const std::string& dst, uintmax_t& size) const;
+
+    /// dst 的续传偏移：记录的偏移与目标实际长度中的较小值，没有记录时为 0
+    uintmax_t resumeOffset(const std::string& dst) const;
+
+    /// 顶层条目是否已完成；files / bytes 返回完成时计入进度的数量
+    bool entryDone(size_t index, int& files, uintmax_t& bytes) const;
+
+    void markFile(const std::string& dst, uintmax_t size);
+    void markPartial(const std::string& dst, uintmax_t offset);
+    void markEntry(size_t index, int files, uintmax_t bytes);
+
+    /// 写出缓冲中的记录
+    void flush();
+
+    /// 任务结束（完成、取消或失败并已清理）后删除日志
+    void remove();
+
+    /**
+     * @brief 单个文件复制过程中的检查点：每前进 kCheckpointBytes 写一条 P 记录
+     * journal 为空时所有操作都是空操作
+     */
+    class FileCheckpoint {
+    public:
+        FileCheckpoint(CopyJournal* journal, std::string dst, uintmax_t offset)
+            : journal_(journal), dst_(std::move(dst)), pos_(offset), last_(offset) {}
+        void advance(uintmax_t bytes);
+        void complete();
+
+    private:
+        CopyJournal* journal_;
+        std::string  dst_;
+        uintmax_t    pos_;
+        uintmax_t    last_;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    CopyJournal(std::string path, int fd) : path_(std::move(path)), fd_(fd) {}
+
+    void append(const std::string& record, bool now);
+    void writeLocked();
+    bool load();
+
+    std::string path_;
+    int         fd_ = -1;
+    Header      header_;
+
+    std::unordered_map<std::string, uintmax_t> done_;      // 目标 → 大小
+    std::unordered_map<std::string, uintmax_t> partial_;   // 目标 → 偏移
+    struct EntryDone {
+        int       files = 0;
+        uintmax_t bytes = 0;
+    };
+    std::unordered_map<size_t, EntryDone> entries_done_;
+
+    std::mutex        mutex_;
+    std::string       buffer_;
+    Clock::time_point last_write_ = Clock::now();
+};
+
+}  // namespace FTB
+
+#endif  // COPY_JOURNAL_HPP
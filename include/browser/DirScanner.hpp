@@ -0,0 +1,120 @@
+#ifndef DIR_SCANNER_HPP
+#define DIR_SCANNER_HPP
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @struct RawDirEntry
+ * @brief getdents64 返回的原始目录条目（不含任何 stat 信息）
+ *
+ * 成员变量：
+ *   name - 条目名称（已过滤 "." 与 ".."）
+ *   ino  - inode 号
+ *   type - d_type（DT_REG / DT_DIR / DT_LNK ...），文件系统不支持时为 DT_UNKNOWN
+ */
+struct RawDirEntry
+{
+    std::string   name;
+    uint64_t      ino  = 0;
+    unsigned char type = 0;
+};
+
+/**
+ * @struct EntryStat
+ * @brief statx 获取的精简元信息，仅填充请求的字段
+ */
+struct EntryStat
+{
+    mode_t    mode       = 0;   // 文件类型 + 权限位
+    uintmax_t size       = 0;   // 逻辑大小（字节）
+    uintmax_t blocks     = 0;   // 已分配 512 字节块数
+    int64_t   mtime_sec  = 0;   // 修改时间（秒）
+    uint32_t  mtime_nsec = 0;   // 修改时间的纳秒部分
+    uint64_t  ino        = 0;
+    uint64_t  dev        = 0;
+    uint32_t  nlink      = 0;
+};
+
+/**
+ * @class DirScanner
+ * @brief 基于 getdents64 的批量目录扫描器
+ *
+ * 以大缓冲区批量读取目录项，借助 d_type 判断类型而无需逐项 stat；
+ * 需要元信息时再通过 statAt() 以最小掩码调用 statx。
+ * 非 Linux 平台退化为 opendir/readdir + fstatat，接口保持一致。
+ */
+class DirScanner {
+public:
+    /// 默认读取缓冲区大小：256KB，一次系统调用可返回数千条目
+    static constexpr size_t kDefaultBufferSize = 256 * 1024;
+
+    /// statAt() 可请求的字段
+    enum StatField : unsigned {
+        kStatType   = 1u << 0,
+        kStatMode   = 1u << 1,
+        kStatSize   = 1u << 2,
+        kStatMtime  = 1u << 3,
+        kStatBlocks = 1u << 4,
+        kStatIno    = 1u << 5,   // ino + dev + nlink
+    };
+
+    explicit DirScanner(const std::string& path, size_t buffer_size = kDefaultBufferSize);
+    ~DirScanner();
+
+    DirScanner(const DirScanner&) = delete;
+    DirScanner& operator=(const DirScanner&) = delete;
+
+    /// 目录是否成功打开
+    bool ok() const { return fd_ >= 0; }
+
+    /// 打开失败或读取出错时的 errno，正常为 0
+    int error() const { return error_; }
+
+    /// 目录文件描述符，供 statAt() 做相对路径查询
+    int fd() const { return fd_; }
+
+    /**
+     * @brief 读取下一批条目并追加到 out
+     * @return 本次读取到条目返回 true；目录读完或出错返回 false
+     */
+    bool next(std::vector<RawDirEntry>& out);
+
+    /**
+     * @brief 读取全部条目
+     * @param path 目录路径
+     * @return 条目列表，目录无法打开时为空
+     */
+    static std::vector<RawDirEntry> readAll(const std::string& path);
+
+    /**
+     * @brief 以最小掩码获取单个条目的元信息
+     * @param dirfd  所在目录的文件描述符
+     * @param name   条目名称（相对 dirfd）
+     * @param fields StatField 组合
+     * @param out    [输出] 元信息
+     * @param follow 是否跟随符号链接
+     * @return 成功返回 true
+     */
+    static bool statAt(int dirfd, const char* name, unsigned fields,
+                       EntryStat& out, bool follow = false);
+
+    /// 将 d_type 转换为 mode_t 的类型位，DT_UNKNOWN 返回 0
+    static mode_t typeToMode(unsigned char type);
+
+private:
+    int               fd_    = -1;
+    int               error_ = 0;
+    bool              eof_   = false;
+    std::vector<char> buffer_;
+    void*             dir_   = nullptr;   // 非 Linux 平台的 DIR*
+};
+
+}  // namespace FTB
+
+#endif  // DIR_SCANNER_HPP
@@ -0,0 +1,93 @@
+#ifndef DIR_SNAPSHOT_HPP
+#define DIR_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "browser/EntryTable.hpp"
+#include "browser/SortMode.hpp"
+
+namespace FTB {
+
+/**
+ * @class DirSnapshot
+ * @brief 目录条目表的二进制快照，mmap 后直接使用，无需解析
+ *
+ * 文件布局（本机字节序，所有区域 8 字节对齐）：
+ *   Header    魔数、版本、排序模式、各区域偏移、文件大小、目录表校验和
+ *   DirRecord 按路径排序的目录表，可二分查找；每项带 DirStamp 与本目录数据的校验和
+ *   IconRecord 图标字符串表，行中以下标引用（进程内的图标编号不能跨进程使用）
+ *   RowRecord 每个条目 32 字节的定长记录，与 EntryTable 的列一一对应
+ *   Arena     路径、名称与图标字符串
+ *
+ * open() 只校验头部、目录表与边界；某个目录的行与名称在 load() 时才校验，
+ * 启动时的开销与快照大小无关。写入先落到临时文件，fsync 后 rename 替换，
+ * 读者看到的要么是旧文件要么是完整的新文件。
+ */
+class DirSnapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    struct Entry {
+        std::string                        path;
+        std::shared_ptr<const EntryTable>  table;
+    };
+
+    /**
+     * @brief 写入快照
+     * 每个目录记录条目表自带的 dirStamp()（读取目录之前取得）；没有 stamp、
+     * 当前 DirStamp 已与之不同（列表可能缺少尚未修补进来的变更）或仍有待补全条目的目录被跳过
+     * @param file    目标文件
+     * @param entries 目录及其条目表（表须已按 mode 排序）
+     * @param mode    条目表的排序模式
+     * @return 是否写入成功
+     */
+    static bool write(const std::string& file, const std::vector<Entry>& entries, SortMode mode);
+
+    /**
+     * @brief 映射并校验快照文件
+     * @return 文件不存在、版本不符或已损坏时返回空指针
+     */
+    static std::shared_ptr<const DirSnapshot> open(const std::string& file);
+
+    /// 读取目录当前的 DirStamp
+    static bool stampOf(const std::string& path, DirStamp& stamp);
+
+    ~DirSnapshot();
+
+    DirSnapshot(const DirSnapshot&) = delete;
+    DirSnapshot& operator=(const DirSnapshot&) = delete;
+
+    /**
+     * @brief 取出目录的条目表
+     * 目录不在快照中、数据校验失败或当前 DirStamp 与记录不一致时返回空
+     * @param path 目录路径
+     */
+    std::optional<EntryTable> load(const std::string& path) const;
+
+    /// 快照中条目表的排序模式
+    SortMode sortMode() const { return sort_mode_; }
+
+    /// 快照中的目录数
+    size_t directoryCount() const { return dir_count_; }
+
+    /// 快照中的所有目录路径（按字典序）
+    std::vector<std::string> paths() const;
+
+private:
+    DirSnapshot() = default;
+
+    const unsigned char* data_ = nullptr;
+    size_t               size_ = 0;
+    size_t               dir_count_ = 0;
+    SortMode             sort_mode_ = SortMode::NameAsc;
+    std::vector<uint16_t> icon_ids_;   // 快照图标下标 → 本进程的 InternIcon 编号
+};
+
+}  // namespace FTB
+
+#endif  // DIR_SNAPSHOT_HPP
@@ -0,0 +1,69 @@
+#ifndef DIR_WATCHER_HPP
+#define DIR_WATCHER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @class DirWatcher
+ * @brief 基于 inotify 的目录变更监听，把内核事件整理成按目录聚合的增量变更
+ *
+ * 只监听目录自身的直接子项（不递归）。后台线程在首个 watch() 时启动，
+ * 读取事件后短暂合并同一批次内的重复事件，再按目录回调所有监听者。
+ * 事件队列溢出或目录本身被删除/移动时发出 Rescan，表示该目录的缓存必须整体丢弃。
+ * 非 Linux 平台或 inotify 不可用时 available() 返回 false，其余接口均为空操作，
+ * 调用方应回退到 mtime 轮询。
+ */
+class DirWatcher {
+public:
+    struct Change {
+        enum Kind {
+            Created,   // 新建或移入
+            Deleted,   // 删除或移出
+            Modified,  // 属性或内容变化
+            Rescan,    // 无法增量描述，需要整体重新加载（name 为空）
+        };
+        Kind        kind;
+        std::string name;
+    };
+
+    using ChangeHandler = std::function<void(const std::string& dir, const std::vector<Change>& changes)>;
+
+    static DirWatcher& instance();
+
+    bool available() const;
+
+    /// 开始监听目录，重复调用无副作用；失败（无权限、达到 max_user_watches）返回 false
+    bool watch(const std::string& dir);
+
+    /// 停止监听目录
+    void unwatch(const std::string& dir);
+
+    bool isWatched(const std::string& dir) const;
+    size_t watchCount() const;
+
+    /**
+     * @brief 注册变更监听者，回调在监听线程上执行
+     * @return 用于 removeListener 的标识
+     */
+    size_t addListener(ChangeHandler handler);
+    void removeListener(size_t id);
+
+    DirWatcher(const DirWatcher&) = delete;
+    DirWatcher& operator=(const DirWatcher&) = delete;
+
+private:
+    DirWatcher();
+    ~DirWatcher();
+
+    struct Impl;
+    Impl* impl_;
+};
+
+}  // namespace FTB
+
+#endif  // DIR_WATCHER_HPP
@@ -0,0 +1,76 @@
+#ifndef DIRECTORY_LOADER_HPP
+#define DIRECTORY_LOADER_HPP
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "browser/EntryTable.hpp"
+#include "browser/FileManager.hpp"
+
+namespace FTB {
+
+/**
+ * @class DirectoryLoader
+ * @brief 在后台线程中流式加载单个目录，供 UI 线程分批取用
+ *
+ * 构造即开始加载，析构或 cancel() 即放弃（后台线程自行退出，不阻塞调用方）。
+ * 流式模式下按 FileManager::loadDirectoryEntries 的节奏发布名称批次与元信息批次；
+ * 非流式模式只在完成时发布最终结果，适合对已显示目录的静默重载。
+ * 每当有新数据发布且上一次通知尚未被 take() 消费时，调用一次 notify（通常是 screen->Post）。
+ */
+class DirectoryLoader {
+public:
+    /// 自上次 take() 以来累积的更新
+    struct Update {
+        EntryTable names;          // 新读取的条目（stat_pending）
+        EntryTable metadata;       // 元信息已补全的条目
+        EntryTable final_entries;  // 完成时的完整表（按配置排序）
+        bool finished = false;
+    };
+
+    /**
+     * @param path   目录路径
+     * @param stream 是否发布中间批次
+     * @param notify 有新数据可取时的通知回调，在后台线程调用
+     */
+    DirectoryLoader(std::string path, bool stream, std::function<void()> notify);
+    ~DirectoryLoader();
+
+    DirectoryLoader(const DirectoryLoader&) = delete;
+    DirectoryLoader& operator=(const DirectoryLoader&) = delete;
+
+    const std::string& path() const { return path_; }
+    bool streaming() const { return stream_; }
+
+    /// 是否已完成（不代表已被 take() 取走）
+    bool finished() const;
+
+    /// 已读取的名称数量
+    size_t loadedCount() const;
+
+    /**
+     * @brief 等待首个可显示的结果：流式模式为首批名称，非流式模式为最终结果
+     * @return 超时前等到返回 true
+     */
+    bool waitForFirstResult(std::chrono::milliseconds timeout);
+
+    /// 取走全部累积的更新（UI 线程调用）
+    Update take();
+
+    /// 放弃加载
+    void cancel();
+
+private:
+    struct State;
+
+    std::string            path_;
+    bool                   stream_;
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace FTB
+
+#endif  // DIRECTORY_LOADER_HPP
@@ -0,0 +1,87 @@
+#ifndef DISK_USAGE_HPP
+#define DISK_USAGE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace FTB {
+
+class SizeIndex;
+
+/**
+ * @class DiskUsage
+ * @brief 并行统计目录树的大小（du -s）
+ *
+ * 目录按 WorkStealingQueues 分配给工作线程：自己从队尾取（深度优先，待处理路径少），
+ * 空闲时从其他线程的队首窃取（靠近根的大子树），目录树不均衡时各线程仍保持忙碌。
+ * 目录用 DirScanner 批量读取，条目用 statx（STATX_SIZE | STATX_BLOCKS | STATX_INO | STATX_NLINK）
+ * 直接同步查询：io_uring 的 statx 总是交给内核工作线程执行，inode 已缓存时反而更慢，
+ * 并发由多个遍历线程提供。
+ *
+ * 统计口径与 du 一致：不跟随符号链接（计链接本身），跨越挂载点，
+ * 链接数大于 1 的文件按 (st_dev, st_ino) 去重只计一次。
+ * 同时给出逻辑大小（非目录条目 st_size 之和，与文件列表显示的大小一致）
+ * 与占用空间（所有条目含目录本身的 st_blocks * 512，稀疏文件与压缩文件系统上小于逻辑大小）。
+ * 无法读取的目录与无法 stat 的条目计入 errors，其余部分照常统计。
+ *
+ * 传入 SizeIndex 时，mtime 未变化的目录直接取用索引中的文件合计，只 stat 其中的子目录；
+ * 其余目录扫描后把结果写回索引。refresh_index 时不取用记录，全部重新扫描并覆盖（用户要求重新统计）。
+ */
+class DiskUsage {
+public:
+    struct Totals {
+        uintmax_t apparent = 0;   // 逻辑大小
+        uintmax_t disk     = 0;   // 占用空间
+        uint64_t  files    = 0;   // 非目录条目数
+        uint64_t  dirs     = 0;   // 目录数（含根）
+        uint64_t  errors   = 0;
+    };
+
+    struct Child {
+        std::string name;
+        Totals      totals;
+    };
+
+    struct Report {
+        Totals             total;
+        std::vector<Child> children;   // 根目录下各条目的子树合计（Options::per_child），按读取顺序
+        uint64_t           reused_dirs = 0;  // 取用索引记录、未 stat 其中文件的目录数
+        bool               cancelled = false;
+    };
+
+    /// 部分合计；在工作线程上调用，回调需自行保证线程安全
+    using ProgressFn = std::function<void(const Totals& partial)>;
+
+    struct Options {
+        size_t                    threads = 0;   // 0 表示 defaultThreads()
+        bool                      per_child = false;
+        bool                      dedupe_hardlinks = true;
+        ProgressFn                on_progress;
+        std::chrono::milliseconds progress_interval{100};
+        const std::atomic<bool>*  cancel = nullptr;
+        SizeIndex*                index = nullptr;
+        bool                      refresh_index = false;   // 只写入索引，不取用其中的记录
+    };
+
+    /**
+     * @brief 统计 root（跟随 root 本身的符号链接）；root 不是目录时只统计它自己
+     * 取消时返回已统计的部分，cancelled 为 true。结束前以最终合计再调用一次 on_progress
+     */
+    static Report measure(const std::string& root, const Options& options);
+
+    static Report measure(const std::string& root) {
+        return measure(root, Options());
+    }
+
+    /// 即 defaultWalkThreads()：至少 4 个线程，最多 16 个
+    static size_t defaultThreads();
+};
+
+}  // namespace FTB
+
+#endif  // DISK_USAGE_HPP
@@ -0,0 +1,198 @@
+#ifndef ENTRY_TABLE_HPP
+#define ENTRY_TABLE_HPP
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "browser/FileManager.hpp"
+#include "browser/SortMode.hpp"
+
+namespace FTB {
+
+/**
+ * @struct DirStamp
+ * @brief 目录自身的身份与修改时间，用于判断快照中的列表是否仍然有效
+ *
+ * 名称增删改都会更新目录的 mtime；dev + ino 防止目录被删除后同名重建。
+ */
+struct DirStamp
+{
+    uint64_t dev      = 0;
+    uint64_t ino      = 0;
+    int64_t  mtime_ns = 0;
+
+    bool operator==(const DirStamp& other) const {
+        return dev == other.dev && ino == other.ino && mtime_ns == other.mtime_ns;
+    }
+    bool operator!=(const DirStamp& other) const { return !(*this == other); }
+    bool empty() const { return dev == 0 && ino == 0 && mtime_ns == 0; }
+};
+
+/**
+ * @class EntryTable
+ * @brief 目录条目的列式存储（structure of arrays）
+ *
+ * DirEntryInfo 每个条目带有名称、时间、权限、图标四个 std::string，大目录的内存占用
+ * 与整表拷贝（lru_entry_cache 按值返回）都随之放大。这里把名称追加到一块连续的字符区，
+ * mode / 大小 / mtime 存入紧凑数组，图标以进程内驻留表的 16 位编号保存，
+ * 权限与时间字符串只在访问时格式化——界面只对可见行调用。
+ *
+ * 行一经追加位置固定，显示顺序由独立的行号数组维护：排序、插入、删除只移动 4 字节行号。
+ * 删除的行暂留在存储区，失效行超过一半时压缩。以下接口中的 pos 均指显示顺序中的位置。
+ */
+class EntryTable {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    size_t size() const { return order_.size(); }
+    bool empty() const { return order_.empty(); }
+    void reserve(size_t rows, size_t name_bytes = 0);
+    void clear();
+
+    /// 追加仅有名称与 d_type 的条目（元信息待补全），返回其位置
+    size_t appendPending(std::string_view name, unsigned char d_type);
+
+    /// 追加完整条目（SFTP 等没有原始 stat 的来源），返回其位置
+    size_t append(const FileManager::DirEntryInfo& info);
+
+    /// 追加 other 中 [begin, end) 位置的条目
+    void appendFrom(const EntryTable& other, size_t begin, size_t end);
+
+    // ---- 按位置读取 ----
+    std::string_view name(size_t pos) const;
+    mode_t   mode(size_t pos) const;       // lstat 的类型与权限位；待补全时只有类型位
+    uint64_t fileSize(size_t pos) const;   // 普通文件（含指向普通文件的链接）的大小；目录为 setTreeSize 写入的值
+    int64_t  mtime(size_t pos) const;
+    bool     isDir(size_t pos) const;      // 符号链接取目标类型
+    bool     isRegular(size_t pos) const;
+    bool     isSymlink(size_t pos) const;
+    bool     isExecutable(size_t pos) const;
+    bool     isHidden(size_t pos) const;
+    bool     statPending(size_t pos) const;
+    const std::string& icon(size_t pos) const;
+
+    /// 按需格式化的权限字符串（如 drwxr-xr-x），元信息未补全时为空
+    std::string permissions(size_t pos) const;
+
+    /// 按需格式化的修改时间（YYYY-MM-DD HH:MM），元信息未补全时为空
+    std::string modTime(size_t pos) const;
+
+    /// 展开为 DirEntryInfo，只应对少量（可见）条目调用
+    FileManager::DirEntryInfo entry(size_t pos) const;
+    std::vector<FileManager::DirEntryInfo> toEntries() const;
+    static EntryTable fromEntries(const std::vector<FileManager::DirEntryInfo>& entries);
+
+    // ---- 元信息 ----
+
+    /**
+     * @brief 用 stat 结果补全第 pos 个条目；不同位置可在多个线程上并发调用
+     * @param lmode       lstat 得到的 mode
+     * @param mtime       修改时间（秒）
+     * @param size        大小（符号链接传目标大小）
+     * @param target_mode 符号链接目标的 mode；非链接或目标无法解析时为 0
+     */
+    void setStat(size_t pos, mode_t lmode, int64_t mtime, uint64_t size, mode_t target_mode);
+
+    /// 写入目录的子树大小（TreeSize 排序用）；之后的 setStat / copyMetadata 会将其清零
+    void setTreeSize(size_t pos, uint64_t size);
+
+    /// stat 失败：保留 d_type 推断的类型，只清除待补全标记
+    void clearPending(size_t pos);
+
+    /// 用 other 中第 other_pos 个条目的元信息覆盖第 pos 个条目（名称不变）
+    void copyMetadata(size_t pos, const EntryTable& other, size_t other_pos);
+
+    // ---- 有序操作（除 sort 外均要求表已按 mode 排好序） ----
+
+    bool less(size_t a, size_t b, SortMode mode) const;
+    void sort(SortMode mode);
+
+    /**
+     * @brief 查找名为 name 的条目
+     * 名称/类型/扩展名排序下二分查找；大小/时间排序的键无法由名称得出，退化为线性查找
+     * @return 位置，未找到返回 npos
+     */
+    size_t find(std::string_view name, SortMode mode) const;
+
+    void erase(size_t pos);
+
+    /// 将第 pos 个条目移到其余条目中按 mode 应处的位置（元信息变化后调用），返回新位置
+    size_t reposition(size_t pos, SortMode mode);
+
+    /// 将 chunk 排序后归并进本表（chunk 会被清空）
+    void mergeSorted(EntryTable&& chunk, SortMode mode);
+
+    /// 占用的堆内存（字节，按容量计）
+    size_t memoryUsage() const;
+
+    // ---- 目录身份 ----
+
+    /// 读取目录之前记录的 DirStamp，写快照时用来确认列表仍是最新；没有记录或表经过修补时为空
+    const DirStamp& dirStamp() const { return dir_stamp_; }
+    void setDirStamp(const DirStamp& stamp) { dir_stamp_ = stamp; }
+
+    // ---- 原始列值（二进制快照直接读写，不经格式化） ----
+
+    struct RawRow {
+        std::string_view name;
+        uint32_t         mode = 0;
+        uint64_t         size = 0;
+        int64_t          mtime = 0;
+        uint8_t          flags = 0;
+        uint16_t         icon = 0;    // InternIcon 编号，仅在本进程内有效
+    };
+
+    /// 第 pos 个条目的原始列值，name 指向表内存储
+    RawRow rawRow(size_t pos) const;
+
+    /// 按原始列值追加一个条目（不重新计算图标与标志），返回其位置
+    size_t appendRaw(const RawRow& row);
+
+private:
+    using Row = uint32_t;
+
+    enum Flag : uint8_t {
+        kDir     = 1 << 0,
+        kRegular = 1 << 1,
+        kHidden  = 1 << 2,
+        kPending = 1 << 3,
+        kExists  = 1 << 4,
+    };
+
+    Row appendRow(std::string_view name, mode_t mode, uint8_t flags, uint16_t icon);
+    void copyRowMetadata(Row dst, const EntryTable& other, Row src);
+    std::string_view rowName(Row r) const {
+        return std::string_view(names_.data() + name_off_[r], name_len_[r]);
+    }
+    EntrySortKey rowKey(Row r) const;
+    void compact();
+
+    std::string           names_;       // 所有名称首尾相接
+    std::vector<uint32_t> name_off_;
+    std::vector<uint16_t> name_len_;
+    std::vector<uint32_t> mode_;
+    std::vector<uint64_t> size_;
+    std::vector<int64_t>  mtime_;
+    std::vector<uint8_t>  flags_;
+    std::vector<uint16_t> icon_;
+    std::vector<Row>      order_;       // 显示顺序 → 行号
+    size_t                dead_rows_ = 0;
+    DirStamp              dir_stamp_;
+
+    // 没有原始 mtime 的条目（SFTP 返回的是已格式化的时间）
+    std::unordered_map<Row, std::string> mod_time_text_;
+};
+
+/// 图标字符串驻留：进程内去重后以 16 位编号表示，线程安全
+uint16_t InternIcon(const std::string& icon);
+const std::string& IconText(uint16_t id);
+
+}  // namespace FTB
+
+#endif  // ENTRY_TABLE_HPP
@@ -0,0 +1,95 @@
+#ifndef FILE_COPIER_HPP
+#define FILE_COPIER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace FTB {
+
+/**
+ * @class FileCopier
+ * @brief 单个文件的复制引擎，尽量让数据留在内核中
+ *
+ * 依次尝试：
+ *   Reflink        ioctl(FICLONE)，btrfs / XFS 等支持共享数据块的文件系统上瞬间完成
+ *   CopyFileRange  copy_file_range，内核内复制，NFS / SMB 上可由服务器端完成
+ *   Sendfile       sendfile，较旧内核或 copy_file_range 不支持的组合
+ *   Buffered       pread / pwrite 经页对齐的用户态缓冲区复制，缓冲区按 st_blksize 起步、
+ *                  按实测吞吐翻倍到 kMaxBufferSize
+ * 某种方式不被支持时从当前偏移继续使用下一种，已复制的部分不会重做。
+ * 内核方式按 kKernelChunk 分块提交，每块完成后回调一次，进度与取消的粒度与缓冲复制一致。
+ * 非 Linux 平台只有 Buffered。
+ *
+ * 稀疏文件（已分配的块明显少于长度，如虚拟机镜像）不能 reflink 时按区段复制：
+ * SEEK_DATA / SEEK_HOLE 找出数据区段，只复制数据，空洞在目标中保留为空洞，
+ * 回调仍按逻辑字节报告空洞（hole 为 true），进度百分比与整体复制一致。
+ *
+ * 不能 reflink 的稠密文件先用 fallocate（KEEP_SIZE）预分配目标；不小于 16MB 的文件
+ * 对源声明顺序读取，并随复制进度丢弃源与目标的页缓存，批量复制不会挤掉浏览时使用的缓存。
+ * PerfLogger 开启时，不小于 1MB 的文件记录打开 / 预分配 / 复制 / 关闭各阶段的耗时。
+ */
+class FileCopier {
+public:
+    enum class Method { Reflink, CopyFileRange, Sendfile, Buffered };
+
+    /// 内核复制方式默认单次提交的字节数
+    static constexpr size_t kKernelChunk = 8u << 20;
+
+    /// 缓冲复制的起始（最小）缓冲区大小
+    static constexpr size_t kBufferSize = 64u << 10;
+
+    /// 缓冲复制的缓冲区上限（同时不超过 kernel_chunk）
+    static constexpr size_t kMaxBufferSize = 4u << 20;
+
+    /**
+     * @brief 每块复制完成后调用
+     * @param bytes 本块的字节数
+     * @param hole  为 true 时这段是跳过的空洞：计入进度，但没有实际 I/O（不应计入限速）
+     * @return false 时中止复制（取消）
+     */
+    using ChunkFn = std::function<bool(uintmax_t bytes, bool hole)>;
+
+    struct Result {
+        bool      ok = false;
+        bool      cancelled = false;
+        Method    method = Method::Buffered;   // 最终完成复制的方式
+        uintmax_t bytes = 0;
+        uintmax_t holes = 0;                   // 按空洞跳过（未读写）的字节数
+        int       error = 0;                   // 失败时的 errno
+
+        // 各阶段耗时（微秒）；open_us / close_us 只由 copyFile 填写
+        uint64_t  open_us = 0;
+        uint64_t  prealloc_us = 0;             // 预分配与页缓存提示
+        uint64_t  copy_us = 0;
+        uint64_t  close_us = 0;
+    };
+
+    /**
+     * @brief 复制 src 到 dst（截断或新建，权限位取自源文件）
+     * @param on_chunk 可为空
+     * @param first    从哪种方式开始尝试（基准测试用于固定方式）
+     * @param kernel_chunk 内核复制方式单次提交的字节数（不小于 kBufferSize），也是缓冲区的上限，
+     *                     限速时调小以平滑速率
+     * @param offset   续传：保留 dst 的前 offset 字节（不截断），从该偏移继续复制；
+     *                 超过源或目标长度时取较小者。回调只报告新复制的字节，Result::bytes 为最终长度
+     */
+    static Result copyFile(const std::string& src, const std::string& dst,
+                           const ChunkFn& on_chunk = {}, Method first = Method::Reflink,
+                           size_t kernel_chunk = kKernelChunk, uintmax_t offset = 0);
+
+    /**
+     * @brief 在已打开的描述符之间复制，从两者的偏移 offset 开始（offset 非 0 时跳过 reflink）
+     * @param size 源文件大小；为 0 时（/proc 等伪文件）直接使用缓冲复制读到 EOF
+     */
+    static Result copyFd(int src_fd, int dst_fd, uintmax_t size,
+                         const ChunkFn& on_chunk = {}, Method first = Method::Reflink,
+                         size_t kernel_chunk = kKernelChunk, uintmax_t offset = 0);
+
+    static const char* methodName(Method method);
+};
+
+}  // namespace FTB
+
+#endif  // FILE_COPIER_HPP
@@ -12,11 +12,12 @@
 #include <shared_mutex>  // 读写锁，提高并发性能
 #include <atomic>        // 原子操作
 #include <thread>        // 线程支持
+#include <functional>    // 分批加载回调
 
 #include "DirectoryHistory.hpp"  // 目录历史记录，用于记录进入/返回操作
 #include "utils/LRUCache.hpp"          // LRU缓存实现
 
-namespace FTB { enum class SortMode; }
+namespace FTB { enum class SortMode; class EntryTable; }
 
 // 定义读取文件时的分块大小：8KB，用于分块加载大文件内容
 constexpr size_t CHUNK_SIZE = 8192;  // 8KB
@@ -38,7 +39,6 @@ namespace FileManager
      *   sizes        - 与 contents 对应的每个条目的大小（filesize 或子目录大小）
      *   total_size   - 整个目录的总大小（递归计算）
      *   last_update  - 本次缓存更新时间戳，用于判断是否过期
-     *   file_mod_times - 文件修改时间，用于智能缓存失效
      */
     struct DirectoryCache
     {
@@ -47,7 +47,6 @@ namespace FileManager
         std::vector<uintmax_t>                sizes;
         uintmax_t                             total_size = 0;
         std::chrono::system_clock::time_point last_update;
-        std::vector<std::chrono::system_clock::time_point> file_mod_times;
         
         DirectoryCache() = default;
         
@@ -66,6 +65,13 @@ namespace FileManager
                 return false;
             }
         }
+
+        // 占用的堆内存（字节，按容量计），供缓存按字节预算驱逐
+        size_t memoryUsage() const {
+            size_t bytes = contents.capacity() * sizeof(std::string) + sizes.capacity() * sizeof(uintmax_t);
+            for (const auto& name : contents) bytes += name.capacity();
+            return bytes;
+        }
     };
 
     /**
@@ -123,21 +129,26 @@ namespace FileManager
         std::string  mod_time;       // 格式化后的修改时间
         std::string  permissions;    // 权限字符串 (如 drwxr-xr-x)
         std::string  icon;           // 图标
+        bool         stat_pending = false;  // 名称优先加载时为 true：尺寸/时间/权限尚未填充
     };
 
+    /// 元信息批次回调：entries 中 [begin, end) 区间的元信息已补全
+    using EntryBatchCallback =
+        std::function<void(const FTB::EntryTable& entries, size_t begin, size_t end)>;
+
     // ---------------------------- 全局缓存变量声明 ----------------------------
 
     /// 保护缓存访问的互斥锁，确保线程安全
     extern std::mutex                           cache_mutex;
     
-    /// 优化的LRU缓存，用于目录内容缓存
-    extern std::unique_ptr<FTB::LRUCache<std::string, DirectoryCache>> lru_dir_cache;
+    /// 共享快照的LRU缓存，用于目录内容缓存
+    extern std::unique_ptr<FTB::SharedLRUCache<std::string, DirectoryCache>> lru_dir_cache;
     /// 优化的LRU缓存，用于文件大小缓存
     extern std::unique_ptr<FTB::LRUCache<std::string, uintmax_t>>      lru_size_cache;
-    /// 优化的LRU缓存，用于文件内容缓存
-    extern std::unique_ptr<FTB::LRUCache<std::string, std::string>>    lru_content_cache;
-    /// LRU缓存，用于DirEntryInfo列表缓存
-    extern std::unique_ptr<FTB::LRUCache<std::string, std::vector<DirEntryInfo>>> lru_entry_cache;
+    /// 共享快照的LRU缓存，用于文件内容缓存
+    extern std::unique_ptr<FTB::SharedLRUCache<std::string, std::string>> lru_content_cache;
+    /// 共享快照的LRU缓存，用于目录条目表缓存（使用前需包含 browser/EntryTable.hpp）
+    extern std::unique_ptr<FTB::SharedLRUCache<std::string, FTB::EntryTable>> lru_entry_cache;
     
     /// 缓存统计信息
     extern std::atomic<size_t>                   cache_hits;
@@ -147,7 +158,27 @@ namespace FileManager
     // ---------------------------- 接口声明 ----------------------------
 
     /**
-     * @brief 获取指定目录下所有条目的完整信息（使用 directory_iterator 缓存）
+     * @brief 获取指定目录下所有条目的只读快照（优先命中 lru_entry_cache，命中时不拷贝）
+     * @param path 目录路径
+     * @return 按配置排序的条目表，与缓存共享
+     */
+    std::shared_ptr<const FTB::EntryTable> getSharedEntryTable(const std::string& path);
+
+    /**
+     * @brief 获取指定目录下所有条目的列式表（可修改的副本）
+     * @param path 目录路径
+     * @return 按配置排序的条目表
+     */
+    FTB::EntryTable getEntryTable(const std::string& path);
+
+    /**
+     * @brief 获取指定目录下所有条目的列式表并使用指定的排序模式
+     */
+    FTB::EntryTable getEntryTable(const std::string& path, FTB::SortMode mode);
+
+    /**
+     * @brief 获取指定目录下所有条目的完整信息（优先命中 lru_entry_cache）
+     * 每个条目都会展开为字符串，界面渲染应使用 getEntryTable
      * @param path 目录路径
      * @return 返回条目信息列表
      */
@@ -161,6 +192,28 @@ namespace FileManager
      */
     std::vector<DirEntryInfo> getDirectoryEntries(const std::string& path, FTB::SortMode mode);
 
+    /// 名称优先加载时每批交付的条目数
+    constexpr size_t kNameChunkSize = 2048;
+
+    /**
+     * @brief 名称优先地加载目录条目（不读缓存，结果写入 lru_entry_cache）
+     *
+     * 边读取边交付名称：首批立即回调 on_names，此后每满 kNameChunkSize 条回调一次，
+     * 此时条目的 stat_pending 为 true，仅名称、类型与图标可用；
+     * 随后 statx 被分发到并行线程池，元信息按原顺序分批补全并回调 on_batch。
+     * 两个回调都在调用线程上执行，可为空。
+     * @param path     目录路径
+     * @param on_names 名称批次回调，[begin, end) 为新读取的条目
+     * @param on_batch 元信息批次回调，[begin, end) 为已补全的条目
+     * @param cancel   可选的取消标志，置位后尽快返回空列表且不写缓存
+     * @return 按配置排序后的完整条目表；写入缓存时与缓存共享同一份，不另行复制
+     */
+    std::shared_ptr<const FTB::EntryTable> loadDirectoryEntries(
+        const std::string& path,
+        const EntryBatchCallback& on_names,
+        const EntryBatchCallback& on_batch,
+        const std::atomic<bool>* cancel = nullptr);
+
     /**
      * @brief 判断给定路径是否为目录
      * @param path 要检查的路径
@@ -184,6 +237,8 @@ namespace FileManager
 
     /**
      * @brief 递归计算目录大小（包含所有子目录和文件）
+     *
+     * 由 FTB::DiskUsage 多线程遍历：不跟随符号链接，硬链接只计一次。
      * @param path 要计算大小的目录路径
      * @return 返回该目录及其子目录所有文件总大小（字节数），如果出错返回 0
      */
@@ -305,12 +360,17 @@ namespace FileManager
      * @param max_dir_cache_size 目录缓存最大大小
      * @param max_size_cache_size 大小缓存最大大小
      * @param max_content_cache_size 内容缓存最大大小
-     * @param enable_persistence 是否启用持久化
+     * @param enable_persistence 是否启用持久化（目录条目表的二进制快照）
      */
     void initializeCacheSystem(size_t max_dir_cache_size = 1000,
                               size_t max_size_cache_size = 5000,
                               size_t max_content_cache_size = 2000,
                               bool enable_persistence = true);
+
+    /**
+     * @brief 停止缓存清理线程，并写入最终的目录快照
+     */
+    void shutdownCacheSystem();
     
     /**
      * @brief 清理所有缓存
@@ -334,6 +394,11 @@ namespace FileManager
         size_t total_misses;
         size_t total_evictions;
         double hit_ratio;
+        // 各缓存按分片的命中、未命中与驱逐计数
+        FTB::CacheStats dir_cache;
+        FTB::CacheStats size_cache;
+        FTB::CacheStats content_cache;
+        FTB::CacheStats entry_cache;
     };
     
     CacheStatistics getCacheStatistics();
@@ -350,9 +415,50 @@ namespace FileManager
      */
     void invalidateCacheForPath(const std::string& path);
     
+    /**
+     * @brief 丢弃 path 及其下各路径的大小缓存（用户要求重新统计时）
+     * @param path 目录路径
+     */
+    void invalidateSizeCaches(const std::string& path);
+    
     // 排序缓存失效
     void invalidateEntryCache();
 
+    /**
+     * @brief 本地文件操作完成后增量修补所在目录的缓存
+     *
+     * 对已缓存的父目录条目列表做定点删除/插入（按配置排序模式二分定位），
+     * 避免整目录失效后重新扫描与排序；父目录未缓存时无操作。
+     * @param path 新建、删除或修改的条目完整路径
+     */
+    void patchCacheOnCreate(const std::string& path);
+    void patchCacheOnRemove(const std::string& path);
+    void patchCacheOnModify(const std::string& path);
+
+    /**
+     * @brief 重命名/移动完成后修补新旧父目录的缓存
+     * @param oldPath 原完整路径
+     * @param newPath 新完整路径
+     */
+    void patchCacheOnRename(const std::string& oldPath, const std::string& newPath);
+
+    /// 被监听目录的缓存被增量修补或整体丢弃后的回调，在监听线程上调用
+    using DirectoryChangeListener = std::function<void(const std::string& dir)>;
+
+    /**
+     * @brief 设置目录变更回调（只保留一个，传空函数即取消）
+     *
+     * 写入 lru_dir_cache / lru_entry_cache 的本地目录会被 inotify 监听，
+     * 创建、删除、重命名、属性变化直接修补缓存中的条目，随后回调通知界面。
+     */
+    void setDirectoryChangeListener(DirectoryChangeListener listener);
+
+    /**
+     * @brief 目录缓存是否由 inotify 保持最新
+     * @return true 时缓存内容可直接信任，无需再检查目录 mtime
+     */
+    bool isDirectoryWatched(const std::string& path);
+
     // 智能缓存管理函数
     void preloadHotPaths();
     void trackPathAccess(const std::string& path);
@@ -28,6 +28,9 @@ bool IsCalculating();
 // 请求取消当前计算
 void RequestCancel();
 
+// 取消当前计算；下一次异步计算不使用大小缓存与持久化索引，并用新结果覆盖索引记录
+void RequestRescan();
+
 }
 
 #endif // FILE_SIZE_CALCULATOR_HPP
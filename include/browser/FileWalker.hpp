@@ -0,0 +1,48 @@
+#ifndef FILE_WALKER_HPP
+#define FILE_WALKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace FTB {
+
+/**
+ * @class FileWalker
+ * @brief 并行遍历目录树，逐个回报条目（文件搜索用）
+ *
+ * 目录按 WorkStealingQueues 分配给工作线程，用 DirScanner（getdents64）读取，
+ * 类型取自 d_type，只有文件系统不提供 d_type 时才 stat。不跟随符号链接。
+ * 可跳过隐藏条目与指定名称的目录，并遵循 .gitignore（含仓库根到遍历起点之间各层的规则）。
+ * 条目在工作线程上回报，顺序不确定；回调需自行保证线程安全。
+ */
+class FileWalker {
+public:
+    struct Entry {
+        std::string_view path;   // 相对遍历起点的路径
+        std::string_view name;
+        bool             is_dir = false;
+    };
+
+    /// 回调中的字符串视图只在调用期间有效
+    using Visitor = std::function<void(const Entry& entry)>;
+
+    struct Options {
+        size_t                                 threads = 0;     // 0 表示 defaultWalkThreads()
+        int                                    max_depth = 0;   // 起点的直接条目深度为 1；0 表示不限
+        bool                                   include_hidden = false;
+        bool                                   honor_gitignore = true;
+        const std::unordered_set<std::string>* skip_dirs = nullptr;   // 不进入也不回报的目录名
+        const std::atomic<bool>*               cancel = nullptr;
+    };
+
+    /// 遍历 root 下的条目（不含 root 本身）。取消时提前返回 false
+    static bool walk(const std::string& root, const Options& options, const Visitor& visit);
+};
+
+}  // namespace FTB
+
+#endif  // FILE_WALKER_HPP
@@ -0,0 +1,58 @@
+#ifndef GIT_IGNORE_HPP
+#define GIT_IGNORE_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @class GitIgnore
+ * @brief 一个 .gitignore 文件的规则，连同上层目录的规则组成一条链
+ *
+ * 支持 gitignore 的常用语法：# 注释、! 取反、结尾 / 只匹配目录、
+ * 含 / 的模式相对该文件所在目录锚定、不含 / 的模式匹配任意层级的名称、
+ * 通配 * ? [...]，以及独占一段的 **（开头、中间、结尾，可跨越任意层目录）。
+ * 判定时深层文件的规则优先，同一文件中靠后的规则优先；
+ * 被忽略的目录不会进入，因此其中的文件无法被 ! 重新包含，与 git 一致。
+ * 对象不可变，可在多个遍历线程间共享。
+ */
+class GitIgnore {
+public:
+    /// 解析 .gitignore 的内容；dir 为该文件所在目录的绝对路径。没有规则时返回 parent
+    static std::shared_ptr<const GitIgnore> parse(const std::string& dir, std::string_view text,
+                                                  std::shared_ptr<const GitIgnore> parent);
+
+    /// 读取 dir/.gitignore；文件不存在或没有规则时返回 parent
+    static std::shared_ptr<const GitIgnore> load(const std::string& dir, std::shared_ptr<const GitIgnore> parent);
+
+    /**
+     * @brief 从 root 向上查找所在仓库（含 .git 的目录），由外到内加载 root 之上各层的 .gitignore
+     * 以及仓库的 .git/info/exclude。root 自身的 .gitignore 由遍历时加载。不在仓库中时返回 nullptr
+     */
+    static std::shared_ptr<const GitIgnore> loadAncestors(const std::string& root);
+
+    /// 绝对路径 path 是否被忽略
+    bool ignored(std::string_view path, bool is_dir) const;
+
+    /// gitignore 风格的通配匹配：* 与 ? 不匹配 /，** 可跨越目录
+    static bool globMatch(std::string_view pattern, std::string_view text);
+
+private:
+    struct Rule {
+        std::string pattern;
+        bool        negate   = false;
+        bool        dir_only = false;
+        bool        anchored = false;   // 匹配相对路径而不只是名称
+    };
+
+    std::string                      dir_;   // 以 / 结尾
+    std::vector<Rule>                rules_;
+    std::shared_ptr<const GitIgnore> parent_;
+};
+
+}  // namespace FTB
+
+#endif  // GIT_IGNORE_HPP
@@ -0,0 +1,128 @@
+#ifndef IO_RING_HPP
+#define IO_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @class IoRing
+ * @brief 批量文件系统操作的提交队列：io_uring 可用时一次系统调用提交多条请求，否则逐条同步执行
+ *
+ * 批量复制 / 删除 / 统计大小时每个条目都是一次阻塞系统调用，单个线程同一时刻只有一个操作在途。
+ * IoRing 直接通过 io_uring_setup / io_uring_enter 管理一个提交 / 完成队列（不依赖 liburing），
+ * push() 只把请求写入提交队列，wait() / drain() 时一次提交并收取完成，一个线程即可保持数十个操作在途。
+ *
+ * 运行时探测：内核不支持 io_uring、被 sysctl kernel.io_uring_disabled 禁用或 seccomp 拒绝时，
+ * 整个实例退化为同步模式；内核不支持其中某个操作码时（如 5.11 之前的 UNLINKAT）仅该操作同步执行。
+ * 同步模式下请求在 push() 中立即执行，完成结果同样经 wait() 返回，调用方代码无需区分两种模式。
+ *
+ * 完成顺序不保证与提交顺序一致，调用方以 user_data 区分请求。
+ * 请求引用的路径、缓冲区与目录描述符在其完成前必须保持有效。
+ * 实例不是线程安全的，每个线程使用各自的 IoRing。
+ */
+class IoRing {
+public:
+    enum class Op : uint8_t { OpenAt, Read, Write, Statx, UnlinkAt, Close };
+
+    /// 默认提交队列深度
+    static constexpr unsigned kDefaultEntries = 64;
+
+    /// 相对当前工作目录解析路径（与 AT_FDCWD 相同）
+    static constexpr int kCwd = -100;
+
+    struct Request {
+        Op          op        = Op::Close;
+        int         fd        = -1;        // OpenAt / Statx / UnlinkAt 为目录描述符，其余为文件描述符
+        const char* path      = nullptr;   // OpenAt / Statx / UnlinkAt
+        int         flags     = 0;         // open 标志或 AT_* 标志
+        unsigned    mode      = 0;         // OpenAt 为创建权限，Statx 为 STATX_* 掩码
+        void*       buf       = nullptr;   // Read / Write 的缓冲区，Statx 为 struct statx*
+        unsigned    len       = 0;
+        uint64_t    offset    = 0;
+        uint64_t    user_data = 0;
+    };
+
+    struct Completion {
+        uint64_t user_data = 0;
+        int      result    = 0;   // 成功为 fd / 字节数 / 0，失败为 -errno
+    };
+
+    static Request openAt(int dirfd, const char* path, int flags, unsigned mode, uint64_t user_data);
+    static Request read(int fd, void* buf, unsigned len, uint64_t offset, uint64_t user_data);
+    static Request write(int fd, const void* buf, unsigned len, uint64_t offset, uint64_t user_data);
+    /// @param out 指向 struct statx
+    static Request statx(int dirfd, const char* path, int flags, unsigned mask, void* out, uint64_t user_data);
+    static Request unlinkAt(int dirfd, const char* path, int flags, uint64_t user_data);
+    static Request close(int fd, uint64_t user_data);
+
+    /**
+     * @param entries  提交队列深度（内核向上取整为 2 的幂）
+     * @param use_ring false 时强制同步模式（基准测试对照与排错）
+     */
+    explicit IoRing(unsigned entries = kDefaultEntries, bool use_ring = true);
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    /// 当前内核能否创建 io_uring（进程内只探测一次）
+    static bool available();
+
+    /// 本实例是否在使用 io_uring
+    bool active() const { return ring_fd_ >= 0; }
+
+    /// 该操作是否经由 io_uring 执行
+    bool supports(Op op) const;
+
+    /// 加入一个请求；提交队列已满时先提交已排队的请求
+    void push(const Request& request);
+
+    /**
+     * @brief 提交所有排队的请求，至少等到 min_complete 个完成（不超过在途数），完成结果追加到 out
+     * @return 本次追加的完成数
+     */
+    size_t wait(std::vector<Completion>& out, size_t min_complete = 1);
+
+    /// 提交并等待全部请求完成
+    size_t drain(std::vector<Completion>& out);
+
+    /// 已加入但尚未经 wait() 取回完成的请求数
+    size_t pending() const { return queued_ + in_flight_ + ready_.size(); }
+
+private:
+    void submitQueued(unsigned min_complete);
+    void reap();
+    static Completion runSync(const Request& request);
+
+    int      ring_fd_      = -1;
+    uint32_t supported_    = 0;    // 按 Op 索引的位图
+    size_t   queued_       = 0;    // 已写入提交队列、尚未交给内核
+    size_t   in_flight_    = 0;    // 已交给内核、尚未收取完成
+    unsigned sq_entries_   = 0;
+    unsigned cq_entries_   = 0;
+
+    // 映射的共享内存与其中的队列指针
+    void*     sq_map_      = nullptr;
+    size_t    sq_map_size_ = 0;
+    void*     cq_map_      = nullptr;
+    size_t    cq_map_size_ = 0;
+    void*     sqes_        = nullptr;
+    size_t    sqes_size_   = 0;
+    unsigned* sq_head_     = nullptr;
+    unsigned* sq_tail_     = nullptr;
+    unsigned* sq_mask_     = nullptr;
+    unsigned* sq_array_    = nullptr;
+    unsigned* cq_head_     = nullptr;
+    unsigned* cq_tail_     = nullptr;
+    unsigned* cq_mask_     = nullptr;
+    void*     cqes_        = nullptr;
+
+    std::vector<Completion> ready_;   // 已完成、尚未交给调用方（同步执行或提前收取）
+};
+
+}  // namespace FTB
+
+#endif  // IO_RING_HPP
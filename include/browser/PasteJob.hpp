@@ -0,0 +1,75 @@
+#ifndef PASTE_JOB_HPP
+#define PASTE_JOB_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "browser/TaskSystem.hpp"
+
+namespace FTB {
+
+class CopyJournal;
+class SizeIndex;
+
+/**
+ * @class PasteJob
+ * @brief 粘贴（复制 / 移动）任务的执行部分，ClipboardManager 负责提交与缓存修补
+ *
+ * 剪切到同一设备时每个顶层条目用 renameNoReplace 直接改名，不遍历也不复制；
+ * 期间目标位置出现同名条目（EEXIST）时重新选择名称再改名，不会覆盖它；
+ * 同一设备的不同挂载点（EXDEV）或要求覆盖时目录替换非空目录等情况退回复制后删除，其他错误整条失败。
+ * 源已不在的条目标记为 moved，失败清理时保留其目标——那是唯一的副本。
+ */
+class PasteJob {
+public:
+    struct Entry {
+        std::filesystem::path src;
+        std::filesystem::path dst;
+        bool rename = false;   // 剪切到同一文件系统：尝试直接改名
+        bool moved = false;    // 源已移到 dst，失败清理时不得删除
+    };
+
+    struct Plan {
+        std::vector<Entry> entries;
+        int                total_files = 0;
+        uintmax_t          total_bytes = 0;
+    };
+
+    /// 改名函数：返回 0 或 errno，签名与 renameNoReplace 相同
+    using RenameFn = std::function<int(const std::filesystem::path& from,
+                                       const std::filesystem::path& to, bool replace)>;
+
+    struct Options {
+        bool         cut = false;
+        bool         force_overwrite = false;
+        CopyJournal* journal = nullptr;
+        SizeIndex*   index = nullptr;   // 移除写入过文件的目标目录的记录
+        RenameFn     rename;   // 为空时使用 renameNoReplace
+    };
+
+    /**
+     * @brief 解析目标路径并统计总量
+     * 未指定覆盖时同名目标改为 "name (1).ext" 等；同一设备的剪切只计条目数，不遍历源目录
+     */
+    static Plan collect(const std::vector<std::string>& items, const std::filesystem::path& target_dir,
+                        bool force_overwrite, bool cut);
+
+    /**
+     * @brief 按顺序处理各条目，更新进度并响应取消与暂停
+     * @return 全部成功返回 true；取消或出错返回 false（已完成的条目保留 moved 标记，
+     *         改名失败的条目 dst 被清空——它指向的不是本任务写入的目标）
+     */
+    static bool run(std::vector<Entry>& entries, const Options& options, Progress& progress,
+                    const std::atomic<bool>& cancel, const std::atomic<bool>& pause);
+
+    /// 失败或取消后删除已写入的目标；moved 的条目跳过
+    static void cleanup(const std::vector<Entry>& entries);
+};
+
+}  // namespace FTB
+
+#endif  // PASTE_JOB_HPP
@@ -0,0 +1,103 @@
+#ifndef RATE_LIMITER_HPP
+#define RATE_LIMITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace FTB {
+
+/**
+ * @class RateLimiter
+ * @brief 所有后台任务共享的字节令牌桶，限制复制等操作的总吞吐量
+ *
+ * 令牌按 rate 字节/秒持续补充，最多积累 kBurstSeconds 秒的量作为突发额度。
+ * acquire() 在令牌余额非负时立即放行并扣除本次字节数（余额可以为负），
+ * 因此单次请求可以大于突发额度，之后的请求等待余额回正，长期平均速率等于 rate。
+ *
+ * 多个任务同时等待时按开始时间公平排队（start-time fair queuing）：
+ * 每个流（通常以任务的 Progress 地址标识）累计已获准的字节数作为虚拟时间，
+ * 总是先放行虚拟时间最小的请求，所以无论各任务的块大小与复制线程数如何，
+ * 并发任务按字节平分带宽；空闲的流不积累额度，桶中的突发额度先到先得。
+ *
+ * rate 为 0 时不限速，acquire() 只检查取消标志。
+ */
+class RateLimiter {
+public:
+    /// 令牌桶容量：rate × kBurstSeconds
+    static constexpr double kBurstSeconds = 0.5;
+
+    /// 限速时建议的单次提交下限，避免过小的块放大系统调用开销
+    static constexpr size_t kMinChunk = 64u << 10;
+
+    using Clock = std::chrono::steady_clock;
+    using NowFn = std::function<Clock::time_point()>;
+
+    static RateLimiter& instance();
+
+    /// @param now 补充令牌所用的时钟；测试可传入手动推进的时钟
+    explicit RateLimiter(NowFn now = Clock::now) : now_(std::move(now)) {}
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /// 设置总速率（字节/秒），0 表示不限速；正在等待的请求按新速率重新计算
+    void setRate(uintmax_t bytes_per_sec);
+
+    uintmax_t rate() const { return rate_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 为 flow 消耗 bytes 个令牌，必要时阻塞
+     * @param flow   公平分配的单位，同一任务的所有线程应使用同一个值
+     * @param cancel 等待期间置位时放弃并返回 false
+     * @return 获准返回 true
+     */
+    bool acquire(const void* flow, uintmax_t bytes, const std::atomic<bool>& cancel);
+
+    /**
+     * @brief 限速时的建议单次提交字节数：约 1/10 秒的量，使速率平滑
+     * @param max 不限速时（或建议值更大时）返回的上限
+     */
+    size_t chunkHint(size_t max) const;
+
+    /// 当前排队等待令牌的请求数
+    size_t waiting() const;
+
+private:
+    struct Ticket {
+        double   start;   // 虚拟开始时间
+        uint64_t seq;     // 同一开始时间按到达顺序
+        bool operator<(const Ticket& other) const {
+            return start != other.start ? start < other.start : seq < other.seq;
+        }
+    };
+
+    struct Flow {
+        double finish  = 0;   // 该流最后一个请求的虚拟结束时间
+        size_t waiting = 0;
+    };
+
+    void refill(Clock::time_point now);
+    void forget(const void* flow, Flow& state);
+
+    NowFn                                   now_;
+    std::atomic<uintmax_t>                  rate_{0};
+    mutable std::mutex                      mutex_;
+    std::condition_variable                 cv_;
+    double                                  tokens_ = 0;
+    Clock::time_point                       last_refill_{};
+    double                                  vtime_ = 0;   // 最近放行请求的虚拟开始时间
+    uint64_t                                next_seq_ = 0;
+    std::set<Ticket>                        queue_;
+    std::unordered_map<const void*, Flow>   flows_;
+};
+
+}  // namespace FTB
+
+#endif  // RATE_LIMITER_HPP
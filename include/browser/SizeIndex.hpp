@@ -0,0 +1,125 @@
+#ifndef SIZE_INDEX_HPP
+#define SIZE_INDEX_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FTB {
+
+/**
+ * @class SizeIndex
+ * @brief 持久化的目录大小索引，重复统计同一棵树时跳过未变化的目录
+ *
+ * 以 (st_dev, st_ino) 为键，每个目录一条记录：目录的 mtime 与它直接包含的非目录条目的合计。
+ * DiskUsage 遇到 mtime 与记录一致的目录时只读取目录项找出子目录，
+ * 不再逐个 stat 其中的文件——大树上绝大部分时间花在这些 stat 上，重复统计因此从分钟级降到秒级。
+ * mtime 变化（条目增删、改名）的目录照常扫描并更新记录。
+ *
+ * 记录的是目录自身的合计而不是子树合计：子目录深处的变化不会改变上层目录的 mtime，
+ * 只凭上层的 mtime 复用整棵子树会漏掉这些变化，所以子目录总是逐个核对。
+ * 同样，文件被原地改写（O_TRUNC 覆盖、追加）而目录项不变时目录的 mtime 不变：
+ * FTB 自己写入或删除文件后用 forget() 移除所在目录的记录，其他程序的改写则靠记录的期限——
+ * 扫描后超过 kMaxAgeDays 天的记录不再取用，目录会被重新扫描；需要精确结果时不传入索引即可。
+ *
+ * 链接数大于 1 的文件单独保存 inode，复用时仍参与硬链接去重。
+ * 索引保存在 ~/.config/ftb/size-index，过期的记录在保存时丢弃。
+ * 所有方法线程安全。
+ */
+class SizeIndex {
+public:
+    struct Linked {
+        uint64_t  ino      = 0;
+        uintmax_t apparent = 0;
+        uintmax_t disk     = 0;
+    };
+
+    struct Record {
+        int64_t             mtime_sec  = 0;
+        uint32_t            mtime_nsec = 0;
+        uintmax_t           apparent   = 0;   // 直接包含的非目录条目（不含 linked）
+        uintmax_t           disk       = 0;
+        uint64_t            files      = 0;
+        std::vector<Linked> linked;           // 链接数大于 1 的文件
+        uint32_t            stored_day = 0;   // 扫描并写入的日期（自 1970 年起的天数）；取用不会更新
+    };
+
+    /// 记录在写入后的有效天数
+    static constexpr uint32_t kMaxAgeDays = 7;
+
+    /// 两次自动保存的最小间隔
+    static constexpr std::chrono::seconds kSaveInterval{30};
+
+    /// ~/.config/ftb/size-index
+    static std::string defaultPath();
+
+    /// 进程共享的索引：首次使用时从 defaultPath() 加载，进程退出时保存未写出的修改
+    static SizeIndex& instance();
+
+    explicit SizeIndex(std::string path);
+    /// 保存未写出的修改
+    ~SizeIndex();
+    SizeIndex(const SizeIndex&) = delete;
+    SizeIndex& operator=(const SizeIndex&) = delete;
+
+    /// 从文件加载（替换内存中的记录）；文件不存在或格式不符时返回 false，索引为空
+    bool load();
+
+    /// 写入临时文件后改名替换，中途被杀不会留下损坏的索引
+    bool save();
+
+    /// 有未写出的修改且距上次保存超过 kSaveInterval 时保存
+    void maybeSave();
+
+    /// (dev, ino) 的记录存在、mtime 一致且未过期时复制到 out 并返回 true
+    bool lookup(uint64_t dev, uint64_t ino, int64_t mtime_sec, uint32_t mtime_nsec, Record& out);
+
+    void store(uint64_t dev, uint64_t ino, Record record);
+
+    /// 移除 (dev, ino) 的记录，下次统计时重新扫描该目录
+    void forget(uint64_t dev, uint64_t ino);
+
+    /// 移除目录 dir（跟随符号链接）的记录；dir 无法 stat 时什么也不做
+    void forget(const std::string& dir);
+
+    size_t size() const;
+
+    /// 清空内存中的记录（下次保存时写出空索引）
+    void clear();
+
+private:
+    static constexpr size_t kShards = 64;
+
+    struct Key {
+        uint64_t dev;
+        uint64_t ino;
+        bool operator==(const Key& other) const { return dev == other.dev && ino == other.ino; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>((key.ino * 0x9E3779B97F4A7C15ull) ^ (key.dev >> 3) ^ (key.ino >> 29));
+        }
+    };
+    struct Shard {
+        mutable std::mutex                        mutex;
+        std::unordered_map<Key, Record, KeyHash> records;
+    };
+
+    Shard& shardOf(const Key& key) { return shards_[KeyHash()(key) % kShards]; }
+
+    std::string path_;
+    Shard       shards_[kShards];
+
+    std::mutex                            save_mutex_;
+    std::atomic<bool>                     dirty_{false};
+    std::chrono::steady_clock::time_point last_save_{};   // 受 save_mutex_ 保护
+};
+
+}  // namespace FTB
+
+#endif  // SIZE_INDEX_HPP
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "browser/FileManager.hpp"
 
@@ -15,6 +17,8 @@ enum class SortMode {
     TimeDesc,
     Type,
     Extension,
+    TreeSizeAsc,    // 目录按子树大小（后台统计）与文件混合排序
+    TreeSizeDesc,
 };
 
 SortMode SortModeFromString(const std::string& str);
@@ -22,6 +26,24 @@ std::string SortModeToString(SortMode mode);
 std::string SortModeDescription(SortMode mode);
 std::vector<SortMode> GetAllSortModes();
 
+// 排序是否依赖 stat 得到的元信息（大小/时间），名称优先加载阶段无法确定最终顺序
+bool SortModeUsesMetadata(SortMode mode);
+
+// 排序是否需要目录的子树大小（由 TreeSizeLoader 在后台统计后写入 EntryTable::setTreeSize）
+bool SortModeUsesTreeSize(SortMode mode);
+
+// 排序所需的最小信息，列式存储可直接构造而无需展开为 DirEntryInfo
+struct EntrySortKey {
+    std::string_view name;
+    bool             is_dir = false;
+    uint64_t         size = 0;    // 文件大小；目录为子树大小，仅在 TreeSize 排序中参与比较
+    int64_t          mtime = 0;   // 修改时间（秒）
+};
+
+// 排序模式下 a 是否应排在 b 之前（目录优先，TreeSize 排序除外；名称不区分大小写）
+bool CompareSortKeys(const EntrySortKey& a, const EntrySortKey& b, SortMode mode);
+bool CompareEntries(const FileManager::DirEntryInfo& a, const FileManager::DirEntryInfo& b, SortMode mode);
+
 void SortEntries(std::vector<FileManager::DirEntryInfo>& entries, SortMode mode);
 
 } // namespace FTB
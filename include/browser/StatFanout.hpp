@@ -0,0 +1,43 @@
+#ifndef STAT_FANOUT_HPP
+#define STAT_FANOUT_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace FTB {
+
+/**
+ * @class StatFanout
+ * @brief 将逐条目的 stat 工作分发到有界线程池，并按原顺序回报完成的批次
+ *
+ * 网络文件系统上单次 stat 的延迟远大于 CPU 开销，串行填充元信息会线性放大延迟。
+ * 这里把 [0, count) 切成固定大小的批次，由共享线程池与调用线程共同领取执行；
+ * 调用线程在批次按顺序连续完成时触发 on_ready，因此回调总是从前往后推进，
+ * 并且始终运行在调用线程上，调用方无需额外加锁。
+ */
+class StatFanout {
+public:
+    /// 每批条目数
+    static constexpr size_t kBatchSize = 256;
+
+    /// 少于该数量时直接在调用线程串行执行，避免线程调度开销
+    static constexpr size_t kParallelThreshold = 512;
+
+    using WorkFn  = std::function<void(size_t index)>;
+    using ReadyFn = std::function<void(size_t begin, size_t end)>;
+
+    /**
+     * @brief 并行执行 work(0..count-1)，阻塞直到全部完成
+     * @param count    条目总数
+     * @param work     处理单个条目，会在多个线程上并发调用，不同 index 之间不得共享可写状态
+     * @param on_ready 可选，[begin, end) 区间全部完成时在调用线程上按顺序回调
+     */
+    static void run(size_t count, const WorkFn& work, const ReadyFn& on_ready = {});
+
+    /// 线程池中的工作线程数
+    static size_t workerCount();
+};
+
+}  // namespace FTB
+
+#endif  // STAT_FANOUT_HPP
@@ -7,12 +7,14 @@
 #include <thread>
 #include <deque>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <atomic>
 #include <memory>
 #include <chrono>
 #include <map>
 #include <cstdint>
+#include "browser/BlockDevice.hpp"
 
 enum class TaskState { Pending, Running, Paused, Completed, Failed, Cancelled };
 enum class TaskType { Copy, Move, Delete, Extract, Rename, BulkRename };
@@ -41,10 +43,20 @@ struct TaskSnapshot {
     std::string current_target;
 };
 
+struct TaskGroup;
+
 struct TaskContext {
     Progress& progress;
     const std::atomic<bool>& cancel;
     const std::atomic<bool>& pause;
+    std::shared_ptr<TaskGroup> subtasks = nullptr;   // 由 TaskSystem 设置
+
+    // 派生子任务（如每个子目录一个），放入当前工作线程的本地队列，空闲工作线程可窃取执行。
+    // 子任务与父任务共享 progress / cancel / pause；不在 TaskSystem 中运行时直接同步执行。
+    void spawn(std::function<bool()> fn);
+
+    // 等待本任务派生的全部子任务，等待期间当前线程也执行子任务；全部成功返回 true
+    bool wait_subtasks();
 };
 
 using WorkFunction = std::function<bool(TaskContext& ctx)>;
@@ -57,6 +69,8 @@ struct TaskRequest {
     WorkFunction work;
     std::function<void()> cleanup = nullptr;
     TaskCallback callback = nullptr;
+    // 任务读写的路径（源与目标），用于按所在块设备限制并发；为空时不受设备限制
+    std::vector<std::string> io_paths;
 };
 
 class TaskSystem {
@@ -76,10 +90,21 @@ public:
     void set_speed_limit(uintmax_t bytes_per_sec);
     uintmax_t get_speed_limit() const;
 
+    // 排队任务每等待一个间隔，有效优先级提升一级（Low 等待两个间隔后与新提交的 High 同级）
+    void set_aging_interval(std::chrono::milliseconds interval);
+
+    // 同一块设备上同时运行的任务数上限，0 表示只受工作线程数限制。
+    // 机械硬盘与可移动设备默认 1（避免寻道抖动），SSD / NVMe 与无法识别的设备默认不限
+    void set_device_concurrency(size_t rotational, size_t solid_state);
+    // 为单个设备（st_dev）指定上限，覆盖按类型的默认值；n 为 0 时取消覆盖
+    void set_device_limit(uint64_t dev, size_t n);
+
     void start();
     void stop();
 
 private:
+    friend struct TaskContext;
+
     TaskSystem() = default;
     ~TaskSystem();
     TaskSystem(const TaskSystem&) = delete;
@@ -93,39 +118,106 @@ private:
         std::shared_ptr<std::atomic<bool>> cancel;
         std::shared_ptr<std::atomic<bool>> pause;
         std::chrono::steady_clock::time_point start_time;
+        // get_snapshot 计算近期速度用的采样点
+        mutable std::chrono::steady_clock::time_point speed_sample_time;
+        mutable uintmax_t speed_sample_bytes = 0;
+        mutable double speed = -1.0;
     };
 
     struct QueuedEntry {
         std::string task_id;
         std::shared_ptr<TaskRequest> request;
+        std::chrono::steady_clock::time_point enqueue_time;
+        std::vector<uint64_t> devices;   // 去重后的 st_dev，运行期间各占一个名额
+    };
+
+    struct DeviceSlot {
+        FTB::BlockDevice::Kind kind = FTB::BlockDevice::Kind::Unknown;
+        size_t running = 0;
+        size_t limit_override = 0;
+        bool probed = false;
+    };
+
+    // 子任务：属于某个 TaskGroup，完成后递减其计数
+    struct Job {
+        std::function<bool()> fn;
+        std::shared_ptr<TaskGroup> group;
+    };
+
+    // 每个工作线程一个双端队列：本线程从尾部取（后进先出，缓存友好），
+    // 其他线程从头部窃取（先进先出，窃取到的通常是较大的子树）
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
     };
 
-    void worker_loop();
-    std::shared_ptr<QueuedEntry> pop_next();
+    void worker_loop(size_t index);
+    void run_task(QueuedEntry& entry);
+    bool pop_next(QueuedEntry& out);
+    bool devices_available(const QueuedEntry& entry) const;
+    size_t device_limit(const DeviceSlot& slot) const;
+    void release_devices(const std::vector<uint64_t>& devices);
+    void push_job(Job job);
+    bool take_job(Job& out);
+    void run_job(Job& job);
+    void notify_work();
+    void notify_all_work();
     void store_history(const std::string& task_id, const std::string& title,
                        TaskType type, TaskState state, Progress& progress,
                        std::chrono::steady_clock::time_point start) const;
     void remove_running(const std::string& task_id);
+    void set_state(const std::string& task_id, TaskState state);
 
     std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+
+    // 新提交的任务：按优先级分三个队列，取出时按等待时间提升有效优先级
+    mutable std::mutex inject_mutex_;
     std::deque<QueuedEntry> high_queue_;
     std::deque<QueuedEntry> normal_queue_;
     std::deque<QueuedEntry> low_queue_;
-
+    std::atomic<size_t> queued_count_{0};
+    std::chrono::milliseconds aging_interval_{AGING_INTERVAL_MS};
+    // 各设备的运行计数与上限，同样由 inject_mutex_ 保护
+    std::map<uint64_t, DeviceSlot> devices_;
+    size_t rotational_limit_{1};
+    size_t solid_state_limit_{0};
+
+    // 任务状态表：写入只在提交、状态切换与结束时发生，快照只取共享锁
+    mutable std::shared_mutex tasks_mutex_;
     std::map<std::string, RunningTask> running_tasks_;
+    mutable std::mutex speed_mutex_;   // 共享锁下更新速度采样点
+
+    // 空闲工作线程在此休眠；work_epoch_ 每次有新工作时递增，避免漏掉唤醒
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::atomic<uint64_t> work_epoch_{0};
+
+    // 开始前被暂停的任务在此等待恢复或取消
+    std::mutex pause_mutex_;
+    std::condition_variable pause_cv_;
 
-    mutable std::mutex queue_mutex_;
-    std::condition_variable cv_;
     std::atomic<bool> running_{false};
     std::atomic<bool> should_stop_{false};
 
     size_t max_workers_{4};
     std::atomic<uintmax_t> speed_limit_{0};
     std::atomic<uint64_t> next_id_{1};
+    std::atomic<size_t> next_queue_{0};   // 非工作线程派生子任务时轮流放入各队列
 
     mutable std::mutex history_mutex_;
     mutable std::deque<TaskSnapshot> recent_history_;
     static constexpr size_t MAX_HISTORY = 50;
+    static constexpr int64_t AGING_INTERVAL_MS = 5000;
+    // current_speed 的采样窗口：限速或暂停后显示实际速率，而不是自开始以来的平均值
+    static constexpr double SPEED_WINDOW_SECONDS = 1.0;
+};
+
+// 一个任务派生的子任务集合
+struct TaskGroup {
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> failed{false};
+    bool scheduled = false;   // 由 TaskSystem 创建时子任务进入工作队列，否则同步执行
 };
 
 #endif
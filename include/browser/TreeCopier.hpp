@@ -0,0 +1,75 @@
+#ifndef TREE_COPIER_HPP
+#define TREE_COPIER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "browser/TaskSystem.hpp"
+
+namespace FTB {
+
+class CopyJournal;
+class SizeIndex;
+
+/**
+ * @class TreeCopier
+ * @brief 目录树的流水线复制：一个遍历线程 + 有界队列 + N 个复制线程
+ *
+ * 大量小文件时耗时主要在逐个文件的 open / create / close 上，串行复制无法填满设备队列。
+ * 调用线程用 DirScanner 遍历源目录树，先在目标处创建目录、再把该目录下的文件放入有界队列，
+ * 复制线程并发领取并交给 FileCopier；目录总是先于其中的文件创建，复制线程无需检查父目录。
+ *
+ * 进度语义与串行复制一致：每个目录与文件完成后 files_processed 加一，
+ * 字节按块累加到 bytes_processed；暂停时所有线程在块边界等待，取消或任一文件失败时尽快停止。
+ * current_file 只由遍历线程更新。
+ *
+ * io_uring 可用时（见 IoRing），复制线程每次领取至多 kRingBatch 个文件，
+ * 其中不超过 kBatchFileSize 的小文件按阶段批量提交 statx / open / read / write / close，
+ * 一个线程即可保持数十个请求在途；其余文件仍交给 FileCopier。
+ *
+ * 指定 journal 时每个完成的文件记入日志，大文件定期记录偏移；日志中已完成的文件跳过
+ * （大小计入进度），有偏移记录的文件从该偏移继续。
+ */
+class TreeCopier {
+public:
+    struct Options {
+        size_t workers = 0;            // 复制线程数，0 表示按 CPU 数自动选择
+        size_t queue_capacity = 4096;  // 队列中待复制的文件数上限
+        bool   use_io_uring = true;    // 可用时经 IoRing 批量复制小文件
+        CopyJournal* journal = nullptr;  // 可恢复任务的进度日志
+        SizeIndex*   index = nullptr;    // 结束后移除写入过的目标目录的记录（覆盖文件不改变目录 mtime）
+    };
+
+    /// 复制线程每次领取的文件数（io_uring 模式）
+    static constexpr size_t kRingBatch = 32;
+
+    /// 走批量路径的文件大小上限：整个文件一次读入内存
+    static constexpr uintmax_t kBatchFileSize = 64u << 10;
+
+    /// 自动选择时的复制线程数
+    static size_t defaultWorkers();
+
+    /**
+     * @brief 复制目录树 src 到 dst（dst 不存在时创建，已存在时合并）
+     * 指向目录的符号链接在目标处创建为空目录，指向文件的符号链接复制其内容（与原串行实现一致）
+     * @return 全部成功返回 true；取消或出错返回 false
+     */
+    static bool copy(const std::string& src, const std::string& dst,
+                     Progress& progress,
+                     const std::atomic<bool>& cancel,
+                     const std::atomic<bool>& pause,
+                     const Options& options);
+
+    static bool copy(const std::string& src, const std::string& dst,
+                     Progress& progress,
+                     const std::atomic<bool>& cancel,
+                     const std::atomic<bool>& pause) {
+        return copy(src, dst, progress, cancel, pause, Options());
+    }
+};
+
+}  // namespace FTB
+
+#endif  // TREE_COPIER_HPP
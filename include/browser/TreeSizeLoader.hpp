@@ -0,0 +1,72 @@
+#ifndef TREE_SIZE_LOADER_HPP
+#define TREE_SIZE_LOADER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace FTB {
+
+class SizeIndex;
+
+/**
+ * @class TreeSizeLoader
+ * @brief 在后台线程中逐个统计目录下各子目录的子树大小，供 UI 线程分批取用
+ *
+ * 按给定顺序对每个子目录调用 DiskUsage::measure（使用 SizeIndex，重复进入同一目录很快；
+ * rescan 时不取用索引记录，全部重新扫描并覆盖），
+ * 每统计完一个就发布一条结果，界面据此把该目录移到按大小应处的位置，而不必等全部完成。
+ * 大小为逻辑大小，与文件列表中文件的大小同一口径。
+ * 构造即开始，enqueue() 可在统计期间或结束后追加子目录（如条目表重新加载后出现的新目录）；
+ * 析构或 cancel() 即放弃（后台线程自行退出，不阻塞调用方）。
+ * 每当有新结果发布且上一次通知尚未被 take() 消费时，调用一次 notify。
+ */
+class TreeSizeLoader {
+public:
+    struct Result {
+        std::string name;
+        uint64_t    size = 0;
+    };
+
+    /**
+     * @param path   父目录
+     * @param names  要统计的子目录名（不跟随符号链接的目录）
+     * @param notify 有新结果可取时的通知回调，在后台线程调用
+     * @param rescan 用户要求重新统计：不取用 SizeIndex 中的记录
+     * @param index  大小索引，为空时使用 SizeIndex::instance()
+     */
+    TreeSizeLoader(std::string path, std::vector<std::string> names, std::function<void()> notify,
+                   bool rescan = false, SizeIndex* index = nullptr);
+    ~TreeSizeLoader();
+
+    TreeSizeLoader(const TreeSizeLoader&) = delete;
+    TreeSizeLoader& operator=(const TreeSizeLoader&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    /// 追加要统计的子目录；已排队过的名称忽略，后台线程已结束时重新启动
+    void enqueue(std::vector<std::string> names);
+
+    /// 所有已排队的子目录是否都已统计（不代表已被 take() 取走）
+    bool finished() const;
+
+    /// 取走自上次 take() 以来完成的结果（UI 线程调用）
+    std::vector<Result> take();
+
+    /// 放弃统计
+    void cancel();
+
+private:
+    struct State;
+
+    static void run(std::shared_ptr<State> state);
+
+    std::string            path_;
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace FTB
+
+#endif  // TREE_SIZE_LOADER_HPP
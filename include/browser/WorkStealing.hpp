@@ -0,0 +1,135 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FTB {
+
+/// 目录遍历的默认线程数：受 I/O 延迟而非 CPU 限制，至少 4 个线程，最多 16 个
+inline size_t defaultWalkThreads() {
+    return std::clamp<size_t>(std::thread::hardware_concurrency(), 4, 16);
+}
+
+/**
+ * @class WorkStealingQueues
+ * @brief 目录遍历用的每线程任务队列：自己从队尾取，空闲时从其他线程的队首窃取
+ *
+ * 自己从队尾取是深度优先，待处理的路径保持较少；从队首窃取得到靠近根的目录，
+ * 通常是较大的子树，目录树不均衡时各线程仍保持忙碌。
+ * 处理一个任务时产生的新任务用 push 放入自己的队列，处理完调用 done()；
+ * 所有任务处理完毕（或取消）后 next() 在所有线程上返回 false。
+ */
+template <typename Job>
+class WorkStealingQueues {
+public:
+    explicit WorkStealingQueues(size_t workers, const std::atomic<bool>* cancel = nullptr)
+        : cancel_(cancel) {
+        for (size_t i = 0; i < workers; ++i) queues_.push_back(std::make_unique<Queue>());
+    }
+
+    size_t workers() const { return queues_.size(); }
+
+    /// 已入队或正在处理的任务数
+    size_t pending() const { return pending_.load(std::memory_order_acquire); }
+
+    bool cancelled() const { return cancel_ && cancel_->load(std::memory_order_relaxed); }
+
+    void push(size_t self, Job job) {
+        pending_.fetch_add(1, std::memory_order_acq_rel);
+        {
+            std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+            queues_[self]->jobs.push_back(std::move(job));
+        }
+        announce();
+    }
+
+    /// 移入 jobs 中的全部任务并清空 jobs
+    void push(size_t self, std::vector<Job>& jobs) {
+        if (jobs.empty()) return;
+        pending_.fetch_add(jobs.size(), std::memory_order_acq_rel);
+        {
+            std::lock_guard<std::mutex> lock(queues_[self]->mutex);
+            for (auto& job : jobs) queues_[self]->jobs.push_back(std::move(job));
+        }
+        jobs.clear();
+        announce();
+    }
+
+    /// 取下一个任务；没有可取的任务时等待，全部完成或取消后返回 false
+    bool next(size_t self, Job& job) {
+        for (;;) {
+            if (cancelled()) return false;
+            uint64_t seen = epoch_.load(std::memory_order_acquire);
+            if (popOwn(self, job) || steal(self, job)) return true;
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            if (pending_.load(std::memory_order_acquire) == 0) return false;
+            idle_cv_.wait_for(lock, kIdleWait, [&] {
+                return epoch_.load(std::memory_order_relaxed) != seen || pending_.load(std::memory_order_acquire) == 0;
+            });
+        }
+    }
+
+    /// 由 next() 取得的任务处理完毕
+    void done() {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) announce();
+    }
+
+private:
+    // 空闲线程等待新任务的最长时间，兜底错过的唤醒
+    static constexpr std::chrono::milliseconds kIdleWait{2};
+
+    struct Queue {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    bool popOwn(size_t self, Job& job) {
+        Queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.jobs.empty()) return false;
+        job = std::move(q.jobs.back());
+        q.jobs.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, Job& job) {
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            Queue& victim = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.jobs.empty()) continue;
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void announce() {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+        idle_cv_.notify_all();
+    }
+
+    const std::atomic<bool>*            cancel_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::atomic<size_t>                 pending_{0};
+    std::mutex                          idle_mutex_;
+    std::condition_variable             idle_cv_;
+    std::atomic<uint64_t>               epoch_{0};   // 每有新任务入队或全部完成时递增
+};
+
+}  // namespace FTB
+
+#endif  // WORK_STEALING_HPP
@@ -73,6 +73,7 @@ public:
         Tasks,
         BatchRename,
         Extract,
+        RescanSizes,
         QuitWithCwd,
         PluginCommand,
         ShellCommand,
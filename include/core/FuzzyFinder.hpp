@@ -1,25 +1,44 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
 struct FdResult {
     std::string path;
     bool is_dir = false;
+    int score = 0;   // FuzzyPattern::score，越高越好
 };
 
-bool FuzzyMatch(const std::string& query, const std::string& str);
+/// query 是否为 str 的子序列（大小写不敏感）
+bool FuzzyMatch(std::string_view query, std::string_view str);
 
 class SearchEngine {
 public:
-    static bool HasExternal();
+    /// 一批匹配结果；在遍历线程上调用，可能并发
+    using ResultSink = std::function<void(std::vector<FdResult>&& batch)>;
+
+    /// 当前得分最高的结果（已排序）与目前为止的匹配总数；调用是串行的，后一次覆盖前一次
+    using RankSink = std::function<void(std::vector<FdResult>&& top, size_t matched)>;
+
+    /// 搜索 basePath 下相对路径模糊匹配 query 的文件，返回按得分排序的全部结果
     static std::vector<FdResult> Search(const std::string& query,
                                         const std::string& basePath);
 
-private:
-    static std::vector<FdResult> ExternalSearch(const std::string& query,
-                                                 const std::string& basePath);
-    static std::vector<FdResult> BuiltinSearch(const std::string& query,
-                                                const std::string& basePath);
+    /// 同 Search，但不排序，边遍历边把结果分批交给 sink：首个结果立即交出；cancel 置位后尽快返回
+    static void Stream(const std::string& query,
+                       const std::string& basePath,
+                       const ResultSink& sink,
+                       const std::atomic<bool>* cancel = nullptr);
+
+    /// 边遍历边维护得分最高的 limit 个结果，只有进入前 limit 的路径才会被复制。
+    /// 首个结果立即交出，之后名次有变化时定期交出快照；遍历结束时交出最终结果
+    static void Rank(const std::string& query,
+                     const std::string& basePath,
+                     size_t limit,
+                     const RankSink& sink,
+                     const std::atomic<bool>* cancel = nullptr);
 };
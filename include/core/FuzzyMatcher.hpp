@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class FuzzyPattern
+ * @brief 模糊查找的打分匹配（fzf 风格），大小写不敏感
+ *
+ * 先用 SIMD 按序查找查询的每个字符（SSE2 比较 + movemask 位掩码，每次检查 16 字节），
+ * 不是子序列的候选在这一步就被排除，不进入打分。
+ * 通过预筛的候选在 [首个字符的最早位置, 末字符的最后位置] 窗口内做动态规划，
+ * 取得分最高的对齐：匹配的字符得分，间隔扣分，位于单词边界、路径分隔符之后、
+ * camelCase 大写或数字开头处的字符有额外加分，连续匹配沿用首字符的加分。
+ */
+class FuzzyPattern {
+public:
+    static constexpr int kNoMatch = -1;
+
+    static constexpr int kScoreMatch = 16;
+    static constexpr int kScoreGapStart = -3;
+    static constexpr int kScoreGapExtension = -1;
+    static constexpr int kBonusBoundary = kScoreMatch / 2;                         // 非单词字符之后
+    static constexpr int kBonusBoundaryWhite = kBonusBoundary + 2;                 // 空白之后
+    static constexpr int kBonusBoundaryDelimiter = kBonusBoundary + 1;             // '/' 等分隔符之后
+    static constexpr int kBonusNonWord = kScoreMatch / 2;                          // 非单词字符本身
+    static constexpr int kBonusCamel123 = kBonusBoundary + kScoreGapExtension;     // aB、a1
+    static constexpr int kBonusConsecutive = -(kScoreGapStart + kScoreGapExtension);
+    static constexpr int kBonusFirstCharMultiplier = 2;
+
+    explicit FuzzyPattern(std::string_view query);
+
+    bool empty() const { return query_.empty(); }
+    const std::string& query() const { return query_; }   // 已转为小写
+
+    /// 只做预筛：query 是否为 text 的子序列
+    bool matches(std::string_view text) const;
+
+    /// 得分越高越好；不匹配返回 kNoMatch，空查询返回 0
+    int score(std::string_view text) const;
+
+    /// 与 matches 相同，但不需要预先构造 FuzzyPattern（query 按字符即时转小写）
+    static bool isSubsequence(std::string_view query, std::string_view text);
+
+private:
+    std::string query_;
+};
+
+/**
+ * @class FuzzyTopK
+ * @brief 只保留得分最高的 K 个候选的小顶堆
+ *
+ * 得分相同时较短的路径优先，再按字典序，保证顺序确定。
+ * 不如堆顶的候选在比较时即被拒绝，不复制字符串；只有进入前 K 的候选才会被保存。
+ * 非线程安全。
+ */
+class FuzzyTopK {
+public:
+    struct Item {
+        int         score = FuzzyPattern::kNoMatch;
+        std::string text;
+    };
+
+    explicit FuzzyTopK(size_t capacity) : capacity_(capacity) {}
+
+    /// 返回候选是否进入了前 K
+    bool offer(int score, std::string_view text);
+
+    /// 堆满时，得分低于此值的候选一定会被拒绝；未满时为 kNoMatch
+    int threshold() const { return full() ? heap_.front().score : FuzzyPattern::kNoMatch; }
+
+    size_t size() const { return heap_.size(); }
+    size_t capacity() const { return capacity_; }
+    bool full() const { return capacity_ > 0 && heap_.size() >= capacity_; }
+
+    /// 按名次排序的副本
+    std::vector<Item> sorted() const;
+
+    /// a 的名次是否排在 b 之前
+    static bool better(int a_score, std::string_view a, int b_score, std::string_view b);
+
+private:
+    size_t            capacity_;
+    std::vector<Item> heap_;   // 堆顶为当前名次最低的候选
+};
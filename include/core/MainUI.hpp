@@ -8,11 +8,14 @@
 #include <atomic>
 #include <functional>
 #include <filesystem>
+#include <unordered_map>
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/component/event.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include "browser/FileManager.hpp"
 #include "browser/DirectoryHistory.hpp"
+#include "browser/DirectoryLoader.hpp"
+#include "browser/TreeSizeLoader.hpp"
 #include "browser/ClipboardManager.hpp"
 #include "config/KeyBindings.hpp"
 #include "core/TabManager.hpp"
@@ -180,9 +183,21 @@ struct MainState {
     std::string cached_parent_display;
     std::string cached_canonical_path;
     int cached_parent_selected = -1;
-    std::vector<FileManager::DirEntryInfo> cached_parent_entries;
-    std::vector<FileManager::DirEntryInfo> cached_current_entries;
+    EntryTable cached_parent_entries;
+    EntryTable cached_current_entries;
     std::filesystem::file_time_type cached_dir_mtime;
+    std::string loaded_entries_path;                              // cached_current_entries 实际对应的目录
+    std::unordered_map<std::string, size_t> cached_entry_index;   // 名称 → cached_current_entries 下标
+
+    // 流式目录加载
+    std::shared_ptr<DirectoryLoader> dir_loader;
+    std::string pending_select_name;   // 批次合并后需要恢复选中的条目名
+
+    // 按子树大小排序（SortMode::TreeSize*）
+    std::shared_ptr<TreeSizeLoader> tree_size_loader;
+    std::unordered_map<std::string, uint64_t> tree_sizes;   // 当前目录下已统计的子目录 → 大小
+    bool tree_sizes_applied = false;                         // tree_sizes 是否已写入 cached_current_entries
+    bool tree_size_rescan = false;                           // 下一次统计不取用大小索引（rescan 命令）
 
     // 文件大小
     std::string selected_size;
@@ -266,6 +281,7 @@ struct MainState {
 
 // ---- 获取条目颜色 ----
 ftxui::Color GetEntryColor(const FileManager::DirEntryInfo& info);
+ftxui::Color GetEntryColor(const EntryTable& entries, size_t pos);
 
 // ---- 构建面板 Modal ----
 ftxui::Element BuildPanelModal(MainState& state);
@@ -282,6 +298,9 @@ bool HandleNavigationEvent(MainState& state, const ftxui::Event& event);
 // ---- 刷新目录内容 ----
 void RefreshDirectoryContents(MainState& state);
 
+// ---- 本地文件操作后从已修补的缓存同步当前列表，可选地选中指定条目 ----
+void SyncCurrentEntries(MainState& state, const std::string& select_name = std::string());
+
 // ---- 更新路径缓存 ----
 void UpdatePathCache(MainState& state);
 
@@ -5,6 +5,7 @@
 #include <memory>
 #include "browser/DirectoryHistory.hpp"
 #include "browser/SortMode.hpp"
+#include "browser/EntryTable.hpp"
 #include "browser/FileManager.hpp"
 
 namespace FTB {
@@ -59,8 +60,8 @@ struct Tab {
     std::string cached_parent_display;
     std::string cached_canonical_path;
     int cached_parent_selected = -1;
-    std::vector<FileManager::DirEntryInfo> cached_parent_entries;
-    std::vector<FileManager::DirEntryInfo> cached_current_entries;
+    EntryTable cached_parent_entries;
+    EntryTable cached_current_entries;
 
     TabClipboard clipboard;
 
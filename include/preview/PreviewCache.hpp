@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -9,6 +10,7 @@
 #include <ftxui/dom/elements.hpp>
 
 #include "editor/SyntaxHighlighter.hpp"
+#include "browser/EntryTable.hpp"
 #include "browser/FileManager.hpp"
 #include "preview/ArchivePreview.hpp"
 
@@ -29,7 +31,7 @@ struct PreviewData {
     uintmax_t file_size = 0;
     std::string mod_time;
     std::string icon;
-    std::vector<FileManager::DirEntryInfo> dir_contents;
+    std::shared_ptr<const EntryTable> dir_contents;  // 与 lru_entry_cache 共享的快照
     std::string text_preview;
     std::vector<ArchiveEntry> archive_contents;
     bool dir_loaded = false;
@@ -51,7 +53,7 @@ public:
     PreviewData Copy();
     void Invalidate();
 
-    void Update(const std::vector<FileManager::DirEntryInfo>& entries,
+    void Update(const EntryTable& entries,
                 int selected, const std::string& currentPath);
     void EnsureDirLoaded(const std::string& dirPath);
     void EnsureTextLoaded(const std::string& filePath, uintmax_t fileSize);
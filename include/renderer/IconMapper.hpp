@@ -30,6 +30,15 @@ std::string GetFileIcon(const std::filesystem::path& path);
  */
 std::string GetIconForPath(const std::filesystem::path& path, bool is_directory);
 
+/**
+ * @brief 根据已知的条目信息返回图标，不再访问文件系统。
+ * @param name 条目名称。
+ * @param is_directory 是否为文件夹。
+ * @param is_executable 是否带有可执行权限位（调用方已通过 stat 获得）。
+ * @return Nerd Font 图标。
+ */
+std::string GetIconForEntry(const std::string& name, bool is_directory, bool is_executable);
+
 #else
 
 // No-icon fallback: use ASCII markers
@@ -50,6 +59,11 @@ inline std::string GetIconForPath(const std::filesystem::path& path, bool is_dir
     return is_directory ? GetFolderIcon(path) : GetFileIcon(path);
 }
 
+inline std::string GetIconForEntry(const std::string&, bool is_directory, bool is_executable) {
+    if (is_directory) return "[D] ";
+    return is_executable ? "[X] " : "    ";
+}
+
 #endif
 
 /// Check if icons are enabled at compile time
@@ -27,7 +27,7 @@ inline ftxui::Decorator GetPanelBorder() {
     return ftxui::borderStyled(ftxui::ROUNDED, border_color);
 }
 
-ftxui::Element CreateDetailElement(const std::vector<FileManager::DirEntryInfo>& entries,
+ftxui::Element CreateDetailElement(const EntryTable& entries,
                                    int selected,
                                    const std::string& currentPath,
                                    int scroll_y = 0,
@@ -1,6 +1,14 @@
 #pragma once
 #include <filesystem>
 #include <system_error>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 namespace fs = std::filesystem;
 
@@ -29,4 +37,24 @@ inline bool renameWithFallback(const fs::path& from, const fs::path& to) {
     return false;
 }
 
+/**
+ * 同一文件系统内原子地改名，不复制数据
+ * replace 为 false 时目标已存在返回 EEXIST 而不覆盖（renameat2 RENAME_NOREPLACE；
+ * 内核或文件系统不支持时退化为先检查再改名）
+ * @return 0 表示成功，否则为 errno；EXDEV 表示跨文件系统，需要复制后删除
+ */
+inline int renameNoReplace(const fs::path& from, const fs::path& to, bool replace = false) {
+    if (replace) return ::rename(from.c_str(), to.c_str()) == 0 ? 0 : errno;
+#if defined(__linux__) && defined(SYS_renameat2)
+    constexpr unsigned kRenameNoReplace = 1u << 0;
+    if (::syscall(SYS_renameat2, AT_FDCWD, from.c_str(), AT_FDCWD, to.c_str(), kRenameNoReplace) == 0) {
+        return 0;
+    }
+    if (errno != ENOSYS && errno != EINVAL) return errno;
+#endif
+    struct stat st;
+    if (::lstat(to.c_str(), &st) == 0) return EEXIST;
+    return ::rename(from.c_str(), to.c_str()) == 0 ? 0 : errno;
+}
+
 } // namespace FTB
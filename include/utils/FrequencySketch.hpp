@@ -0,0 +1,146 @@
+#ifndef FREQUENCY_SKETCH_HPP
+#define FREQUENCY_SKETCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace FTB {
+
+/**
+ * @brief 访问频率的近似计数（TinyLFU 使用的 count-min sketch + doorkeeper）
+ *
+ * 每个键映射到 4 个 4 位计数器，估计值取其最小值，上限 15。
+ * 首次出现的键只记入 doorkeeper（布隆过滤器），第二次起才进入计数器，
+ * 只出现一次的键（扫描）因此不会占用计数器。累计记录次数达到样本量后，
+ * 所有计数器减半并清空 doorkeeper，使频率随时间衰减。
+ *
+ * 计数器为原子字，可在读锁下并发记录；减半时与并发记录竞争丢失的计数可以忽略。
+ */
+class FrequencySketch {
+public:
+    /**
+     * @param capacity 预计同时跟踪的键数量（通常为缓存容量）
+     */
+    explicit FrequencySketch(size_t capacity) {
+        size_t words = 8;
+        while (words < capacity) words <<= 1;
+        table_mask_ = words - 1;
+        table_ = std::make_unique<std::atomic<uint64_t>[]>(words);
+        // doorkeeper 每个键约 8 位
+        size_t door_words = 1;
+        while (door_words * 64 < capacity * 8) door_words <<= 1;
+        door_mask_ = door_words * 64 - 1;
+        door_words_ = door_words;
+        doorkeeper_ = std::make_unique<std::atomic<uint64_t>[]>(door_words);
+        sample_size_ = capacity < 8 ? 80 : capacity * 10;
+    }
+
+    /**
+     * @brief 记录一次访问
+     * @param hash 键的哈希值
+     */
+    void increment(uint64_t hash) {
+        hash = spread(hash);
+        if (!admitDoorkeeper(hash)) return;
+
+        bool added = false;
+        for (int i = 0; i < 4; ++i) {
+            added |= incrementAt(counterIndex(hash, i));
+        }
+        if (added && additions_.fetch_add(1, std::memory_order_relaxed) + 1 >= sample_size_) {
+            reset();
+        }
+    }
+
+    /**
+     * @brief 估计访问频率（0-16）
+     * @param hash 键的哈希值
+     */
+    uint32_t estimate(uint64_t hash) const {
+        hash = spread(hash);
+        uint32_t freq = 15;
+        for (int i = 0; i < 4; ++i) {
+            uint64_t idx = counterIndex(hash, i);
+            uint64_t word = table_[idx >> 4].load(std::memory_order_relaxed);
+            freq = std::min<uint32_t>(freq, static_cast<uint32_t>((word >> ((idx & 15) * 4)) & 0xF));
+        }
+        return freq + (inDoorkeeper(hash) ? 1 : 0);
+    }
+
+private:
+    static uint64_t spread(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // 第 i 个计数器的位置：高位为字下标，低 4 位为字内的计数器序号
+    uint64_t counterIndex(uint64_t hash, int i) const {
+        static constexpr uint64_t kSeeds[4] = {
+            0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull,
+            0x9ae16a3b2f90404full, 0xcbf29ce484222325ull};
+        uint64_t h = (hash + kSeeds[i]) * kSeeds[i];
+        h += h >> 32;
+        uint64_t word = h & table_mask_;
+        return (word << 4) | ((hash >> (i * 4)) & 15);
+    }
+
+    bool incrementAt(uint64_t idx) {
+        auto& slot = table_[idx >> 4];
+        unsigned shift = static_cast<unsigned>(idx & 15) * 4;
+        uint64_t word = slot.load(std::memory_order_relaxed);
+        for (;;) {
+            if (((word >> shift) & 0xF) == 0xF) return false;
+            if (slot.compare_exchange_weak(word, word + (uint64_t(1) << shift),
+                                           std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // 键已在 doorkeeper 中返回 true；否则加入并返回 false
+    bool admitDoorkeeper(uint64_t hash) {
+        uint64_t a = hash & door_mask_;
+        uint64_t b = (hash >> 32) & door_mask_;
+        uint64_t had_a = doorkeeper_[a >> 6].fetch_or(uint64_t(1) << (a & 63), std::memory_order_relaxed);
+        uint64_t had_b = doorkeeper_[b >> 6].fetch_or(uint64_t(1) << (b & 63), std::memory_order_relaxed);
+        return (had_a & (uint64_t(1) << (a & 63))) && (had_b & (uint64_t(1) << (b & 63)));
+    }
+
+    bool inDoorkeeper(uint64_t hash) const {
+        uint64_t a = hash & door_mask_;
+        uint64_t b = (hash >> 32) & door_mask_;
+        return (doorkeeper_[a >> 6].load(std::memory_order_relaxed) & (uint64_t(1) << (a & 63))) &&
+               (doorkeeper_[b >> 6].load(std::memory_order_relaxed) & (uint64_t(1) << (b & 63)));
+    }
+
+    // 所有计数器减半，清空 doorkeeper
+    void reset() {
+        for (size_t i = 0; i <= table_mask_; ++i) {
+            uint64_t word = table_[i].load(std::memory_order_relaxed);
+            table_[i].store((word >> 1) & 0x7777777777777777ull, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < door_words_; ++i) {
+            doorkeeper_[i].store(0, std::memory_order_relaxed);
+        }
+        additions_.store(0, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> table_;
+    uint64_t                                 table_mask_ = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> doorkeeper_;
+    uint64_t                                 door_mask_ = 0;
+    size_t                                   door_words_ = 0;
+    size_t                                   sample_size_ = 0;
+    std::atomic<size_t>                      additions_{0};
+};
+
+} // namespace FTB
+
+#endif // FREQUENCY_SKETCH_HPP
@@ -1,72 +1,216 @@
 #ifndef LRU_CACHE_HPP
 #define LRU_CACHE_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <unordered_map>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <optional>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "utils/FrequencySketch.hpp"
 
 namespace FTB {
 
 /**
- * @brief LRU缓存模板类，支持TTL和持久化
+ * @brief 估算缓存值占用的字节数，用于按字节预算驱逐
+ *
+ * 默认取 sizeof；提供 memoryUsage()（堆内存字节数）的类型自动计入堆内存。
+ * 其他类型可特化此模板。
+ */
+template<typename T, typename = void>
+struct CacheSizeOf {
+    size_t operator()(const T&) const { return sizeof(T); }
+};
+
+template<typename T>
+struct CacheSizeOf<T, std::void_t<decltype(std::declval<const T&>().memoryUsage())>> {
+    size_t operator()(const T& value) const { return sizeof(T) + value.memoryUsage(); }
+};
+
+template<>
+struct CacheSizeOf<std::string> {
+    size_t operator()(const std::string& value) const { return sizeof(value) + value.capacity(); }
+};
+
+template<typename T, typename Alloc>
+struct CacheSizeOf<std::vector<T, Alloc>> {
+    size_t operator()(const std::vector<T, Alloc>& value) const {
+        size_t bytes = sizeof(value) + (value.capacity() - value.size()) * sizeof(T);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            bytes += value.size() * sizeof(T);
+        } else {
+            for (const auto& item : value) bytes += CacheSizeOf<T>()(item);
+        }
+        return bytes;
+    }
+};
+
+template<typename T>
+struct CacheSizeOf<std::shared_ptr<T>> {
+    size_t operator()(const std::shared_ptr<T>& value) const {
+        return sizeof(value) + (value ? CacheSizeOf<std::remove_const_t<T>>()(*value) : 0);
+    }
+};
+
+/**
+ * @brief 单个分片的统计信息
+ */
+struct CacheShardStats {
+    size_t size = 0;
+    size_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t rejections = 0;                // 准入过滤拒绝的新项（也计入 evictions）
+};
+
+/**
+ * @brief 缓存统计信息（各分片汇总）
+ */
+struct CacheStats {
+    size_t size = 0;
+    size_t max_size = 0;
+    size_t bytes = 0;
+    size_t max_bytes = 0;                 // 0 表示不限字节
+    size_t expired_count = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;                 // 因容量/字节预算被挤出的项
+    size_t rejections = 0;                // 准入过滤拒绝的新项（也计入 evictions）
+    double hit_ratio = 0.0;
+    std::chrono::system_clock::time_point last_cleanup;
+    std::vector<CacheShardStats> shards;
+};
+
+/**
+ * @brief 分片的LRU缓存模板类，支持TTL、字节预算和持久化
+ *
+ * 键按哈希分布到若干分片，每个分片有独立的读写锁，互不争用。
+ * 近似 LRU 采用时钟（second-chance）算法：命中只在共享锁下原子地置位访问标记，
+ * 驱逐时指针扫过环，跳过并清除带标记的项，挤出第一个未被访问过的项。
+ * 容量同时受条目数和字节数（由 SizeOf 估算）限制，预算平均分给各分片。
+ *
+ * 启用准入过滤（W-TinyLFU）后，每个分片划出约 1% 容量的窗口区接收新项，
+ * 窗口溢出的项须与主区的驱逐候选比较访问频率（FrequencySketch 估计），
+ * 频率更高者留下。只访问一次的扫描因此无法挤掉反复访问的工作集。
  * @tparam Key 键类型
  * @tparam Value 值类型
  * @tparam Hash 哈希函数类型
+ * @tparam SizeOf 值大小估算函数类型
  */
-template<typename Key, typename Value, typename Hash = std::hash<Key>>
+template<typename Key, typename Value, typename Hash = std::hash<Key>,
+         typename SizeOf = CacheSizeOf<Value>>
 class LRUCache {
 public:
     using key_type = Key;
     using value_type = Value;
     using size_type = size_t;
     using time_point = std::chrono::system_clock::time_point;
-    
+    using CacheStats = FTB::CacheStats;
+
+    /// 每项的固定开销估算（链表节点与哈希表节点）
+    static constexpr size_type kEntryOverhead = 64;
+
+private:
     /**
      * @brief 缓存项结构
      */
     struct CacheItem {
+        Key key;
         Value value;
-        time_point last_access;
         time_point created_time;
         std::chrono::seconds ttl;
-        
-        CacheItem(const Value& val, std::chrono::seconds item_ttl = std::chrono::seconds(300))
-            : value(val), last_access(std::chrono::system_clock::now()), 
-              created_time(std::chrono::system_clock::now()), ttl(item_ttl) {}
-              
-        bool is_expired() const {
-            return std::chrono::system_clock::now() - created_time > ttl;
-        }
-        
-        void update_access() {
-            last_access = std::chrono::system_clock::now();
+        size_type bytes;
+        size_t hash;
+        bool in_window = false;                       // 位于准入窗口区
+        mutable std::atomic<bool> referenced{false};  // 时钟算法的访问标记
+
+        CacheItem(const Key& k, Value val, std::chrono::seconds item_ttl,
+                  size_type item_bytes, size_t item_hash)
+            : key(k), value(std::move(val)), created_time(std::chrono::system_clock::now()),
+              ttl(item_ttl), bytes(item_bytes), hash(item_hash) {}
+
+        bool is_expired(time_point now) const {
+            return now - created_time > ttl;
         }
     };
 
-private:
-    using item_list = std::list<std::pair<Key, CacheItem>>;
-    using item_map = std::unordered_map<Key, typename item_list::iterator, Hash>;
-    
-    mutable std::shared_mutex mutex_;  // 读写锁，提高并发性能
-    item_list items_;                  // LRU链表
-    item_map item_map_;               // 快速查找映射
-    size_type max_size_;              // 最大缓存大小
-    std::chrono::seconds default_ttl_; // 默认TTL
-    bool enable_persistence_;         // 是否启用持久化
-    std::string persistence_file_;    // 持久化文件路径
-    
+    using item_list = std::list<CacheItem>;
+    using item_iter = typename item_list::iterator;
+    using item_map = std::unordered_map<Key, item_iter, Hash>;
+
+    /**
+     * @brief 时钟环：新项插在指针之前
+     */
+    struct Ring {
+        item_list items;
+        item_iter hand = items.end();
+        size_type bytes = 0;
+    };
+
+    /**
+     * @brief 分片：独立加锁的主区与窗口区
+     */
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        Ring main;
+        Ring window;                                   // 仅在启用准入过滤时使用
+        item_map index;
+        std::unique_ptr<FrequencySketch> sketch;       // 启用准入过滤时创建
+        mutable std::atomic<size_type> hits{0};
+        mutable std::atomic<size_type> misses{0};
+        std::atomic<size_type> evictions{0};
+        std::atomic<size_type> rejections{0};
+
+        size_type size() const { return main.items.size() + window.items.size(); }
+    };
+
+    /**
+     * @brief 一个区的条目数与字节数上限（字节为 0 表示不限）
+     */
+    struct Limits {
+        size_type entries = 1;
+        size_type bytes = 0;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_type shard_count_;              // 2 的幂
+    unsigned shard_shift_;               // 取哈希高位选分片
+    size_type max_size_;                 // 最大条目数
+    size_type max_bytes_ = 0;            // 最大字节数，0 表示不限
+    bool admission_ = false;             // 是否启用准入过滤
+    Limits shard_limits_;                // 每个分片的总预算
+    Limits main_limits_;                 // 每个分片的主区预算
+    Limits window_limits_;               // 每个分片的窗口区预算
+    std::chrono::seconds default_ttl_;   // 默认TTL
+    bool enable_persistence_;            // 是否启用持久化
+    std::string persistence_file_;       // 持久化文件路径
+    std::atomic<time_point::rep> last_cleanup_{0};
+
     // 序列化/反序列化函数
     std::function<std::string(const Key&)> key_serializer_;
     std::function<std::string(const Value&)> value_serializer_;
     std::function<Key(const std::string&)> key_deserializer_;
     std::function<Value(const std::string&)> value_deserializer_;
 
+    // 条目被移出缓存（驱逐、删除、过期清理、清空）时的回调，在释放锁后调用
+    mutable std::mutex listener_mutex_;
+    std::function<void(const Key&)> eviction_listener_;
+
 public:
     /**
      * @brief 构造函数
@@ -81,7 +225,16 @@ public:
                      const std::string& persistence_file = "")
         : max_size_(max_size), default_ttl_(default_ttl), 
           enable_persistence_(enable_persistence), persistence_file_(persistence_file) {
-        
+        // 每个分片至少约 16 项，否则哈希不均会让小缓存过早驱逐
+        shard_count_ = 1;
+        shard_shift_ = 64;
+        while (shard_count_ < 16 && shard_count_ * 32 <= max_size_) {
+            shard_count_ *= 2;
+            --shard_shift_;
+        }
+        shards_ = std::make_unique<Shard[]>(shard_count_);
+        update_limits();
+
         if (enable_persistence_ && !persistence_file_.empty()) {
             load_from_disk();
         }
@@ -102,26 +255,72 @@ public:
     }
     
     /**
-     * @brief 获取缓存值
+     * @brief 设置条目移出缓存时的回调
+     * @param listener 回调函数，参数为被移出的键；在缓存锁释放后调用，可安全访问其他缓存
+     */
+    void set_eviction_listener(std::function<void(const Key&)> listener) {
+        std::lock_guard<std::mutex> lock(listener_mutex_);
+        eviction_listener_ = std::move(listener);
+    }
+
+    /**
+     * @brief 设置字节预算，超出的项立即按时钟顺序驱逐
+     * @param max_bytes 最大字节数，0 表示不限
+     */
+    void set_max_bytes(size_type max_bytes) {
+        max_bytes_ = max_bytes;
+        update_limits();
+        trim_all();
+    }
+
+    /**
+     * @brief 启用或关闭 W-TinyLFU 准入过滤（应在缓存投入使用前设置）
+     * @param enabled 是否启用
+     */
+    void set_admission_filter(bool enabled) {
+        admission_ = enabled;
+        update_limits();
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            if (enabled && !shard.sketch) {
+                shard.sketch = std::make_unique<FrequencySketch>(main_limits_.entries + window_limits_.entries);
+            }
+            if (!enabled) {
+                // 窗口区的项并入主区
+                for (auto& item : shard.window.items) item.in_window = false;
+                shard.main.bytes += shard.window.bytes;
+                shard.main.items.splice(shard.main.hand, shard.window.items);
+                shard.window.bytes = 0;
+                shard.window.hand = shard.window.items.end();
+                shard.sketch.reset();
+            }
+        }
+        trim_all();
+    }
+
+    /**
+     * @brief 获取缓存值，命中时标记为最近访问
      * @param key 键
      * @return 可选值，如果不存在或过期则返回空
      */
     std::optional<Value> get(const Key& key) const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
+        size_t hash = Hash()(key);
+        const Shard& shard = shard_for(hash);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
         
-        auto it = item_map_.find(key);
-        if (it == item_map_.end()) {
-            return std::nullopt;
-        }
-        
-        auto& item = it->second->second;
-        if (item.is_expired()) {
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() || it->second->is_expired(std::chrono::system_clock::now())) {
             // 过期项将在下次清理时删除
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
             return std::nullopt;
         }
         
-        item.update_access();
-        return item.value;
+        // 频率只在命中与插入时记录：未命中后紧跟的 put 不应让一次性访问显得频繁
+        if (shard.sketch) shard.sketch->increment(hash);
+        it->second->referenced.store(true, std::memory_order_relaxed);
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        return it->second->value;
     }
     
     /**
@@ -130,31 +329,50 @@ public:
      * @param value 值
      * @param ttl 可选的TTL时间
      */
-    void put(const Key& key, const Value& value, 
+    void put(const Key& key, Value value, 
              std::optional<std::chrono::seconds> ttl = std::nullopt) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
+        size_t hash = Hash()(key);
+        Shard& shard = shard_for(hash);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        std::vector<Key> evicted;
+        auto now = std::chrono::system_clock::now();
         
-        auto it = item_map_.find(key);
-        if (it != item_map_.end()) {
-            // 更新现有项
-            it->second->second.value = value;
-            it->second->second.update_access();
-            it->second->second.ttl = ttl.value_or(default_ttl_);
-            move_to_front(it->second);
+        bool replaced = false;
+        bool referenced = false;
+        bool to_window = admission_;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // 替换现有项：保留其访问标记，留在原来的区
+            replaced = true;
+            referenced = it->second->referenced.load(std::memory_order_relaxed);
+            to_window = it->second->in_window;
+            remove_item(shard, it->second);
+        } else if (shard.sketch) {
+            shard.sketch->increment(hash);
+        }
+
+        size_type bytes = item_bytes(key, value);
+        if (shard_limits_.bytes != 0 && bytes > main_limits_.bytes) {
+            // 单项超过分片预算，不缓存；原有的旧值也已移除
+            if (replaced) evicted.push_back(key);
+            shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        } else if (to_window) {
+            auto item = insert_item(shard, shard.window, key, std::move(value),
+                                    ttl.value_or(default_ttl_), bytes, hash);
+            item->in_window = true;
+            item->referenced.store(referenced, std::memory_order_relaxed);
+            drain_window(shard, now, evicted);
         } else {
-            // 添加新项
-            if (items_.size() >= max_size_) {
-                evict_lru();
-            }
-            
-            auto ttl_time = ttl.value_or(default_ttl_);
-            items_.emplace_front(key, CacheItem(value, ttl_time));
-            item_map_[key] = items_.begin();
+            make_room(shard, shard.main, main_limits_, bytes, now, evicted);
+            insert_item(shard, shard.main, key, std::move(value), ttl.value_or(default_ttl_), bytes, hash)
+                ->referenced.store(referenced, std::memory_order_relaxed);
         }
         
         if (enable_persistence_) {
             save_to_disk_async();
         }
+
+        notify_evicted(lock, evicted);
     }
     
     /**
@@ -163,39 +381,95 @@ public:
      * @return 是否成功删除
      */
     bool erase(const Key& key) {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
+        Shard& shard = shard_for(Hash()(key));
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
         
-        auto it = item_map_.find(key);
-        if (it == item_map_.end()) {
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
             return false;
         }
         
-        items_.erase(it->second);
-        item_map_.erase(it);
+        remove_item(shard, it->second);
         
         if (enable_persistence_) {
             save_to_disk_async();
         }
         
+        std::vector<Key> evicted{key};
+        notify_evicted(lock, evicted);
         return true;
     }
+
+    /**
+     * @brief 删除所有满足条件的缓存项
+     * @param pred 判定函数，参数为键
+     * @return 删除的项数量
+     */
+    size_type erase_if(const std::function<bool(const Key&)>& pred) {
+        size_type removed = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::vector<Key> evicted;
+            for (Ring* ring : {&shard.window, &shard.main}) {
+                for (auto it = ring->items.begin(); it != ring->items.end();) {
+                    auto next = std::next(it);
+                    if (pred(it->key)) {
+                        evicted.push_back(it->key);
+                        remove_item(shard, it);
+                    }
+                    it = next;
+                }
+            }
+            removed += evicted.size();
+            notify_evicted(lock, evicted);
+        }
+        if (removed > 0 && enable_persistence_) {
+            save_to_disk_async();
+        }
+        return removed;
+    }
     
     /**
-     * @brief 检查键是否存在且未过期
+     * @brief 检查键是否存在且未过期（不复制值，不计入命中统计）
      * @param key 键
      * @return 是否存在
      */
     bool contains(const Key& key) const {
-        return get(key).has_value();
+        const Shard& shard = shard_for(Hash()(key));
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        return it != shard.index.end() && !it->second->is_expired(std::chrono::system_clock::now());
     }
     
+    /**
+     * @brief 遍历所有未过期的缓存项（逐分片持读锁，不改变访问标记与频率）
+     * @param fn 回调，不得再访问本缓存
+     */
+    void for_each(const std::function<void(const Key&, const Value&)>& fn) const {
+        auto now = std::chrono::system_clock::now();
+        for (size_type i = 0; i < shard_count_; ++i) {
+            const Shard& shard = shards_[i];
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const Ring* ring : {&shard.window, &shard.main}) {
+                for (const auto& item : ring->items) {
+                    if (!item.is_expired(now)) fn(item.key, item.value);
+                }
+            }
+        }
+    }
+
     /**
      * @brief 获取缓存大小
      * @return 当前缓存项数量
      */
     size_type size() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        return items_.size();
+        size_type total = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+            total += shards_[i].size();
+        }
+        return total;
     }
     
     /**
@@ -203,17 +477,27 @@ public:
      * @return 是否为空
      */
     bool empty() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        return items_.empty();
+        return size() == 0;
     }
     
     /**
      * @brief 清空缓存
      */
     void clear() {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        items_.clear();
-        item_map_.clear();
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::vector<Key> evicted;
+            evicted.reserve(shard.size());
+            for (Ring* ring : {&shard.window, &shard.main}) {
+                for (const auto& item : ring->items) evicted.push_back(item.key);
+                ring->items.clear();
+                ring->hand = ring->items.end();
+                ring->bytes = 0;
+            }
+            shard.index.clear();
+            notify_evicted(lock, evicted);
+        }
         
         if (enable_persistence_) {
             save_to_disk_async();
@@ -225,19 +509,26 @@ public:
      * @return 清理的项数量
      */
     size_type cleanup_expired() {
-        std::unique_lock<std::shared_mutex> lock(mutex_);
-        
+        auto now = std::chrono::system_clock::now();
         size_type cleaned = 0;
-        auto it = items_.begin();
-        while (it != items_.end()) {
-            if (it->second.is_expired()) {
-                item_map_.erase(it->first);
-                it = items_.erase(it);
-                cleaned++;
-            } else {
-                ++it;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::vector<Key> evicted;
+            for (Ring* ring : {&shard.window, &shard.main}) {
+                for (auto it = ring->items.begin(); it != ring->items.end();) {
+                    auto next = std::next(it);
+                    if (it->is_expired(now)) {
+                        evicted.push_back(it->key);
+                        remove_item(shard, it);
+                    }
+                    it = next;
+                }
             }
+            cleaned += evicted.size();
+            notify_evicted(lock, evicted);
         }
+        last_cleanup_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
         
         if (cleaned > 0 && enable_persistence_) {
             save_to_disk_async();
@@ -247,55 +538,203 @@ public:
     }
     
     /**
-     * @brief 获取缓存统计信息
+     * @brief 获取缓存统计信息（含各分片的命中、未命中与驱逐计数）
      */
-    struct CacheStats {
-        size_type size;
-        size_type max_size;
-        size_type expired_count;
-        double hit_ratio;
-        time_point last_cleanup;
-    };
-    
     CacheStats get_stats() const {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        
-        CacheStats stats{};
-        stats.size = items_.size();
+        auto now = std::chrono::system_clock::now();
+        CacheStats stats;
         stats.max_size = max_size_;
-        
-        size_type expired = 0;
-        for (const auto& item : items_) {
-            if (item.second.is_expired()) {
-                expired++;
+        stats.max_bytes = max_bytes_;
+        stats.last_cleanup = time_point(time_point::duration(last_cleanup_.load(std::memory_order_relaxed)));
+        stats.shards.reserve(shard_count_);
+
+        for (size_type i = 0; i < shard_count_; ++i) {
+            const Shard& shard = shards_[i];
+            CacheShardStats s;
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                s.size = shard.size();
+                s.bytes = shard.main.bytes + shard.window.bytes;
+                for (const Ring* ring : {&shard.window, &shard.main}) {
+                    for (const auto& item : ring->items) {
+                        if (item.is_expired(now)) stats.expired_count++;
+                    }
+                }
             }
+            s.hits = shard.hits.load(std::memory_order_relaxed);
+            s.misses = shard.misses.load(std::memory_order_relaxed);
+            s.evictions = shard.evictions.load(std::memory_order_relaxed);
+            s.rejections = shard.rejections.load(std::memory_order_relaxed);
+            stats.size += s.size;
+            stats.bytes += s.bytes;
+            stats.hits += s.hits;
+            stats.misses += s.misses;
+            stats.evictions += s.evictions;
+            stats.rejections += s.rejections;
+            stats.shards.push_back(s);
         }
-        stats.expired_count = expired;
-        
-        // 这里可以添加命中率统计逻辑
-        stats.hit_ratio = 0.0; // 简化实现
-        
+
+        size_type requests = stats.hits + stats.misses;
+        stats.hit_ratio = requests > 0 ? static_cast<double>(stats.hits) / requests : 0.0;
         return stats;
     }
 
 private:
+    Shard& shard_for(size_t hash) const {
+        if (shard_count_ == 1) return shards_[0];
+        // 乘法散列后取高位，避免与分片内哈希表使用的低位相关
+        uint64_t h = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+        return shards_[static_cast<size_type>(h >> shard_shift_)];
+    }
+
+    size_type item_bytes(const Key& key, const Value& value) const {
+        return kEntryOverhead + CacheSizeOf<Key>()(key) + SizeOf()(value);
+    }
+
     /**
-     * @brief 将项移动到链表前端
+     * @brief 按分片数与准入设置划分各区预算
      */
-    void move_to_front(typename item_list::iterator it) {
-        if (it != items_.begin()) {
-            items_.splice(items_.begin(), items_, it);
+    void update_limits() {
+        size_type entries = std::max<size_type>(1, (max_size_ + shard_count_ - 1) / shard_count_);
+        size_type bytes = max_bytes_ == 0 ? 0 : std::max<size_type>(1, (max_bytes_ + shard_count_ - 1) / shard_count_);
+        window_limits_ = Limits{};
+        window_limits_.entries = 0;
+        shard_limits_ = Limits{entries, bytes};
+        main_limits_ = shard_limits_;
+        if (admission_ && entries > 1) {
+            window_limits_.entries = std::max<size_type>(1, entries / 100);
+            window_limits_.bytes = bytes / 100;
+            main_limits_.entries = entries - window_limits_.entries;
+            main_limits_.bytes = bytes - window_limits_.bytes;
         }
     }
-    
+
+    item_iter insert_item(Shard& shard, Ring& ring, const Key& key, Value value,
+                          std::chrono::seconds ttl, size_type bytes, size_t hash) {
+        // 插在指针之前：指针转满一圈后才会检查新项
+        auto it = ring.items.emplace(ring.hand, key, std::move(value), ttl, bytes, hash);
+        shard.index[key] = it;
+        ring.bytes += bytes;
+        return it;
+    }
+
+    void remove_item(Shard& shard, item_iter it) {
+        Ring& ring = it->in_window ? shard.window : shard.main;
+        if (ring.hand == it) ++ring.hand;
+        ring.bytes -= it->bytes;
+        shard.index.erase(it->key);
+        ring.items.erase(it);
+    }
+
     /**
-     * @brief 驱逐最久未使用的项
+     * @brief 区内是否放不下再加入 incoming 字节的一项（incoming 为 0 时检查是否已超限）
      */
-    void evict_lru() {
-        if (!items_.empty()) {
-            auto last = std::prev(items_.end());
-            item_map_.erase(last->first);
-            items_.erase(last);
+    static bool over_limit(const Ring& ring, const Limits& limits, size_type incoming) {
+        if (ring.items.empty()) return false;
+        size_type count = ring.items.size() + (incoming > 0 ? 1 : 0);
+        if (count > limits.entries) return true;
+        return limits.bytes != 0 && ring.bytes + incoming > limits.bytes;
+    }
+
+    /**
+     * @brief 时钟扫描：清除访问标记直到找到未访问（或已过期）的项
+     */
+    static item_iter pick_victim(Ring& ring, time_point now) {
+        for (;;) {
+            if (ring.hand == ring.items.end()) ring.hand = ring.items.begin();
+            auto it = ring.hand;
+            if (!it->is_expired(now) && it->referenced.exchange(false, std::memory_order_relaxed)) {
+                ++ring.hand;
+                continue;
+            }
+            return it;
+        }
+    }
+
+    void evict(Shard& shard, item_iter it, std::vector<Key>& evicted) {
+        evicted.push_back(it->key);
+        remove_item(shard, it);
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 驱逐直到区内能再放入 incoming 字节的一项
+     */
+    void make_room(Shard& shard, Ring& ring, const Limits& limits, size_type incoming,
+                   time_point now, std::vector<Key>& evicted) {
+        while (over_limit(ring, limits, incoming)) {
+            evict(shard, pick_victim(ring, now), evicted);
+        }
+    }
+
+    /**
+     * @brief 窗口区溢出的项与主区的驱逐候选比较频率，胜者进入（或留在）主区
+     */
+    void drain_window(Shard& shard, time_point now, std::vector<Key>& evicted) {
+        // 窗口至少保留一项，否则单个大项无法经过窗口
+        while (shard.window.items.size() > 1 && over_limit(shard.window, window_limits_, 0)) {
+            auto candidate = pick_victim(shard.window, now);
+            bool admitted = true;
+            while (admitted && over_limit(shard.main, main_limits_, candidate->bytes)) {
+                auto victim = pick_victim(shard.main, now);
+                if (!victim->is_expired(now) &&
+                    shard.sketch->estimate(candidate->hash) <= shard.sketch->estimate(victim->hash)) {
+                    admitted = false;
+                } else {
+                    evict(shard, victim, evicted);
+                }
+            }
+            if (!admitted) {
+                shard.rejections.fetch_add(1, std::memory_order_relaxed);
+                evict(shard, candidate, evicted);
+                continue;
+            }
+            if (shard.window.hand == candidate) ++shard.window.hand;
+            shard.window.bytes -= candidate->bytes;
+            shard.main.bytes += candidate->bytes;
+            candidate->in_window = false;
+            shard.main.items.splice(shard.main.hand, shard.window.items, candidate);
+        }
+        // 窗口中超出自身预算的单个大项占用主区的字节额度
+        while (shard_limits_.bytes != 0 && !shard.main.items.empty() &&
+               shard.main.bytes + shard.window.bytes > shard_limits_.bytes) {
+            evict(shard, pick_victim(shard.main, now), evicted);
+        }
+    }
+
+    /**
+     * @brief 按当前预算修剪所有分片
+     */
+    void trim_all() {
+        auto now = std::chrono::system_clock::now();
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            std::vector<Key> evicted;
+            make_room(shard, shard.main, main_limits_, 0, now, evicted);
+            if (shard.sketch) drain_window(shard, now, evicted);
+            notify_evicted(lock, evicted);
+        }
+    }
+
+    /**
+     * @brief 释放锁后通知被移出的键
+     */
+    void notify_evicted(std::unique_lock<std::shared_mutex>& lock, const std::vector<Key>& evicted) {
+        if (evicted.empty()) {
+            return;
+        }
+        std::function<void(const Key&)> listener;
+        {
+            std::lock_guard<std::mutex> guard(listener_mutex_);
+            listener = eviction_listener_;
+        }
+        if (!listener) {
+            return;
+        }
+        lock.unlock();
+        for (const auto& key : evicted) {
+            listener(key);
         }
     }
     
@@ -323,22 +762,33 @@ private:
         }
         
         try {
+            // 先在各分片锁内序列化，再统一写出
+            auto now = std::chrono::system_clock::now();
+            std::vector<std::string> records;
+            for (size_type i = 0; i < shard_count_; ++i) {
+                const Shard& shard = shards_[i];
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                for (const Ring* ring : {&shard.window, &shard.main}) {
+                    for (const auto& item : ring->items) {
+                        if (item.is_expired(now)) continue;
+                        std::ostringstream record;
+                        record << key_serializer_(item.key) << "\n";
+                        record << value_serializer_(item.value) << "\n";
+                        record << std::chrono::duration_cast<std::chrono::seconds>(
+                            item.created_time.time_since_epoch()).count() << "\n";
+                        record << item.ttl.count() << "\n";
+                        records.push_back(record.str());
+                    }
+                }
+            }
+
             std::ofstream file(persistence_file_);
             if (!file.is_open()) {
                 return;
             }
-            
-            std::shared_lock<std::shared_mutex> lock(mutex_);
-            
-            file << items_.size() << "\n";
-            for (const auto& item : items_) {
-                if (!item.second.is_expired()) {
-                    file << key_serializer_(item.first) << "\n";
-                    file << value_serializer_(item.second.value) << "\n";
-                    file << std::chrono::duration_cast<std::chrono::seconds>(
-                        item.second.created_time.time_since_epoch()).count() << "\n";
-                    file << item.second.ttl.count() << "\n";
-                }
+            file << records.size() << "\n";
+            for (const auto& record : records) {
+                file << record;
             }
         } catch (const std::exception& e) {
             // 静默处理保存错误
@@ -364,8 +814,6 @@ private:
                 return;
             }
             
-            std::unique_lock<std::shared_mutex> lock(mutex_);
-            
             size_type count;
             file >> count;
             
@@ -385,9 +833,16 @@ private:
                 
                 // 检查是否过期
                 if (std::chrono::system_clock::now() - created_time < ttl) {
-                    items_.emplace_front(key, CacheItem(value, ttl));
-                    items_.front().second.created_time = created_time;
-                    item_map_[key] = items_.begin();
+                    size_t hash = Hash()(key);
+                    Shard& shard = shard_for(hash);
+                    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                    auto existing = shard.index.find(key);
+                    if (existing != shard.index.end()) remove_item(shard, existing->second);
+                    size_type bytes = item_bytes(key, value);
+                    std::vector<Key> evicted;
+                    make_room(shard, shard.main, main_limits_, bytes, std::chrono::system_clock::now(), evicted);
+                    insert_item(shard, shard.main, key, std::move(value), ttl, bytes, hash)
+                        ->created_time = created_time;
                 }
             }
         } catch (const std::exception& e) {
@@ -396,6 +851,104 @@ private:
     }
 };
 
+/**
+ * @brief 共享所有权的LRU缓存：值以不可变快照 std::shared_ptr<const Value> 保存
+ *
+ * LRUCache::get 按值返回，命中一个大目录列表就要深拷贝整张表。这里缓存的是指向
+ * 不可变值的句柄，命中只增加一次引用计数，与值的大小无关；调用方持有句柄期间，
+ * 即使该项被替换或驱逐，快照依然有效。修改需拷贝出新值后重新 put（写时复制）。
+ * @tparam Key 键类型
+ * @tparam Value 值类型
+ * @tparam Hash 哈希函数类型
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class SharedLRUCache {
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using handle = std::shared_ptr<const Value>;
+    using size_type = size_t;
+    using CacheStats = FTB::CacheStats;
+
+    explicit SharedLRUCache(size_type max_size = 1000,
+                            std::chrono::seconds default_ttl = std::chrono::seconds(300),
+                            bool enable_persistence = false,
+                            const std::string& persistence_file = "")
+        : cache_(max_size, default_ttl, enable_persistence, persistence_file) {}
+
+    /**
+     * @brief 设置序列化函数（按值类型给出，内部完成句柄转换）
+     */
+    void set_serializers(
+        std::function<std::string(const Key&)> key_ser,
+        std::function<std::string(const Value&)> value_ser,
+        std::function<Key(const std::string&)> key_deser,
+        std::function<Value(const std::string&)> value_deser) {
+        cache_.set_serializers(
+            std::move(key_ser),
+            [ser = std::move(value_ser)](const handle& value) {
+                return value ? ser(*value) : std::string();
+            },
+            std::move(key_deser),
+            [deser = std::move(value_deser)](const std::string& text) -> handle {
+                return std::make_shared<const Value>(deser(text));
+            });
+    }
+
+    void set_eviction_listener(std::function<void(const Key&)> listener) {
+        cache_.set_eviction_listener(std::move(listener));
+    }
+
+    /**
+     * @brief 设置字节预算（按快照指向的值估算）
+     */
+    void set_max_bytes(size_type max_bytes) { cache_.set_max_bytes(max_bytes); }
+
+    /**
+     * @brief 启用或关闭 W-TinyLFU 准入过滤
+     */
+    void set_admission_filter(bool enabled) { cache_.set_admission_filter(enabled); }
+
+    /**
+     * @brief 获取缓存值的句柄
+     * @return 不存在或过期时返回空指针
+     */
+    handle get(const Key& key) const {
+        auto cached = cache_.get(key);
+        return cached ? std::move(*cached) : handle();
+    }
+
+    /**
+     * @brief 设置缓存值
+     * @param value 值会被移入新的快照
+     */
+    void put(const Key& key, Value value,
+             std::optional<std::chrono::seconds> ttl = std::nullopt) {
+        cache_.put(key, std::make_shared<const Value>(std::move(value)), ttl);
+    }
+
+    /**
+     * @brief 直接缓存已有的快照（与调用方共享同一份值）
+     */
+    void put(const Key& key, handle value,
+             std::optional<std::chrono::seconds> ttl = std::nullopt) {
+        if (value) cache_.put(key, std::move(value), ttl);
+    }
+
+    bool erase(const Key& key) { return cache_.erase(key); }
+    size_type erase_if(const std::function<bool(const Key&)>& pred) { return cache_.erase_if(pred); }
+    bool contains(const Key& key) const { return cache_.contains(key); }
+    void for_each(const std::function<void(const Key&, const handle&)>& fn) const { cache_.for_each(fn); }
+    size_type size() const { return cache_.size(); }
+    bool empty() const { return cache_.empty(); }
+    void clear() { cache_.clear(); }
+    size_type cleanup_expired() { return cache_.cleanup_expired(); }
+    CacheStats get_stats() const { return cache_.get_stats(); }
+
+private:
+    LRUCache<Key, handle, Hash> cache_;
+};
+
 } // namespace FTB
 
 #endif // LRU_CACHE_HPP
@@ -210,6 +210,8 @@ int main(int argc, char* argv[])
     state.ssh_records = config_manager->GetSSHRecords();
 #endif
 
+    // 映射上次退出时的目录快照，访问过的目录无需重新读取
+    FileManager::initializeCacheSystem(100, 2000, 50, true);
     {
         state.allContents = FileManager::getDirectoryContents(state.currentPath);
     }
@@ -281,12 +283,9 @@ int main(int argc, char* argv[])
         auto current_col = BuildCurrentColumn(state) | size(WIDTH, EQUAL, cw);
         int preview_idx = state.selected;
         if (state.selected >= 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
-            const std::string& sel_name = state.filteredContents[state.selected];
-            for (size_t ei = 0; ei < state.cached_current_entries.size(); ++ei) {
-                if (state.cached_current_entries[ei].name == sel_name) {
-                    preview_idx = static_cast<int>(ei);
-                    break;
-                }
+            auto found = state.cached_entry_index.find(state.filteredContents[state.selected]);
+            if (found != state.cached_entry_index.end()) {
+                preview_idx = static_cast<int>(found->second);
             }
         }
         auto preview_col = CreateDetailElement(state.cached_current_entries, preview_idx, state.currentPath,
@@ -380,7 +379,7 @@ int main(int argc, char* argv[])
         if (event == Event::Custom) {
             screen.SetCursor(Screen::Cursor{0, 0, Screen::Cursor::Hidden});
             if (state.refresh_pending.exchange(false)) {
-                RefreshDirectoryContents(state);
+                SyncCurrentEntries(state);
                 if (state.selected >= static_cast<int>(state.filteredContents.size()))
                     state.selected = std::max(0, static_cast<int>(state.filteredContents.size()) - 1);
             }
@@ -652,6 +651,7 @@ int main(int argc, char* argv[])
 
     screen.Loop(final_component);
     refresh_ui = false;
+    FileManager::setDirectoryChangeListener(nullptr);  // 监听线程不再向已退出的 screen 投递事件
 
 #ifdef FTB_ENABLE_PLUGINS
     FTB::PluginManager::GetInstance()->StopBackgroundRefresh();
@@ -674,6 +674,7 @@ int main(int argc, char* argv[])
 #endif
 
     config_manager->SaveConfig();
+    FileManager::shutdownCacheSystem();
     std::cout << "\033[?25h" << std::flush;
 
     // 清理终端图像残留（Kitty/iTerm2/Sixel）
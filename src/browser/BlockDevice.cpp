@@ -0,0 +1,61 @@
+// BlockDevice.cpp - 通过 sysfs 识别块设备类型
+#include "../include/browser/BlockDevice.hpp"
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace FTB {
+
+namespace {
+
+// 读取 sysfs 中的单个整数属性，失败返回 -1
+int readFlag(const fs::path& file) {
+    std::ifstream in(file);
+    int value = -1;
+    if (!(in >> value)) return -1;
+    return value;
+}
+
+}  // namespace
+
+uint64_t BlockDevice::deviceOf(const std::string& path) {
+    if (path.empty()) return 0;
+    fs::path p(path);
+    struct stat st{};
+    while (::stat(p.c_str(), &st) != 0) {
+        if (!p.has_relative_path()) return 0;
+        fs::path parent = p.parent_path();
+        if (parent == p || parent.empty()) return 0;
+        p = parent;
+    }
+    return static_cast<uint64_t>(st.st_dev);
+}
+
+BlockDevice::Kind BlockDevice::classify(uint64_t dev, const std::string& sysfs_root) {
+    unsigned maj = major(static_cast<dev_t>(dev));
+    unsigned min = minor(static_cast<dev_t>(dev));
+    if (dev == 0 || maj == 0) return Kind::Unknown;   // 匿名设备：tmpfs、overlay、NFS 等
+
+    std::error_code ec;
+    fs::path link = fs::path(sysfs_root) / "dev" / "block" / (std::to_string(maj) + ":" + std::to_string(min));
+    fs::path dir = fs::canonical(link, ec);
+    if (ec) return Kind::Unknown;
+    // 分区没有 queue 目录，属性在所属磁盘上
+    if (!fs::exists(dir / "queue" / "rotational", ec) && fs::exists(dir / "partition", ec)) {
+        dir = dir.parent_path();
+    }
+
+    int rotational = readFlag(dir / "queue" / "rotational");
+    if (rotational < 0) return Kind::Unknown;
+    if (readFlag(dir / "removable") == 1 || dir.string().find("/usb") != std::string::npos) {
+        return Kind::Removable;
+    }
+    return rotational == 1 ? Kind::Rotational : Kind::SolidState;
+}
+
+}  // namespace FTB
@@ -0,0 +1,323 @@
+// CopyJournal.cpp - 可恢复复制 / 移动任务的进度日志
+#include "../include/browser/CopyJournal.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace FTB {
+
+namespace {
+
+constexpr int kVersion = 1;
+constexpr const char* kExtension = ".journal";
+
+// 路径中的换行与反斜杠转义，保证一条记录占一行
+std::string escape(const std::string& path) {
+    std::string out;
+    out.reserve(path.size());
+    for (char c : path) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string unescape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            out += text[++i] == 'n' ? '\n' : text[i];
+        } else {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool lockFd(int fd) {
+    return ::flock(fd, LOCK_EX | LOCK_NB) == 0;
+}
+
+bool fileSize(const std::string& path, uintmax_t& size) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    size = static_cast<uintmax_t>(st.st_size);
+    return true;
+}
+
+json toJson(const CopyJournal::Header& header) {
+    json entries = json::array();
+    for (const auto& e : header.entries) {
+        entries.push_back({{"src", e.src}, {"dst", e.dst}, {"rename", e.rename}});
+    }
+    return {
+        {"version", kVersion},
+        {"title", header.title},
+        {"move", header.move},
+        {"force_overwrite", header.force_overwrite},
+        {"total_files", header.total_files},
+        {"total_bytes", header.total_bytes},
+        {"entries", std::move(entries)},
+    };
+}
+
+bool fromJson(const std::string& line, CopyJournal::Header& header) {
+    json j = json::parse(line, nullptr, false);
+    if (j.is_discarded() || !j.is_object() || j.value("version", 0) != kVersion) return false;
+    try {
+        header.title = j.value("title", std::string());
+        header.move = j.value("move", false);
+        header.force_overwrite = j.value("force_overwrite", false);
+        header.total_files = j.value("total_files", 0);
+        header.total_bytes = j.value("total_bytes", uintmax_t{0});
+        header.entries.clear();
+        for (const auto& e : j.at("entries")) {
+            header.entries.push_back({e.at("src").get<std::string>(), e.at("dst").get<std::string>(),
+                                      e.value("rename", false)});
+        }
+    } catch (const json::exception&) {
+        return false;
+    }
+    return true;
+}
+
+// "<数字> <其余>"：解析前导数字，rest 为空格之后的部分
+bool splitNumber(const std::string& text, uintmax_t& number, std::string& rest) {
+    size_t space = text.find(' ');
+    if (space == 0 || space == std::string::npos) return false;
+    char* end = nullptr;
+    number = std::strtoumax(text.c_str(), &end, 10);
+    if (end != text.c_str() + space) return false;
+    rest = text.substr(space + 1);
+    return true;
+}
+
+}  // namespace
+
+std::string CopyJournal::defaultDirectory() {
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : "/tmp") + "/.config/ftb/journal";
+}
+
+std::unique_ptr<CopyJournal> CopyJournal::create(const Header& header, const std::string& dir) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) return nullptr;
+
+    auto stamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string base = dir + "/" + std::to_string(stamp) + "-" + std::to_string(::getpid());
+    int fd = -1;
+    std::string path;
+    for (int attempt = 0; attempt < 100 && fd < 0; ++attempt) {
+        path = base + (attempt ? "-" + std::to_string(attempt) : "") + kExtension;
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0600);
+        if (fd < 0 && errno != EEXIST) return nullptr;
+    }
+    if (fd < 0) return nullptr;
+
+    std::unique_ptr<CopyJournal> journal(new CopyJournal(path, fd));
+    journal->header_ = header;
+    if (!lockFd(fd) || !writeAll(fd, toJson(header).dump() + "\n")) {
+        journal->remove();
+        return nullptr;
+    }
+    return journal;
+}
+
+std::unique_ptr<CopyJournal> CopyJournal::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    if (!lockFd(fd)) {
+        ::close(fd);
+        return nullptr;
+    }
+    std::unique_ptr<CopyJournal> journal(new CopyJournal(path, fd));
+    if (!journal->load()) return nullptr;
+    return journal;
+}
+
+std::vector<std::string> CopyJournal::pending(const std::string& dir) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& de : fs::directory_iterator(dir, ec)) {
+        if (de.path().extension() != kExtension) continue;
+        int fd = ::open(de.path().c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (lockFd(fd)) paths.push_back(de.path().string());
+        ::close(fd);
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+bool CopyJournal::readHeader(const std::string& path, Header& header) {
+    std::ifstream in(path);
+    std::string line;
+    return std::getline(in, line) && fromJson(line, header);
+}
+
+CopyJournal::~CopyJournal() {
+    if (fd_ < 0) return;
+    flush();
+    ::close(fd_);
+}
+
+bool CopyJournal::load() {
+    std::ifstream in(path_, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t eol = content.find('\n');
+    if (eol == std::string::npos || !fromJson(content.substr(0, eol), header_)) return false;
+
+    // 进程被杀时最后一行可能不完整：忽略它，并补上换行使之后的记录从新行开始
+    bool torn = content.back() != '\n';
+    size_t pos = eol + 1;
+    while (pos < content.size()) {
+        size_t end = content.find('\n', pos);
+        if (end == std::string::npos) break;
+        std::string line = content.substr(pos, end - pos);
+        pos = end + 1;
+        if (line.size() < 3 || line[1] != ' ') continue;
+
+        uintmax_t number = 0;
+        std::string rest;
+        if (!splitNumber(line.substr(2), number, rest)) continue;
+        switch (line[0]) {
+        case 'F':
+            done_[unescape(rest)] = number;
+            break;
+        case 'P': {
+            uintmax_t& offset = partial_[unescape(rest)];
+            offset = std::max(offset, number);
+            break;
+        }
+        case 'E': {
+            uintmax_t files = 0;
+            std::string bytes;
+            if (!splitNumber(rest, files, bytes)) continue;
+            EntryDone& done = entries_done_[static_cast<size_t>(number)];
+            done.files = static_cast<int>(files);
+            done.bytes = std::strtoumax(bytes.c_str(), nullptr, 10);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    if (torn) writeAll(fd_, "\n");
+    return true;
+}
+
+bool CopyJournal::completed(const std::string& src, const std::string& dst, uintmax_t& size) const {
+    auto it = done_.find(dst);
+    if (it == done_.end()) return false;
+    uintmax_t src_size = 0, dst_size = 0;
+    if (!fileSize(src, src_size) || !fileSize(dst, dst_size)) return false;
+    if (src_size != it->second || dst_size != it->second) return false;
+    size = it->second;
+    return true;
+}
+
+uintmax_t CopyJournal::resumeOffset(const std::string& dst) const {
+    auto it = partial_.find(dst);
+    if (it == partial_.end()) return 0;
+    uintmax_t dst_size = 0;
+    if (!fileSize(dst, dst_size)) return 0;
+    return std::min(it->second, dst_size);
+}
+
+bool CopyJournal::entryDone(size_t index, int& files, uintmax_t& bytes) const {
+    auto it = entries_done_.find(index);
+    if (it == entries_done_.end()) return false;
+    files = it->second.files;
+    bytes = it->second.bytes;
+    return true;
+}
+
+void CopyJournal::markFile(const std::string& dst, uintmax_t size) {
+    append("F " + std::to_string(size) + " " + escape(dst) + "\n", false);
+}
+
+void CopyJournal::markPartial(const std::string& dst, uintmax_t offset) {
+    append("P " + std::to_string(offset) + " " + escape(dst) + "\n", true);
+}
+
+void CopyJournal::markEntry(size_t index, int files, uintmax_t bytes) {
+    append("E " + std::to_string(index) + " " + std::to_string(files) + " " + std::to_string(bytes) + "\n", true);
+}
+
+void CopyJournal::append(const std::string& record, bool now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) return;
+    buffer_ += record;
+    if (now || buffer_.size() >= kFlushBytes || Clock::now() - last_write_ >= kFlushInterval) {
+        writeLocked();
+    }
+}
+
+void CopyJournal::writeLocked() {
+    if (!buffer_.empty()) writeAll(fd_, buffer_);
+    buffer_.clear();
+    last_write_ = Clock::now();
+}
+
+void CopyJournal::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) writeLocked();
+}
+
+void CopyJournal::remove() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) return;
+    ::unlink(path_.c_str());
+    ::close(fd_);
+    fd_ = -1;
+    buffer_.clear();
+}
+
+void CopyJournal::FileCheckpoint::advance(uintmax_t bytes) {
+    pos_ += bytes;
+    if (journal_ && pos_ - last_ >= kCheckpointBytes) {
+        journal_->markPartial(dst_, pos_);
+        last_ = pos_;
+    }
+}
+
+void CopyJournal::FileCheckpoint::complete() {
+    if (journal_) journal_->markFile(dst_, pos_);
+}
+
+}  // namespace FTB
@@ -0,0 +1,188 @@
+// DirScanner.cpp - 基于 getdents64 的批量目录扫描器
+#include "../include/browser/DirScanner.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace FTB {
+
+namespace {
+
+// 过滤 "." 与 ".."
+inline bool isDotOrDotDot(const char* name) {
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#ifdef __linux__
+// 内核 getdents64 返回的记录布局
+struct LinuxDirent64 {
+    uint64_t       d_ino;
+    int64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[1];
+};
+
+unsigned toStatxMask(unsigned fields) {
+    unsigned mask = 0;
+    if (fields & DirScanner::kStatType)   mask |= STATX_TYPE;
+    if (fields & DirScanner::kStatMode)   mask |= STATX_TYPE | STATX_MODE;
+    if (fields & DirScanner::kStatSize)   mask |= STATX_SIZE;
+    if (fields & DirScanner::kStatMtime)  mask |= STATX_MTIME;
+    if (fields & DirScanner::kStatBlocks) mask |= STATX_BLOCKS;
+    if (fields & DirScanner::kStatIno)    mask |= STATX_INO | STATX_NLINK;
+    return mask;
+}
+#endif
+
+}  // namespace
+
+DirScanner::DirScanner(const std::string& path, size_t buffer_size) {
+    fd_ = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd_ < 0) {
+        error_ = errno;
+        return;
+    }
+#ifdef __linux__
+    buffer_.resize(buffer_size < 4096 ? 4096 : buffer_size);
+#else
+    (void)buffer_size;
+    dir_ = ::fdopendir(fd_);
+    if (!dir_) {
+        error_ = errno;
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+DirScanner::~DirScanner() {
+#ifdef __linux__
+    if (fd_ >= 0) ::close(fd_);
+#else
+    // closedir 同时关闭 fdopendir 接管的描述符
+    if (dir_) ::closedir(static_cast<DIR*>(dir_));
+#endif
+}
+
+bool DirScanner::next(std::vector<RawDirEntry>& out) {
+    if (fd_ < 0 || eof_) return false;
+
+#ifdef __linux__
+    long nread;
+    do {
+        nread = ::syscall(SYS_getdents64, fd_, buffer_.data(), buffer_.size());
+    } while (nread < 0 && errno == EINTR);
+
+    if (nread <= 0) {
+        if (nread < 0) error_ = errno;
+        eof_ = true;
+        return false;
+    }
+
+    size_t before = out.size();
+    for (long pos = 0; pos < nread;) {
+        auto* d = reinterpret_cast<LinuxDirent64*>(buffer_.data() + pos);
+        pos += d->d_reclen;
+        if (isDotOrDotDot(d->d_name)) continue;
+        RawDirEntry e;
+        e.name = d->d_name;
+        e.ino  = d->d_ino;
+        e.type = d->d_type;
+        out.push_back(std::move(e));
+    }
+    // 整批都是 "." / ".." 时继续读取，避免调用方误判为结束
+    return out.size() > before || next(out);
+#else
+    // 每批最多 1024 条，保持与 Linux 路径一致的分批语义
+    DIR* dir = static_cast<DIR*>(dir_);
+    size_t count = 0;
+    errno = 0;
+    while (count < 1024) {
+        struct dirent* d = ::readdir(dir);
+        if (!d) {
+            if (errno != 0) error_ = errno;
+            eof_ = true;
+            break;
+        }
+        if (isDotOrDotDot(d->d_name)) continue;
+        RawDirEntry e;
+        e.name = d->d_name;
+        e.ino  = d->d_ino;
+        e.type = d->d_type;
+        out.push_back(std::move(e));
+        ++count;
+    }
+    return count > 0;
+#endif
+}
+
+std::vector<RawDirEntry> DirScanner::readAll(const std::string& path) {
+    std::vector<RawDirEntry> entries;
+    DirScanner scanner(path);
+    if (!scanner.ok()) return entries;
+    entries.reserve(256);
+    while (scanner.next(entries)) {
+    }
+    return entries;
+}
+
+bool DirScanner::statAt(int dirfd, const char* name, unsigned fields,
+                        EntryStat& out, bool follow) {
+#if defined(__linux__) && defined(STATX_TYPE)
+    struct statx stx;
+    int flags = AT_STATX_SYNC_AS_STAT | (follow ? 0 : AT_SYMLINK_NOFOLLOW);
+    if (::statx(dirfd, name, flags, toStatxMask(fields), &stx) != 0) {
+        return false;
+    }
+    out.mode      = stx.stx_mode;
+    out.size      = stx.stx_size;
+    out.blocks    = stx.stx_blocks;
+    out.mtime_sec = stx.stx_mtime.tv_sec;
+    out.mtime_nsec = stx.stx_mtime.tv_nsec;
+    out.ino       = stx.stx_ino;
+    out.dev       = (static_cast<uint64_t>(stx.stx_dev_major) << 32) | stx.stx_dev_minor;
+    out.nlink     = stx.stx_nlink;
+    return true;
+#else
+    (void)fields;
+    struct stat st;
+    if (::fstatat(dirfd, name, &st, follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+        return false;
+    }
+    out.mode      = st.st_mode;
+    out.size      = static_cast<uintmax_t>(st.st_size);
+    out.blocks    = static_cast<uintmax_t>(st.st_blocks);
+    out.mtime_sec = st.st_mtime;
+    out.mtime_nsec = 0;
+    out.ino       = st.st_ino;
+    out.dev       = st.st_dev;
+    out.nlink     = static_cast<uint32_t>(st.st_nlink);
+    return true;
+#endif
+}
+
+mode_t DirScanner::typeToMode(unsigned char type) {
+    switch (type) {
+    case DT_REG:  return S_IFREG;
+    case DT_DIR:  return S_IFDIR;
+    case DT_LNK:  return S_IFLNK;
+    case DT_FIFO: return S_IFIFO;
+    case DT_SOCK: return S_IFSOCK;
+    case DT_CHR:  return S_IFCHR;
+    case DT_BLK:  return S_IFBLK;
+    default:      return 0;
+    }
+}
+
+}  // namespace FTB
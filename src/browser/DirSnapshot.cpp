@@ -0,0 +1,354 @@
+// DirSnapshot.cpp - 可 mmap 直接使用的目录条目快照
+#include "../include/browser/DirSnapshot.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+
+namespace FTB {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'T', 'B', 'S', 'N', 'A', 'P', '\0'};
+
+struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t sort_mode;
+    uint32_t dir_count;
+    uint32_t icon_count;
+    uint64_t dirs_off;
+    uint64_t icons_off;
+    uint64_t rows_off;
+    uint64_t arena_off;
+    uint64_t file_size;
+    uint64_t table_checksum;   // [dirs_off, rows_off)：目录表与图标表
+};
+
+struct DirRecord {
+    uint64_t path_off;         // 以下 *_off 除 first_row 外均为文件内偏移
+    uint32_t path_len;
+    uint32_t row_count;
+    uint64_t first_row;        // 在行区中的下标
+    uint64_t names_off;
+    uint32_t names_len;
+    uint32_t reserved;
+    uint64_t dev;
+    uint64_t ino;
+    int64_t  mtime_ns;
+    uint64_t checksum;         // 本目录的行、名称与路径
+};
+
+struct IconRecord {
+    uint64_t off;
+    uint32_t len;
+    uint32_t reserved;
+};
+
+struct RowRecord {
+    uint32_t name_off;         // 相对于所属目录的名称区
+    uint16_t name_len;
+    uint8_t  flags;
+    uint8_t  reserved0;
+    uint32_t mode;
+    uint16_t icon;             // 图标表下标
+    uint16_t reserved1;
+    uint64_t size;
+    int64_t  mtime;
+};
+
+static_assert(sizeof(Header) == 72, "snapshot header layout");
+static_assert(sizeof(DirRecord) == 72, "snapshot dir record layout");
+static_assert(sizeof(IconRecord) == 16, "snapshot icon record layout");
+static_assert(sizeof(RowRecord) == 32, "snapshot row record layout");
+
+// FNV-1a 64，h 传入上一段的结果以串接多段数据
+uint64_t fnv1a(const void* data, size_t len, uint64_t h = 0xcbf29ce484222325ull) {
+    auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+bool inBounds(uint64_t off, uint64_t len, uint64_t size) {
+    return off <= size && len <= size - off;
+}
+
+bool writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+// ---------------------------- 写入 ----------------------------
+
+bool DirSnapshot::stampOf(const std::string& path, DirStamp& stamp) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+    stamp.dev = static_cast<uint64_t>(st.st_dev);
+    stamp.ino = static_cast<uint64_t>(st.st_ino);
+#ifdef __APPLE__
+    stamp.mtime_ns = int64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    stamp.mtime_ns = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+bool DirSnapshot::write(const std::string& file, const std::vector<Entry>& entries, SortMode mode) {
+    // 按路径去重并排序，顺带过滤无法使用的目录
+    struct Dir {
+        const Entry* entry;
+        DirStamp     stamp;
+    };
+    std::map<std::string_view, Dir> dirs;
+    for (const auto& e : entries) {
+        if (!e.table || e.path.empty()) continue;
+        const EntryTable& table = *e.table;
+        bool complete = true;
+        for (size_t pos = 0; pos < table.size() && complete; ++pos) {
+            complete = !table.statPending(pos);
+        }
+        // 写入时才 stat 得到的 stamp 会把尚未修补的旧列表标记为最新，只能用读取时的 stamp
+        const DirStamp& stamp = table.dirStamp();
+        DirStamp current;
+        if (!complete || stamp.empty() || !stampOf(e.path, current) || current != stamp) continue;
+        dirs[e.path] = Dir{&e, stamp};
+    }
+
+    // 图标表与各区域大小
+    std::unordered_map<uint16_t, uint16_t> icon_index;
+    std::vector<uint16_t> icons;
+    size_t row_count = 0;
+    size_t arena_size = 0;
+    for (const auto& [path, dir] : dirs) {
+        const EntryTable& table = *dir.entry->table;
+        row_count += table.size();
+        arena_size += path.size();
+        for (size_t pos = 0; pos < table.size(); ++pos) {
+            auto raw = table.rawRow(pos);
+            arena_size += raw.name.size();
+            if (icon_index.emplace(raw.icon, static_cast<uint16_t>(icons.size())).second) {
+                icons.push_back(raw.icon);
+            }
+        }
+    }
+    for (uint16_t id : icons) arena_size += IconText(id).size();
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sort_mode = static_cast<uint32_t>(mode);
+    header.dir_count = static_cast<uint32_t>(dirs.size());
+    header.icon_count = static_cast<uint32_t>(icons.size());
+    header.dirs_off = align8(sizeof(Header));
+    header.icons_off = header.dirs_off + dirs.size() * sizeof(DirRecord);
+    header.rows_off = header.icons_off + icons.size() * sizeof(IconRecord);
+    header.arena_off = header.rows_off + row_count * sizeof(RowRecord);
+    header.file_size = header.arena_off + arena_size;
+
+    std::string buf(header.file_size, '\0');
+    auto* dir_records = reinterpret_cast<DirRecord*>(&buf[header.dirs_off]);
+    auto* icon_records = reinterpret_cast<IconRecord*>(&buf[header.icons_off]);
+    auto* rows = reinterpret_cast<RowRecord*>(&buf[header.rows_off]);
+    size_t arena = header.arena_off;
+    auto append = [&buf, &arena](std::string_view bytes) {
+        uint64_t off = arena;
+        std::memcpy(&buf[arena], bytes.data(), bytes.size());
+        arena += bytes.size();
+        return off;
+    };
+
+    for (size_t i = 0; i < icons.size(); ++i) {
+        const std::string& text = IconText(icons[i]);
+        icon_records[i].off = append(text);
+        icon_records[i].len = static_cast<uint32_t>(text.size());
+    }
+
+    size_t next_row = 0;
+    for (const auto& [path, dir] : dirs) {
+        const EntryTable& table = *dir.entry->table;
+        DirRecord& rec = *dir_records++;
+        rec.path_off = append(path);
+        rec.path_len = static_cast<uint32_t>(path.size());
+        rec.row_count = static_cast<uint32_t>(table.size());
+        rec.first_row = next_row;
+        rec.names_off = arena;
+        rec.dev = dir.stamp.dev;
+        rec.ino = dir.stamp.ino;
+        rec.mtime_ns = dir.stamp.mtime_ns;
+        for (size_t pos = 0; pos < table.size(); ++pos) {
+            auto raw = table.rawRow(pos);
+            RowRecord& row = rows[next_row++];
+            row.name_off = static_cast<uint32_t>(append(raw.name) - rec.names_off);
+            row.name_len = static_cast<uint16_t>(raw.name.size());
+            row.flags = raw.flags;
+            row.mode = raw.mode;
+            row.icon = icon_index[raw.icon];
+            row.size = raw.size;
+            row.mtime = raw.mtime;
+        }
+        rec.names_len = static_cast<uint32_t>(arena - rec.names_off);
+        uint64_t h = fnv1a(&rows[rec.first_row], rec.row_count * sizeof(RowRecord));
+        h = fnv1a(&buf[rec.names_off], rec.names_len, h);
+        rec.checksum = fnv1a(path.data(), path.size(), h);
+    }
+    header.table_checksum = fnv1a(&buf[header.dirs_off], header.rows_off - header.dirs_off);
+    std::memcpy(&buf[0], &header, sizeof(header));
+
+    // 临时文件写完并落盘后再替换，崩溃时不会留下半个快照
+    std::string tmp = file + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = writeAll(fd, buf.data(), buf.size()) && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || ::rename(tmp.c_str(), file.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------- 读取 ----------------------------
+
+std::shared_ptr<const DirSnapshot> DirSnapshot::open(const std::string& file) {
+    int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return nullptr;
+
+    std::shared_ptr<DirSnapshot> snapshot(new DirSnapshot());
+    snapshot->data_ = static_cast<const unsigned char*>(map);
+    snapshot->size_ = size;
+
+    Header header;
+    std::memcpy(&header, map, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.file_size != size) {
+        return nullptr;
+    }
+    if (header.dirs_off < sizeof(Header) || header.dirs_off % 8 != 0 ||
+        header.icons_off != header.dirs_off + uint64_t(header.dir_count) * sizeof(DirRecord) ||
+        header.rows_off != header.icons_off + uint64_t(header.icon_count) * sizeof(IconRecord) ||
+        header.rows_off > header.arena_off || header.arena_off > size ||
+        (header.arena_off - header.rows_off) % sizeof(RowRecord) != 0 ||
+        header.sort_mode > static_cast<uint32_t>(SortMode::TreeSizeDesc)) {
+        return nullptr;
+    }
+    const unsigned char* data = snapshot->data_;
+    if (fnv1a(data + header.dirs_off, header.rows_off - header.dirs_off) != header.table_checksum) {
+        return nullptr;
+    }
+
+    // 目录表的边界在此一次校验完，load() 只需校验行内的偏移
+    const uint64_t total_rows = (header.arena_off - header.rows_off) / sizeof(RowRecord);
+    auto* dirs = reinterpret_cast<const DirRecord*>(data + header.dirs_off);
+    for (uint32_t i = 0; i < header.dir_count; ++i) {
+        const DirRecord& rec = dirs[i];
+        if (!inBounds(rec.path_off, rec.path_len, size) || !inBounds(rec.names_off, rec.names_len, size) ||
+            rec.first_row > total_rows || rec.row_count > total_rows - rec.first_row) {
+            return nullptr;
+        }
+    }
+
+    auto* icons = reinterpret_cast<const IconRecord*>(data + header.icons_off);
+    snapshot->icon_ids_.reserve(header.icon_count);
+    for (uint32_t i = 0; i < header.icon_count; ++i) {
+        if (!inBounds(icons[i].off, icons[i].len, size)) return nullptr;
+        snapshot->icon_ids_.push_back(
+            InternIcon(std::string(reinterpret_cast<const char*>(data + icons[i].off), icons[i].len)));
+    }
+
+    snapshot->dir_count_ = header.dir_count;
+    snapshot->sort_mode_ = static_cast<SortMode>(header.sort_mode);
+    return snapshot;
+}
+
+DirSnapshot::~DirSnapshot() {
+    if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+}
+
+std::vector<std::string> DirSnapshot::paths() const {
+    Header header;
+    std::memcpy(&header, data_, sizeof(header));
+    auto* dirs = reinterpret_cast<const DirRecord*>(data_ + header.dirs_off);
+    std::vector<std::string> result;
+    result.reserve(dir_count_);
+    for (size_t i = 0; i < dir_count_; ++i) {
+        result.emplace_back(reinterpret_cast<const char*>(data_ + dirs[i].path_off), dirs[i].path_len);
+    }
+    return result;
+}
+
+std::optional<EntryTable> DirSnapshot::load(const std::string& path) const {
+    Header header;
+    std::memcpy(&header, data_, sizeof(header));
+    auto* dirs = reinterpret_cast<const DirRecord*>(data_ + header.dirs_off);
+    auto* end = dirs + dir_count_;
+    auto pathOf = [this](const DirRecord& rec) {
+        return std::string_view(reinterpret_cast<const char*>(data_ + rec.path_off), rec.path_len);
+    };
+
+    auto it = std::lower_bound(dirs, end, std::string_view(path),
+                               [&pathOf](const DirRecord& rec, std::string_view key) { return pathOf(rec) < key; });
+    if (it == end || pathOf(*it) != path) return std::nullopt;
+    const DirRecord& rec = *it;
+
+    auto* rows = reinterpret_cast<const RowRecord*>(data_ + header.rows_off) + rec.first_row;
+    const unsigned char* names = data_ + rec.names_off;
+    uint64_t h = fnv1a(rows, rec.row_count * sizeof(RowRecord));
+    h = fnv1a(names, rec.names_len, h);
+    if (fnv1a(path.data(), path.size(), h) != rec.checksum) return std::nullopt;
+
+    DirStamp stamp;
+    if (!stampOf(path, stamp) || stamp != DirStamp{rec.dev, rec.ino, rec.mtime_ns}) return std::nullopt;
+
+    EntryTable table;
+    table.reserve(rec.row_count, rec.names_len);
+    table.setDirStamp(stamp);
+    for (uint32_t i = 0; i < rec.row_count; ++i) {
+        const RowRecord& row = rows[i];
+        if (!inBounds(row.name_off, row.name_len, rec.names_len) || row.icon >= icon_ids_.size()) {
+            return std::nullopt;
+        }
+        EntryTable::RawRow raw;
+        raw.name = std::string_view(reinterpret_cast<const char*>(names + row.name_off), row.name_len);
+        raw.mode = row.mode;
+        raw.size = row.size;
+        raw.mtime = row.mtime;
+        raw.flags = row.flags;
+        raw.icon = icon_ids_[row.icon];
+        table.appendRaw(raw);
+    }
+    return table;
+}
+
+}  // namespace FTB
@@ -0,0 +1,279 @@
+// DirWatcher.cpp - inotify 目录变更监听
+#include "../include/browser/DirWatcher.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace FTB {
+
+namespace {
+
+// 读到事件后继续等待的时间，把保存文件等操作产生的一串事件合并成一次回调
+constexpr int kCoalesceMs = 20;
+
+// 同一批次内按目录聚合，并对同名条目去重
+class ChangeBatch {
+public:
+    void add(const std::string& dir, DirWatcher::Change::Kind kind, const std::string& name) {
+        auto& changes = dirs_[dir];
+        if (!changes.empty() && changes.front().kind == DirWatcher::Change::Rescan) return;
+        if (kind == DirWatcher::Change::Rescan) {
+            changes.assign(1, DirWatcher::Change{kind, std::string()});
+            index_.erase(dir);
+            return;
+        }
+        auto& idx = index_[dir];
+        auto it = idx.find(name);
+        if (it == idx.end()) {
+            idx.emplace(name, changes.size());
+            changes.push_back(DirWatcher::Change{kind, name});
+            return;
+        }
+        auto& existing = changes[it->second];
+        // 新建后紧接着的写入/属性变化仍然是新建
+        if (!(existing.kind == DirWatcher::Change::Created && kind == DirWatcher::Change::Modified)) {
+            existing.kind = kind;
+        }
+    }
+
+    bool empty() const { return dirs_.empty(); }
+    const std::map<std::string, std::vector<DirWatcher::Change>>& dirs() const { return dirs_; }
+
+private:
+    std::map<std::string, std::vector<DirWatcher::Change>>               dirs_;
+    std::map<std::string, std::unordered_map<std::string, size_t>>       index_;
+};
+
+}  // namespace
+
+struct DirWatcher::Impl {
+    mutable std::mutex                              mutex;
+    int                                             fd = -1;
+    int                                             wake_pipe[2] = {-1, -1};
+    std::thread                                     thread;
+    bool                                            stop = false;
+    std::unordered_map<std::string, int>            dir_to_wd;
+    std::unordered_map<int, std::vector<std::string>> wd_to_dirs;
+    std::map<size_t, ChangeHandler>                 listeners;
+    size_t                                          next_listener = 1;
+
+#ifdef __linux__
+    void ensureThread() {
+        if (thread.joinable() || fd < 0) return;
+        thread = std::thread([this] { loop(); });
+    }
+
+    void forget(int wd, ChangeBatch& batch) {
+        auto it = wd_to_dirs.find(wd);
+        if (it == wd_to_dirs.end()) return;
+        for (const auto& dir : it->second) {
+            batch.add(dir, Change::Rescan, std::string());
+            dir_to_wd.erase(dir);
+        }
+        wd_to_dirs.erase(it);
+    }
+
+    void drain(ChangeBatch& batch) {
+        alignas(struct inotify_event) char buf[64 * 1024];
+        for (;;) {
+            ssize_t n = ::read(fd, buf, sizeof(buf));
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (char* p = buf; p < buf + n;) {
+                auto* ev = reinterpret_cast<struct inotify_event*>(p);
+                p += sizeof(struct inotify_event) + ev->len;
+
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    for (const auto& [dir, wd] : dir_to_wd) {
+                        batch.add(dir, Change::Rescan, std::string());
+                    }
+                    continue;
+                }
+                if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                    if (ev->mask & IN_MOVE_SELF) {
+                        // 目录被移走后 wd 仍然有效但路径已失效，主动移除
+                        inotify_rm_watch(fd, ev->wd);
+                    }
+                    forget(ev->wd, batch);
+                    continue;
+                }
+
+                auto it = wd_to_dirs.find(ev->wd);
+                if (it == wd_to_dirs.end() || ev->len == 0) continue;
+                std::string name(ev->name);
+
+                Change::Kind kind;
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    kind = Change::Created;
+                } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    kind = Change::Deleted;
+                } else {
+                    kind = Change::Modified;
+                }
+                for (const auto& dir : it->second) {
+                    batch.add(dir, kind, name);
+                }
+            }
+        }
+    }
+
+    void loop() {
+        for (;;) {
+            struct pollfd fds[2] = {{fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+            int rc = ::poll(fds, 2, -1);
+            if (rc < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            if (fds[1].revents) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stop) return;
+            }
+            if (!(fds[0].revents & POLLIN)) continue;
+
+            ChangeBatch batch;
+            drain(batch);
+            // 合并紧随其后的事件
+            struct pollfd more = {fd, POLLIN, 0};
+            while (::poll(&more, 1, kCoalesceMs) > 0 && (more.revents & POLLIN)) {
+                drain(batch);
+            }
+            if (batch.empty()) continue;
+
+            std::vector<ChangeHandler> handlers;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stop) return;
+                for (const auto& [id, handler] : listeners) handlers.push_back(handler);
+            }
+            for (const auto& [dir, changes] : batch.dirs()) {
+                for (const auto& handler : handlers) {
+                    try {
+                        handler(dir, changes);
+                    } catch (...) {
+                        // 监听者的异常不能终止监听线程
+                    }
+                }
+            }
+        }
+    }
+#endif
+};
+
+DirWatcher& DirWatcher::instance() {
+    static DirWatcher watcher;
+    return watcher;
+}
+
+DirWatcher::DirWatcher() : impl_(new Impl) {
+#ifdef __linux__
+    impl_->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (impl_->fd >= 0 && ::pipe2(impl_->wake_pipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        ::close(impl_->fd);
+        impl_->fd = -1;
+    }
+#endif
+}
+
+DirWatcher::~DirWatcher() {
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stop = true;
+    }
+    if (impl_->wake_pipe[1] >= 0) {
+        char c = 0;
+        (void)!::write(impl_->wake_pipe[1], &c, 1);
+    }
+    if (impl_->thread.joinable()) impl_->thread.join();
+    if (impl_->fd >= 0) ::close(impl_->fd);
+    for (int p : impl_->wake_pipe) {
+        if (p >= 0) ::close(p);
+    }
+#endif
+    delete impl_;
+}
+
+bool DirWatcher::available() const {
+    return impl_->fd >= 0;
+}
+
+bool DirWatcher::watch(const std::string& dir) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->fd < 0) return false;
+    if (impl_->dir_to_wd.count(dir)) return true;
+
+    constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                               IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR |
+                               IN_EXCL_UNLINK;
+    int wd = inotify_add_watch(impl_->fd, dir.c_str(), kMask);
+    if (wd < 0) return false;
+
+    // 同一目录的不同路径写法会得到相同的 wd
+    impl_->dir_to_wd.emplace(dir, wd);
+    impl_->wd_to_dirs[wd].push_back(dir);
+    impl_->ensureThread();
+    return true;
+#else
+    (void)dir;
+    return false;
+#endif
+}
+
+void DirWatcher::unwatch(const std::string& dir) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->dir_to_wd.find(dir);
+    if (it == impl_->dir_to_wd.end()) return;
+    int wd = it->second;
+    impl_->dir_to_wd.erase(it);
+
+    auto& dirs = impl_->wd_to_dirs[wd];
+    dirs.erase(std::remove(dirs.begin(), dirs.end(), dir), dirs.end());
+    if (dirs.empty()) {
+        impl_->wd_to_dirs.erase(wd);
+        inotify_rm_watch(impl_->fd, wd);
+    }
+#else
+    (void)dir;
+#endif
+}
+
+bool DirWatcher::isWatched(const std::string& dir) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->dir_to_wd.count(dir) != 0;
+}
+
+size_t DirWatcher::watchCount() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->dir_to_wd.size();
+}
+
+size_t DirWatcher::addListener(ChangeHandler handler) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    size_t id = impl_->next_listener++;
+    impl_->listeners.emplace(id, std::move(handler));
+    return id;
+}
+
+void DirWatcher::removeListener(size_t id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->listeners.erase(id);
+}
+
+}  // namespace FTB
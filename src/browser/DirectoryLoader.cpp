@@ -0,0 +1,99 @@
+// DirectoryLoader.cpp - 后台流式目录加载
+#include "../include/browser/DirectoryLoader.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace FTB {
+
+// 后台线程与 UI 线程共享的状态；后台线程持有 shared_ptr，因此加载器可以先于线程销毁
+struct DirectoryLoader::State {
+    std::atomic<bool>       cancel{false};
+    std::atomic<bool>       notify_armed{true};
+    std::atomic<size_t>     loaded{0};
+    std::function<void()>   notify;
+
+    mutable std::mutex      mutex;
+    std::condition_variable cv;
+    Update                  pending;
+    bool                    has_result = false;
+    bool                    finished = false;
+
+    template <typename Fn>
+    void publish(Fn&& fill) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fill(pending);
+            has_result = true;
+        }
+        cv.notify_all();
+        if (notify && !cancel.load() && notify_armed.exchange(false)) {
+            notify();
+        }
+    }
+};
+
+DirectoryLoader::DirectoryLoader(std::string path, bool stream, std::function<void()> notify)
+    : path_(std::move(path)), stream_(stream), state_(std::make_shared<State>()) {
+    state_->notify = std::move(notify);
+
+    std::thread([state = state_, path = path_, stream]() {
+        FileManager::EntryBatchCallback on_names;
+        FileManager::EntryBatchCallback on_batch;
+        if (stream) {
+            on_names = [&state](const EntryTable& entries, size_t begin, size_t end) {
+                state->loaded.store(end);
+                state->publish([&](Update& u) { u.names.appendFrom(entries, begin, end); });
+            };
+            on_batch = [&state](const EntryTable& entries, size_t begin, size_t end) {
+                state->publish([&](Update& u) { u.metadata.appendFrom(entries, begin, end); });
+            };
+        }
+
+        auto entries = FileManager::loadDirectoryEntries(path, on_names, on_batch, &state->cancel);
+        if (state->cancel.load()) return;
+
+        state->loaded.store(entries->size());
+        state->publish([&](Update& u) {
+            u.final_entries = *entries;   // 界面会修改自己的表，从缓存共享的表复制一份
+            u.finished = true;
+            state->finished = true;
+        });
+    }).detach();
+}
+
+DirectoryLoader::~DirectoryLoader() {
+    cancel();
+}
+
+bool DirectoryLoader::finished() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->finished;
+}
+
+size_t DirectoryLoader::loadedCount() const {
+    return state_->loaded.load();
+}
+
+bool DirectoryLoader::waitForFirstResult(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    return state_->cv.wait_for(lock, timeout, [this] { return state_->has_result; });
+}
+
+DirectoryLoader::Update DirectoryLoader::take() {
+    Update out;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(out, state_->pending);
+    }
+    state_->notify_armed.store(true);
+    return out;
+}
+
+void DirectoryLoader::cancel() {
+    state_->cancel.store(true);
+}
+
+}  // namespace FTB
@@ -0,0 +1,354 @@
+// DiskUsage.cpp - 并行、识别硬链接的目录树大小统计
+#include "../include/browser/DiskUsage.hpp"
+#include "../include/browser/DirScanner.hpp"
+#include "../include/browser/SizeIndex.hpp"
+#include "../include/browser/WorkStealing.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace FTB {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Totals = DiskUsage::Totals;
+
+// 根目录本身：其中每个条目开启一个新的 Child
+constexpr int kRootChild = -2;
+constexpr size_t kInodeShards = 64;
+// mtime 距统计开始不足此秒数的目录不写入索引：时间戳粒度较粗时，之后的修改可能不改变 mtime
+constexpr int64_t kRacySeconds = 2;
+constexpr unsigned kStatFields = DirScanner::kStatType | DirScanner::kStatSize | DirScanner::kStatBlocks |
+                                 DirScanner::kStatIno | DirScanner::kStatMtime;
+
+struct DirJob {
+    std::string path;
+    int         child = -1;   // 所属的根目录条目，-1 表示不区分
+    // 父目录 stat 时得到的目录自身信息，用于查询 SizeIndex
+    uint64_t    dev = 0;
+    uint64_t    ino = 0;
+    int64_t     mtime_sec = 0;
+    uint32_t    mtime_nsec = 0;
+};
+
+DirJob makeJob(std::string path, int child, const EntryStat& st) {
+    return DirJob{std::move(path), child, st.dev, st.ino, st.mtime_sec, st.mtime_nsec};
+}
+
+void add(Totals& into, const Totals& t) {
+    into.apparent += t.apparent;
+    into.disk += t.disk;
+    into.files += t.files;
+    into.dirs += t.dirs;
+    into.errors += t.errors;
+}
+
+std::string join(const std::string& dir, const std::string& name) {
+    return !dir.empty() && dir.back() == '/' ? dir + name : dir + "/" + name;
+}
+
+// 已计入的多链接 inode；按哈希分片加锁，线程之间很少争用同一把锁
+class InodeSet {
+public:
+    bool insert(uint64_t dev, uint64_t ino) {
+        Key key{dev, ino};
+        Shard& shard = shards_[Hash()(key) % kInodeShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.seen.insert(key).second;
+    }
+
+private:
+    struct Key {
+        uint64_t dev;
+        uint64_t ino;
+        bool operator==(const Key& other) const { return dev == other.dev && ino == other.ino; }
+    };
+    struct Hash {
+        size_t operator()(const Key& key) const {
+            return static_cast<size_t>((key.ino * 0x9E3779B97F4A7C15ull) ^ (key.dev >> 3) ^ (key.ino >> 29));
+        }
+    };
+    struct Shard {
+        std::mutex                    mutex;
+        std::unordered_set<Key, Hash> seen;
+    };
+    Shard shards_[kInodeShards];
+};
+
+// 每个工作线程复用的缓冲
+struct Scratch {
+    std::vector<RawDirEntry> batch;
+    std::vector<EntryStat>   stats;
+    std::vector<char>        ok;
+    std::vector<DirJob>      subdirs;
+};
+
+// stat 一批条目（不跟随符号链接），结果写入 s.stats / s.ok
+void statBatch(int dirfd, Scratch& s) {
+    const size_t n = s.batch.size();
+    s.stats.resize(n);
+    s.ok.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        s.ok[i] = DirScanner::statAt(dirfd, s.batch[i].name.c_str(), kStatFields, s.stats[i]);
+    }
+}
+
+class Walker {
+public:
+    Walker(const DiskUsage::Options& options, size_t threads) : options_(options), queues_(threads, options.cancel) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_.back()->id = i;
+        }
+        interval_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(options.progress_interval).count();
+        auto now = std::chrono::system_clock::now().time_since_epoch();
+        racy_after_ = std::chrono::duration_cast<std::chrono::seconds>(now).count() - kRacySeconds;
+    }
+
+    // 根目录在调用线程上单独处理，分配 Child 序号后再启动其他线程
+    void run(const std::string& root, const EntryStat& root_stat, const Totals& root_totals) {
+        credit(*workers_[0], -1, root_totals);
+        Scratch scratch;
+        processDirectory(*workers_[0], scratch, makeJob(root, kRootChild, root_stat));
+        flush(*workers_[0]);
+
+        if (queues_.pending() == 0) return;   // 根目录下没有子目录
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < workers_.size(); ++i) threads.emplace_back([this, i] { work(i); });
+        work(0);
+        for (auto& t : threads) t.join();
+    }
+
+    bool cancelled() const { return queues_.cancelled(); }
+
+    Totals totals() const {
+        Totals t;
+        t.apparent = apparent_.load(std::memory_order_relaxed);
+        t.disk = disk_.load(std::memory_order_relaxed);
+        t.files = files_.load(std::memory_order_relaxed);
+        t.dirs = dirs_.load(std::memory_order_relaxed);
+        t.errors = errors_.load(std::memory_order_relaxed);
+        return t;
+    }
+
+    uint64_t reused() const { return reused_.load(std::memory_order_relaxed); }
+
+    std::vector<DiskUsage::Child> children() const {
+        std::vector<DiskUsage::Child> out(names_.size());
+        for (size_t i = 0; i < names_.size(); ++i) out[i].name = names_[i];
+        for (const auto& w : workers_) {
+            for (size_t i = 0; i < w->children.size() && i < out.size(); ++i) add(out[i].totals, w->children[i]);
+        }
+        return out;
+    }
+
+private:
+    struct Worker {
+        size_t              id = 0;
+        Totals              delta;      // 尚未汇入共享合计的部分
+        std::vector<Totals> children;
+    };
+
+    void work(size_t self) {
+        Scratch scratch;
+        Worker& w = *workers_[self];
+        DirJob job;
+        while (queues_.next(self, job)) {
+            processDirectory(w, scratch, job);
+            flush(w);
+            queues_.done();
+        }
+    }
+
+    void credit(Worker& w, int child, const Totals& t) {
+        add(w.delta, t);
+        if (child < 0) return;
+        if (w.children.size() <= static_cast<size_t>(child)) w.children.resize(static_cast<size_t>(child) + 1);
+        add(w.children[static_cast<size_t>(child)], t);
+    }
+
+    void processDirectory(Worker& w, Scratch& s, const DirJob& job) {
+        const bool root = job.child == kRootChild;
+        // 按条目拆分时根目录的条目要分别计入各 Child，不能使用合并后的记录
+        SizeIndex::Record record;
+        if (options_.index && !options_.refresh_index && !(root && options_.per_child) &&
+            options_.index->lookup(job.dev, job.ino, job.mtime_sec, job.mtime_nsec, record)) {
+            processCached(w, s, job, record);
+            return;
+        }
+
+        DirScanner scanner(job.path);
+        Totals error;
+        error.errors = 1;
+        if (!scanner.ok()) {
+            credit(w, root ? -1 : job.child, error);
+            return;
+        }
+        bool complete = true;   // 所有条目都 stat 成功，结果可以写入索引
+        record = SizeIndex::Record{};
+        s.subdirs.clear();
+        while (scanner.next(s.batch)) {
+            statBatch(scanner.fd(), s);
+            for (size_t i = 0; i < s.batch.size(); ++i) {
+                int child = job.child;
+                if (root) {
+                    child = options_.per_child ? static_cast<int>(names_.size()) : -1;
+                    if (options_.per_child) names_.push_back(s.batch[i].name);
+                }
+                if (!s.ok[i]) {
+                    complete = false;
+                    credit(w, child, error);
+                    continue;
+                }
+                const EntryStat& st = s.stats[i];
+                Totals t;
+                t.disk = st.blocks * 512;
+                if (S_ISDIR(st.mode)) {
+                    t.dirs = 1;
+                    s.subdirs.push_back(makeJob(join(job.path, s.batch[i].name), child, st));
+                } else {
+                    if (st.nlink > 1) {
+                        record.linked.push_back({st.ino, st.size, t.disk});
+                    } else {
+                        record.apparent += st.size;
+                        record.disk += t.disk;
+                        ++record.files;
+                    }
+                    if (options_.dedupe_hardlinks && st.nlink > 1 && !inodes_.insert(st.dev, st.ino)) continue;
+                    t.files = 1;
+                    t.apparent = st.size;
+                }
+                credit(w, child, t);
+            }
+            s.batch.clear();
+            if (cancelled()) return;
+        }
+        if (scanner.error() != 0) {
+            complete = false;
+            credit(w, root ? -1 : job.child, error);
+        }
+        if (options_.index && complete && job.mtime_sec < racy_after_) {
+            record.mtime_sec = job.mtime_sec;
+            record.mtime_nsec = job.mtime_nsec;
+            options_.index->store(job.dev, job.ino, std::move(record));
+        }
+        queues_.push(w.id, s.subdirs);
+    }
+
+    // 目录自上次统计后没有变化：文件合计取自索引，只需找出子目录（d_type 已知时不 stat 文件）
+    void processCached(Worker& w, Scratch& s, const DirJob& job, const SizeIndex::Record& record) {
+        const int child = job.child == kRootChild ? -1 : job.child;
+        DirScanner scanner(job.path);
+        Totals error;
+        error.errors = 1;
+        if (!scanner.ok()) {
+            credit(w, child, error);
+            return;
+        }
+        Totals files;
+        files.apparent = record.apparent;
+        files.disk = record.disk;
+        files.files = record.files;
+        for (const auto& linked : record.linked) {
+            if (options_.dedupe_hardlinks && !inodes_.insert(job.dev, linked.ino)) continue;
+            files.apparent += linked.apparent;
+            files.disk += linked.disk;
+            ++files.files;
+        }
+        credit(w, child, files);
+        reused_.fetch_add(1, std::memory_order_relaxed);
+
+        s.subdirs.clear();
+        EntryStat st;
+        while (scanner.next(s.batch)) {
+            for (const auto& raw : s.batch) {
+                if (raw.type != DT_DIR && raw.type != DT_UNKNOWN) continue;
+                if (!DirScanner::statAt(scanner.fd(), raw.name.c_str(), kStatFields, st)) {
+                    credit(w, child, error);
+                    continue;
+                }
+                if (!S_ISDIR(st.mode)) continue;   // 类型未知的文件已计入记录
+                Totals dir;
+                dir.dirs = 1;
+                dir.disk = st.blocks * 512;
+                credit(w, child, dir);
+                s.subdirs.push_back(makeJob(join(job.path, raw.name), child, st));
+            }
+            s.batch.clear();
+            if (cancelled()) return;
+        }
+        if (scanner.error() != 0) credit(w, child, error);
+        queues_.push(w.id, s.subdirs);
+    }
+
+    // 把线程的增量汇入共享合计，并按间隔回报进度
+    void flush(Worker& w) {
+        apparent_.fetch_add(w.delta.apparent, std::memory_order_relaxed);
+        disk_.fetch_add(w.delta.disk, std::memory_order_relaxed);
+        files_.fetch_add(w.delta.files, std::memory_order_relaxed);
+        dirs_.fetch_add(w.delta.dirs, std::memory_order_relaxed);
+        errors_.fetch_add(w.delta.errors, std::memory_order_relaxed);
+        w.delta = Totals{};
+
+        if (!options_.on_progress) return;
+        int64_t now = Clock::now().time_since_epoch().count();
+        int64_t due = next_report_.load(std::memory_order_relaxed);
+        if (now < due || !next_report_.compare_exchange_strong(due, now + interval_ns_)) return;
+        options_.on_progress(totals());
+    }
+
+    const DiskUsage::Options&            options_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::string>             names_;   // 只在处理根目录时写入
+    InodeSet                             inodes_;
+    WorkStealingQueues<DirJob>           queues_;
+
+    std::atomic<uintmax_t> apparent_{0};
+    std::atomic<uintmax_t> disk_{0};
+    std::atomic<uint64_t>  files_{0};
+    std::atomic<uint64_t>  dirs_{0};
+    std::atomic<uint64_t>  errors_{0};
+    std::atomic<uint64_t>  reused_{0};
+    std::atomic<int64_t>   next_report_{0};
+    int64_t                interval_ns_ = 0;
+    int64_t                racy_after_ = 0;
+};
+
+}  // namespace
+
+size_t DiskUsage::defaultThreads() {
+    return defaultWalkThreads();
+}
+
+DiskUsage::Report DiskUsage::measure(const std::string& root, const Options& options) {
+    Report report;
+    EntryStat st;
+    if (!DirScanner::statAt(AT_FDCWD, root.c_str(), kStatFields, st, true)) {
+        report.total.errors = 1;
+    } else if (!S_ISDIR(st.mode)) {
+        report.total.files = 1;
+        report.total.apparent = st.size;
+        report.total.disk = st.blocks * 512;
+    } else {
+        Totals self;
+        self.dirs = 1;
+        self.disk = st.blocks * 512;
+        Walker walker(options, options.threads ? options.threads : defaultThreads());
+        walker.run(root, st, self);
+        report.total = walker.totals();
+        report.children = walker.children();
+        report.reused_dirs = walker.reused();
+        report.cancelled = walker.cancelled();
+    }
+    if (options.on_progress) options.on_progress(report.total);
+    return report;
+}
+
+}  // namespace FTB
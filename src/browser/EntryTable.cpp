@@ -0,0 +1,400 @@
+// EntryTable.cpp - 目录条目的列式存储
+#include "../include/browser/EntryTable.hpp"
+#include "../include/browser/DirScanner.hpp"
+#include "../include/renderer/IconMapper.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+
+namespace FTB {
+
+namespace {
+
+// 图标种类只有几百个，而条目可能有几十万个
+struct IconPool {
+    std::shared_mutex                         mutex;
+    std::deque<std::string>                   texts{std::string()};  // 0 号为空图标
+    std::unordered_map<std::string, uint16_t> ids{{std::string(), 0}};
+};
+
+IconPool& iconPool() {
+    static IconPool pool;
+    return pool;
+}
+
+std::string formatPermissions(mode_t mode) {
+    static const char   kPermChars[] = "rwxrwxrwx";
+    static const mode_t kPermBits[] = {
+        S_IRUSR, S_IWUSR, S_IXUSR,
+        S_IRGRP, S_IWGRP, S_IXGRP,
+        S_IROTH, S_IWOTH, S_IXOTH
+    };
+    char perm_buf[10];
+    perm_buf[0] = S_ISLNK(mode) ? 'l' : S_ISDIR(mode) ? 'd' : S_ISREG(mode) ? '-' : '?';
+    for (int i = 0; i < 9; ++i)
+        perm_buf[1 + i] = (mode & kPermBits[i]) ? kPermChars[i] : '-';
+    return std::string(perm_buf, 10);
+}
+
+// formatPermissions 的逆过程，用于没有原始 mode 的来源
+mode_t parsePermissions(const std::string& text) {
+    static const mode_t kPermBits[] = {
+        S_IRUSR, S_IWUSR, S_IXUSR,
+        S_IRGRP, S_IWGRP, S_IXGRP,
+        S_IROTH, S_IWOTH, S_IXOTH
+    };
+    mode_t mode = 0;
+    if (text.size() != 10) return mode;
+    for (int i = 0; i < 9; ++i)
+        if (text[1 + i] != '-') mode |= kPermBits[i];
+    return mode;
+}
+
+std::string formatModTime(int64_t mtime_sec) {
+    std::time_t t = static_cast<std::time_t>(mtime_sec);
+    std::tm tm_buf{};
+    char time_buf[20];
+    if (localtime_r(&t, &tm_buf) && std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M", &tm_buf))
+        return time_buf;
+    return {};
+}
+
+// formatModTime 的逆过程：SFTP 条目只有格式化后的时间，解析回来以便按时间排序
+int64_t parseModTime(const std::string& text) {
+    std::tm tm_buf{};
+    if (text.empty() || !strptime(text.c_str(), "%Y-%m-%d %H:%M", &tm_buf)) return 0;
+    tm_buf.tm_isdst = -1;
+    return static_cast<int64_t>(std::mktime(&tm_buf));
+}
+
+// 没有原始 stat 的条目：权限字符串未知，不做格式化
+constexpr uint8_t kNoPermissions = 1 << 5;
+
+}  // namespace
+
+uint16_t InternIcon(const std::string& icon) {
+    auto& pool = iconPool();
+    {
+        std::shared_lock<std::shared_mutex> lock(pool.mutex);
+        auto it = pool.ids.find(icon);
+        if (it != pool.ids.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(pool.mutex);
+    auto it = pool.ids.find(icon);
+    if (it != pool.ids.end()) return it->second;
+    if (pool.texts.size() > std::numeric_limits<uint16_t>::max()) return 0;
+    auto id = static_cast<uint16_t>(pool.texts.size());
+    pool.texts.push_back(icon);
+    pool.ids.emplace(icon, id);
+    return id;
+}
+
+const std::string& IconText(uint16_t id) {
+    auto& pool = iconPool();
+    std::shared_lock<std::shared_mutex> lock(pool.mutex);
+    return id < pool.texts.size() ? pool.texts[id] : pool.texts[0];
+}
+
+// ---------------------------- 存储 ----------------------------
+
+void EntryTable::reserve(size_t rows, size_t name_bytes) {
+    names_.reserve(name_bytes ? name_bytes : rows * 16);
+    name_off_.reserve(rows);
+    name_len_.reserve(rows);
+    mode_.reserve(rows);
+    size_.reserve(rows);
+    mtime_.reserve(rows);
+    flags_.reserve(rows);
+    icon_.reserve(rows);
+    order_.reserve(rows);
+}
+
+void EntryTable::clear() {
+    *this = EntryTable();
+}
+
+EntryTable::Row EntryTable::appendRow(std::string_view name, mode_t mode, uint8_t flags, uint16_t icon) {
+    auto row = static_cast<Row>(name_off_.size());
+    name_off_.push_back(static_cast<uint32_t>(names_.size()));
+    name_len_.push_back(static_cast<uint16_t>(std::min<size_t>(name.size(), std::numeric_limits<uint16_t>::max())));
+    names_.append(name.data(), name_len_.back());
+    mode_.push_back(static_cast<uint32_t>(mode));
+    size_.push_back(0);
+    mtime_.push_back(0);
+    flags_.push_back(flags);
+    icon_.push_back(icon);
+    order_.push_back(row);
+    return row;
+}
+
+size_t EntryTable::appendPending(std::string_view name, unsigned char d_type) {
+    mode_t mode = DirScanner::typeToMode(d_type);
+    uint8_t flags = kPending | kExists;
+    if (!name.empty() && name[0] == '.') flags |= kHidden;
+    if (S_ISDIR(mode)) flags |= kDir;
+    if (S_ISREG(mode)) flags |= kRegular;
+    uint16_t icon = InternIcon(FTB::Icons::GetIconForEntry(std::string(name), S_ISDIR(mode), false));
+    appendRow(name, mode, flags, icon);
+    return order_.size() - 1;
+}
+
+size_t EntryTable::append(const FileManager::DirEntryInfo& info) {
+    mode_t mode = info.is_symlink ? S_IFLNK : info.is_dir ? S_IFDIR : info.is_regular ? S_IFREG : 0;
+    mode |= parsePermissions(info.permissions);
+    if (info.is_executable) mode |= S_IXUSR;
+
+    uint8_t flags = 0;
+    if (info.is_dir) flags |= kDir;
+    if (info.is_regular) flags |= kRegular;
+    if (info.is_hidden) flags |= kHidden;
+    if (info.exists) flags |= kExists;
+    if (info.stat_pending) flags |= kPending;
+    if (info.permissions.empty()) flags |= kNoPermissions;
+
+    Row row = appendRow(info.name, mode, flags, InternIcon(info.icon));
+    size_[row] = info.file_size;
+    if (!info.mod_time.empty()) {
+        mtime_[row] = parseModTime(info.mod_time);
+        mod_time_text_.emplace(row, info.mod_time);
+    }
+    return order_.size() - 1;
+}
+
+void EntryTable::appendFrom(const EntryTable& other, size_t begin, size_t end) {
+    end = std::min(end, other.size());
+    for (size_t pos = begin; pos < end; ++pos) {
+        Row src = other.order_[pos];
+        Row dst = appendRow(other.rowName(src), other.mode_[src], other.flags_[src], other.icon_[src]);
+        copyRowMetadata(dst, other, src);
+    }
+}
+
+size_t EntryTable::appendRaw(const RawRow& raw) {
+    Row row = appendRow(raw.name, static_cast<mode_t>(raw.mode), raw.flags, raw.icon);
+    size_[row] = raw.size;
+    mtime_[row] = raw.mtime;
+    return order_.size() - 1;
+}
+
+// ---------------------------- 读取 ----------------------------
+
+std::string_view EntryTable::name(size_t pos) const { return rowName(order_[pos]); }
+mode_t EntryTable::mode(size_t pos) const { return static_cast<mode_t>(mode_[order_[pos]]); }
+uint64_t EntryTable::fileSize(size_t pos) const { return size_[order_[pos]]; }
+int64_t EntryTable::mtime(size_t pos) const { return mtime_[order_[pos]]; }
+bool EntryTable::isDir(size_t pos) const { return flags_[order_[pos]] & kDir; }
+bool EntryTable::isRegular(size_t pos) const { return flags_[order_[pos]] & kRegular; }
+bool EntryTable::isSymlink(size_t pos) const { return S_ISLNK(mode_[order_[pos]]); }
+bool EntryTable::isExecutable(size_t pos) const { return (mode_[order_[pos]] & S_IXUSR) != 0; }
+bool EntryTable::isHidden(size_t pos) const { return flags_[order_[pos]] & kHidden; }
+bool EntryTable::statPending(size_t pos) const { return flags_[order_[pos]] & kPending; }
+const std::string& EntryTable::icon(size_t pos) const { return IconText(icon_[order_[pos]]); }
+
+EntryTable::RawRow EntryTable::rawRow(size_t pos) const {
+    Row r = order_[pos];
+    RawRow raw;
+    raw.name = rowName(r);
+    raw.mode = mode_[r];
+    raw.size = size_[r];
+    raw.mtime = mtime_[r];
+    raw.flags = flags_[r];
+    raw.icon = icon_[r];
+    return raw;
+}
+
+std::string EntryTable::permissions(size_t pos) const {
+    Row r = order_[pos];
+    if (flags_[r] & (kPending | kNoPermissions)) return {};
+    return formatPermissions(static_cast<mode_t>(mode_[r]));
+}
+
+std::string EntryTable::modTime(size_t pos) const {
+    Row r = order_[pos];
+    if (flags_[r] & kPending) return {};
+    if (!mod_time_text_.empty()) {
+        auto it = mod_time_text_.find(r);
+        if (it != mod_time_text_.end()) return it->second;
+    }
+    if (flags_[r] & kNoPermissions) return {};
+    return formatModTime(mtime_[r]);
+}
+
+FileManager::DirEntryInfo EntryTable::entry(size_t pos) const {
+    FileManager::DirEntryInfo info;
+    info.name = std::string(name(pos));
+    info.is_dir = isDir(pos);
+    info.is_symlink = isSymlink(pos);
+    info.is_regular = isRegular(pos);
+    info.is_executable = isExecutable(pos);
+    info.is_hidden = isHidden(pos);
+    info.exists = (flags_[order_[pos]] & kExists) != 0;
+    info.file_size = fileSize(pos);
+    info.mod_time = modTime(pos);
+    info.permissions = permissions(pos);
+    info.icon = icon(pos);
+    info.stat_pending = statPending(pos);
+    return info;
+}
+
+std::vector<FileManager::DirEntryInfo> EntryTable::toEntries() const {
+    std::vector<FileManager::DirEntryInfo> entries;
+    entries.reserve(size());
+    for (size_t pos = 0; pos < size(); ++pos) entries.push_back(entry(pos));
+    return entries;
+}
+
+EntryTable EntryTable::fromEntries(const std::vector<FileManager::DirEntryInfo>& entries) {
+    EntryTable table;
+    table.reserve(entries.size());
+    for (const auto& info : entries) table.append(info);
+    return table;
+}
+
+// ---------------------------- 元信息 ----------------------------
+
+void EntryTable::setStat(size_t pos, mode_t lmode, int64_t mtime, uint64_t size, mode_t target_mode) {
+    Row r = order_[pos];
+    mode_t type = S_ISLNK(lmode) ? target_mode : lmode;
+    uint8_t flags = flags_[r] & (kHidden | kExists);
+    if (S_ISDIR(type)) flags |= kDir;
+    if (S_ISREG(type)) flags |= kRegular;
+
+    mode_[r] = static_cast<uint32_t>(lmode);
+    mtime_[r] = mtime;
+    size_[r] = S_ISREG(type) ? size : 0;
+    flags_[r] = flags;
+    icon_[r] = InternIcon(FTB::Icons::GetIconForEntry(std::string(rowName(r)), S_ISDIR(type),
+                                                 (lmode & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0));
+}
+
+void EntryTable::setTreeSize(size_t pos, uint64_t size) {
+    size_[order_[pos]] = size;
+}
+
+void EntryTable::clearPending(size_t pos) {
+    flags_[order_[pos]] &= static_cast<uint8_t>(~kPending);
+}
+
+void EntryTable::copyRowMetadata(Row dst, const EntryTable& other, Row src) {
+    mode_[dst] = other.mode_[src];
+    size_[dst] = other.size_[src];
+    mtime_[dst] = other.mtime_[src];
+    flags_[dst] = other.flags_[src];
+    icon_[dst] = other.icon_[src];
+    mod_time_text_.erase(dst);
+    if (!other.mod_time_text_.empty()) {
+        auto it = other.mod_time_text_.find(src);
+        if (it != other.mod_time_text_.end()) mod_time_text_.emplace(dst, it->second);
+    }
+}
+
+void EntryTable::copyMetadata(size_t pos, const EntryTable& other, size_t other_pos) {
+    copyRowMetadata(order_[pos], other, other.order_[other_pos]);
+}
+
+// ---------------------------- 有序操作 ----------------------------
+
+EntrySortKey EntryTable::rowKey(Row r) const {
+    return EntrySortKey{rowName(r), (flags_[r] & kDir) != 0, size_[r], mtime_[r]};
+}
+
+bool EntryTable::less(size_t a, size_t b, SortMode mode) const {
+    return CompareSortKeys(rowKey(order_[a]), rowKey(order_[b]), mode);
+}
+
+void EntryTable::sort(SortMode mode) {
+    // 先把排序键收集到连续数组，比较时不再经行号间接访问各列
+    std::vector<std::pair<EntrySortKey, Row>> keyed;
+    keyed.reserve(order_.size());
+    for (Row r : order_) keyed.emplace_back(rowKey(r), r);
+    std::sort(keyed.begin(), keyed.end(), [mode](const auto& a, const auto& b) {
+        return CompareSortKeys(a.first, b.first, mode);
+    });
+    for (size_t i = 0; i < keyed.size(); ++i) order_[i] = keyed[i].second;
+}
+
+size_t EntryTable::find(std::string_view name, SortMode mode) const {
+    if (SortModeUsesMetadata(mode)) {
+        for (size_t pos = 0; pos < order_.size(); ++pos) {
+            if (rowName(order_[pos]) == name) return pos;
+        }
+        return npos;
+    }
+
+    // 排序键只取决于名称与是否目录：分别按两种类型定位，再在不区分大小写的等价区间内比对原名
+    for (bool is_dir : {true, false}) {
+        EntrySortKey probe{name, is_dir, 0, 0};
+        auto it = std::lower_bound(order_.begin(), order_.end(), probe,
+                                   [this, mode](Row r, const EntrySortKey& key) {
+                                       return CompareSortKeys(rowKey(r), key, mode);
+                                   });
+        for (; it != order_.end() && !CompareSortKeys(probe, rowKey(*it), mode); ++it) {
+            if (rowName(*it) == name) return static_cast<size_t>(it - order_.begin());
+        }
+    }
+    return npos;
+}
+
+void EntryTable::erase(size_t pos) {
+    order_.erase(order_.begin() + static_cast<std::ptrdiff_t>(pos));
+    ++dead_rows_;
+    if (dead_rows_ > 256 && dead_rows_ > order_.size()) compact();
+}
+
+size_t EntryTable::reposition(size_t pos, SortMode mode) {
+    Row r = order_[pos];
+    order_.erase(order_.begin() + static_cast<std::ptrdiff_t>(pos));
+    auto it = std::upper_bound(order_.begin(), order_.end(), r, [this, mode](Row a, Row b) {
+        return CompareSortKeys(rowKey(a), rowKey(b), mode);
+    });
+    it = order_.insert(it, r);
+    return static_cast<size_t>(it - order_.begin());
+}
+
+void EntryTable::mergeSorted(EntryTable&& chunk, SortMode mode) {
+    if (chunk.empty()) return;
+    chunk.sort(mode);
+    size_t mid = order_.size();
+    appendFrom(chunk, 0, chunk.size());
+    std::inplace_merge(order_.begin(), order_.begin() + static_cast<std::ptrdiff_t>(mid), order_.end(),
+                       [this, mode](Row a, Row b) {
+                           return CompareSortKeys(rowKey(a), rowKey(b), mode);
+                       });
+    chunk.clear();
+}
+
+// 按当前显示顺序重建存储区，丢弃已删除的行
+void EntryTable::compact() {
+    EntryTable packed;
+    size_t name_bytes = 0;
+    for (Row r : order_) name_bytes += name_len_[r];
+    packed.reserve(order_.size(), name_bytes);
+    for (Row r : order_) {
+        Row dst = packed.appendRow(rowName(r), mode_[r], flags_[r], icon_[r]);
+        packed.copyRowMetadata(dst, *this, r);
+    }
+    *this = std::move(packed);
+}
+
+size_t EntryTable::memoryUsage() const {
+    size_t bytes = names_.capacity();
+    bytes += name_off_.capacity() * sizeof(uint32_t);
+    bytes += name_len_.capacity() * sizeof(uint16_t);
+    bytes += mode_.capacity() * sizeof(uint32_t);
+    bytes += size_.capacity() * sizeof(uint64_t);
+    bytes += mtime_.capacity() * sizeof(int64_t);
+    bytes += flags_.capacity() * sizeof(uint8_t);
+    bytes += icon_.capacity() * sizeof(uint16_t);
+    bytes += order_.capacity() * sizeof(Row);
+    for (const auto& [row, text] : mod_time_text_) {
+        bytes += sizeof(row) + sizeof(text) + 2 * sizeof(void*);
+        if (text.capacity() > 15) bytes += text.capacity() + 1;
+    }
+    return bytes;
+}
+
+}  // namespace FTB
@@ -0,0 +1,468 @@
+// FileCopier.cpp - reflink / copy_file_range / sendfile / 缓冲复制
+#include "../include/browser/FileCopier.hpp"
+#include "../include/utils/PerfLogger.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+namespace FTB {
+
+namespace {
+
+enum class Step { Done, Unsupported, Failed, Cancelled };
+
+using Clock = std::chrono::steady_clock;
+
+// 缓冲区按页对齐，内核在页缓存与用户态之间按整页拷贝
+constexpr size_t kBufferAlign = 4096;
+// 每档缓冲区大小测量的块数，以及翻倍所需的吞吐提升
+constexpr int    kProbeChunks = 2;
+constexpr double kGrowGain = 1.1;
+// 小于此大小的文件不预分配：多一次系统调用不值得
+constexpr uintmax_t kPreallocMin = 1u << 20;
+// 不小于此大小的文件按流式复制处理：顺序预读并丢弃用过的页缓存
+constexpr uintmax_t kStreamingSize = 16u << 20;
+// 丢弃页缓存的窗口
+constexpr uintmax_t kDropWindow = 8u << 20;
+// PerfLogger 只记录不小于此大小的文件，避免目录复制时逐个小文件刷屏
+constexpr uintmax_t kPerfLogMin = 1u << 20;
+
+uint64_t elapsedUs(Clock::time_point since) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count());
+}
+
+// 这些错误码表示该方式对这对文件不可用，换下一种方式即可
+bool isUnsupported(int err) {
+    return err == ENOSYS || err == EOPNOTSUPP || err == ENOTSUP || err == EXDEV ||
+           err == EINVAL || err == ENOTTY || err == EBADF || err == EPERM;
+}
+
+bool report(const FileCopier::ChunkFn& on_chunk, uintmax_t bytes, bool hole = false) {
+    return !on_chunk || on_chunk(bytes, hole);
+}
+
+// 复制到文件末尾，而不是某个区段的结尾
+constexpr uintmax_t kToEof = ~uintmax_t{0};
+
+size_t nextChunk(uintmax_t done, uintmax_t end, size_t chunk) {
+    return static_cast<size_t>(std::min<uintmax_t>(chunk, end - done));
+}
+
+#ifdef __linux__
+Step reflink(int src_fd, int dst_fd, uintmax_t size, uintmax_t& done, const FileCopier::ChunkFn& on_chunk) {
+#ifdef FICLONE
+    if (done != 0) return Step::Unsupported;   // 只能整文件克隆
+    if (::ioctl(dst_fd, FICLONE, src_fd) != 0) {
+        return isUnsupported(errno) ? Step::Unsupported : Step::Failed;
+    }
+    done = size;
+    return report(on_chunk, size) ? Step::Done : Step::Cancelled;
+#else
+    (void)src_fd; (void)dst_fd; (void)size; (void)done; (void)on_chunk;
+    return Step::Unsupported;
+#endif
+}
+
+Step copyFileRange(int src_fd, int dst_fd, uintmax_t& done, uintmax_t end, size_t chunk,
+                   const FileCopier::ChunkFn& on_chunk) {
+#ifdef SYS_copy_file_range
+    while (done < end) {
+        loff_t in_off = static_cast<loff_t>(done);
+        loff_t out_off = static_cast<loff_t>(done);
+        ssize_t n = ::syscall(SYS_copy_file_range, src_fd, &in_off, dst_fd, &out_off,
+                              nextChunk(done, end, chunk), 0u);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return isUnsupported(errno) ? Step::Unsupported : Step::Failed;
+        }
+        if (n == 0) return Step::Done;
+        done += static_cast<uintmax_t>(n);
+        if (!report(on_chunk, static_cast<uintmax_t>(n))) return Step::Cancelled;
+    }
+    return Step::Done;
+#else
+    (void)src_fd; (void)dst_fd; (void)done; (void)end; (void)chunk; (void)on_chunk;
+    return Step::Unsupported;
+#endif
+}
+
+Step sendFile(int src_fd, int dst_fd, uintmax_t& done, uintmax_t end, size_t chunk,
+              const FileCopier::ChunkFn& on_chunk) {
+    if (::lseek(dst_fd, static_cast<off_t>(done), SEEK_SET) < 0) return Step::Unsupported;
+    while (done < end) {
+        off_t in_off = static_cast<off_t>(done);
+        ssize_t n = ::sendfile(dst_fd, src_fd, &in_off, nextChunk(done, end, chunk));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return isUnsupported(errno) ? Step::Unsupported : Step::Failed;
+        }
+        if (n == 0) return Step::Done;
+        done += static_cast<uintmax_t>(n);
+        if (!report(on_chunk, static_cast<uintmax_t>(n))) return Step::Cancelled;
+    }
+    return Step::Done;
+}
+#endif
+
+struct FreeDeleter {
+    void operator()(char* p) const { std::free(p); }
+};
+using AlignedBuffer = std::unique_ptr<char, FreeDeleter>;
+
+AlignedBuffer allocAligned(size_t size) {
+    void* p = nullptr;
+    if (::posix_memalign(&p, kBufferAlign, size) != 0) return nullptr;
+    return AlignedBuffer(static_cast<char*>(p));
+}
+
+// 起始缓冲区：不小于 kBufferSize，并取两端文件系统建议的 I/O 大小（NFS / FUSE 上常为数百 KB 到数 MB）
+size_t initialBuffer(int src_fd, int dst_fd, size_t cap) {
+    size_t size = FileCopier::kBufferSize;
+    struct stat st;
+    if (::fstat(src_fd, &st) == 0 && st.st_blksize > 0) size = std::max(size, static_cast<size_t>(st.st_blksize));
+    if (::fstat(dst_fd, &st) == 0 && st.st_blksize > 0) size = std::max(size, static_cast<size_t>(st.st_blksize));
+    return std::min(size, cap);
+}
+
+/**
+ * pread / pwrite 经用户态缓冲区复制。缓冲区从 initialBuffer 开始，每档测量 kProbeChunks 块，
+ * 吞吐比上一档高出 kGrowGain 倍才翻倍，最大为 min(cap, kMaxBufferSize)：
+ * 页缓存命中或高速设备上减少系统调用次数，吞吐不再增长时停在较小的档位，进度与取消仍然及时。
+ * 吞吐只计读写本身的时间，不含回调（限速等待）。
+ */
+Step buffered(int src_fd, int dst_fd, uintmax_t& done, uintmax_t end, size_t cap,
+              const FileCopier::ChunkFn& on_chunk) {
+    cap = std::min(cap, FileCopier::kMaxBufferSize);
+    size_t size = initialBuffer(src_fd, dst_fd, cap);
+    // 只复制一小段时不必分配到上限
+    size_t capacity = end == kToEof ? cap : static_cast<size_t>(std::min<uintmax_t>(cap, std::max<uintmax_t>(end - done, size)));
+    AlignedBuffer buf = allocAligned(capacity);
+    if (!buf) {
+        errno = ENOMEM;
+        return Step::Failed;
+    }
+
+    bool growing = size < capacity;
+    double last_rate = 0;
+    uintmax_t probe_bytes = 0;
+    Clock::duration probe_time{};
+    int probe_chunks = 0;
+    while (done < end) {
+        auto start = Clock::now();
+        ssize_t n = ::pread(src_fd, buf.get(), nextChunk(done, end, size), static_cast<off_t>(done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return Step::Failed;
+        }
+        if (n == 0) return Step::Done;
+        for (ssize_t written = 0; written < n;) {
+            ssize_t w = ::pwrite(dst_fd, buf.get() + written, static_cast<size_t>(n - written),
+                                 static_cast<off_t>(done + written));
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return Step::Failed;
+            }
+            written += w;
+        }
+        done += static_cast<uintmax_t>(n);
+
+        if (growing) {
+            probe_time += Clock::now() - start;
+            probe_bytes += static_cast<uintmax_t>(n);
+            if (++probe_chunks == kProbeChunks) {
+                auto ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(probe_time).count());
+                double rate = static_cast<double>(probe_bytes) / static_cast<double>(ns);
+                if (rate > last_rate * kGrowGain) {
+                    last_rate = rate;
+                    size = std::min(size * 2, capacity);
+                    growing = size < capacity;
+                } else {
+                    growing = false;
+                }
+                probe_bytes = 0;
+                probe_time = {};
+                probe_chunks = 0;
+            }
+        }
+        if (!report(on_chunk, static_cast<uintmax_t>(n))) return Step::Cancelled;
+    }
+    return Step::Done;
+}
+
+// 复制 [done, end)：从 method 开始，某种方式不被支持时从当前偏移换下一种；method 返回最后使用的方式
+Step copyRange(int src_fd, int dst_fd, uintmax_t& done, uintmax_t end, size_t chunk,
+               FileCopier::Method& method, const FileCopier::ChunkFn& on_chunk) {
+    using Method = FileCopier::Method;
+    for (;;) {
+        Step step = Step::Unsupported;
+        switch (method) {
+#ifdef __linux__
+        case Method::CopyFileRange: step = copyFileRange(src_fd, dst_fd, done, end, chunk, on_chunk); break;
+        case Method::Sendfile:      step = sendFile(src_fd, dst_fd, done, end, chunk, on_chunk); break;
+#else
+        case Method::CopyFileRange:
+        case Method::Sendfile:      break;
+#endif
+        case Method::Reflink:       break;   // 整文件克隆由调用方处理
+        case Method::Buffered:      step = buffered(src_fd, dst_fd, done, end, chunk, on_chunk); break;
+        }
+        if (step != Step::Unsupported || method == Method::Buffered) return step;
+        method = static_cast<Method>(static_cast<int>(method) + 1);
+    }
+}
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+// 分配的块明显少于逻辑长度时才按区段复制，普通文件不多付 lseek 的开销
+bool looksSparse(int src_fd, uintmax_t size) {
+    struct stat st;
+    if (::fstat(src_fd, &st) != 0) return false;
+    return static_cast<uintmax_t>(st.st_blocks) * 512 + FileCopier::kBufferSize < size;
+}
+
+/**
+ * 只复制数据区段：SEEK_DATA / SEEK_HOLE 枚举源文件，空洞只报告进度不做 I/O。
+ * 目标已被截断到 done，跳过的区域写入之后自然成为空洞，最后 ftruncate 补上末尾的空洞。
+ * 源文件系统不支持区段查询时返回 Unsupported（此时 done 未改变），由调用方整体复制。
+ */
+Step copySparse(int src_fd, int dst_fd, uintmax_t size, uintmax_t& done, size_t chunk,
+                FileCopier::Method& method, uintmax_t& holes, const FileCopier::ChunkFn& on_chunk) {
+    const uintmax_t start = done;
+    while (done < size) {
+        off_t data = ::lseek(src_fd, static_cast<off_t>(done), SEEK_DATA);
+        if (data < 0) {
+            if (errno != ENXIO) return done == start ? Step::Unsupported : Step::Failed;
+            data = static_cast<off_t>(size);   // 之后全是空洞
+        }
+        uintmax_t data_start = std::min(static_cast<uintmax_t>(data), size);
+        if (data_start > done) {
+            uintmax_t gap = data_start - done;
+            holes += gap;
+            done = data_start;
+            if (!report(on_chunk, gap, true)) return Step::Cancelled;
+        }
+        if (done >= size) break;
+
+        off_t hole = ::lseek(src_fd, static_cast<off_t>(done), SEEK_HOLE);
+        uintmax_t data_end = hole < 0 ? size : std::min(static_cast<uintmax_t>(hole), size);
+        Step step = copyRange(src_fd, dst_fd, done, data_end, chunk, method, on_chunk);
+        if (step != Step::Done) return step;
+        if (done < data_end) break;   // 复制期间源文件变短
+    }
+    if (::ftruncate(dst_fd, static_cast<off_t>(std::max(done, size))) != 0) return Step::Failed;
+    return Step::Done;
+}
+#endif
+
+/**
+ * 预先分配目标 [from, to) 的块，文件系统可以一次分配连续的区段，而不是随每次写入逐步扩展。
+ * FALLOC_FL_KEEP_SIZE 不改变文件长度，中断的复制仍按目标的实际长度续传。
+ * 不支持时（FUSE、部分网络文件系统）忽略，照常复制。
+ */
+bool preallocate(int dst_fd, uintmax_t from, uintmax_t to) {
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    if (to <= from || to - from < kPreallocMin) return false;
+    return ::fallocate(dst_fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(from), static_cast<off_t>(to - from)) == 0;
+#else
+    (void)dst_fd; (void)from; (void)to;
+    return false;
+#endif
+}
+
+/**
+ * 流式复制大文件时不挤掉浏览器正在使用的页缓存：每前进 kDropWindow，
+ * 丢弃这一窗口的源页面，启动目标的异步回写，并丢弃上一窗口的目标页面
+ * （此时回写通常已完成；脏页不会被 DONTNEED 丢弃，所以不能丢刚写入的窗口）。
+ */
+class CacheDropper {
+public:
+    CacheDropper(int src_fd, int dst_fd, uintmax_t start)
+        : src_fd_(src_fd), dst_fd_(dst_fd), prev_(start), window_(start), pos_(start) {
+        ::posix_fadvise(src_fd_, static_cast<off_t>(start), 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    void advance(uintmax_t bytes) {
+        pos_ += bytes;
+        if (pos_ - window_ >= kDropWindow) drop();
+    }
+
+    void finish() {
+        drop();
+        ::posix_fadvise(dst_fd_, static_cast<off_t>(prev_), static_cast<off_t>(window_ - prev_), POSIX_FADV_DONTNEED);
+    }
+
+private:
+    void drop() {
+        if (pos_ <= window_) return;
+        auto off = static_cast<off_t>(window_);
+        auto len = static_cast<off_t>(pos_ - window_);
+        ::posix_fadvise(src_fd_, off, len, POSIX_FADV_DONTNEED);
+#ifdef __linux__
+        ::sync_file_range(dst_fd_, off, len, SYNC_FILE_RANGE_WRITE);
+#endif
+        if (window_ > prev_) {
+            ::posix_fadvise(dst_fd_, static_cast<off_t>(prev_), static_cast<off_t>(window_ - prev_), POSIX_FADV_DONTNEED);
+        }
+        prev_ = window_;
+        window_ = pos_;
+    }
+
+    int       src_fd_;
+    int       dst_fd_;
+    uintmax_t prev_;     // 上一窗口的起点
+    uintmax_t window_;   // 当前窗口的起点
+    uintmax_t pos_;
+};
+
+}  // namespace
+
+FileCopier::Result FileCopier::copyFd(int src_fd, int dst_fd, uintmax_t size,
+                                      const ChunkFn& on_chunk, Method first, size_t kernel_chunk,
+                                      uintmax_t offset) {
+    Result result;
+    uintmax_t done = offset;
+    size_t chunk = std::max<size_t>(kernel_chunk, kBufferSize);
+    // 大小为 0 的伪文件（/proc 等）上内核复制会直接返回 0，只能逐块读到 EOF
+    Method method = size == 0 ? Method::Buffered : first;
+
+    Step step = Step::Unsupported;
+    if (method == Method::Reflink) {
+        auto start = Clock::now();
+#ifdef __linux__
+        step = reflink(src_fd, dst_fd, size, done, on_chunk);
+#endif
+        method = step == Step::Unsupported ? Method::CopyFileRange : Method::Reflink;
+        result.copy_us += elapsedUs(start);
+    }
+    // 需要实际搬运数据：稠密文件预分配目标，大文件顺序预读并在复制后丢弃页缓存
+    if (step == Step::Unsupported) {
+        auto start = Clock::now();
+        bool sparse = false;
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        sparse = size > 0 && looksSparse(src_fd, size);
+#endif
+        bool preallocated = !sparse && preallocate(dst_fd, done, size);
+        std::optional<CacheDropper> dropper;
+        ChunkFn tracked;
+        if (size >= kStreamingSize) {
+            dropper.emplace(src_fd, dst_fd, done);
+            tracked = [&dropper, &on_chunk](uintmax_t bytes, bool hole) {
+                dropper->advance(bytes);
+                return report(on_chunk, bytes, hole);
+            };
+        }
+        const ChunkFn& chunk_fn = dropper ? tracked : on_chunk;
+        result.prealloc_us = elapsedUs(start);
+
+        start = Clock::now();
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        if (sparse) step = copySparse(src_fd, dst_fd, size, done, chunk, method, result.holes, chunk_fn);
+#endif
+        if (step == Step::Unsupported) step = copyRange(src_fd, dst_fd, done, kToEof, chunk, method, chunk_fn);
+        int err = errno;
+        if (dropper) dropper->finish();
+        // 复制期间源文件变短：释放预分配在末尾之后的块
+        if (preallocated && step == Step::Done && done < size) ::ftruncate(dst_fd, static_cast<off_t>(done));
+        errno = err;
+        result.copy_us += elapsedUs(start);
+    }
+
+    result.method = method;
+    result.bytes = done;
+    if (step == Step::Done) {
+        result.ok = true;
+    } else if (step == Step::Cancelled) {
+        result.cancelled = true;
+    } else {
+        result.error = errno;
+    }
+    return result;
+}
+
+FileCopier::Result FileCopier::copyFile(const std::string& src, const std::string& dst,
+                                        const ChunkFn& on_chunk, Method first, size_t kernel_chunk,
+                                        uintmax_t offset) {
+    Result result;
+    auto start = Clock::now();
+    int src_fd = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd < 0) {
+        result.error = errno;
+        return result;
+    }
+    struct stat st;
+    if (::fstat(src_fd, &st) != 0) {
+        result.error = errno;
+        ::close(src_fd);
+        return result;
+    }
+    offset = std::min(offset, static_cast<uintmax_t>(st.st_size));
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (offset == 0 ? O_TRUNC : 0);
+    int dst_fd = ::open(dst.c_str(), flags, st.st_mode & 0777);
+    if (dst_fd < 0) {
+        result.error = errno;
+        ::close(src_fd);
+        return result;
+    }
+    if (offset > 0) {
+        // 丢弃检查点之后可能不完整的尾部；目标比检查点短时从目标末尾继续
+        struct stat dst_st;
+        if (::fstat(dst_fd, &dst_st) == 0) offset = std::min(offset, static_cast<uintmax_t>(dst_st.st_size));
+        if (::ftruncate(dst_fd, static_cast<off_t>(offset)) != 0) {
+            result.error = errno;
+            ::close(src_fd);
+            ::close(dst_fd);
+            return result;
+        }
+    }
+    uint64_t open_us = elapsedUs(start);
+
+    result = copyFd(src_fd, dst_fd, static_cast<uintmax_t>(st.st_size), on_chunk, first, kernel_chunk, offset);
+    result.open_us = open_us;
+    start = Clock::now();
+    ::close(src_fd);
+    if (::close(dst_fd) != 0 && result.ok) {
+        result.ok = false;
+        result.error = errno;
+    }
+    result.close_us = elapsedUs(start);
+
+    if (PerfLogger::IsEnabled() && static_cast<uintmax_t>(st.st_size) >= kPerfLogMin) {
+        uintmax_t copied = result.bytes - offset - result.holes;
+        double mb_s = result.copy_us ? static_cast<double>(copied) / static_cast<double>(result.copy_us) : 0.0;
+        PERF_LOG("FileCopier", dst + " " + std::to_string(result.bytes) + "B " + methodName(result.method)
+                 + (result.ok ? "" : result.cancelled ? " cancelled" : " failed")
+                 + " open=" + std::to_string(result.open_us) + "us"
+                 + " prealloc=" + std::to_string(result.prealloc_us) + "us"
+                 + " copy=" + std::to_string(result.copy_us) + "us"
+                 + " close=" + std::to_string(result.close_us) + "us"
+                 + " (" + std::to_string(static_cast<int>(mb_s)) + " MB/s)");
+    }
+    return result;
+}
+
+const char* FileCopier::methodName(Method method) {
+    switch (method) {
+    case Method::Reflink:       return "reflink";
+    case Method::CopyFileRange: return "copy_file_range";
+    case Method::Sendfile:      return "sendfile";
+    case Method::Buffered:      return "buffered";
+    }
+    return "unknown";
+}
+
+}  // namespace FTB
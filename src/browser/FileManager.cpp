@@ -1,6 +1,14 @@
 // FileManager.cpp
 #include "../include/browser/FileManager.hpp"
 #include "../include/browser/DirectoryHistory.hpp"
+#include "../include/browser/DirScanner.hpp"
+#include "../include/browser/DirSnapshot.hpp"
+#include "../include/browser/DirWatcher.hpp"
+#include "../include/browser/DiskUsage.hpp"
+#include "../include/browser/EntryTable.hpp"
+#include "../include/browser/IoRing.hpp"
+#include "../include/browser/SizeIndex.hpp"
+#include "../include/browser/StatFanout.hpp"
 #include "../include/renderer/IconMapper.hpp"
 #include "../include/browser/SortMode.hpp"
 #include "../include/config/ConfigManager.hpp"
@@ -14,6 +22,8 @@
 #include <map>                                // 字典容器，用于缓存
 #include <vector>                             // 动态数组
 #include <chrono>                             // 时间操作
+#include <condition_variable>                 // 清理线程的唤醒
+#include <deque>                              // 待校验目录队列
 #include <cstdlib>                            // getenv
 #include <cstring>                            // C 字符串操作
 #include <numeric>                            // 数值算法
@@ -25,7 +35,14 @@
 #include <atomic>                             // 原子操作
 #include <sstream>                            // 字符串流
 #include <unordered_map>                      // 哈希表
+#include <unordered_set>                      // 哈希集合
 #include <set>                                // 集合容器
+#include <ctime>                              // localtime_r / strftime
+#include <climits>                            // NAME_MAX
+#include <dirent.h>                           // DT_UNKNOWN
+#include <fcntl.h>                            // open
+#include <sys/stat.h>                         // statx
+#include <unistd.h>                           // close
 
 #ifdef FTB_ENABLE_SSH
 #include "../include/remote/SSHConnection.hpp"
@@ -46,18 +63,40 @@ Connection::SSHConnection* getSSHConnection() { return g_ssh_conn; }
 std::mutex cache_mutex;
 
 // 优化的LRU缓存 - 严格控制内存用量
+// 条目数与字节数同时限制；字节预算防止少数大目录或大文件片段撑满内存
+constexpr size_t kDirCacheBytes     = 8u << 20;
+constexpr size_t kSizeCacheBytes    = 1u << 20;
+constexpr size_t kContentCacheBytes = 16u << 20;
+constexpr size_t kEntryCacheBytes   = 32u << 20;
+
+// 各缓存的过期时间；initializeCacheSystem 重建缓存时沿用，启动后的行为与静态初始化一致
+constexpr std::chrono::seconds kDirCacheTtl{600};
+constexpr std::chrono::seconds kSizeCacheTtl{900};
+constexpr std::chrono::seconds kContentCacheTtl{120};
+constexpr std::chrono::seconds kEntryCacheTtl{300};
+
+// 条目表与内容缓存开启准入过滤：模糊查找、search_files 等一次性扫描不会冲掉常用目录
+template <typename Cache>
+static std::unique_ptr<Cache> makeCache(size_t max_entries, size_t max_bytes,
+                                        std::chrono::seconds ttl, bool admission = false) {
+    auto cache = std::make_unique<Cache>(max_entries, ttl);
+    cache->set_max_bytes(max_bytes);
+    cache->set_admission_filter(admission);
+    return cache;
+}
+
 // 目录缓存：较小容量（内容缓存较多，目录列表通常不会频繁切换）
-std::unique_ptr<FTB::LRUCache<std::string, DirectoryCache>> lru_dir_cache = 
-    std::make_unique<FTB::LRUCache<std::string, DirectoryCache>>(100, std::chrono::seconds(600));
+std::unique_ptr<FTB::SharedLRUCache<std::string, DirectoryCache>> lru_dir_cache = 
+    makeCache<FTB::SharedLRUCache<std::string, DirectoryCache>>(100, kDirCacheBytes, kDirCacheTtl);
 // 大小缓存：中等容量（每个条目仅8字节）
 std::unique_ptr<FTB::LRUCache<std::string, uintmax_t>> lru_size_cache = 
-    std::make_unique<FTB::LRUCache<std::string, uintmax_t>>(2000, std::chrono::seconds(900));
-// 内容缓存：极小容量（文件内容可能很大，限制条目数控制内存）
-std::unique_ptr<FTB::LRUCache<std::string, std::string>> lru_content_cache = 
-    std::make_unique<FTB::LRUCache<std::string, std::string>>(50, std::chrono::seconds(120));
-// DirEntryInfo列表缓存：较小容量（每个条目附带多个字符串）
-std::unique_ptr<FTB::LRUCache<std::string, std::vector<DirEntryInfo>>> lru_entry_cache = 
-    std::make_unique<FTB::LRUCache<std::string, std::vector<DirEntryInfo>>>(50, std::chrono::seconds(300));
+    makeCache<FTB::LRUCache<std::string, uintmax_t>>(2000, kSizeCacheBytes, kSizeCacheTtl);
+// 内容缓存：极小容量（文件内容可能很大，限制条目数与字节数控制内存）
+std::unique_ptr<FTB::SharedLRUCache<std::string, std::string>> lru_content_cache = 
+    makeCache<FTB::SharedLRUCache<std::string, std::string>>(50, kContentCacheBytes, kContentCacheTtl, true);
+// 条目表缓存：较小容量（列式存储，每个条目约 30 字节加名称）
+std::unique_ptr<FTB::SharedLRUCache<std::string, FTB::EntryTable>> lru_entry_cache = 
+    makeCache<FTB::SharedLRUCache<std::string, FTB::EntryTable>>(50, kEntryCacheBytes, kEntryCacheTtl, true);
 
 // 缓存统计信息
 std::atomic<size_t> cache_hits{0};
@@ -69,9 +108,19 @@ std::atomic<size_t> preload_hits{0};
 std::unordered_map<std::string, std::atomic<uint32_t>> path_access_count;
 std::mutex path_tracking_mutex;
 
-// 缓存清理线程
+// 缓存清理线程：定期清理过期项并重写目录快照，也负责校验从快照取出的目录
 std::thread cache_cleanup_thread;
 std::atomic<bool> cache_cleanup_running{false};
+static std::mutex cleanup_mutex;
+static std::condition_variable cleanup_cv;
+static std::deque<std::string> revalidate_queue;
+
+// 目录快照：启动时映射，条目表未命中时先于 readdir 查询
+static std::mutex snapshot_mutex;
+static std::shared_ptr<const FTB::DirSnapshot> dir_snapshot;
+static std::string dir_snapshot_file;
+// 重写快照时从旧快照沿用的目录数上限（缓存中的目录总是写入）
+constexpr size_t kSnapshotCarryOverDirs = 500;
 
 // ---------------------------- 辅助函数 ----------------------------
 
@@ -85,6 +134,119 @@ bool isDirectory(const std::string & path) {
     return fs::is_directory(path, ec);
 }
 
+// ---------------------------- 目录监听 ----------------------------
+// lru_dir_cache / lru_entry_cache 中的本地目录由 DirWatcher 监听，
+// 变更事件直接修补缓存，不再依赖 mtime 轮询；目录离开两个缓存后取消监听
+
+// 串行化监听的建立与释放，避免驱逐回调与新的 put 交错导致误取消
+static std::mutex watch_mutex;
+// 每个目录收到变更的次数；加载前后不一致说明结果可能已过时，不写入缓存
+static std::unordered_map<std::string, uint64_t> dir_change_seq;
+// 由缓存建立的监听；其他模块直接监听的目录不归这里释放
+static std::unordered_set<std::string> cache_watched_dirs;
+static std::mutex change_listener_mutex;
+static DirectoryChangeListener change_listener;
+
+static void applyDirectoryChanges(const std::string& dir,
+                                  const std::vector<FTB::DirWatcher::Change>& changes);
+
+static bool isDirectoryCached(const std::string& dir) {
+    return lru_dir_cache->contains(dir) || lru_entry_cache->contains(dir);
+}
+
+static void releaseDirectoryWatch(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(watch_mutex);
+    if (!isDirectoryCached(dir)) {
+        if (cache_watched_dirs.erase(dir)) FTB::DirWatcher::instance().unwatch(dir);
+        dir_change_seq.erase(dir);
+    }
+}
+
+// lru_dir_cache 会被 initializeCacheSystem 重建，需要重新挂接
+static void installDirCacheHook() {
+    lru_dir_cache->set_eviction_listener([](const std::string& dir) { releaseDirectoryWatch(dir); });
+}
+
+static void installWatchHooks() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        FTB::DirWatcher::instance().addListener(applyDirectoryChanges);
+        installDirCacheHook();
+        lru_entry_cache->set_eviction_listener([](const std::string& dir) { releaseDirectoryWatch(dir); });
+    });
+}
+
+/**
+ * 开始监听即将写入缓存的目录，并返回当前变更序号
+ * 必须在读取目录之前调用，保证读取期间发生的变更都能收到事件
+ */
+static uint64_t watchCachedDirectory(const std::string& dir) {
+    installWatchHooks();
+    std::lock_guard<std::mutex> lock(watch_mutex);
+    auto& watcher = FTB::DirWatcher::instance();
+    if (!watcher.isWatched(dir) && watcher.watch(dir)) cache_watched_dirs.insert(dir);
+    return dir_change_seq[dir];
+}
+
+// 读取期间目录是否没有变更（未被监听时无从判断，视为未变更，由 mtime 校验兜底）
+static bool directoryUnchangedSince(const std::string& dir, uint64_t seq) {
+    std::lock_guard<std::mutex> lock(watch_mutex);
+    auto it = dir_change_seq.find(dir);
+    return it == dir_change_seq.end() || it->second == seq;
+}
+
+static void notifyDirectoryChanged(const std::string& dir) {
+    DirectoryChangeListener listener;
+    {
+        std::lock_guard<std::mutex> lock(change_listener_mutex);
+        listener = change_listener;
+    }
+    if (listener) listener(dir);
+}
+
+void setDirectoryChangeListener(DirectoryChangeListener listener) {
+    std::lock_guard<std::mutex> lock(change_listener_mutex);
+    change_listener = std::move(listener);
+}
+
+bool isDirectoryWatched(const std::string& path) {
+    return FTB::DirWatcher::instance().isWatched(path);
+}
+
+// ---------------------------- 目录快照 ----------------------------
+
+static std::shared_ptr<const FTB::DirSnapshot> currentSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    return dir_snapshot;
+}
+
+/**
+ * 从快照取出目录的条目表并写入缓存（调用前须已 watchCachedDirectory）
+ * 目录 mtime 未变保证名称集合未变；子项被原地修改不会更新目录 mtime，
+ * 交给清理线程在后台重新 stat 校验
+ * @return 不在快照中、已失效或读取期间发生变更时返回空指针
+ */
+static std::shared_ptr<const FTB::EntryTable> loadFromSnapshot(const std::string& path, uint64_t seq) {
+    auto snapshot = currentSnapshot();
+    if (!snapshot) return nullptr;
+    auto table = snapshot->load(path);
+    if (!table) return nullptr;
+
+    auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
+    auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
+    if (mode != snapshot->sortMode()) table->sort(mode);
+    if (!directoryUnchangedSince(path, seq)) return nullptr;
+
+    auto shared = std::make_shared<const FTB::EntryTable>(std::move(*table));
+    lru_entry_cache->put(path, shared);
+    {
+        std::lock_guard<std::mutex> lock(cleanup_mutex);
+        revalidate_queue.push_back(path);
+    }
+    cleanup_cv.notify_one();
+    return shared;
+}
+
 /**
  * 获取指定目录下的所有文件和子目录名称（不包括 "." 和 ".."）
  * @param path 要读取的目录路径
@@ -108,66 +270,109 @@ std::vector<std::string> getDirectoryContents(const std::string & path) {
 
     trackPathAccess(path);
     
+    // 被监听的目录由事件保持最新，无需再 stat 校验 mtime
     auto cached_result = lru_dir_cache->get(path);
-    if (cached_result.has_value() && cached_result->is_still_valid(path)) {
+    if (cached_result &&
+        (isDirectoryWatched(path) || cached_result->is_still_valid(path))) {
         cache_hits.fetch_add(1);
         return cached_result->contents;
     }
     
     cache_misses.fetch_add(1);
     std::vector<std::string> contents;  // 存储结果的字符串向量
-    contents.reserve(1000);  // 预分配空间，减少重新分配
-    
-    try {
-        // 使用 C++17 文件系统库遍历目录
-        for (const auto& entry : fs::directory_iterator(path)) {
-            // 获取当前条目的文件名/目录名
-            std::string name;
-            name.reserve(256);  // 预分配常用字符串长度
-            name = entry.path().filename().string();
-            
-            // 过滤掉 "." 和 ".." 这两个特殊目录
-            if (name != "." && name != "..")
-                contents.push_back(name);  // 将有效名称添加到结果向量中
+
+    uint64_t seq = watchCachedDirectory(path);
+    if (auto table = loadFromSnapshot(path, seq)) {
+        // 快照命中：无需 readdir
+        contents.reserve(table->size());
+        for (size_t pos = 0; pos < table->size(); ++pos) {
+            contents.emplace_back(table->name(pos));
         }
-        
-        // 将结果缓存到LRU缓存中
-        DirectoryCache cache;
-        cache.contents = contents;
-        cache.valid = true;
-        cache.last_update = std::chrono::system_clock::now();
-        cache.file_mod_times.resize(contents.size());
-        
-        // 记录文件修改时间
-        for (size_t i = 0; i < contents.size(); ++i) {
-            try {
-                auto full_path = fs::path(path) / contents[i];
-                auto mod_time = fs::last_write_time(full_path);
-                cache.file_mod_times[i] = std::chrono::system_clock::from_time_t(
-                    std::chrono::duration_cast<std::chrono::seconds>(
-                        mod_time.time_since_epoch()).count());
-            } catch (...) {
-                cache.file_mod_times[i] = std::chrono::system_clock::now();
-            }
+    } else {
+        // 仅需名称：getdents64 批量读取，不做任何 stat
+        FTB::DirScanner scanner(path);
+        if (!scanner.ok()) {
+            releaseDirectoryWatch(path);
+            return contents;  // 无法打开时不写入缓存
+        }
+        std::vector<FTB::RawDirEntry> raw_entries;
+        raw_entries.reserve(256);
+        while (scanner.next(raw_entries)) {
+        }
+        contents.reserve(raw_entries.size());
+        for (auto& raw : raw_entries) {
+            contents.push_back(std::move(raw.name));
         }
-        
-        lru_dir_cache->put(path, cache);
-        
-    } catch (const std::exception &) {
+    }
+
+    // 将结果缓存到LRU缓存中
+    DirectoryCache cache;
+    cache.contents = contents;
+    cache.valid = true;
+    cache.last_update = std::chrono::system_clock::now();
+    if (directoryUnchangedSince(path, seq)) {
+        lru_dir_cache->put(path, std::move(cache));
+    } else {
+        releaseDirectoryWatch(path);
     }
 
     return contents;  // 返回包含所有条目名称的向量
 }
 
-std::vector<DirEntryInfo> getDirectoryEntries(const std::string& path) {
+// 名称以 '\0' 结尾的副本：表中的名称首尾相接
+static void copyEntryName(std::string_view name, char (&buf)[NAME_MAX + 1]) {
+    size_t len = std::min(name.size(), sizeof(buf) - 1);
+    std::memcpy(buf, name.data(), len);
+    buf[len] = '\0';
+}
+
+/**
+ * 补全条目的元信息
+ * 对每个条目只发起一次最小掩码的 statx（符号链接额外解析一次目标类型与大小）
+ * 会在 StatFanout 的工作线程上并发调用，只写入第 pos 行
+ * @param dirfd 所在目录的文件描述符
+ * @param table 条目表
+ * @param pos   appendPending() 追加的条目位置
+ * @return stat 失败（条目已不存在）时返回 false
+ */
+static bool fillEntryMetadata(int dirfd, FTB::EntryTable& table, size_t pos) {
+    FTB::EntryStat st;
+    constexpr unsigned kFields = FTB::DirScanner::kStatMode | FTB::DirScanner::kStatSize |
+                                 FTB::DirScanner::kStatMtime;
+    char name_buf[NAME_MAX + 1];
+    copyEntryName(table.name(pos), name_buf);
+
+    if (!FTB::DirScanner::statAt(dirfd, name_buf, kFields, st)) {
+        table.clearPending(pos);
+        return false;  // 条目在扫描后被删除或无权限：保留 d_type 推断的结果
+    }
+
+    mode_t target_mode = 0;
+    uint64_t size = st.size;
+    if (S_ISLNK(st.mode)) {
+        // 与 fs::directory_entry::status() 一致：类型与大小取自链接目标
+        FTB::EntryStat target;
+        size = 0;
+        if (FTB::DirScanner::statAt(dirfd, name_buf,
+                                    FTB::DirScanner::kStatType | FTB::DirScanner::kStatSize,
+                                    target, /*follow=*/true)) {
+            target_mode = target.mode;
+            size = target.size;
+        }
+    }
+    table.setStat(pos, st.mode, st.mtime_sec, size, target_mode);
+    return true;
+}
+
+std::shared_ptr<const FTB::EntryTable> getSharedEntryTable(const std::string& path) {
 
 
 
 #ifdef FTB_ENABLE_SSH
     if (g_ssh_conn && g_ssh_conn->isConnected()) {
         auto sftp_entries = g_ssh_conn->listDirectory(path);
-        std::vector<DirEntryInfo> entries;
-        entries.reserve(sftp_entries.size());
+        FTB::EntryTable table;
+        table.reserve(sftp_entries.size());
         for (const auto& se : sftp_entries) {
             DirEntryInfo info;
             info.name = se.name;
@@ -179,100 +384,290 @@ std::vector<DirEntryInfo> getDirectoryEntries(const std::string& path) {
             info.file_size = se.file_size;
             info.mod_time = se.mod_time;
             info.icon = FTB::Icons::GetIconForPath(std::filesystem::path(se.name), se.is_directory);
-            entries.push_back(std::move(info));
+            table.append(info);
         }
         {
             auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
             auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
-            FTB::SortEntries(entries, mode);
+            table.sort(mode);
         }
-        lru_entry_cache->put(path, entries);
-        return entries;
+        auto shared = std::make_shared<const FTB::EntryTable>(std::move(table));
+        lru_entry_cache->put(path, shared);
+        return shared;
     }
 #endif
 
-    auto cached = lru_entry_cache->get(path);
-    if (cached.has_value()) {
-        return cached.value();
+    if (auto cached = lru_entry_cache->get(path)) {
+        return cached;
     }
 
-    std::vector<DirEntryInfo> entries;
-    entries.reserve(256);
+    return loadDirectoryEntries(path, nullptr, nullptr);
+}
 
-    try {
-        for (const auto& entry : fs::directory_iterator(path, fs::directory_options::skip_permission_denied)) {
-            DirEntryInfo info;
-            info.name = entry.path().filename().string();
+FTB::EntryTable getEntryTable(const std::string& path) {
+    return *getSharedEntryTable(path);
+}
 
-            if (info.name == "." || info.name == "..") continue;
+FTB::EntryTable getEntryTable(const std::string& path, FTB::SortMode mode) {
+    auto table = getEntryTable(path);
+    table.sort(mode);
+    return table;
+}
 
-            auto sft = entry.symlink_status();
-            info.exists = true;
-            info.is_hidden = (!info.name.empty() && info.name[0] == '.');
-            info.is_symlink = sft.type() == fs::file_type::symlink;
-            info.is_dir = sft.type() == fs::file_type::directory;
-            info.is_regular = sft.type() == fs::file_type::regular;
-
-            if (info.is_symlink) {
-                auto ft = entry.status();
-                info.is_dir = ft.type() == fs::file_type::directory;
-                info.is_regular = ft.type() == fs::file_type::regular;
-            }
+std::vector<DirEntryInfo> getDirectoryEntries(const std::string& path) {
+    return getSharedEntryTable(path)->toEntries();
+}
 
-            if (info.is_regular) {
-                info.file_size = entry.file_size();
-            }
+std::shared_ptr<const FTB::EntryTable> loadDirectoryEntries(
+    const std::string& path,
+    const EntryBatchCallback& on_names,
+    const EntryBatchCallback& on_batch,
+    const std::atomic<bool>* cancel) {
+    FTB::EntryTable entries;
+    auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+
+    uint64_t seq = watchCachedDirectory(path);
+    if (auto table = loadFromSnapshot(path, seq)) {
+        return table;  // 快照命中：无需 readdir 与 stat，直接作为最终结果
+    }
+
+    // 读取之前记录目录的 DirStamp，之后的变更会让它与目录不再一致
+    FTB::DirStamp stamp;
+    if (FTB::DirSnapshot::stampOf(path, stamp)) entries.setDirStamp(stamp);
 
-            auto perms = sft.permissions();
-            info.is_executable = (perms & fs::perms::owner_exec) != fs::perms::none;
-
-            static const char kPermChars[] = "rwxrwxrwx";
-            static const fs::perms kPermBits[] = {
-                fs::perms::owner_read,  fs::perms::owner_write, fs::perms::owner_exec,
-                fs::perms::group_read,  fs::perms::group_write, fs::perms::group_exec,
-                fs::perms::others_read, fs::perms::others_write, fs::perms::others_exec
-            };
-            char perm_buf[11];
-            perm_buf[0] = info.is_symlink ? 'l' : info.is_dir ? 'd' : info.is_regular ? '-' : '?';
-            for (int i = 0; i < 9; ++i)
-                perm_buf[1 + i] = (perms & kPermBits[i]) != fs::perms::none ? kPermChars[i] : '-';
-            perm_buf[10] = '\0';
-            info.permissions = std::string(perm_buf, 10);
-
-            auto ftime = entry.last_write_time();
-            auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
-            std::time_t cftime = std::chrono::system_clock::to_time_t(sctp);
-            char time_buf[20];
-            if (std::strftime(time_buf, sizeof(time_buf), "%Y-%m-%d %H:%M", std::localtime(&cftime)))
-                info.mod_time = time_buf;
-            else
-                info.mod_time.clear();
-
-            info.icon = FTB::Icons::GetIconForPath(entry.path(), info.is_dir);
-
-            entries.push_back(std::move(info));
+    // getdents64 批量读取名称与 d_type；首批立即交付，此后每满 kNameChunkSize 条交付一次
+    FTB::DirScanner scanner(path);
+    {
+        std::vector<FTB::RawDirEntry> raw_entries;
+        raw_entries.reserve(256);
+        size_t published = 0;
+        while (scanner.next(raw_entries)) {
+            if (cancelled()) {
+                releaseDirectoryWatch(path);
+                return std::make_shared<const FTB::EntryTable>();
+            }
+            for (const auto& raw : raw_entries) {
+                entries.appendPending(raw.name, raw.type);
+            }
+            raw_entries.clear();
+            if (on_names && (published == 0 || entries.size() - published >= kNameChunkSize)) {
+                on_names(entries, published, entries.size());
+                published = entries.size();
+            }
+        }
+        if (on_names && entries.size() > published) {
+            on_names(entries, published, entries.size());
         }
-    } catch (const std::exception&) {
+    }
+
+    // statx 并行分发，按原顺序分批交付
+    const int dirfd = scanner.fd();
+    FTB::StatFanout::run(
+        entries.size(),
+        [&entries, dirfd, &cancelled](size_t i) {
+            if (!cancelled()) fillEntryMetadata(dirfd, entries, i);
+        },
+        [&entries, &on_batch, &cancelled](size_t begin, size_t end) {
+            if (on_batch && !cancelled()) on_batch(entries, begin, end);
+        });
+    if (cancelled()) {
+        releaseDirectoryWatch(path);
+        return std::make_shared<const FTB::EntryTable>();
     }
 
     // 根据配置的排序模式进行排序
     {
         auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
         auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
-        FTB::SortEntries(entries, mode);
+        entries.sort(mode);
     }
 
-    // 存入LRU缓存
-    lru_entry_cache->put(path, entries);
+    // 存入LRU缓存（与返回值共享，大目录不复制）；读取期间目录已变化则不缓存，变更通知会触发重新加载
+    auto shared = std::make_shared<const FTB::EntryTable>(std::move(entries));
+    if (scanner.ok() && directoryUnchangedSince(path, seq)) {
+        lru_entry_cache->put(path, shared);
+    } else {
+        releaseDirectoryWatch(path);
+    }
 
-    return entries;
+    return shared;
 }
 
 std::vector<DirEntryInfo> getDirectoryEntries(const std::string& path, FTB::SortMode mode) {
-    auto entries = getDirectoryEntries(path);
-    FTB::SortEntries(entries, mode);
-    return entries;
+    return getEntryTable(path, mode).toEntries();
+}
+
+// 目录自身与发生变化的子项的大小缓存、文件内容缓存均已失效；
+// 原地改写文件不改变目录的 mtime，持久化大小索引中该目录的记录也一并移除
+static void invalidateChildCaches(const std::string& dir,
+                                  const std::vector<FTB::DirWatcher::Change>& changes) {
+    using Change = FTB::DirWatcher::Change;
+    const std::string prefix = (dir == "/") ? dir : dir + "/";
+    std::vector<std::string> touched;
+    lru_size_cache->erase(dir);
+    FTB::SizeIndex::instance().forget(dir);
+    for (const auto& change : changes) {
+        if (change.kind == Change::Rescan) continue;
+        std::string child = prefix + change.name;
+        lru_size_cache->erase(child);
+        if (change.kind != Change::Created) touched.push_back(child + ":");
+    }
+    if (!touched.empty()) {
+        lru_content_cache->erase_if([&touched](const std::string& key) {
+            for (const auto& p : touched) {
+                if (key.compare(0, p.size(), p) == 0) return true;
+            }
+            return false;
+        });
+    }
+}
+
+enum class PatchResult { NotCached, Patched, Failed };
+
+/**
+ * 将变更修补进目录的缓存
+ * 条目列表按名称删除旧条目，对新建/修改的条目单独 statx 后二分插入到排序位置，
+ * 单个条目的代价为 O(log n) 定位加一次元素移动，无需重新读取与排序整个目录
+ * （大小/时间排序下查找旧条目退化为线性扫描，插入仍为二分）
+ * @return 目录不在缓存中返回 NotCached；目录无法打开返回 Failed
+ */
+static PatchResult patchCachedDirectory(const std::string& dir,
+                                        const std::vector<FTB::DirWatcher::Change>& changes) {
+    using Change = FTB::DirWatcher::Change;
+    // 缓存中的快照可能正被其他线程持有，修补在副本上进行后整体替换
+    auto cached_entries = lru_entry_cache->get(dir);
+    auto cached_listing = lru_dir_cache->get(dir);
+    if (!cached_entries && !cached_listing) return PatchResult::NotCached;
+
+    int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) return PatchResult::Failed;
+
+    if (cached_entries) {
+        auto entries = std::make_shared<FTB::EntryTable>(*cached_entries);
+        // 修补后的列表与任何时刻的 DirStamp 都无法对应，不再写入快照，直到重新读取
+        entries->setDirStamp({});
+        auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
+        auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
+        for (const auto& change : changes) {
+            size_t pos = entries->find(change.name, mode);
+            if (pos != FTB::EntryTable::npos) entries->erase(pos);
+            if (change.kind == Change::Deleted) continue;
+
+            pos = entries->appendPending(change.name, DT_UNKNOWN);
+            if (!fillEntryMetadata(dirfd, *entries, pos)) {
+                entries->erase(pos);  // 事件到达前已被删除
+                continue;
+            }
+            entries->reposition(pos, mode);
+        }
+        lru_entry_cache->put(dir, std::move(entries));
+    }
+
+    if (cached_listing) {
+        auto listing = std::make_shared<DirectoryCache>(*cached_listing);
+        auto& names = listing->contents;
+        for (const auto& change : changes) {
+            bool present = std::find(names.begin(), names.end(), change.name) != names.end();
+            if (change.kind == Change::Deleted && present) {
+                names.erase(std::remove(names.begin(), names.end(), change.name), names.end());
+            } else if (change.kind == Change::Created && !present) {
+                names.push_back(change.name);
+            }
+        }
+        listing->last_update = std::chrono::system_clock::now();
+        lru_dir_cache->put(dir, std::move(listing));
+    }
+
+    ::close(dirfd);
+    return PatchResult::Patched;
+}
+
+static void bumpChangeSeq(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(watch_mutex);
+    ++dir_change_seq[dir];
+}
+
+/**
+ * 将 DirWatcher 报告的变更应用到缓存（在监听线程上调用）
+ * Rescan 或目录无法打开时整体丢弃该目录的缓存
+ * @param dir     发生变化的目录
+ * @param changes 合并后的变更列表
+ */
+static void applyDirectoryChanges(const std::string& dir,
+                                  const std::vector<FTB::DirWatcher::Change>& changes) {
+    if (changes.empty()) return;
+    bumpChangeSeq(dir);
+    invalidateChildCaches(dir, changes);
+
+    PatchResult result = PatchResult::Failed;
+    if (changes.front().kind != FTB::DirWatcher::Change::Rescan) {
+        result = patchCachedDirectory(dir, changes);
+    } else if (!isDirectoryCached(dir)) {
+        result = PatchResult::NotCached;
+    }
+
+    if (result == PatchResult::NotCached) {
+        releaseDirectoryWatch(dir);  // 缓存已过期，不再需要监听
+        return;
+    }
+    if (result == PatchResult::Failed) {
+        lru_entry_cache->erase(dir);
+        lru_dir_cache->erase(dir);
+    }
+    notifyDirectoryChanged(dir);
+}
+
+// 本地文件操作完成后同步修补缓存；随后到达的 inotify 事件会再次应用同样的变更，结果相同
+static void applyLocalChanges(const std::string& dir,
+                              const std::vector<FTB::DirWatcher::Change>& changes) {
+    if (dir.empty()) return;
+    bumpChangeSeq(dir);
+    invalidateChildCaches(dir, changes);
+    if (patchCachedDirectory(dir, changes) == PatchResult::Failed) {
+        lru_entry_cache->erase(dir);
+        lru_dir_cache->erase(dir);
+    }
+}
+
+static void applyLocalChange(const fs::path& path, FTB::DirWatcher::Change::Kind kind) {
+    std::string name = path.filename().string();
+    if (name.empty()) return;
+    applyLocalChanges(path.parent_path().string(), {{kind, name}});
+}
+
+// 路径本身作为目录键的缓存（被删除或改名的目录）
+static void dropDirectoryCaches(const std::string& path) {
+    lru_dir_cache->erase(path);
+    lru_entry_cache->erase(path);
+    lru_size_cache->erase(path);
+}
+
+void patchCacheOnCreate(const std::string& path) {
+    applyLocalChange(fs::path(path), FTB::DirWatcher::Change::Created);
+}
+
+void patchCacheOnRemove(const std::string& path) {
+    applyLocalChange(fs::path(path), FTB::DirWatcher::Change::Deleted);
+    dropDirectoryCaches(path);
+}
+
+void patchCacheOnRename(const std::string& oldPath, const std::string& newPath) {
+    fs::path from(oldPath), to(newPath);
+    if (from.parent_path() == to.parent_path()) {
+        // 同目录改名：一次打开目录完成删除与插入
+        applyLocalChanges(from.parent_path().string(), {
+            {FTB::DirWatcher::Change::Deleted, from.filename().string()},
+            {FTB::DirWatcher::Change::Created, to.filename().string()},
+        });
+    } else {
+        applyLocalChange(from, FTB::DirWatcher::Change::Deleted);
+        applyLocalChange(to, FTB::DirWatcher::Change::Created);
+    }
+    dropDirectoryCaches(oldPath);
+}
+
+void patchCacheOnModify(const std::string& path) {
+    applyLocalChange(fs::path(path), FTB::DirWatcher::Change::Modified);
 }
 
 
@@ -287,6 +682,63 @@ std::string formatTime(const std::tm & time) {
     return buffer;
 }
 
+// ---------------------------- 批量遍历（IoRing） ----------------------------
+// 每读到一批目录项就把其中的 statx / unlinkat 一次提交，io_uring 可用时这些请求同时在途。
+
+// 目录项是否为目录（不跟随符号链接），d_type 缺失时补一次 statx
+static bool isSubdirectory(const FTB::DirScanner& scanner, const FTB::RawDirEntry& raw) {
+    if (raw.type != DT_UNKNOWN) return raw.type == DT_DIR;
+    FTB::EntryStat st;
+    return FTB::DirScanner::statAt(scanner.fd(), raw.name.c_str(), FTB::DirScanner::kStatType, st) &&
+           S_ISDIR(st.mode);
+}
+
+// 删除 dir 下的全部内容（不含 dir 本身）；文件与子目录分别批量 unlinkat
+static bool removeTreeContentsBatched(FTB::IoRing& ring, const std::string& dir) {
+    std::vector<std::string> subdirs;
+    std::vector<FTB::IoRing::Completion> done;
+    bool ok = true;
+    auto collect = [&] {
+        ring.drain(done);
+        for (const auto& c : done) {
+            if (c.result < 0 && c.result != -ENOENT) ok = false;
+        }
+        done.clear();
+    };
+    {
+        FTB::DirScanner scanner(dir);
+        if (!scanner.ok()) return false;
+        std::vector<FTB::RawDirEntry> batch;
+        while (scanner.next(batch)) {
+            for (const auto& raw : batch) {
+                if (isSubdirectory(scanner, raw)) {
+                    subdirs.push_back(dir + "/" + raw.name);
+                } else {
+                    ring.push(FTB::IoRing::unlinkAt(scanner.fd(), raw.name.c_str(), 0, 0));
+                }
+            }
+            collect();
+            batch.clear();
+        }
+        if (scanner.error() != 0) ok = false;
+    }
+    // 先关闭本目录再逐层深入，打开的描述符数不随深度增长
+    for (const auto& sub : subdirs) {
+        if (!removeTreeContentsBatched(ring, sub)) ok = false;
+    }
+    for (const auto& sub : subdirs) {
+        ring.push(FTB::IoRing::unlinkAt(FTB::IoRing::kCwd, sub.c_str(), AT_REMOVEDIR, 0));
+    }
+    collect();
+    return ok;
+}
+
+static bool removeTreeBatched(const std::string& root) {
+    FTB::IoRing ring;
+    bool ok = removeTreeContentsBatched(ring, root);
+    return ::rmdir(root.c_str()) == 0 && ok;
+}
+
 /**
  * 递归计算目录及其所有子目录中文件的总大小
  * @param path 要计算大小的目录路径
@@ -301,25 +753,12 @@ uintmax_t calculateDirectorySize(const std::string & path) {
     }
     
     cache_misses.fetch_add(1);
-    uintmax_t total = 0;  // 初始化总大小为0
-    
-    try {
-        // 使用递归目录迭代器遍历目录及其所有子目录
-        for (const auto & entry : fs::recursive_directory_iterator(path)) {
-            // 只统计文件的大小，跳过目录项
-            if (!fs::is_directory(entry)) {
-                total += fs::file_size(entry);  // 累加文件大小到总和中
-            }
-        }
-        
-        // 将结果缓存到LRU缓存中
-        lru_size_cache->put(path, total);
-        
-    } catch (...) {
-        // 捕获所有可能的异常（如权限不足、路径不存在等）
-        return 0;  // 发生错误时返回0
-    }
-    
+    // 并行遍历，硬链接只计一次；无法读取的部分计为 0；未变化的目录取用持久化索引
+    FTB::DiskUsage::Options options;
+    options.index = &FTB::SizeIndex::instance();
+    uintmax_t total = FTB::DiskUsage::measure(path, options).total.apparent;
+    options.index->maybeSave();
+    lru_size_cache->put(path, total);
     return total;  // 返回计算得到的总大小
 }
 
@@ -414,6 +853,9 @@ bool createFile(const std::string & filePath) {
     // 关闭文件句柄
     file.close();
     
+    // 将新文件插入父目录的缓存列表
+    patchCacheOnCreate(filePath);
+    
     // 返回操作成功
     return true;
 }
@@ -448,8 +890,6 @@ bool createDirectory(const std::string & dirPath) {
         return false;
     }
     
-    // 获取父目录路径用于缓存更新
-    std::string parentPath = fs::path(dirPath).parent_path().string();
     {
         // 加锁保护缓存操作
         std::lock_guard<std::mutex> lock(cache_mutex);
@@ -457,8 +897,8 @@ bool createDirectory(const std::string & dirPath) {
         // 如果新目录已在缓存中，则清除
         lru_dir_cache->erase(dirPath);
             
-        // 标记父目录缓存为无效，下次访问时会重新加载
-        lru_dir_cache->erase(parentPath);
+        // 将新目录插入父目录的缓存列表
+        patchCacheOnCreate(dirPath);
     }
     
     // 返回操作成功
@@ -481,8 +921,12 @@ bool deleteFileOrDirectory(const std::string & path) {
         // 检查路径是否为目录
         if (fs::is_directory(path)) {
             // 递归删除目录及其所有内容，返回删除的条目数>0表示成功
-            bool ok = fs::remove_all(path) > 0;
+            // 指向目录的符号链接只删除链接本身，仍交给 remove_all
+            bool ok = FTB::IoRing::available() && !fs::is_symlink(path)
+                          ? removeTreeBatched(path)
+                          : fs::remove_all(path) > 0;
             PERF_LOG("FileMgr", "deleteFileOrDirectory result=" + std::to_string(ok) + " type=dir");
+            if (ok) patchCacheOnRemove(path);
             return ok;
         }
         // 检查路径是否为普通文件
@@ -490,6 +934,7 @@ bool deleteFileOrDirectory(const std::string & path) {
             // 删除单个文件
             bool ok = fs::remove(path);
             PERF_LOG("FileMgr", "deleteFileOrDirectory result=" + std::to_string(ok) + " type=file");
+            if (ok) patchCacheOnRemove(path);
             return ok;
         }
     } catch (...) {
@@ -530,6 +975,7 @@ bool moveToTrash(const std::string & path) {
         std::string orig_path = fs::absolute(path).string();
 
         if (!FTB::renameWithFallback(path, dest)) return false;
+        patchCacheOnRename(path, dest);
 
 #ifndef __APPLE__
         auto now = std::chrono::system_clock::now();
@@ -581,7 +1027,7 @@ void enterDirectory(DirectoryHistory & history,
     
     // 获取当前路径缓存，若无效则重新加载
     auto cached_result = lru_dir_cache->get(currentPath);
-    if (cached_result.has_value()) {
+    if (cached_result) {
         contents = cached_result->contents;
     } else {
         contents = getDirectoryContents(currentPath);
@@ -640,29 +1086,35 @@ void calculation_current_folder_files_number(
     folder_permissions.clear();
     fileNames.clear();
     
-    try {
-        // 遍历目录中的所有条目
-        for (const auto &entry : fs::directory_iterator(path)) {
-            // 获取当前条目名称
-            std::string name = entry.path().filename().string();
-            fileNames.push_back(name); // 记录所有条目名称
-            
-            if (entry.is_directory()) {
-                folder_count++; // 统计子目录数量
-                
-                // 获取子目录权限信息
-                struct stat fileStat;
-                if (stat(entry.path().c_str(), &fileStat) == 0) {
-                    // 保存(名称, 权限位)对
-                    folder_permissions.emplace_back(name, fileStat.st_mode);
-                }
-            } 
-            // 统计普通文件数量
-            else if (entry.is_regular_file()) {
-                file_count++; 
+    // d_type 足以区分文件/目录，仅对子目录（及 d_type 未知的条目）发起 statx
+    FTB::DirScanner scanner(path);
+    std::vector<FTB::RawDirEntry> raw_entries;
+    while (scanner.next(raw_entries)) {
+    }
+
+    for (auto& raw : raw_entries) {
+        mode_t type_mode = FTB::DirScanner::typeToMode(raw.type);
+        FTB::EntryStat st;
+        bool have_stat = false;
+        if (type_mode == 0 || S_ISDIR(type_mode) || S_ISLNK(type_mode)) {
+            // 与 directory_entry::is_directory() 一致：跟随符号链接
+            have_stat = FTB::DirScanner::statAt(scanner.fd(), raw.name.c_str(),
+                                                FTB::DirScanner::kStatMode, st, /*follow=*/true);
+            if (have_stat) type_mode = st.mode & S_IFMT;
+        }
+
+        if (S_ISDIR(type_mode)) {
+            folder_count++; // 统计子目录数量
+            if (have_stat) {
+                // 保存(名称, 权限位)对
+                folder_permissions.emplace_back(raw.name, st.mode);
             }
         }
-    } catch (const std::exception &) {
+        // 统计普通文件数量
+        else if (S_ISREG(type_mode)) {
+            file_count++;
+        }
+        fileNames.push_back(std::move(raw.name)); // 记录所有条目名称
     }
 }
 
@@ -690,9 +1142,9 @@ std::string readFileContent(const std::string & filePath, size_t startLine, size
     std::string cache_key = cache_key_stream.str();
     
     auto cached_content = lru_content_cache->get(cache_key);
-    if (cached_content.has_value()) {
+    if (cached_content) {
         cache_hits.fetch_add(1);
-        return cached_content.value();
+        return *cached_content;
     }
     
     cache_misses.fetch_add(1);
@@ -751,12 +1203,8 @@ bool writeFileContent(const std::string & filePath, const std::string & content)
         // 加锁保护缓存操作
         std::lock_guard<std::mutex> lock(cache_mutex);
         
-        // 清除该文件的缓存内容
-        lru_content_cache->erase(filePath);
-        
-        // 获取父目录路径并标记其缓存为无效
-        std::string parentDir = fs::path(filePath).parent_path().string();
-        lru_dir_cache->erase(parentDir);
+        // 清除该文件的内容缓存，并刷新父目录缓存中该条目的大小与时间
+        patchCacheOnModify(filePath);
     }
     
     return true;
@@ -825,17 +1273,12 @@ bool renameFileOrDirectory(const std::string& oldPath, const std::string& newNam
             return false;
         }
         
-        // 获取父目录路径用于缓存更新
-        std::string parentPath = oldFilePath.parent_path().string();
         {
             // 加锁保护缓存操作
             std::lock_guard<std::mutex> lock(cache_mutex);
             
-            // 标记父目录缓存为无效(下次访问会重新加载)
-            lru_dir_cache->erase(parentPath);
-            
-            // 清除旧路径的缓存(如果存在)
-            lru_dir_cache->erase(oldPath);
+            // 在父目录缓存中原位替换条目，并清除旧路径自身的缓存
+            patchCacheOnRename(oldPath, newFilePath.string());
         }
         
         return true;
@@ -849,6 +1292,87 @@ bool renameFileOrDirectory(const std::string& oldPath, const std::string& newNam
 
 // ---------------------------- 缓存管理函数实现 ----------------------------
 
+/**
+ * 后台校验从快照取出的目录
+ * 逐个 stat 比对类型、mtime 与大小，不一致的条目按 Modified 事件修补进缓存
+ */
+static void revalidateSnapshotEntries(const std::string& dir) {
+    using Change = FTB::DirWatcher::Change;
+    auto table = lru_entry_cache->get(dir);
+    if (!table) return;
+    int dirfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) return;
+
+    std::vector<char> stale(table->size(), 0);
+    FTB::StatFanout::run(table->size(), [&table, &stale, dirfd](size_t pos) {
+        constexpr unsigned kFields = FTB::DirScanner::kStatMode | FTB::DirScanner::kStatSize |
+                                     FTB::DirScanner::kStatMtime;
+        auto raw = table->rawRow(pos);
+        char name_buf[NAME_MAX + 1];
+        copyEntryName(raw.name, name_buf);
+        FTB::EntryStat st;
+        if (!FTB::DirScanner::statAt(dirfd, name_buf, kFields, st)) {
+            stale[pos] = 1;
+            return;
+        }
+        stale[pos] = st.mode != raw.mode || st.mtime_sec != raw.mtime ||
+                     (S_ISREG(st.mode) && st.size != raw.size);
+    });
+    ::close(dirfd);
+
+    std::vector<Change> changes;
+    for (size_t pos = 0; pos < stale.size(); ++pos) {
+        if (stale[pos]) changes.push_back({Change::Modified, std::string(table->name(pos))});
+    }
+    if (!changes.empty()) applyDirectoryChanges(dir, changes);
+}
+
+/**
+ * 将条目表写入快照后重新映射
+ * 只写入被监听（由事件保持最新）的目录；旧快照中仍然有效的目录一并沿用
+ */
+static void writeDirectorySnapshot() {
+    std::string file;
+    std::shared_ptr<const FTB::DirSnapshot> previous;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        file = dir_snapshot_file;
+        previous = dir_snapshot;
+    }
+    if (file.empty()) return;
+
+    std::vector<FTB::DirSnapshot::Entry> entries;
+    lru_entry_cache->for_each([&entries](const std::string& dir, const auto& table) {
+        entries.push_back({dir, table});
+    });
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const auto& e) { return !isDirectoryWatched(e.path); }),
+                  entries.end());
+
+    auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
+    auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
+    if (previous) {
+        std::unordered_set<std::string> cached;
+        for (const auto& e : entries) cached.insert(e.path);
+        size_t carried = 0;
+        for (const auto& dir : previous->paths()) {
+            if (carried >= kSnapshotCarryOverDirs) break;
+            if (cached.count(dir)) continue;
+            auto table = previous->load(dir);
+            if (!table) continue;
+            if (mode != previous->sortMode()) table->sort(mode);
+            entries.push_back({dir, std::make_shared<const FTB::EntryTable>(std::move(*table))});
+            ++carried;
+        }
+    }
+
+    if (FTB::DirSnapshot::write(file, entries, mode)) {
+        auto snapshot = FTB::DirSnapshot::open(file);
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        dir_snapshot = std::move(snapshot);
+    }
+}
+
 /**
  * @brief 初始化缓存系统
  */
@@ -856,63 +1380,53 @@ void initializeCacheSystem(size_t max_dir_cache_size,
                           size_t max_size_cache_size,
                           size_t max_content_cache_size,
                           bool enable_persistence) {
-    std::string cache_dir;
+    // 持久化只保存目录条目表的二进制快照；大小与内容缓存重启后重新计算
     if (enable_persistence) {
         const char* home = std::getenv("HOME");
-        cache_dir = (home ? std::string(home) : "/tmp") + "/.config/ftb/cache";
-        fs::create_directories(cache_dir);
+        std::string cache_dir = (home ? std::string(home) : "/tmp") + "/.config/ftb/cache";
+        std::error_code ec;
+        fs::create_directories(cache_dir, ec);
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        dir_snapshot_file = cache_dir + "/dir_snapshot.bin";
+        dir_snapshot = FTB::DirSnapshot::open(dir_snapshot_file);
     }
     // 重新初始化LRU缓存
-    lru_dir_cache = std::make_unique<FTB::LRUCache<std::string, DirectoryCache>>(
-        max_dir_cache_size, std::chrono::seconds(300), enable_persistence,
-        enable_persistence ? cache_dir + "/dir_cache.dat" : "");
+    lru_dir_cache = makeCache<FTB::SharedLRUCache<std::string, DirectoryCache>>(
+        max_dir_cache_size, kDirCacheBytes, kDirCacheTtl);
     
-    lru_size_cache = std::make_unique<FTB::LRUCache<std::string, uintmax_t>>(
-        max_size_cache_size, std::chrono::seconds(600), enable_persistence,
-        enable_persistence ? cache_dir + "/size_cache.dat" : "");
+    lru_size_cache = makeCache<FTB::LRUCache<std::string, uintmax_t>>(
+        max_size_cache_size, kSizeCacheBytes, kSizeCacheTtl);
     
-    lru_content_cache = std::make_unique<FTB::LRUCache<std::string, std::string>>(
-        max_content_cache_size, std::chrono::seconds(180), enable_persistence,
-        enable_persistence ? cache_dir + "/content_cache.dat" : "");
+    lru_content_cache = makeCache<FTB::SharedLRUCache<std::string, std::string>>(
+        max_content_cache_size, kContentCacheBytes, kContentCacheTtl, true);
     
-    // 设置序列化函数
-    lru_dir_cache->set_serializers(
-        [](const std::string& key) { return key; },
-        [](const DirectoryCache& value) {
-            std::ostringstream oss;
-            oss << value.valid << "|" << value.total_size << "|" 
-                << std::chrono::duration_cast<std::chrono::seconds>(
-                    value.last_update.time_since_epoch()).count();
-            for (const auto& content : value.contents) {
-                oss << "|" << content;
-            }
-            return oss.str();
-        },
-        [](const std::string& key) { return key; },
-        [](const std::string& value) {
-            DirectoryCache cache;
-            std::istringstream iss(value);
-            std::string token;
-            std::getline(iss, token, '|');
-            cache.valid = (token == "1");
-            std::getline(iss, token, '|');
-            cache.total_size = std::stoull(token);
-            std::getline(iss, token, '|');
-            cache.last_update = std::chrono::system_clock::from_time_t(std::stoll(token));
-            while (std::getline(iss, token, '|')) {
-                cache.contents.push_back(token);
-            }
-            return cache;
-        }
-    );
+    installDirCacheHook();
     
-    // 启动缓存清理线程
+    // 启动缓存清理线程：每 5 分钟清理并写快照，有待校验的目录时立即唤醒
     if (!cache_cleanup_running.load()) {
         cache_cleanup_running.store(true);
         cache_cleanup_thread = std::thread([]() {
+            auto next_cleanup = std::chrono::steady_clock::now() + std::chrono::minutes(5);
+            std::unique_lock<std::mutex> lock(cleanup_mutex);
             while (cache_cleanup_running.load()) {
-                std::this_thread::sleep_for(std::chrono::minutes(5));
-                cleanupExpiredCaches();
+                cleanup_cv.wait_until(lock, next_cleanup, [] {
+                    return !cache_cleanup_running.load() || !revalidate_queue.empty();
+                });
+                if (!cache_cleanup_running.load()) break;
+                while (!revalidate_queue.empty()) {
+                    std::string dir = std::move(revalidate_queue.front());
+                    revalidate_queue.pop_front();
+                    lock.unlock();
+                    revalidateSnapshotEntries(dir);
+                    lock.lock();
+                }
+                if (std::chrono::steady_clock::now() >= next_cleanup) {
+                    lock.unlock();
+                    cleanupExpiredCaches();
+                    writeDirectorySnapshot();
+                    lock.lock();
+                    next_cleanup = std::chrono::steady_clock::now() + std::chrono::minutes(5);
+                }
             }
         });
     }
@@ -923,6 +1437,20 @@ void initializeCacheSystem(size_t max_dir_cache_size,
     cache_evictions.store(0);
 }
 
+/**
+ * @brief 停止缓存清理线程并写入最终的目录快照
+ */
+void shutdownCacheSystem() {
+    {
+        std::lock_guard<std::mutex> lock(cleanup_mutex);
+        cache_cleanup_running.store(false);
+        revalidate_queue.clear();
+    }
+    cleanup_cv.notify_all();
+    if (cache_cleanup_thread.joinable()) cache_cleanup_thread.join();
+    writeDirectorySnapshot();
+}
+
 /**
  * @brief 清理所有缓存
  */
@@ -991,7 +1519,13 @@ CacheStatistics getCacheStatistics() {
     stats.content_cache_size = lru_content_cache->size();
     stats.total_hits = cache_hits.load();
     stats.total_misses = cache_misses.load();
-    stats.total_evictions = cache_evictions.load();
+    stats.dir_cache = lru_dir_cache->get_stats();
+    stats.size_cache = lru_size_cache->get_stats();
+    stats.content_cache = lru_content_cache->get_stats();
+    stats.entry_cache = lru_entry_cache->get_stats();
+    stats.total_evictions = cache_evictions.load() + stats.dir_cache.evictions +
+                            stats.size_cache.evictions + stats.content_cache.evictions +
+                            stats.entry_cache.evictions;
     
     size_t total_requests = stats.total_hits + stats.total_misses;
     stats.hit_ratio = total_requests > 0 ? 
@@ -1053,6 +1587,15 @@ void invalidateCacheForPath(const std::string& path) {
     }
 }
 
+void invalidateSizeCaches(const std::string& path) {
+    const std::string prefix = (path == "/") ? path : path + "/";
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    lru_size_cache->erase(path);
+    lru_size_cache->erase_if([&prefix](const std::string& key) {
+        return key.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
 // 新增：智能预加载函数
 void preloadHotPaths() {
     std::lock_guard<std::mutex> lock(path_tracking_mutex);
@@ -1099,16 +1642,23 @@ std::string getCachePerformanceReport() {
     double hit_ratio = total_requests > 0 ? 
         static_cast<double>(cache_hits.load()) / total_requests * 100.0 : 0.0;
     
+    CacheStatistics stats = getCacheStatistics();
     std::ostringstream report;
     report << "=== 缓存性能报告 ===\n";
     report << "命中次数: " << cache_hits.load() << "\n";
     report << "未命中次数: " << cache_misses.load() << "\n";
-    report << "驱逐次数: " << cache_evictions.load() << "\n";
+    report << "驱逐次数: " << stats.total_evictions << "\n";
     report << "预加载命中: " << preload_hits.load() << "\n";
     report << "命中率: " << std::fixed << std::setprecision(2) << hit_ratio << "%\n";
-    report << "目录缓存大小: " << lru_dir_cache->size() << "\n";
-    report << "大小缓存大小: " << lru_size_cache->size() << "\n";
-    report << "内容缓存大小: " << lru_content_cache->size() << "\n";
+    auto describe = [&report](const char* label, const FTB::CacheStats& s) {
+        report << label << ": " << s.size << " 项, " << s.bytes / 1024 << " KB, "
+               << s.shards.size() << " 分片, 命中/未命中/驱逐 "
+               << s.hits << "/" << s.misses << "/" << s.evictions << "\n";
+    };
+    describe("目录缓存", stats.dir_cache);
+    describe("大小缓存", stats.size_cache);
+    describe("内容缓存", stats.content_cache);
+    describe("条目表缓存", stats.entry_cache);
     
     return report.str();
 }
@@ -4,12 +4,15 @@
 #include <algorithm>
 #include <filesystem>
 #include <iomanip>
+#include <memory>
 #include <mutex>
-#include <numeric>
+#include <optional>
 #include <sstream>
 #include <vector>
 
+#include "../include/browser/DiskUsage.hpp"
 #include "../include/browser/FileManager.hpp"
+#include "../include/browser/SizeIndex.hpp"
 
 namespace fs = std::filesystem;
 
@@ -19,12 +22,18 @@ namespace FileSizeCalculator
     // ---- 异步计算状态 ----
     static std::atomic<bool> g_calculating{false};
     static std::atomic<bool> g_cancel_requested{false};
+    static std::atomic<bool> g_rescan_requested{false};
     static std::mutex g_calc_mutex;
     static std::thread g_calc_thread;
 
     bool IsCalculating() { return g_calculating.load(); }
     void RequestCancel() { g_cancel_requested.store(true); }
 
+    void RequestRescan() {
+        g_rescan_requested.store(true);
+        g_cancel_requested.store(true);
+    }
+
     // ---- 格式化文件大小 ----
     static std::string FormatSize(uintmax_t size) {
         std::ostringstream oss;
@@ -37,77 +46,101 @@ namespace FileSizeCalculator
         return oss.str();
     }
 
-    // ---- 同步计算 (保留原接口) ----
-    void CalculateSizes(const std::string& path, int selected,
+    // ---- 目录名称列表：命中 lru_dir_cache 时与缓存快照共享，不拷贝 ----
+    static std::shared_ptr<const std::vector<std::string>> ListDirectory(const std::string& path) {
+        std::shared_ptr<const FileManager::DirectoryCache> cached;
+        {
+            std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
+            cached = FileManager::lru_dir_cache->get(path);
+        }
+        if (cached) {
+            return std::shared_ptr<const std::vector<std::string>>(cached, &cached->contents);
+        }
+        return std::make_shared<const std::vector<std::string>>(FileManager::getDirectoryContents(path));
+    }
+
+    // ---- 统计 path 下各条目的大小 ----
+    // 一次并行遍历整棵树同时得到总量与各顶层条目的合计，遍历中的部分合计持续写入 total_folder_size，
+    // 状态栏随之增长而不是等到结束。被取消时返回 false，不写入缓存与选中项
+    static bool Compute(const std::string& path, int selected,
                         std::atomic<uintmax_t>& total_folder_size,
                         std::atomic<double>& size_ratio,
-                        std::string& selected_size)
+                        std::string& selected_size,
+                        const std::atomic<bool>* cancel,
+                        bool rescan)
     {
+        auto listing = ListDirectory(path);
+        const std::vector<std::string>& contents = *listing;
 
-        std::vector<std::string> contents_copy;
-        {
-            std::unique_lock<std::mutex> lock(FileManager::cache_mutex);
-            auto cached_result = FileManager::lru_dir_cache->get(path);
-            if (cached_result.has_value()) {
-                contents_copy = cached_result->contents;
-            } else {
-                lock.unlock();
-                contents_copy = FileManager::getDirectoryContents(path);
-                lock.lock();
-            }
-        }
-
-        if (contents_copy.empty()) {
+        if (contents.empty()) {
             total_folder_size.store(0, std::memory_order_relaxed);
             size_ratio.store(0.0, std::memory_order_relaxed);
             selected_size = "0 B";
-            return;
+            return true;
         }
 
-        // 尝试从大小缓存获取
-        uintmax_t totalSize = 0;
-        std::vector<uintmax_t> sizes;
-        {
+        const bool has_selection = selected >= 0 && static_cast<size_t>(selected) < contents.size();
+        const std::string selected_path = has_selection ? (fs::path(path) / contents[selected]).string() : "";
+
+        // 尝试从大小缓存获取（重新统计时跳过）
+        std::optional<uintmax_t> cached_size;
+        if (!rescan) {
             std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-            auto cached_size = FileManager::lru_size_cache->get(path);
-            if (cached_size.has_value()) {
-                totalSize = cached_size.value();
-            }
+            cached_size = FileManager::lru_size_cache->get(path);
         }
 
-        if (totalSize == 0) {
-            sizes.resize(contents_copy.size());
-            std::transform(
-                           contents_copy.begin(), contents_copy.end(),
-                           sizes.begin(),
-                           [&](const std::string& item) {
-                               std::string fullPath = (fs::path(path) / item).string();
-                               return FileManager::getFileSize(fullPath);
-                           });
-            totalSize = std::accumulate(sizes.begin(), sizes.end(), uintmax_t(0));
+        uintmax_t totalSize = 0;
+        uintmax_t sel_size = 0;
+        if (cached_size.has_value()) {
+            totalSize = cached_size.value();
+            if (has_selection) sel_size = FileManager::getFileSize(selected_path);
+        } else {
+            FTB::DiskUsage::Options options;
+            options.per_child = true;
+            options.cancel = cancel;
+            options.index = &FTB::SizeIndex::instance();
+            options.refresh_index = rescan;
+            options.on_progress = [&total_folder_size](const FTB::DiskUsage::Totals& partial) {
+                total_folder_size.store(partial.apparent, std::memory_order_relaxed);
+            };
+            auto report = FTB::DiskUsage::measure(path, options);
+            options.index->maybeSave();
+            if (report.cancelled) return false;
+
+            totalSize = report.total.apparent;
             {
                 std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
                 FileManager::lru_size_cache->put(path, totalSize);
             }
+            if (has_selection) {
+                for (const auto& child : report.children) {
+                    if (child.name == contents[selected]) {
+                        sel_size = child.totals.apparent;
+                        break;
+                    }
+                }
+            }
         }
 
         total_folder_size.store(totalSize, std::memory_order_relaxed);
 
-        if (selected >= 0 && static_cast<size_t>(selected) < contents_copy.size()) {
-            // 如果 sizes 为空（从缓存获取的 totalSize），单独计算选中文件大小
-            uintmax_t sel_size = 0;
-            if (!sizes.empty()) {
-                sel_size = sizes[selected];
-            } else {
-                std::string fullPath = (fs::path(path) / contents_copy[selected]).string();
-                sel_size = FileManager::getFileSize(fullPath);
-            }
+        if (has_selection) {
             double ratio = (totalSize > 0) ? (static_cast<double>(sel_size) / totalSize) : 0.0;
             size_ratio.store(ratio, std::memory_order_relaxed);
             selected_size = FormatSize(sel_size);
         } else {
             selected_size = "0 B";
         }
+        return true;
+    }
+
+    // ---- 同步计算 (保留原接口) ----
+    void CalculateSizes(const std::string& path, int selected,
+                        std::atomic<uintmax_t>& total_folder_size,
+                        std::atomic<double>& size_ratio,
+                        std::string& selected_size)
+    {
+        Compute(path, selected, total_folder_size, size_ratio, selected_size, nullptr, false);
     }
 
     // ---- 异步计算 ----
@@ -125,86 +158,12 @@ namespace FileSizeCalculator
 
         g_calculating.store(true);
         g_cancel_requested.store(false);
+        const bool rescan = g_rescan_requested.exchange(false);
 
-        g_calc_thread = std::thread([&path, selected,
+        // 路径按值捕获：计算期间调用方可能已切换目录
+        g_calc_thread = std::thread([path, selected, rescan,
                                        &total_folder_size, &size_ratio, &selected_size]() {
-            std::vector<std::string> contents_copy;
-            {
-                std::unique_lock<std::mutex> lock(FileManager::cache_mutex);
-                auto cached_result = FileManager::lru_dir_cache->get(path);
-                if (cached_result.has_value()) {
-                    contents_copy = cached_result->contents;
-                } else {
-                    lock.unlock();
-                    contents_copy = FileManager::getDirectoryContents(path);
-                    lock.lock();
-                }
-            }
-
-            if (g_cancel_requested.load()) {
-                g_calculating.store(false);
-                return;
-            }
-
-            if (contents_copy.empty()) {
-                total_folder_size.store(0, std::memory_order_relaxed);
-                size_ratio.store(0.0, std::memory_order_relaxed);
-                selected_size = "0 B";
-                g_calculating.store(false);
-                return;
-            }
-
-            // 尝试从大小缓存获取
-            uintmax_t totalSize = 0;
-            {
-                std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                auto cached_size = FileManager::lru_size_cache->get(path);
-                if (cached_size.has_value()) {
-                    totalSize = cached_size.value();
-                }
-            }
-
-            std::vector<uintmax_t> sizes;
-            if (totalSize == 0) {
-                sizes.resize(contents_copy.size());
-                std::transform(
-                               contents_copy.begin(), contents_copy.end(),
-                               sizes.begin(),
-                               [&](const std::string& item) {
-                                   if (g_cancel_requested.load()) return uintmax_t(0);
-                                   std::string fullPath = (fs::path(path) / item).string();
-                                   return FileManager::getFileSize(fullPath);
-                               });
-
-                if (g_cancel_requested.load()) {
-                    g_calculating.store(false);
-                    return;
-                }
-
-                totalSize = std::accumulate(sizes.begin(), sizes.end(), uintmax_t(0));
-                {
-                    std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                    FileManager::lru_size_cache->put(path, totalSize);
-                }
-            }
-
-            total_folder_size.store(totalSize, std::memory_order_relaxed);
-
-            if (selected >= 0 && static_cast<size_t>(selected) < contents_copy.size()) {
-                uintmax_t sel_size = 0;
-                if (!sizes.empty()) {
-                    sel_size = sizes[selected];
-                } else {
-                    std::string fullPath = (fs::path(path) / contents_copy[selected]).string();
-                    sel_size = FileManager::getFileSize(fullPath);
-                }
-                double ratio = (totalSize > 0) ? (static_cast<double>(sel_size) / totalSize) : 0.0;
-                size_ratio.store(ratio, std::memory_order_relaxed);
-                selected_size = FormatSize(sel_size);
-            } else {
-                selected_size = "0 B";
-            }
-
+            Compute(path, selected, total_folder_size, size_ratio, selected_size, &g_cancel_requested, rescan);
             g_calculating.store(false);
         });
 
@@ -0,0 +1,122 @@
+// FileWalker.cpp - 并行目录树遍历
+#include "../include/browser/FileWalker.hpp"
+#include "../include/browser/DirScanner.hpp"
+#include "../include/browser/GitIgnore.hpp"
+#include "../include/browser/WorkStealing.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace FTB {
+
+namespace {
+
+struct WalkJob {
+    std::string                      path;   // 绝对路径
+    std::string                      rel;    // 相对起点，起点本身为空
+    int                              depth = 0;
+    std::shared_ptr<const GitIgnore> ignore;
+};
+
+// 每个工作线程复用的缓冲
+struct Scratch {
+    std::vector<RawDirEntry> entries;
+    std::vector<WalkJob>     subdirs;
+    std::string              path;
+    std::string              rel;
+};
+
+class Walk {
+public:
+    Walk(const FileWalker::Options& options, const FileWalker::Visitor& visit, size_t threads)
+        : options_(options), visit_(visit), queues_(threads, options.cancel) {}
+
+    bool run(WalkJob root) {
+        queues_.push(0, std::move(root));
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < queues_.workers(); ++i) threads.emplace_back([this, i] { work(i); });
+        work(0);
+        for (auto& t : threads) t.join();
+        return !queues_.cancelled();
+    }
+
+private:
+    void work(size_t self) {
+        Scratch scratch;
+        WalkJob job;
+        while (queues_.next(self, job)) {
+            processDirectory(scratch, job);
+            queues_.push(self, scratch.subdirs);
+            queues_.done();
+        }
+    }
+
+    void processDirectory(Scratch& s, const WalkJob& job) {
+        DirScanner scanner(job.path);
+        if (!scanner.ok()) return;
+        // 先读完整个目录：.gitignore 的规则要在回报任何条目之前加载
+        s.entries.clear();
+        while (scanner.next(s.entries)) {
+        }
+
+        std::shared_ptr<const GitIgnore> ignore = job.ignore;
+        if (options_.honor_gitignore) {
+            for (const auto& e : s.entries) {
+                if (e.name == ".gitignore") {
+                    ignore = GitIgnore::load(job.path, ignore);
+                    break;
+                }
+            }
+        }
+
+        const bool descend = options_.max_depth <= 0 || job.depth + 1 < options_.max_depth;
+        EntryStat st;
+        for (const auto& e : s.entries) {
+            if (!options_.include_hidden && e.name[0] == '.') continue;
+            bool is_dir = e.type == DT_DIR;
+            if (e.type == DT_UNKNOWN) {
+                if (!DirScanner::statAt(scanner.fd(), e.name.c_str(), DirScanner::kStatType, st)) continue;
+                is_dir = S_ISDIR(st.mode);
+            }
+            if (is_dir && options_.skip_dirs && options_.skip_dirs->count(e.name)) continue;
+
+            s.path.assign(job.path);
+            if (s.path.empty() || s.path.back() != '/') s.path += '/';
+            s.path += e.name;
+            if (ignore && ignore->ignored(s.path, is_dir)) continue;
+
+            s.rel.assign(job.rel);
+            if (!s.rel.empty()) s.rel += '/';
+            s.rel += e.name;
+            visit_(FileWalker::Entry{s.rel, e.name, is_dir});
+
+            if (is_dir && descend) s.subdirs.push_back(WalkJob{s.path, s.rel, job.depth + 1, ignore});
+            if (queues_.cancelled()) return;
+        }
+    }
+
+    const FileWalker::Options&  options_;
+    const FileWalker::Visitor&  visit_;
+    WorkStealingQueues<WalkJob> queues_;
+};
+
+}  // namespace
+
+bool FileWalker::walk(const std::string& root, const Options& options, const Visitor& visit) {
+    // .gitignore 按绝对路径匹配
+    std::error_code ec;
+    WalkJob job;
+    job.path = std::filesystem::absolute(root, ec).lexically_normal().string();
+    if (ec) job.path = root;
+    while (job.path.size() > 1 && job.path.back() == '/') job.path.pop_back();
+    if (options.honor_gitignore) job.ignore = GitIgnore::loadAncestors(job.path);
+    Walk walk(options, visit, options.threads ? options.threads : defaultWalkThreads());
+    return walk.run(std::move(job));
+}
+
+}  // namespace FTB
@@ -0,0 +1,198 @@
+// GitIgnore.cpp - .gitignore 规则解析与匹配
+#include "../include/browser/GitIgnore.hpp"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace FTB {
+
+namespace {
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+bool exists(const std::string& path) {
+    struct stat st;
+    return ::lstat(path.c_str(), &st) == 0;
+}
+
+std::string withSlash(std::string dir) {
+    if (dir.empty() || dir.back() != '/') dir += '/';
+    return dir;
+}
+
+// [...] 字符类，p[pi] 为 '['。返回类结束后的位置；不是完整的类时返回 npos
+size_t matchClass(std::string_view p, size_t pi, char c, bool& matched) {
+    size_t j = pi + 1;
+    bool negate = false;
+    if (j < p.size() && (p[j] == '!' || p[j] == '^')) {
+        negate = true;
+        ++j;
+    }
+    bool hit = false;
+    for (bool first = true; j < p.size() && (p[j] != ']' || first); first = false) {
+        char lo = p[j];
+        if (j + 2 < p.size() && p[j + 1] == '-' && p[j + 2] != ']') {
+            if (lo <= c && c <= p[j + 2]) hit = true;
+            j += 3;
+        } else {
+            if (lo == c) hit = true;
+            ++j;
+        }
+    }
+    if (j >= p.size()) return std::string_view::npos;
+    matched = hit != negate;
+    return j + 1;
+}
+
+}  // namespace
+
+bool GitIgnore::globMatch(std::string_view p, std::string_view t) {
+    size_t pi = 0, ti = 0;
+    while (pi < p.size()) {
+        char c = p[pi];
+        if (c == '*') {
+            bool twin = pi + 1 < p.size() && p[pi + 1] == '*';
+            // 位于整段的 "**"：结尾时匹配其余全部，后接 / 时匹配零个或多个目录
+            if (twin && (pi == 0 || p[pi - 1] == '/')) {
+                size_t rest = pi + 2;
+                if (rest == p.size()) return true;
+                if (p[rest] == '/') {
+                    std::string_view sub = p.substr(rest + 1);
+                    for (size_t k = ti; k <= t.size(); ++k) {
+                        if ((k == ti || t[k - 1] == '/') && globMatch(sub, t.substr(k))) return true;
+                    }
+                    return false;
+                }
+            }
+            // 其余的 * 与 ** 都只在一段之内匹配
+            std::string_view sub = p.substr(pi + (twin ? 2 : 1));
+            for (size_t k = ti;; ++k) {
+                if (globMatch(sub, t.substr(k))) return true;
+                if (k == t.size() || t[k] == '/') return false;
+            }
+        }
+        if (ti == t.size()) return false;
+        if (c == '?') {
+            if (t[ti] == '/') return false;
+            ++pi;
+            ++ti;
+            continue;
+        }
+        if (c == '[') {
+            bool matched = false;
+            size_t end = matchClass(p, pi, t[ti], matched);
+            if (end != std::string_view::npos) {
+                if (!matched || t[ti] == '/') return false;
+                pi = end;
+                ++ti;
+                continue;
+            }
+            // 不完整的类按字面的 '[' 处理
+        }
+        if (c == '\\' && pi + 1 < p.size()) c = p[++pi];
+        if (c != t[ti]) return false;
+        ++pi;
+        ++ti;
+    }
+    return ti == t.size();
+}
+
+std::shared_ptr<const GitIgnore> GitIgnore::parse(const std::string& dir, std::string_view text,
+                                                  std::shared_ptr<const GitIgnore> parent) {
+    auto ignore = std::make_shared<GitIgnore>();
+    ignore->dir_ = withSlash(dir);
+    ignore->parent_ = parent;
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        // 结尾未转义的空格不算模式的一部分
+        while (!line.empty() && line.back() == ' ' && (line.size() < 2 || line[line.size() - 2] != '\\')) {
+            line.remove_suffix(1);
+        }
+        if (line.empty() || line[0] == '#') continue;
+
+        Rule rule;
+        if (line[0] == '!') {
+            rule.negate = true;
+            line.remove_prefix(1);
+        } else if (line.size() > 1 && line[0] == '\\' && (line[1] == '!' || line[1] == '#')) {
+            line.remove_prefix(1);
+        }
+        if (!line.empty() && line.back() == '/') {
+            rule.dir_only = true;
+            line.remove_suffix(1);
+        }
+        if (!line.empty() && line[0] == '/') {
+            rule.anchored = true;
+            line.remove_prefix(1);
+        }
+        if (line.empty()) continue;
+        if (line.find('/') != std::string_view::npos) rule.anchored = true;
+        rule.pattern = std::string(line);
+        ignore->rules_.push_back(std::move(rule));
+    }
+
+    if (ignore->rules_.empty()) return parent;
+    return ignore;
+}
+
+std::shared_ptr<const GitIgnore> GitIgnore::load(const std::string& dir, std::shared_ptr<const GitIgnore> parent) {
+    std::string text;
+    if (!readFile(withSlash(dir) + ".gitignore", text)) return parent;
+    return parse(dir, text, std::move(parent));
+}
+
+std::shared_ptr<const GitIgnore> GitIgnore::loadAncestors(const std::string& root) {
+    std::vector<std::string> chain;   // root 的上层目录，由内到外
+    std::string dir = root;
+    while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+    std::string repo;
+    for (;;) {
+        if (exists(withSlash(dir) + ".git")) {
+            repo = dir;
+            break;
+        }
+        size_t slash = dir.rfind('/');
+        if (slash == std::string::npos || dir == "/") break;
+        dir = slash == 0 ? "/" : dir.substr(0, slash);
+        chain.push_back(dir);
+    }
+    if (repo.empty()) return nullptr;
+
+    std::shared_ptr<const GitIgnore> ignore;
+    std::string text;
+    if (readFile(withSlash(repo) + ".git/info/exclude", text)) ignore = parse(repo, text, nullptr);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) ignore = load(*it, ignore);
+    return ignore;
+}
+
+bool GitIgnore::ignored(std::string_view path, bool is_dir) const {
+    for (const GitIgnore* node = this; node; node = node->parent_.get()) {
+        if (path.size() <= node->dir_.size() || path.compare(0, node->dir_.size(), node->dir_) != 0) continue;
+        std::string_view rel = path.substr(node->dir_.size());
+        size_t slash = rel.rfind('/');
+        std::string_view name = slash == std::string_view::npos ? rel : rel.substr(slash + 1);
+        for (auto it = node->rules_.rbegin(); it != node->rules_.rend(); ++it) {
+            if (it->dir_only && !is_dir) continue;
+            if (globMatch(it->pattern, it->anchored ? rel : name)) return !it->negate;
+        }
+    }
+    return false;
+}
+
+}  // namespace FTB
@@ -0,0 +1,380 @@
+// IoRing.cpp - io_uring 批量提交队列（不可用时同步执行）
+#include "../include/browser/IoRing.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// 操作码是枚举值无法用 #if 检测，以同期（5.13）加入的宏判断头文件版本
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RSRC_TAGS)
+#define FTB_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace FTB {
+
+namespace {
+
+constexpr unsigned bitOf(IoRing::Op op) { return 1u << static_cast<unsigned>(op); }
+
+#ifdef FTB_HAVE_IO_URING
+int ringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+uint8_t toOpcode(IoRing::Op op) {
+    switch (op) {
+        case IoRing::Op::OpenAt:   return IORING_OP_OPENAT;
+        case IoRing::Op::Read:     return IORING_OP_READ;
+        case IoRing::Op::Write:    return IORING_OP_WRITE;
+        case IoRing::Op::Statx:    return IORING_OP_STATX;
+        case IoRing::Op::UnlinkAt: return IORING_OP_UNLINKAT;
+        case IoRing::Op::Close:    return IORING_OP_CLOSE;
+    }
+    return IORING_OP_NOP;
+}
+
+template <typename T>
+T* at(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+#endif
+
+}  // namespace
+
+// ---- 请求构造 ----
+
+IoRing::Request IoRing::openAt(int dirfd, const char* path, int flags, unsigned mode, uint64_t user_data) {
+    Request r;
+    r.op = Op::OpenAt;
+    r.fd = dirfd;
+    r.path = path;
+    r.flags = flags;
+    r.mode = mode;
+    r.user_data = user_data;
+    return r;
+}
+
+IoRing::Request IoRing::read(int fd, void* buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    Request r;
+    r.op = Op::Read;
+    r.fd = fd;
+    r.buf = buf;
+    r.len = len;
+    r.offset = offset;
+    r.user_data = user_data;
+    return r;
+}
+
+IoRing::Request IoRing::write(int fd, const void* buf, unsigned len, uint64_t offset, uint64_t user_data) {
+    Request r = read(fd, const_cast<void*>(buf), len, offset, user_data);
+    r.op = Op::Write;
+    return r;
+}
+
+IoRing::Request IoRing::statx(int dirfd, const char* path, int flags, unsigned mask, void* out,
+                              uint64_t user_data) {
+    Request r;
+    r.op = Op::Statx;
+    r.fd = dirfd;
+    r.path = path;
+    r.flags = flags;
+    r.mode = mask;
+    r.buf = out;
+    r.user_data = user_data;
+    return r;
+}
+
+IoRing::Request IoRing::unlinkAt(int dirfd, const char* path, int flags, uint64_t user_data) {
+    Request r;
+    r.op = Op::UnlinkAt;
+    r.fd = dirfd;
+    r.path = path;
+    r.flags = flags;
+    r.user_data = user_data;
+    return r;
+}
+
+IoRing::Request IoRing::close(int fd, uint64_t user_data) {
+    Request r;
+    r.op = Op::Close;
+    r.fd = fd;
+    r.user_data = user_data;
+    return r;
+}
+
+// ---- 探测与初始化 ----
+
+bool IoRing::available() {
+#ifdef FTB_HAVE_IO_URING
+    static const bool usable = [] {
+        if (std::getenv("FTB_NO_IO_URING")) return false;
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        int fd = ringSetup(1, &params);
+        if (fd < 0) return false;
+        ::close(fd);
+        return true;
+    }();
+    return usable;
+#else
+    return false;
+#endif
+}
+
+IoRing::IoRing(unsigned entries, bool use_ring) {
+#ifdef FTB_HAVE_IO_URING
+    if (!use_ring || !available()) return;
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = ringSetup(std::max(1u, entries), &params);
+    if (fd < 0) return;
+
+    sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+
+    sq_map_ = ::mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                     IORING_OFF_SQ_RING);
+    if (sq_map_ == MAP_FAILED) {
+        sq_map_ = nullptr;
+        ::close(fd);
+        return;
+    }
+    cq_map_ = single ? sq_map_
+                     : ::mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                              IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                   IORING_OFF_SQES);
+    if (cq_map_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+        if (cq_map_ != MAP_FAILED && !single) ::munmap(cq_map_, cq_map_size_);
+        if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+        ::munmap(sq_map_, sq_map_size_);
+        sq_map_ = cq_map_ = sqes_ = nullptr;
+        ::close(fd);
+        return;
+    }
+
+    sq_head_  = at<unsigned>(sq_map_, params.sq_off.head);
+    sq_tail_  = at<unsigned>(sq_map_, params.sq_off.tail);
+    sq_mask_  = at<unsigned>(sq_map_, params.sq_off.ring_mask);
+    sq_array_ = at<unsigned>(sq_map_, params.sq_off.array);
+    cq_head_  = at<unsigned>(cq_map_, params.cq_off.head);
+    cq_tail_  = at<unsigned>(cq_map_, params.cq_off.tail);
+    cq_mask_  = at<unsigned>(cq_map_, params.cq_off.ring_mask);
+    cqes_     = at<io_uring_cqe>(cq_map_, params.cq_off.cqes);
+    sq_entries_ = params.sq_entries;
+    cq_entries_ = params.cq_entries;
+    ring_fd_ = fd;
+
+    // 逐个操作码确认内核支持，不支持的操作同步执行
+    constexpr unsigned kProbeOps = 256;
+    std::vector<char> probe_buf(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(probe_buf.data());
+    if (ringRegister(fd, IORING_REGISTER_PROBE, probe, kProbeOps) == 0) {
+        for (Op op : {Op::OpenAt, Op::Read, Op::Write, Op::Statx, Op::UnlinkAt, Op::Close}) {
+            uint8_t code = toOpcode(op);
+            if (code <= probe->last_op && code < probe->ops_len &&
+                (probe->ops[code].flags & IO_URING_OP_SUPPORTED)) {
+                supported_ |= bitOf(op);
+            }
+        }
+    }
+#else
+    (void)entries;
+    (void)use_ring;
+#endif
+}
+
+IoRing::~IoRing() {
+#ifdef FTB_HAVE_IO_URING
+    if (ring_fd_ < 0) return;
+    // 等待在途请求，避免内核在释放后写入调用方的缓冲区
+    std::vector<Completion> rest;
+    drain(rest);
+    ::munmap(sqes_, sqes_size_);
+    if (cq_map_ != sq_map_) ::munmap(cq_map_, cq_map_size_);
+    ::munmap(sq_map_, sq_map_size_);
+    ::close(ring_fd_);
+#endif
+}
+
+bool IoRing::supports(Op op) const {
+    return ring_fd_ >= 0 && (supported_ & bitOf(op));
+}
+
+// ---- 提交与完成 ----
+
+IoRing::Completion IoRing::runSync(const Request& r) {
+    long ret = -1;
+    switch (r.op) {
+        case Op::OpenAt:
+            ret = ::openat(r.fd, r.path, r.flags, static_cast<mode_t>(r.mode));
+            break;
+        case Op::Read:
+            ret = ::pread(r.fd, r.buf, r.len, static_cast<off_t>(r.offset));
+            break;
+        case Op::Write:
+            ret = ::pwrite(r.fd, r.buf, r.len, static_cast<off_t>(r.offset));
+            break;
+        case Op::Statx:
+#if defined(__linux__) && defined(STATX_TYPE)
+            ret = ::statx(r.fd, r.path, r.flags, r.mode, static_cast<struct statx*>(r.buf));
+#else
+            errno = ENOSYS;
+#endif
+            break;
+        case Op::UnlinkAt:
+            ret = ::unlinkat(r.fd, r.path, r.flags);
+            break;
+        case Op::Close:
+            ret = ::close(r.fd);
+            break;
+    }
+    return {r.user_data, ret < 0 ? -errno : static_cast<int>(ret)};
+}
+
+void IoRing::push(const Request& request) {
+#ifdef FTB_HAVE_IO_URING
+    if (supports(request.op)) {
+        // 在途数不超过完成队列容量，完成队列不会溢出
+        if (queued_ + in_flight_ >= cq_entries_) submitQueued(1);
+        if (queued_ >= sq_entries_) submitQueued(0);
+
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & *sq_mask_;
+        auto* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = toOpcode(request.op);
+        sqe->fd = request.fd;
+        sqe->user_data = request.user_data;
+        switch (request.op) {
+            case Op::OpenAt:
+                sqe->addr = reinterpret_cast<uintptr_t>(request.path);
+                sqe->len = request.mode;
+                sqe->open_flags = static_cast<uint32_t>(request.flags);
+                break;
+            case Op::Read:
+            case Op::Write:
+                sqe->addr = reinterpret_cast<uintptr_t>(request.buf);
+                sqe->len = request.len;
+                sqe->off = request.offset;
+                break;
+            case Op::Statx:
+                sqe->addr = reinterpret_cast<uintptr_t>(request.path);
+                sqe->len = request.mode;
+                sqe->off = reinterpret_cast<uintptr_t>(request.buf);
+                sqe->statx_flags = static_cast<uint32_t>(request.flags);
+                break;
+            case Op::UnlinkAt:
+                sqe->addr = reinterpret_cast<uintptr_t>(request.path);
+                sqe->unlink_flags = static_cast<uint32_t>(request.flags);
+                break;
+            case Op::Close:
+                break;
+        }
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++queued_;
+        return;
+    }
+#endif
+    ready_.push_back(runSync(request));
+}
+
+void IoRing::submitQueued(unsigned min_complete) {
+#ifdef FTB_HAVE_IO_URING
+    bool waited = min_complete == 0;
+    while (queued_ > 0 || !waited) {
+        unsigned to_submit = static_cast<unsigned>(queued_);
+        unsigned want = waited ? 0 : min_complete;
+        int ret = ringEnter(ring_fd_, to_submit, want, want ? IORING_ENTER_GETEVENTS : 0);
+        if (ret < 0) {
+            int err = errno;
+            if (err == EINTR) continue;
+            if ((err == EAGAIN || err == EBUSY) && in_flight_ > 0) {
+                // 内核暂时无法接收新请求：先等一个完成再重试
+                ringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+                reap();
+                continue;
+            }
+            // 无法提交：撤回尚未被内核取走的请求，以错误完成
+            unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+            unsigned tail = *sq_tail_;
+            for (unsigned i = head; i != tail; ++i) {
+                auto* sqe = static_cast<io_uring_sqe*>(sqes_) + sq_array_[i & *sq_mask_];
+                ready_.push_back({sqe->user_data, -err});
+            }
+            __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+            queued_ = 0;
+            break;
+        }
+        queued_ -= static_cast<size_t>(ret);
+        in_flight_ += static_cast<size_t>(ret);
+        // 只有全部提交成功时内核才会等待 min_complete
+        if (static_cast<unsigned>(ret) == to_submit) waited = true;
+    }
+    reap();
+#else
+    (void)min_complete;
+#endif
+}
+
+void IoRing::reap() {
+#ifdef FTB_HAVE_IO_URING
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    auto* cqes = static_cast<io_uring_cqe*>(cqes_);
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = cqes[head & *cq_mask_];
+        ready_.push_back({cqe.user_data, cqe.res});
+        --in_flight_;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+#endif
+}
+
+size_t IoRing::wait(std::vector<Completion>& out, size_t min_complete) {
+    size_t before = out.size();
+    if (ring_fd_ >= 0) {
+        size_t have = ready_.size();
+        size_t outstanding = queued_ + in_flight_;
+        size_t need = have < min_complete ? std::min(min_complete - have, outstanding) : 0;
+        if (queued_ > 0 || need > 0) {
+            submitQueued(static_cast<unsigned>(need));
+        } else if (in_flight_ > 0) {
+            reap();
+        }
+    }
+    out.insert(out.end(), ready_.begin(), ready_.end());
+    ready_.clear();
+    return out.size() - before;
+}
+
+size_t IoRing::drain(std::vector<Completion>& out) {
+    size_t before = out.size();
+    while (pending() > 0) wait(out, queued_ + in_flight_);
+    return out.size() - before;
+}
+
+}  // namespace FTB
@@ -0,0 +1,229 @@
+// PasteJob.cpp - 粘贴（复制 / 移动）任务的执行
+#include "../include/browser/PasteJob.hpp"
+#include "../include/browser/CopyJournal.hpp"
+#include "../include/browser/FileCopier.hpp"
+#include "../include/browser/RateLimiter.hpp"
+#include "../include/browser/SizeIndex.hpp"
+#include "../include/browser/TreeCopier.hpp"
+#include "../include/utils/FilesystemUtil.hpp"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+namespace FTB {
+
+namespace {
+
+fs::path resolve_dest(const fs::path& target, bool force_overwrite) {
+    if (!fs::exists(target)) return target;
+    if (force_overwrite) return target;
+
+    std::string stem = target.stem().string();
+    std::string ext = target.extension().string();
+    auto parent = target.parent_path();
+
+    for (int i = 1; i < 9999; ++i) {
+        fs::path p = parent / (stem + " (" + std::to_string(i) + ")" + ext);
+        if (!fs::exists(p)) return p;
+    }
+    return target;
+}
+
+// 统计目录树中的文件数与字节数（不含根目录本身）
+void count_tree(const fs::path& root, int& files, uintmax_t& bytes) {
+    std::error_code ec;
+    for (const auto& de : fs::recursive_directory_iterator(root, ec)) {
+        if (fs::is_regular_file(de.path())) {
+            auto sz = fs::file_size(de.path(), ec);
+            bytes += ec ? 0 : sz;
+            files += 1;
+        } else if (fs::is_directory(de.path())) {
+            files += 1;
+        }
+    }
+}
+
+// src 与目标目录位于同一设备时可以直接改名
+bool same_device(const fs::path& src, const fs::path& dst_dir) {
+    struct stat s, d;
+    return ::lstat(src.c_str(), &s) == 0 && ::stat(dst_dir.c_str(), &d) == 0 && s.st_dev == d.st_dev;
+}
+
+// 等待暂停解除；期间被取消返回 false
+bool wait_while_paused(const std::atomic<bool>& cancel, const std::atomic<bool>& pause) {
+    while (pause.load()) {
+        if (cancel.load()) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return !cancel.load();
+}
+
+// 由 FileCopier 选择 reflink / copy_file_range / sendfile / 缓冲复制，
+// 每块完成后更新进度、按全局限速等待，并响应取消与暂停；
+// 有日志时跳过已完成的文件，并从记录的偏移续传
+bool copy_file_chunked(const fs::path& src, const fs::path& dst,
+                       Progress& prog,
+                       const std::atomic<bool>& cancel,
+                       const std::atomic<bool>& pause,
+                       CopyJournal* journal) {
+    uintmax_t done_size = 0;
+    if (journal && journal->completed(src.string(), dst.string(), done_size)) {
+        prog.bytes_processed += done_size;
+        return true;
+    }
+    std::error_code ec;
+    fs::create_directories(dst.parent_path(), ec);
+
+    uintmax_t offset = journal ? journal->resumeOffset(dst.string()) : 0;
+    prog.bytes_processed += offset;
+    CopyJournal::FileCheckpoint checkpoint(journal, dst.string(), offset);
+    auto& limiter = RateLimiter::instance();
+    auto result = FileCopier::copyFile(src.string(), dst.string(),
+        [&prog, &cancel, &pause, &limiter, &checkpoint](uintmax_t bytes, bool hole) {
+            prog.bytes_processed += bytes;
+            checkpoint.advance(bytes);
+            return (hole || limiter.acquire(&prog, bytes, cancel)) && wait_while_paused(cancel, pause);
+        }, FileCopier::Method::Reflink, limiter.chunkHint(FileCopier::kKernelChunk), offset);
+    if (result.ok) checkpoint.complete();
+    return result.ok;
+}
+
+}  // namespace
+
+PasteJob::Plan PasteJob::collect(const std::vector<std::string>& items, const fs::path& target_dir,
+                                 bool force_overwrite, bool cut) {
+    Plan r;
+    for (const auto& item : items) {
+        fs::path src(item);
+        if (!fs::exists(src)) continue;
+
+        fs::path dst = resolve_dest(target_dir / src.filename(), force_overwrite);
+
+        // 同一文件系统内的剪切只是改名：不遍历源目录，进度按条目计而不计字节
+        if (cut && same_device(src, target_dir)) {
+            r.entries.push_back({src, dst, true});
+            r.total_files += 1;
+            continue;
+        }
+
+        if (fs::is_directory(src)) {
+            r.entries.push_back({src, dst});
+            r.total_files += 1;
+            count_tree(src, r.total_files, r.total_bytes);
+        } else if (fs::is_regular_file(src)) {
+            r.total_bytes += fs::file_size(src);
+            r.total_files += 1;
+            r.entries.push_back({src, dst});
+        }
+    }
+    return r;
+}
+
+bool PasteJob::run(std::vector<Entry>& entries, const Options& options, Progress& prog,
+                   const std::atomic<bool>& cancel, const std::atomic<bool>& pause) {
+    CopyJournal* journal = options.journal;
+    for (size_t index = 0; index < entries.size(); ++index) {
+        auto& entry = entries[index];
+        if (cancel.load()) return false;
+
+        // 恢复的任务：已完成的顶层条目只补上进度
+        int done_files = 0;
+        uintmax_t done_bytes = 0;
+        if (journal && journal->entryDone(index, done_files, done_bytes)) {
+            prog.files_processed += done_files;
+            prog.bytes_processed += done_bytes;
+            if (options.cut) entry.moved = true;
+            continue;
+        }
+        int files_before = prog.files_processed.load();
+        uintmax_t bytes_before = prog.bytes_processed.load();
+
+        if (!wait_while_paused(cancel, pause)) return false;
+
+        prog.current_file = entry.src.filename().string();
+        prog.current_target = entry.dst.string();
+
+        if (entry.rename) {
+            // 未指定覆盖时 RENAME_NOREPLACE，与 resolve_dest 的结果一致，不会覆盖期间出现的同名文件
+            auto rename = [&options](const fs::path& from, const fs::path& to) {
+                return options.rename ? options.rename(from, to, options.force_overwrite)
+                                      : renameNoReplace(from, to, options.force_overwrite);
+            };
+            int err = rename(entry.src, entry.dst);
+            // collect() 之后目标位置出现了同名条目：重新选择不冲突的名称
+            const fs::path wanted = entry.dst;
+            for (int retry = 0; err == EEXIST && !options.force_overwrite && retry < 8; ++retry) {
+                entry.dst = resolve_dest(wanted, false);
+                prog.current_target = entry.dst.string();
+                err = rename(entry.src, entry.dst);
+            }
+            if (err == 0) {
+                entry.moved = true;
+                ++prog.files_processed;
+                if (journal) journal->markEntry(index, 1, 0);
+                continue;
+            }
+            // 只有同一设备的不同挂载点（EXDEV）与要求覆盖时目录替换非空目录、文件替换目录
+            // 才退回复制后删除；其他错误（含多次重选名称仍冲突）整条失败。
+            // 此时目标不是本任务创建的，清空 dst 使 cleanup() 不会删除它
+            bool fallback = err == EXDEV ||
+                            (options.force_overwrite && (err == ENOTEMPTY || err == EEXIST || err == EISDIR));
+            if (!fallback) {
+                entry.dst.clear();
+                return false;
+            }
+            // 退回复制后删除，补上字节统计
+            int files = 0;
+            uintmax_t bytes = 0;
+            if (fs::is_directory(entry.src)) {
+                count_tree(entry.src, files, bytes);
+            } else {
+                std::error_code ec;
+                bytes = fs::file_size(entry.src, ec);
+                if (ec) bytes = 0;
+            }
+            prog.total_files += files;
+            prog.total_bytes += bytes;
+        }
+
+        if (fs::is_directory(entry.src)) {
+            // 遍历与复制流水线并行：大量小文件时受限于逐文件的打开/创建延迟而不是带宽
+            TreeCopier::Options tree_options;
+            tree_options.journal = journal;
+            tree_options.index = options.index;
+            if (!TreeCopier::copy(entry.src.string(), entry.dst.string(), prog, cancel, pause, tree_options))
+                return false;
+        } else if (fs::is_regular_file(entry.src)) {
+            bool copied = copy_file_chunked(entry.src, entry.dst, prog, cancel, pause, journal);
+            if (options.index) options.index->forget(entry.dst.parent_path().string());
+            if (!copied) return false;
+            ++prog.files_processed;
+        }
+
+        if (options.cut) {
+            entry.moved = true;
+            std::error_code ec;
+            fs::remove_all(entry.src, ec);
+        }
+        if (journal) {
+            journal->markEntry(index, prog.files_processed.load() - files_before,
+                               prog.bytes_processed.load() - bytes_before);
+        }
+    }
+    return true;
+}
+
+void PasteJob::cleanup(const std::vector<Entry>& entries) {
+    for (const auto& e : entries) {
+        if (e.moved) continue;  // 源已不在，目标就是唯一的副本
+        if (fs::exists(e.dst)) {
+            std::error_code ec;
+            fs::remove_all(e.dst, ec);
+        }
+    }
+}
+
+}  // namespace FTB
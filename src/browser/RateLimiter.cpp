@@ -0,0 +1,113 @@
+// RateLimiter.cpp - 全局字节令牌桶（按任务公平分配）
+#include "../include/browser/RateLimiter.hpp"
+
+#include <algorithm>
+
+namespace FTB {
+
+namespace {
+
+// 等待期间检查取消标志的间隔
+constexpr auto kCancelPoll = std::chrono::milliseconds(50);
+
+// 超过该数量时顺带清理其他已空闲的流
+constexpr size_t kFlowSweepThreshold = 64;
+
+}  // namespace
+
+RateLimiter& RateLimiter::instance() {
+    static RateLimiter limiter;
+    return limiter;
+}
+
+void RateLimiter::setRate(uintmax_t bytes_per_sec) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refill(now_());
+        rate_.store(bytes_per_sec, std::memory_order_relaxed);
+        // 新速率从满桶开始，之前积累的负债仍需偿还
+        double burst = static_cast<double>(bytes_per_sec) * kBurstSeconds;
+        tokens_ = tokens_ < 0 ? std::max(tokens_, -burst) : burst;
+    }
+    cv_.notify_all();
+}
+
+size_t RateLimiter::chunkHint(size_t max) const {
+    uintmax_t r = rate();
+    if (r == 0) return max;
+    return static_cast<size_t>(std::clamp<uintmax_t>(r / 10, kMinChunk, std::max<uintmax_t>(max, kMinChunk)));
+}
+
+size_t RateLimiter::waiting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void RateLimiter::refill(Clock::time_point now) {
+    if (last_refill_ != Clock::time_point{}) {
+        double r = static_cast<double>(rate_.load(std::memory_order_relaxed));
+        double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+        tokens_ = std::min(tokens_ + elapsed * r, r * kBurstSeconds);
+    }
+    last_refill_ = now;
+}
+
+// 没有等待中的请求且虚拟时间已被全局追上的流与新流等价，移除以免表无限增长
+void RateLimiter::forget(const void* flow, Flow& state) {
+    if (state.waiting == 0 && state.finish <= vtime_) flows_.erase(flow);
+    if (flows_.size() <= kFlowSweepThreshold) return;
+    for (auto it = flows_.begin(); it != flows_.end();) {
+        if (it->second.waiting == 0 && it->second.finish <= vtime_) {
+            it = flows_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool RateLimiter::acquire(const void* flow, uintmax_t bytes, const std::atomic<bool>& cancel) {
+    if (rate() == 0) return !cancel.load();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    Flow& state = flows_[flow];
+    Ticket ticket{std::max(vtime_, state.finish), next_seq_++};
+    state.finish = ticket.start + static_cast<double>(bytes);
+    ++state.waiting;
+    queue_.insert(ticket);
+
+    bool granted = false;
+    while (true) {
+        if (cancel.load()) break;
+        auto now = now_();
+        refill(now);
+        double r = static_cast<double>(rate_.load(std::memory_order_relaxed));
+        bool first = queue_.begin()->seq == ticket.seq;
+        if (r == 0 || (first && tokens_ >= 0)) {
+            tokens_ -= static_cast<double>(bytes);
+            vtime_ = std::max(vtime_, ticket.start);
+            granted = true;
+            break;
+        }
+        // 队首等待余额回正，其余请求等待队首放行后的通知
+        auto wait = kCancelPoll;
+        if (first && r > 0) {
+            auto until_positive = std::chrono::duration<double>(-tokens_ / r);
+            wait = std::min(wait, std::chrono::duration_cast<std::chrono::milliseconds>(until_positive) +
+                                      std::chrono::milliseconds(1));
+        }
+        cv_.wait_for(lock, wait);
+    }
+
+    queue_.erase(ticket);
+    --state.waiting;
+    if (!granted) {
+        // 放弃的请求不占用该流的份额
+        state.finish = std::max(ticket.start, state.finish - static_cast<double>(bytes));
+    }
+    forget(flow, state);
+    lock.unlock();
+    cv_.notify_all();
+    return granted;
+}
+
+}  // namespace FTB
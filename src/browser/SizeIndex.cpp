@@ -0,0 +1,271 @@
+// SizeIndex.cpp - 持久化的目录大小索引
+#include "../include/browser/SizeIndex.hpp"
+#include "../include/browser/DirScanner.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace FTB {
+
+namespace {
+
+// 文件格式（本机字节序）：
+//   头部  8 字节魔数 | u32 版本 | u32 保留 | u64 记录数
+//   记录  u64 dev | u64 ino | i64 mtime_sec | u32 mtime_nsec | u32 stored_day |
+//         u64 apparent | u64 disk | u64 files | u32 linked 数 | linked × (u64 ino | u64 apparent | u64 disk)
+constexpr char     kMagic[8] = {'F', 'T', 'B', 'S', 'I', 'D', 'X', '\0'};
+constexpr uint32_t kVersion = 2;   // 1: 第 5 个字段为最近取用的日期，不能作为期限
+
+uint32_t today() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::hours>(now).count() / 24);
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// 顺序读取定长字段，越界后所有读取失败
+class Reader {
+public:
+    explicit Reader(const std::string& data) : data_(data) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (data_.size() - pos_ < sizeof(T)) return false;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    size_t remaining() const { return data_.size() - pos_; }
+
+private:
+    const std::string& data_;
+    size_t             pos_ = 0;
+};
+
+}  // namespace
+
+std::string SizeIndex::defaultPath() {
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : "/tmp") + "/.config/ftb/size-index";
+}
+
+// 有意不析构：退出时后台统计线程可能仍在使用索引，改由 atexit 保存
+SizeIndex& SizeIndex::instance() {
+    static SizeIndex* index = [] {
+        auto* created = new SizeIndex(defaultPath());
+        created->load();
+        std::atexit([] {
+            SizeIndex& self = instance();
+            if (self.dirty_.load()) self.save();
+        });
+        return created;
+    }();
+    return *index;
+}
+
+SizeIndex::SizeIndex(std::string path) : path_(std::move(path)) {}
+
+SizeIndex::~SizeIndex() {
+    if (dirty_.load()) save();
+}
+
+bool SizeIndex::load() {
+    clear();
+    dirty_.store(false);
+    std::ifstream in(path_, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    std::string data(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(data.data(), static_cast<std::streamsize>(data.size()))) return false;
+
+    Reader reader(data);
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0, reserved = 0;
+    uint64_t count = 0;
+    for (char& c : magic) {
+        if (!reader.get(c)) return false;
+    }
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !reader.get(version) || version != kVersion ||
+        !reader.get(reserved) || !reader.get(count)) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        Key key{};
+        Record record;
+        uint64_t apparent = 0, disk = 0;
+        uint32_t linked = 0;
+        if (!reader.get(key.dev) || !reader.get(key.ino) || !reader.get(record.mtime_sec) ||
+            !reader.get(record.mtime_nsec) || !reader.get(record.stored_day) || !reader.get(apparent) ||
+            !reader.get(disk) || !reader.get(record.files) || !reader.get(linked) ||
+            linked > reader.remaining() / (3 * sizeof(uint64_t))) {
+            clear();
+            return false;
+        }
+        record.apparent = apparent;
+        record.disk = disk;
+        record.linked.resize(linked);
+        for (auto& l : record.linked) {
+            uint64_t l_apparent = 0, l_disk = 0;
+            reader.get(l.ino);
+            reader.get(l_apparent);
+            reader.get(l_disk);
+            l.apparent = l_apparent;
+            l.disk = l_disk;
+        }
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.records[key] = std::move(record);
+    }
+    return true;
+}
+
+bool SizeIndex::save() {
+    std::lock_guard<std::mutex> save_lock(save_mutex_);
+    dirty_.store(false);
+    last_save_ = std::chrono::steady_clock::now();
+
+    const uint32_t oldest = today() - std::min(today(), kMaxAgeDays);
+    std::string body;
+    uint64_t count = 0;
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.records.begin(); it != shard.records.end();) {
+            const Record& r = it->second;
+            if (r.stored_day < oldest) {
+                it = shard.records.erase(it);
+                continue;
+            }
+            put(body, it->first.dev);
+            put(body, it->first.ino);
+            put(body, r.mtime_sec);
+            put(body, r.mtime_nsec);
+            put(body, r.stored_day);
+            put(body, static_cast<uint64_t>(r.apparent));
+            put(body, static_cast<uint64_t>(r.disk));
+            put(body, r.files);
+            put(body, static_cast<uint32_t>(r.linked.size()));
+            for (const auto& l : r.linked) {
+                put(body, l.ino);
+                put(body, static_cast<uint64_t>(l.apparent));
+                put(body, static_cast<uint64_t>(l.disk));
+            }
+            ++count;
+            ++it;
+        }
+    }
+
+    std::string header(kMagic, sizeof(kMagic));
+    put(header, kVersion);
+    put(header, uint32_t{0});
+    put(header, count);
+
+    std::error_code ec;
+    fs::create_directories(fs::path(path_).parent_path(), ec);
+    const std::string tmp = path_ + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!out.flush()) {
+            out.close();
+            fs::remove(tmp, ec);
+            dirty_.store(true);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        fs::remove(tmp, ec);
+        dirty_.store(true);
+        return false;
+    }
+    return true;
+}
+
+void SizeIndex::maybeSave() {
+    if (!dirty_.load()) return;
+    {
+        std::lock_guard<std::mutex> lock(save_mutex_);
+        if (std::chrono::steady_clock::now() - last_save_ < kSaveInterval) return;
+    }
+    save();
+}
+
+bool SizeIndex::lookup(uint64_t dev, uint64_t ino, int64_t mtime_sec, uint32_t mtime_nsec, Record& out) {
+    Key key{dev, ino};
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.records.find(key);
+    if (it == shard.records.end() || it->second.mtime_sec != mtime_sec || it->second.mtime_nsec != mtime_nsec) {
+        return false;
+    }
+    // 过期的记录留给 store() 覆盖或 save() 丢弃
+    if (it->second.stored_day + kMaxAgeDays < today()) return false;
+    out = it->second;
+    return true;
+}
+
+void SizeIndex::store(uint64_t dev, uint64_t ino, Record record) {
+    record.stored_day = today();
+    Key key{dev, ino};
+    Shard& shard = shardOf(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.records[key] = std::move(record);
+    }
+    dirty_.store(true);
+}
+
+void SizeIndex::forget(uint64_t dev, uint64_t ino) {
+    Key key{dev, ino};
+    Shard& shard = shardOf(key);
+    bool erased = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        erased = shard.records.erase(key) > 0;
+    }
+    if (erased) dirty_.store(true);
+}
+
+// 与 DiskUsage 相同经 DirScanner::statAt 取得 (dev, ino)，编码一致
+void SizeIndex::forget(const std::string& dir) {
+    EntryStat st;
+    if (!DirScanner::statAt(AT_FDCWD, dir.c_str(), DirScanner::kStatType | DirScanner::kStatIno, st, true) ||
+        !S_ISDIR(st.mode)) {
+        return;
+    }
+    forget(st.dev, st.ino);
+}
+
+size_t SizeIndex::size() const {
+    size_t n = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        n += shard.records.size();
+    }
+    return n;
+}
+
+void SizeIndex::clear() {
+    for (Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.records.clear();
+    }
+    dirty_.store(true);
+}
+
+}  // namespace FTB
@@ -3,21 +3,10 @@
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <string_view>
 
 namespace FTB {
 
-static std::string toLower(const std::string& s) {
-    std::string r = s;
-    std::transform(r.begin(), r.end(), r.begin(), ::tolower);
-    return r;
-}
-
-static std::string getExtension(const std::string& name) {
-    auto dot = name.find_last_of('.');
-    if (dot == std::string::npos || dot == 0) return "";
-    return toLower(name.substr(dot));
-}
-
 SortMode SortModeFromString(const std::string& str) {
     if (str == "name_desc")  return SortMode::NameDesc;
     if (str == "size_asc")   return SortMode::SizeAsc;
@@ -26,6 +15,8 @@ SortMode SortModeFromString(const std::string& str) {
     if (str == "time_desc")  return SortMode::TimeDesc;
     if (str == "type")       return SortMode::Type;
     if (str == "extension")  return SortMode::Extension;
+    if (str == "tree_size_asc")  return SortMode::TreeSizeAsc;
+    if (str == "tree_size_desc") return SortMode::TreeSizeDesc;
     return SortMode::NameAsc;
 }
 
@@ -39,6 +30,8 @@ std::string SortModeToString(SortMode mode) {
     case SortMode::TimeDesc:   return "time_desc";
     case SortMode::Type:       return "type";
     case SortMode::Extension:  return "extension";
+    case SortMode::TreeSizeAsc:  return "tree_size_asc";
+    case SortMode::TreeSizeDesc: return "tree_size_desc";
     }
     return "name_asc";
 }
@@ -53,6 +46,8 @@ std::string SortModeDescription(SortMode mode) {
     case SortMode::TimeDesc:   return "Time (newest first)";
     case SortMode::Type:       return "Type (group by extension)";
     case SortMode::Extension:  return "Extension (alphabetical)";
+    case SortMode::TreeSizeAsc:  return "Disk usage (smallest first, folders included)";
+    case SortMode::TreeSizeDesc: return "Disk usage (largest first, folders included)";
     }
     return "";
 }
@@ -63,6 +58,8 @@ std::vector<SortMode> GetAllSortModes() {
         SortMode::NameDesc,
         SortMode::SizeAsc,
         SortMode::SizeDesc,
+        SortMode::TreeSizeAsc,
+        SortMode::TreeSizeDesc,
         SortMode::TimeAsc,
         SortMode::TimeDesc,
         SortMode::Type,
@@ -70,68 +67,101 @@ std::vector<SortMode> GetAllSortModes() {
     };
 }
 
-void SortEntries(std::vector<FileManager::DirEntryInfo>& entries, SortMode mode) {
-    const auto& cmp = [mode](const FileManager::DirEntryInfo& a, const FileManager::DirEntryInfo& b) -> bool {
+bool SortModeUsesMetadata(SortMode mode) {
+    switch (mode) {
+    case SortMode::SizeAsc:
+    case SortMode::SizeDesc:
+    case SortMode::TimeAsc:
+    case SortMode::TimeDesc:
+    case SortMode::TreeSizeAsc:
+    case SortMode::TreeSizeDesc:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool SortModeUsesTreeSize(SortMode mode) {
+    return mode == SortMode::TreeSizeAsc || mode == SortMode::TreeSizeDesc;
+}
+
+// 等价于 toLower(a) < toLower(b)，但不分配临时字符串
+static bool lessIgnoreCase(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; ++i) {
+        int ca = ::tolower(static_cast<unsigned char>(a[i]));
+        int cb = ::tolower(static_cast<unsigned char>(b[i]));
+        if (ca != cb) return static_cast<unsigned char>(ca) < static_cast<unsigned char>(cb);
+    }
+    return a.size() < b.size();
+}
+
+// 扩展名（含点号，隐藏文件的前导点不算），返回原字符串中的视图
+static std::string_view extensionOf(std::string_view name) {
+    auto dot = name.find_last_of('.');
+    if (dot == std::string_view::npos || dot == 0) return {};
+    return name.substr(dot);
+}
+
+bool CompareSortKeys(const EntrySortKey& a, const EntrySortKey& b, SortMode mode) {
+    // 类似 ncdu：目录与文件按大小混排，大小相同时目录在前
+    if (SortModeUsesTreeSize(mode)) {
+        if (a.size != b.size) return mode == SortMode::TreeSizeAsc ? a.size < b.size : a.size > b.size;
         if (a.is_dir != b.is_dir) return a.is_dir;
+        return lessIgnoreCase(a.name, b.name);
+    }
+    if (a.is_dir != b.is_dir) return a.is_dir;
 
-        switch (mode) {
-        case SortMode::NameAsc: {
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::NameDesc: {
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na > nb;
-        }
-        case SortMode::SizeAsc: {
-            if (a.is_dir) {
-                std::string na = toLower(a.name), nb = toLower(b.name);
-                return na < nb;
-            }
-            if (a.file_size != b.file_size) return a.file_size < b.file_size;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::SizeDesc: {
-            if (a.is_dir) {
-                std::string na = toLower(a.name), nb = toLower(b.name);
-                return na < nb;
-            }
-            if (a.file_size != b.file_size) return a.file_size > b.file_size;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::TimeAsc: {
-            auto cmp_time = a.mod_time.compare(b.mod_time);
-            if (cmp_time != 0) return cmp_time < 0;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::TimeDesc: {
-            auto cmp_time = a.mod_time.compare(b.mod_time);
-            if (cmp_time != 0) return cmp_time > 0;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::Type: {
-            std::string ext_a = getExtension(a.name);
-            std::string ext_b = getExtension(b.name);
-            if (ext_a != ext_b) return ext_a < ext_b;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        case SortMode::Extension: {
-            std::string ext_a = getExtension(a.name);
-            std::string ext_b = getExtension(b.name);
-            if (ext_a != ext_b) return ext_a < ext_b;
-            std::string na = toLower(a.name), nb = toLower(b.name);
-            return na < nb;
-        }
-        }
-        return false;
-    };
+    switch (mode) {
+    case SortMode::NameAsc:
+        return lessIgnoreCase(a.name, b.name);
+    case SortMode::NameDesc:
+        return lessIgnoreCase(b.name, a.name);
+    case SortMode::SizeAsc:
+        if (a.is_dir) return lessIgnoreCase(a.name, b.name);
+        if (a.size != b.size) return a.size < b.size;
+        return lessIgnoreCase(a.name, b.name);
+    case SortMode::SizeDesc:
+        if (a.is_dir) return lessIgnoreCase(a.name, b.name);
+        if (a.size != b.size) return a.size > b.size;
+        return lessIgnoreCase(a.name, b.name);
+    case SortMode::TimeAsc:
+        if (a.mtime != b.mtime) return a.mtime < b.mtime;
+        return lessIgnoreCase(a.name, b.name);
+    case SortMode::TimeDesc:
+        if (a.mtime != b.mtime) return a.mtime > b.mtime;
+        return lessIgnoreCase(a.name, b.name);
+    case SortMode::TreeSizeAsc:
+    case SortMode::TreeSizeDesc:
+        break;
+    case SortMode::Type:
+    case SortMode::Extension: {
+        auto ext_a = extensionOf(a.name);
+        auto ext_b = extensionOf(b.name);
+        if (lessIgnoreCase(ext_a, ext_b)) return true;
+        if (lessIgnoreCase(ext_b, ext_a)) return false;
+        return lessIgnoreCase(a.name, b.name);
+    }
+    }
+    return false;
+}
 
-    std::sort(entries.begin(), entries.end(), cmp);
+bool CompareEntries(const FileManager::DirEntryInfo& a, const FileManager::DirEntryInfo& b, SortMode mode) {
+    // 格式化后的时间字符串按字典序即按时间先后，仅在时间排序时才需要比较
+    if (a.is_dir == b.is_dir && (mode == SortMode::TimeAsc || mode == SortMode::TimeDesc)) {
+        auto cmp_time = a.mod_time.compare(b.mod_time);
+        if (cmp_time != 0) return mode == SortMode::TimeAsc ? cmp_time < 0 : cmp_time > 0;
+    }
+    EntrySortKey ka{a.name, a.is_dir, a.file_size, 0};
+    EntrySortKey kb{b.name, b.is_dir, b.file_size, 0};
+    return CompareSortKeys(ka, kb, mode);
+}
+
+void SortEntries(std::vector<FileManager::DirEntryInfo>& entries, SortMode mode) {
+    std::sort(entries.begin(), entries.end(),
+              [mode](const FileManager::DirEntryInfo& a, const FileManager::DirEntryInfo& b) {
+                  return CompareEntries(a, b, mode);
+              });
 }
 
 } // namespace FTB
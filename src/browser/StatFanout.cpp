@@ -0,0 +1,168 @@
+// StatFanout.cpp - 有界线程池上的并行 stat 分发
+#include "../include/browser/StatFanout.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FTB {
+
+namespace {
+
+// 进程内共享的常驻线程池；stat 以等待 I/O 为主，线程数可高于 CPU 核数
+class FanoutPool {
+public:
+    static FanoutPool& instance() {
+        static FanoutPool pool;
+        return pool;
+    }
+
+    void post(std::function<void()> fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(fn));
+        }
+        cv_.notify_one();
+    }
+
+    size_t size() const { return threads_.size(); }
+
+private:
+    FanoutPool() {
+        unsigned hc = std::thread::hardware_concurrency();
+        size_t n = std::clamp<size_t>(hc ? hc * 2 : 4, 4, 16);
+        threads_.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            threads_.emplace_back([this] { loop(); });
+        }
+    }
+
+    ~FanoutPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    void loop() {
+        for (;;) {
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                if (stop_ && queue_.empty()) return;
+                fn = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            fn();
+        }
+    }
+
+    std::vector<std::thread>          threads_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex                        mutex_;
+    std::condition_variable           cv_;
+    bool                              stop_ = false;
+};
+
+// 单次 run() 的共享状态；协助线程可能在 run() 返回后才出队，因此以 shared_ptr 持有
+struct FanoutJob {
+    size_t                                 count   = 0;
+    size_t                                 batches = 0;
+    const StatFanout::WorkFn*              work    = nullptr;
+    std::atomic<size_t>                    next{0};
+    std::unique_ptr<std::atomic<bool>[]>   done;
+    std::mutex                             mutex;
+    std::condition_variable                cv;
+
+    // 领取并执行一个批次；没有剩余批次时返回 false（此后不再访问 work）
+    bool runOne() {
+        size_t b = next.fetch_add(1, std::memory_order_relaxed);
+        if (b >= batches) return false;
+        size_t begin = b * StatFanout::kBatchSize;
+        size_t end = std::min(begin + StatFanout::kBatchSize, count);
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                (*work)(i);
+            } catch (...) {
+                // 单个条目失败不影响其余条目，由 work 自行记录状态
+            }
+        }
+        done[b].store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        cv.notify_one();
+        return true;
+    }
+};
+
+}  // namespace
+
+void StatFanout::run(size_t count, const WorkFn& work, const ReadyFn& on_ready) {
+    if (count == 0) return;
+
+    if (count < kParallelThreshold) {
+        for (size_t i = 0; i < count; ++i) work(i);
+        if (on_ready) on_ready(0, count);
+        return;
+    }
+
+    auto job = std::make_shared<FanoutJob>();
+    job->count = count;
+    job->batches = (count + kBatchSize - 1) / kBatchSize;
+    job->work = &work;
+    job->done.reset(new std::atomic<bool>[job->batches]);
+    for (size_t b = 0; b < job->batches; ++b) job->done[b].store(false);
+
+    auto& pool = FanoutPool::instance();
+    size_t helpers = std::min(pool.size(), job->batches - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        pool.post([job] {
+            while (job->runOne()) {
+            }
+        });
+    }
+
+    // 按顺序交付已连续完成的批次
+    size_t delivered = 0;
+    auto deliver = [&] {
+        size_t first = delivered;
+        while (delivered < job->batches && job->done[delivered].load(std::memory_order_acquire)) {
+            ++delivered;
+        }
+        if (on_ready && delivered > first) {
+            on_ready(first * kBatchSize, std::min(delivered * kBatchSize, count));
+        }
+    };
+
+    // 调用线程同样参与领取批次
+    while (job->runOne()) {
+        deliver();
+    }
+
+    while (delivered < job->batches) {
+        {
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->cv.wait(lock, [&] {
+                return job->done[delivered].load(std::memory_order_acquire);
+            });
+        }
+        deliver();
+    }
+}
+
+size_t StatFanout::workerCount() {
+    return FanoutPool::instance().size();
+}
+
+}  // namespace FTB
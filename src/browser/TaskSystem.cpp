@@ -1,7 +1,14 @@
 #include "browser/TaskSystem.hpp"
+#include "browser/RateLimiter.hpp"
 #include <algorithm>
 #include <thread>
 
+// 当前线程在 TaskSystem 中的工作线程序号，非工作线程为 -1
+static thread_local long t_worker_index = -1;
+
+// 等待子任务时在没有可执行工作的情况下的最长休眠
+static constexpr auto SUBTASK_POLL = std::chrono::milliseconds(10);
+
 TaskSystem& TaskSystem::getInstance() {
     static TaskSystem instance;
     return instance;
@@ -14,24 +21,34 @@ TaskSystem::~TaskSystem() {
 void TaskSystem::start() {
     if (running_.load()) return;
     should_stop_.store(false);
-    running_.store(true);
 
     size_t n = std::max<size_t>(1, max_workers_);
+    worker_queues_.clear();
+    for (size_t i = 0; i < n; ++i) {
+        worker_queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    running_.store(true);
+
     workers_.reserve(n);
     for (size_t i = 0; i < n; ++i) {
-        workers_.emplace_back(&TaskSystem::worker_loop, this);
+        workers_.emplace_back(&TaskSystem::worker_loop, this, i);
     }
 }
 
 void TaskSystem::stop() {
     if (!running_.load()) return;
     should_stop_.store(true);
-    cv_.notify_all();
+    notify_all_work();
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex_);
+    }
+    pause_cv_.notify_all();
 
     for (auto& w : workers_) {
         if (w.joinable()) w.join();
     }
     workers_.clear();
+    worker_queues_.clear();
     running_.store(false);
 }
 
@@ -41,12 +58,11 @@ std::string TaskSystem::submit(TaskRequest request) {
     }
 
     auto req = std::make_shared<TaskRequest>(std::move(request));
-    std::string task_id;
+    std::string task_id = std::to_string(next_id_++);
+    auto now = std::chrono::steady_clock::now();
 
     {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        task_id = std::to_string(next_id_++);
-
+        std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
         RunningTask rt;
         rt.title = req->title;
         rt.type = req->type;
@@ -54,37 +70,71 @@ std::string TaskSystem::submit(TaskRequest request) {
         rt.progress = std::make_shared<Progress>();
         rt.cancel = std::make_shared<std::atomic<bool>>(false);
         rt.pause = std::make_shared<std::atomic<bool>>(false);
-        rt.start_time = std::chrono::steady_clock::now();
+        rt.start_time = now;
+        rt.speed_sample_time = now;
         running_tasks_[task_id] = std::move(rt);
+    }
+
+    // 任务涉及的设备；新出现的设备在锁外读取 sysfs 识别类型
+    std::vector<uint64_t> devices;
+    for (const auto& path : req->io_paths) {
+        uint64_t dev = FTB::BlockDevice::deviceOf(path);
+        if (dev != 0) devices.push_back(dev);
+    }
+    std::sort(devices.begin(), devices.end());
+    devices.erase(std::unique(devices.begin(), devices.end()), devices.end());
+    std::vector<std::pair<uint64_t, FTB::BlockDevice::Kind>> probed;
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        for (uint64_t dev : devices) {
+            auto it = devices_.find(dev);
+            if (it == devices_.end() || !it->second.probed) probed.emplace_back(dev, FTB::BlockDevice::Kind::Unknown);
+        }
+    }
+    for (auto& [dev, kind] : probed) kind = FTB::BlockDevice::classify(dev);
 
-        switch (req->priority) {
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        for (const auto& [dev, kind] : probed) {
+            devices_[dev].kind = kind;
+            devices_[dev].probed = true;
+        }
+        Priority priority = req->priority;
+        QueuedEntry entry{task_id, std::move(req), now, std::move(devices)};
+        switch (priority) {
         case Priority::High:
-            high_queue_.push_back({task_id, std::move(req)});
+            high_queue_.push_back(std::move(entry));
             break;
         case Priority::Low:
-            low_queue_.push_back({task_id, std::move(req)});
+            low_queue_.push_back(std::move(entry));
             break;
         default:
-            normal_queue_.push_back({task_id, std::move(req)});
+            normal_queue_.push_back(std::move(entry));
             break;
         }
+        queued_count_.fetch_add(1);
     }
-    cv_.notify_one();
+    notify_work();
     return task_id;
 }
 
 bool TaskSystem::cancel(const std::string& task_id) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    auto it = running_tasks_.find(task_id);
-    if (it == running_tasks_.end()) return false;
-    it->second.cancel->store(true);
-    it->second.state = TaskState::Cancelled;
-    cv_.notify_all();
+    {
+        std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
+        auto it = running_tasks_.find(task_id);
+        if (it == running_tasks_.end()) return false;
+        it->second.cancel->store(true);
+        it->second.state = TaskState::Cancelled;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex_);
+    }
+    pause_cv_.notify_all();
     return true;
 }
 
 bool TaskSystem::pause(const std::string& task_id) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
+    std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
     auto it = running_tasks_.find(task_id);
     if (it == running_tasks_.end()) return false;
     it->second.pause->store(true);
@@ -93,12 +143,17 @@ bool TaskSystem::pause(const std::string& task_id) {
 }
 
 bool TaskSystem::resume(const std::string& task_id) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    auto it = running_tasks_.find(task_id);
-    if (it == running_tasks_.end()) return false;
-    it->second.pause->store(false);
-    it->second.state = TaskState::Running;
-    cv_.notify_all();
+    {
+        std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
+        auto it = running_tasks_.find(task_id);
+        if (it == running_tasks_.end()) return false;
+        it->second.pause->store(false);
+        it->second.state = TaskState::Running;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pause_mutex_);
+    }
+    pause_cv_.notify_all();
     return true;
 }
 
@@ -107,20 +162,28 @@ std::vector<TaskSnapshot> TaskSystem::get_snapshot() const {
     std::vector<TaskSnapshot> result;
 
     {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
+        std::shared_lock<std::shared_mutex> lock(tasks_mutex_);
+        std::lock_guard<std::mutex> speed_lock(speed_mutex_);
+        result.reserve(running_tasks_.size());
         for (const auto& [id, rt] : running_tasks_) {
-            double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
-                now - rt.start_time).count();
-            double speed = (elapsed > 0.001)
-                ? static_cast<double>(rt.progress->bytes_processed.load()) / elapsed
-                : 0.0;
+            uintmax_t bytes = rt.progress->bytes_processed.load();
+            double window = std::chrono::duration_cast<std::chrono::duration<double>>(
+                now - rt.speed_sample_time).count();
+            if (window >= SPEED_WINDOW_SECONDS) {
+                rt.speed = static_cast<double>(bytes - rt.speed_sample_bytes) / window;
+                rt.speed_sample_time = now;
+                rt.speed_sample_bytes = bytes;
+            }
+            // 第一个窗口结束前使用开始以来的平均速度
+            double speed = rt.speed >= 0.0 ? rt.speed
+                : (window > 0.001 ? static_cast<double>(bytes - rt.speed_sample_bytes) / window : 0.0);
 
             result.push_back({
                 id,
                 rt.title,
                 rt.state,
                 rt.type,
-                rt.progress->bytes_processed.load(),
+                bytes,
                 rt.progress->total_bytes.load(),
                 rt.progress->files_processed.load(),
                 rt.progress->total_files.load(),
@@ -140,7 +203,7 @@ std::vector<TaskSnapshot> TaskSystem::get_snapshot() const {
 }
 
 size_t TaskSystem::active_count() const {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
+    std::shared_lock<std::shared_mutex> lock(tasks_mutex_);
     size_t count = 0;
     for (const auto& [id, rt] : running_tasks_) {
         if (rt.state == TaskState::Running || rt.state == TaskState::Paused) {
@@ -151,151 +214,320 @@ size_t TaskSystem::active_count() const {
 }
 
 size_t TaskSystem::queue_depth() const {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return high_queue_.size() + normal_queue_.size() + low_queue_.size();
+    return queued_count_.load();
 }
 
 void TaskSystem::set_max_workers(size_t n) {
     max_workers_ = std::max<size_t>(1, n);
 }
 
+// 所有任务共享同一个令牌桶，并发任务之间按字节公平分配
 void TaskSystem::set_speed_limit(uintmax_t bytes_per_sec) {
     speed_limit_.store(bytes_per_sec);
+    FTB::RateLimiter::instance().setRate(bytes_per_sec);
 }
 
 uintmax_t TaskSystem::get_speed_limit() const {
     return speed_limit_.load();
 }
 
-std::shared_ptr<TaskSystem::QueuedEntry> TaskSystem::pop_next() {
-    auto pop_one = [](auto& q) -> std::shared_ptr<QueuedEntry> {
-        if (q.empty()) return nullptr;
-        auto entry = std::make_shared<QueuedEntry>(std::move(q.front()));
-        q.pop_front();
-        return entry;
-    };
+void TaskSystem::set_aging_interval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    aging_interval_ = interval;
+}
 
-    auto e = pop_one(high_queue_);
-    if (e) return e;
-    e = pop_one(normal_queue_);
-    if (e) return e;
-    return pop_one(low_queue_);
+void TaskSystem::set_device_concurrency(size_t rotational, size_t solid_state) {
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        rotational_limit_ = rotational;
+        solid_state_limit_ = solid_state;
+    }
+    notify_all_work();
 }
 
-void TaskSystem::worker_loop() {
-    while (!should_stop_.load()) {
-        std::shared_ptr<QueuedEntry> entry;
+void TaskSystem::set_device_limit(uint64_t dev, size_t n) {
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        devices_[dev].limit_override = n;
+    }
+    notify_all_work();
+}
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            cv_.wait(lock, [this] {
-                return should_stop_.load()
-                    || !high_queue_.empty()
-                    || !normal_queue_.empty()
-                    || !low_queue_.empty();
-            });
+// ---- 调度 ----
+
+size_t TaskSystem::device_limit(const DeviceSlot& slot) const {
+    if (slot.limit_override > 0) return slot.limit_override;
+    switch (slot.kind) {
+    case FTB::BlockDevice::Kind::Rotational:
+    case FTB::BlockDevice::Kind::Removable:
+        return rotational_limit_;
+    default:
+        return solid_state_limit_;
+    }
+}
+
+bool TaskSystem::devices_available(const QueuedEntry& entry) const {
+    for (uint64_t dev : entry.devices) {
+        auto it = devices_.find(dev);
+        if (it == devices_.end()) continue;
+        size_t limit = device_limit(it->second);
+        if (limit > 0 && it->second.running >= limit) return false;
+    }
+    return true;
+}
 
-            if (should_stop_.load()) break;
-            entry = pop_next();
+void TaskSystem::release_devices(const std::vector<uint64_t>& devices) {
+    if (devices.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        for (uint64_t dev : devices) {
+            auto it = devices_.find(dev);
+            if (it != devices_.end() && it->second.running > 0) --it->second.running;
         }
+    }
+    // 名额释放后等待该设备的任务可能不止一个工作线程可以接手
+    notify_all_work();
+}
 
-        if (!entry || !entry->request) continue;
+// 取出有效优先级最高的可运行任务：基础优先级 + 已等待的老化间隔数，同级时先提交的优先。
+// 所涉设备已满的任务留在队列中；每个队列内部按提交顺序排列，只需比较各队列第一个可运行的任务。
+bool TaskSystem::pop_next(QueuedEntry& out) {
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    double interval = std::chrono::duration<double, std::milli>(aging_interval_).count();
 
-        const std::string& task_id = entry->task_id;
-        auto& request = entry->request;
-        auto work_start = std::chrono::steady_clock::now();
+    std::deque<QueuedEntry>* best = nullptr;
+    std::deque<QueuedEntry>::iterator best_it;
+    double best_score = 0;
+    std::pair<std::deque<QueuedEntry>*, int> queues[] = {
+        {&high_queue_, 2}, {&normal_queue_, 1}, {&low_queue_, 0},
+    };
+    for (auto& [queue, level] : queues) {
+        auto it = std::find_if(queue->begin(), queue->end(),
+                               [this](const QueuedEntry& e) { return devices_available(e); });
+        if (it == queue->end()) continue;
+        double score = level;
+        if (interval > 0) {
+            score += std::chrono::duration<double, std::milli>(now - it->enqueue_time).count() / interval;
+        }
+        if (!best || score > best_score ||
+            (score == best_score && it->enqueue_time < best_it->enqueue_time)) {
+            best = queue;
+            best_it = it;
+            best_score = score;
+        }
+    }
+    if (!best) return false;
 
-        // Look up running task data
-        std::shared_ptr<Progress> progress;
-        std::shared_ptr<std::atomic<bool>> cancel_flag;
-        std::shared_ptr<std::atomic<bool>> pause_flag;
+    for (uint64_t dev : best_it->devices) ++devices_[dev].running;
+    out = std::move(*best_it);
+    best->erase(best_it);
+    queued_count_.fetch_sub(1);
+    return true;
+}
 
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            auto it = running_tasks_.find(task_id);
-            if (it != running_tasks_.end()) {
-                progress = it->second.progress;
-                cancel_flag = it->second.cancel;
-                pause_flag = it->second.pause;
-                it->second.state = TaskState::Running;
-                it->second.start_time = work_start;
-            }
+void TaskSystem::notify_work() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        work_epoch_.fetch_add(1);
+    }
+    idle_cv_.notify_one();
+}
+
+void TaskSystem::notify_all_work() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        work_epoch_.fetch_add(1);
+    }
+    idle_cv_.notify_all();
+}
+
+void TaskSystem::push_job(Job job) {
+    size_t n = worker_queues_.size();
+    size_t index = (t_worker_index >= 0 && static_cast<size_t>(t_worker_index) < n)
+        ? static_cast<size_t>(t_worker_index)
+        : next_queue_.fetch_add(1) % n;
+    {
+        std::lock_guard<std::mutex> lock(worker_queues_[index]->mutex);
+        worker_queues_[index]->jobs.push_back(std::move(job));
+    }
+    notify_work();
+}
+
+// 先取本线程队列的尾部，再从其他线程队列的头部窃取
+bool TaskSystem::take_job(Job& out) {
+    size_t n = worker_queues_.size();
+    if (n == 0) return false;
+    long self = (t_worker_index >= 0 && static_cast<size_t>(t_worker_index) < n) ? t_worker_index : -1;
+
+    if (self >= 0) {
+        auto& own = *worker_queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            out = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            return true;
         }
+    }
+    size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : next_queue_.load();
+    for (size_t k = 0; k < n; ++k) {
+        size_t index = (start + k) % n;
+        if (static_cast<long>(index) == self) continue;
+        auto& victim = *worker_queues_[index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            out = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
 
-        if (!progress) continue;
+void TaskSystem::run_job(Job& job) {
+    bool ok = false;
+    try {
+        ok = job.fn();
+    } catch (const std::exception&) {
+        ok = false;
+    }
+    if (!ok) job.group->failed.store(true);
+    if (job.group->pending.fetch_sub(1) == 1) {
+        // 最后一个子任务完成：唤醒在 wait_subtasks 中休眠的父任务
+        notify_all_work();
+    }
+}
 
-        // Check cancel before starting
-        if (cancel_flag->load()) {
-            if (request->cleanup) request->cleanup();
-            store_history(task_id, request->title, request->type,
-                          TaskState::Cancelled, *progress, work_start);
-            remove_running(task_id);
-            if (request->callback) request->callback(task_id, TaskState::Cancelled);
+void TaskSystem::worker_loop(size_t index) {
+    t_worker_index = static_cast<long>(index);
+    while (!should_stop_.load()) {
+        uint64_t epoch = work_epoch_.load();
+
+        // 已开始任务的子任务优先，先完成手头的工作再接新任务
+        Job job;
+        if (take_job(job)) {
+            run_job(job);
+            continue;
+        }
+        QueuedEntry entry;
+        if (pop_next(entry)) {
+            if (entry.request) run_task(entry);
+            release_devices(entry.devices);
             continue;
         }
 
-        // Check pause before starting — busy-wait with condition variable
-        if (pause_flag->load()) {
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                auto it = running_tasks_.find(task_id);
-                if (it != running_tasks_.end()) {
-                    it->second.state = TaskState::Paused;
-                }
-            }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_cv_.wait(lock, [this, epoch] {
+            return should_stop_.load() || work_epoch_.load() != epoch;
+        });
+    }
+    t_worker_index = -1;
+}
 
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            cv_.wait(lock, [this, pause_flag, cancel_flag] {
-                return should_stop_.load()
-                    || !pause_flag->load()
-                    || cancel_flag->load();
-            });
+void TaskSystem::set_state(const std::string& task_id, TaskState state) {
+    std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
+    auto it = running_tasks_.find(task_id);
+    if (it != running_tasks_.end()) {
+        it->second.state = state;
+    }
+}
 
-            if (should_stop_.load() || cancel_flag->load()) {
-                if (cancel_flag->load() && request->cleanup) request->cleanup();
-                store_history(task_id, request->title, request->type,
-                              cancel_flag->load() ? TaskState::Cancelled : TaskState::Pending,
-                              *progress, work_start);
-                remove_running(task_id);
-                if (request->callback)
-                    request->callback(task_id, cancel_flag->load() ? TaskState::Cancelled : TaskState::Pending);
-                continue;
-            }
+void TaskSystem::run_task(QueuedEntry& entry) {
+    const std::string& task_id = entry.task_id;
+    auto& request = entry.request;
+    auto work_start = std::chrono::steady_clock::now();
 
-            auto it = running_tasks_.find(task_id);
-            if (it != running_tasks_.end()) {
-                it->second.state = TaskState::Running;
-            }
+    // Look up running task data
+    std::shared_ptr<Progress> progress;
+    std::shared_ptr<std::atomic<bool>> cancel_flag;
+    std::shared_ptr<std::atomic<bool>> pause_flag;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
+        auto it = running_tasks_.find(task_id);
+        if (it != running_tasks_.end()) {
+            progress = it->second.progress;
+            cancel_flag = it->second.cancel;
+            pause_flag = it->second.pause;
+            it->second.state = TaskState::Running;
+            it->second.start_time = work_start;
+            it->second.speed_sample_time = work_start;
+            it->second.speed_sample_bytes = 0;
         }
+    }
+
+    if (!progress) return;
+
+    // Check cancel before starting
+    if (cancel_flag->load()) {
+        if (request->cleanup) request->cleanup();
+        store_history(task_id, request->title, request->type,
+                      TaskState::Cancelled, *progress, work_start);
+        remove_running(task_id);
+        if (request->callback) request->callback(task_id, TaskState::Cancelled);
+        return;
+    }
+
+    // Check pause before starting — wait on the pause condition variable
+    if (pause_flag->load()) {
+        set_state(task_id, TaskState::Paused);
 
-        // Execute the work function
-        TaskContext ctx{*progress, *cancel_flag, *pause_flag};
-        bool success = false;
-        try {
-            success = request->work(ctx);
-        } catch (const std::exception&) {
-            success = false;
+        {
+            std::unique_lock<std::mutex> lock(pause_mutex_);
+            pause_cv_.wait(lock, [this, pause_flag, cancel_flag] {
+                return should_stop_.load()
+                    || !pause_flag->load()
+                    || cancel_flag->load();
+            });
         }
 
-        // Determine final state
-        if (cancel_flag->load()) {
-            store_history(task_id, request->title, request->type,
-                          TaskState::Cancelled, *progress, work_start);
-            remove_running(task_id);
-            if (request->cleanup) request->cleanup();
-            if (request->callback) request->callback(task_id, TaskState::Cancelled);
-        } else if (!success) {
-            store_history(task_id, request->title, request->type,
-                          TaskState::Failed, *progress, work_start);
-            remove_running(task_id);
-            if (request->cleanup) request->cleanup();
-            if (request->callback) request->callback(task_id, TaskState::Failed);
-        } else {
+        if (should_stop_.load() || cancel_flag->load()) {
+            if (cancel_flag->load() && request->cleanup) request->cleanup();
             store_history(task_id, request->title, request->type,
-                          TaskState::Completed, *progress, work_start);
+                          cancel_flag->load() ? TaskState::Cancelled : TaskState::Pending,
+                          *progress, work_start);
             remove_running(task_id);
-            if (request->callback) request->callback(task_id, TaskState::Completed);
+            if (request->callback)
+                request->callback(task_id, cancel_flag->load() ? TaskState::Cancelled : TaskState::Pending);
+            return;
         }
+
+        set_state(task_id, TaskState::Running);
+    }
+
+    // Execute the work function
+    auto group = std::make_shared<TaskGroup>();
+    group->scheduled = true;
+    TaskContext ctx{*progress, *cancel_flag, *pause_flag, group};
+    bool success = false;
+    try {
+        success = request->work(ctx);
+    } catch (const std::exception&) {
+        success = false;
+    }
+    // 子任务引用本任务的 progress 等状态，未等待的子任务也必须在结束前完成
+    if (group->pending.load() > 0 && !ctx.wait_subtasks()) {
+        success = false;
+    }
+
+    // Determine final state
+    if (cancel_flag->load()) {
+        store_history(task_id, request->title, request->type,
+                      TaskState::Cancelled, *progress, work_start);
+        remove_running(task_id);
+        if (request->cleanup) request->cleanup();
+        if (request->callback) request->callback(task_id, TaskState::Cancelled);
+    } else if (!success) {
+        store_history(task_id, request->title, request->type,
+                      TaskState::Failed, *progress, work_start);
+        remove_running(task_id);
+        if (request->cleanup) request->cleanup();
+        if (request->callback) request->callback(task_id, TaskState::Failed);
+    } else {
+        store_history(task_id, request->title, request->type,
+                      TaskState::Completed, *progress, work_start);
+        remove_running(task_id);
+        if (request->callback) request->callback(task_id, TaskState::Completed);
     }
 }
 
@@ -325,6 +557,38 @@ void TaskSystem::store_history(const std::string& task_id, const std::string& ti
 }
 
 void TaskSystem::remove_running(const std::string& task_id) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
+    std::unique_lock<std::shared_mutex> lock(tasks_mutex_);
     running_tasks_.erase(task_id);
 }
+
+// ---- 子任务 ----
+
+void TaskContext::spawn(std::function<bool()> fn) {
+    auto& ts = TaskSystem::getInstance();
+    if (!subtasks) subtasks = std::make_shared<TaskGroup>();
+    if (!subtasks->scheduled || !ts.running_.load() || ts.should_stop_.load()) {
+        if (!fn()) subtasks->failed.store(true);
+        return;
+    }
+    subtasks->pending.fetch_add(1);
+    ts.push_job({std::move(fn), subtasks});
+}
+
+bool TaskContext::wait_subtasks() {
+    if (!subtasks) return true;
+    auto& ts = TaskSystem::getInstance();
+    while (subtasks->pending.load() > 0) {
+        uint64_t epoch = ts.work_epoch_.load();
+        // 等待期间执行子任务（本任务或其他任务的），避免所有工作线程都阻塞在等待上
+        TaskSystem::Job job;
+        if (ts.take_job(job)) {
+            ts.run_job(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(ts.idle_mutex_);
+        ts.idle_cv_.wait_for(lock, SUBTASK_POLL, [&] {
+            return subtasks->pending.load() == 0 || ts.work_epoch_.load() != epoch;
+        });
+    }
+    return !subtasks->failed.exchange(false);
+}
@@ -0,0 +1,339 @@
+// TreeCopier.cpp - 目录树的流水线并行复制
+#include "../include/browser/TreeCopier.hpp"
+#include "../include/browser/CopyJournal.hpp"
+#include "../include/browser/DirScanner.hpp"
+#include "../include/browser/FileCopier.hpp"
+#include "../include/browser/IoRing.hpp"
+#include "../include/browser/RateLimiter.hpp"
+#include "../include/browser/SizeIndex.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace FTB {
+
+namespace {
+
+struct CopyJob {
+    std::string src;
+    std::string dst;
+};
+
+// 有界的多消费者队列；close() 后 pop 取完剩余任务即返回 false
+class JobQueue {
+public:
+    explicit JobQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+    void push(CopyJob job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return jobs_.size() < capacity_; });
+        jobs_.push_back(std::move(job));
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+
+    bool pop(CopyJob& job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) return false;
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // 一次取出至多 max 个任务；队列关闭且为空时返回 false
+    bool popBatch(std::vector<CopyJob>& out, size_t max) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !jobs_.empty(); });
+        if (jobs_.empty()) return false;
+        size_t n = std::min(max, jobs_.size());
+        for (size_t i = 0; i < n; ++i) {
+            out.push_back(std::move(jobs_.front()));
+            jobs_.pop_front();
+        }
+        lock.unlock();
+        not_full_.notify_all();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+    }
+
+private:
+    const size_t            capacity_;
+    std::deque<CopyJob>     jobs_;
+    std::mutex              mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    bool                    closed_ = false;
+};
+
+// 等待暂停解除；期间被取消返回 false
+bool waitWhilePaused(const std::atomic<bool>& cancel, const std::atomic<bool>& pause) {
+    while (pause.load()) {
+        if (cancel.load()) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return !cancel.load();
+}
+
+bool makeDirectory(const std::string& path) {
+    return ::mkdir(path.c_str(), 0777) == 0 || errno == EEXIST;
+}
+
+#if defined(__linux__) && defined(STATX_TYPE)
+/**
+ * 经 IoRing 批量复制一组小文件：statx → open 源与目标 → read → write → close，
+ * 每个阶段一次提交整批请求。不适合整块读入的文件（非普通文件、空文件、超过上限）
+ * 以及任一阶段出错的文件留在 fallback 中，由调用方交给 FileCopier 逐个复制并报告错误。
+ * @return 被取消时返回 false（此时 fallback 中的任务不应再复制）
+ */
+template <typename KeepGoing>
+bool copySmallFiles(IoRing& ring, const std::vector<CopyJob>& jobs, Progress& progress,
+                    const std::atomic<bool>& cancel, const KeepGoing& keepGoing, std::vector<char>& arena,
+                    std::vector<const CopyJob*>& fallback, CopyJournal* journal) {
+    struct Slot {
+        struct statx stx;
+        int          src_fd = -1;
+        int          dst_fd = -1;
+        size_t       offset = 0;
+        bool         batched = false;
+    };
+    std::vector<Slot> slots(jobs.size());
+    std::vector<IoRing::Completion> done;
+    auto size = [&](size_t i) { return static_cast<unsigned>(slots[i].stx.stx_size); };
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        ring.push(IoRing::statx(IoRing::kCwd, jobs[i].src.c_str(), 0, STATX_TYPE | STATX_MODE | STATX_SIZE,
+                                &slots[i].stx, i));
+    }
+    ring.drain(done);
+    size_t total = 0;
+    for (const auto& c : done) {
+        Slot& slot = slots[c.user_data];
+        slot.batched = c.result == 0 && S_ISREG(slot.stx.stx_mode) && slot.stx.stx_size > 0 &&
+                       slot.stx.stx_size <= TreeCopier::kBatchFileSize;
+        if (slot.batched) {
+            slot.offset = total;
+            total += slot.stx.stx_size;
+        }
+    }
+    if (arena.size() < total) arena.resize(total);
+
+    // 每个阶段结束时未通过的文件退出批量路径
+    bool cancelled = !keepGoing();
+    auto phase = [&](auto&& submit, auto&& check) {
+        if (cancelled) return;
+        done.clear();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i].batched) submit(i);
+        }
+        ring.drain(done);
+        for (const auto& c : done) check(c);
+        cancelled = !keepGoing();
+    };
+
+    phase([&](size_t i) {
+        ring.push(IoRing::openAt(IoRing::kCwd, jobs[i].src.c_str(), O_RDONLY | O_CLOEXEC, 0, i * 2));
+        ring.push(IoRing::openAt(IoRing::kCwd, jobs[i].dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                 slots[i].stx.stx_mode & 0777, i * 2 + 1));
+    }, [&](const IoRing::Completion& c) {
+        Slot& slot = slots[c.user_data / 2];
+        (c.user_data % 2 ? slot.dst_fd : slot.src_fd) = c.result;
+        if (c.result < 0) slot.batched = false;
+    });
+    phase([&](size_t i) {
+        ring.push(IoRing::read(slots[i].src_fd, arena.data() + slots[i].offset, size(i), 0, i));
+    }, [&](const IoRing::Completion& c) {
+        if (c.result != static_cast<int>(size(c.user_data))) slots[c.user_data].batched = false;
+    });
+    phase([&](size_t i) {
+        ring.push(IoRing::write(slots[i].dst_fd, arena.data() + slots[i].offset, size(i), 0, i));
+    }, [&](const IoRing::Completion& c) {
+        if (c.result != static_cast<int>(size(c.user_data))) slots[c.user_data].batched = false;
+    });
+
+    // 无论成败都关闭已打开的描述符
+    for (auto& slot : slots) {
+        if (slot.src_fd >= 0) ring.push(IoRing::close(slot.src_fd, 0));
+        if (slot.dst_fd >= 0) ring.push(IoRing::close(slot.dst_fd, 0));
+    }
+    ring.drain(done);
+
+    if (cancelled) return false;
+    uintmax_t copied = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].batched) {
+            copied += slots[i].stx.stx_size;
+            progress.bytes_processed += slots[i].stx.stx_size;
+            ++progress.files_processed;
+            if (journal) journal->markFile(jobs[i].dst, slots[i].stx.stx_size);
+        } else {
+            fallback.push_back(&jobs[i]);
+        }
+    }
+    // 整批完成后一次扣除令牌，下一批在余额回正前不会开始
+    return RateLimiter::instance().acquire(&progress, copied, cancel) && keepGoing();
+}
+#endif
+
+}  // namespace
+
+size_t TreeCopier::defaultWorkers() {
+    unsigned hc = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hc ? hc : 4, 2, 8);
+}
+
+bool TreeCopier::copy(const std::string& src, const std::string& dst,
+                      Progress& progress,
+                      const std::atomic<bool>& cancel,
+                      const std::atomic<bool>& pause,
+                      const Options& options) {
+    std::error_code ec;
+    std::filesystem::create_directories(dst, ec);
+    if (ec) return false;
+
+    std::atomic<bool> failed{false};
+    auto keepGoing = [&] { return !failed.load() && waitWhilePaused(cancel, pause); };
+
+    // 复制线程：失败或取消后继续出队但不再复制，使遍历线程不会阻塞在满队列上
+    JobQueue queue(options.queue_capacity);
+    size_t worker_count = options.workers ? options.workers : defaultWorkers();
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    auto& limiter = RateLimiter::instance();
+    CopyJournal* journal = options.journal;
+    auto copyOne = [&](const CopyJob& job) {
+        uintmax_t offset = journal ? journal->resumeOffset(job.dst) : 0;
+        progress.bytes_processed += offset;
+        CopyJournal::FileCheckpoint checkpoint(journal, job.dst, offset);
+        auto result = FileCopier::copyFile(job.src, job.dst, [&](uintmax_t bytes, bool hole) {
+            progress.bytes_processed += bytes;
+            checkpoint.advance(bytes);
+            return (hole || limiter.acquire(&progress, bytes, cancel)) && keepGoing();
+        }, FileCopier::Method::Reflink, limiter.chunkHint(FileCopier::kKernelChunk), offset);
+        if (result.ok) {
+            checkpoint.complete();
+            ++progress.files_processed;
+        } else {
+            failed.store(true);
+        }
+    };
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back([&] {
+#if defined(__linux__) && defined(STATX_TYPE)
+            if (options.use_io_uring && IoRing::available()) {
+                // 每个复制线程一个 IoRing，一批小文件的各阶段请求同时在途
+                IoRing ring(static_cast<unsigned>(kRingBatch * 2));
+                std::vector<CopyJob> jobs;
+                std::vector<const CopyJob*> fallback;
+                std::vector<char> arena;
+                while (queue.popBatch(jobs, kRingBatch)) {
+                    if (keepGoing() && copySmallFiles(ring, jobs, progress, cancel, keepGoing, arena, fallback, journal)) {
+                        for (const CopyJob* job : fallback) {
+                            if (!keepGoing()) break;
+                            copyOne(*job);
+                        }
+                    }
+                    jobs.clear();
+                    fallback.clear();
+                }
+                return;
+            }
+#endif
+            CopyJob job;
+            while (queue.pop(job)) {
+                if (!keepGoing()) continue;
+                copyOne(job);
+            }
+        });
+    }
+
+    // 遍历线程（调用线程）：目录在入队其中的文件之前创建
+    std::vector<std::pair<std::string, std::string>> pending{{src, dst}};
+    std::vector<RawDirEntry> batch;
+    std::vector<std::string> written_dirs;
+    bool walked = true;
+    while (walked && !pending.empty()) {
+        auto [src_dir, dst_dir] = std::move(pending.back());
+        pending.pop_back();
+        if (options.index) written_dirs.push_back(dst_dir);
+
+        DirScanner scanner(src_dir);
+        if (!scanner.ok()) {
+            walked = false;
+            break;
+        }
+        batch.clear();
+        while (walked && scanner.next(batch)) {
+            for (const auto& raw : batch) {
+                if (!keepGoing()) {
+                    walked = false;
+                    break;
+                }
+                bool is_dir = raw.type == DT_DIR;
+                bool is_reg = raw.type == DT_REG;
+                bool is_link = raw.type == DT_LNK;
+                if (raw.type == DT_UNKNOWN || is_link) {
+                    // 与 fs::is_directory / is_regular_file 一致：按链接目标判断
+                    EntryStat st;
+                    if (!DirScanner::statAt(scanner.fd(), raw.name.c_str(), DirScanner::kStatType, st, true)) {
+                        continue;
+                    }
+                    is_dir = S_ISDIR(st.mode);
+                    is_reg = S_ISREG(st.mode);
+                }
+
+                std::string src_path = src_dir + "/" + raw.name;
+                std::string dst_path = dst_dir + "/" + raw.name;
+                if (is_dir) {
+                    if (!makeDirectory(dst_path)) {
+                        walked = false;
+                        break;
+                    }
+                    ++progress.files_processed;
+                    if (!is_link) pending.emplace_back(std::move(src_path), std::move(dst_path));
+                } else if (is_reg) {
+                    uintmax_t size = 0;
+                    if (journal && journal->completed(src_path, dst_path, size)) {
+                        progress.bytes_processed += size;
+                        ++progress.files_processed;
+                        continue;
+                    }
+                    progress.current_file = raw.name;
+                    queue.push({std::move(src_path), std::move(dst_path)});
+                }
+            }
+            batch.clear();
+        }
+        if (scanner.error() != 0) walked = false;
+    }
+
+    // 遍历出错（而非取消）时同样让复制线程停下：已入队的文件不再复制，进行中的在下一块返回
+    if (!walked) failed.store(true);
+    queue.close();
+    for (auto& worker : workers) worker.join();
+    for (const auto& dir : written_dirs) options.index->forget(dir);
+    return walked && !failed.load() && !cancel.load();
+}
+
+}  // namespace FTB
@@ -0,0 +1,119 @@
+// TreeSizeLoader.cpp - 后台统计子目录大小
+#include "../include/browser/TreeSizeLoader.hpp"
+#include "../include/browser/DiskUsage.hpp"
+#include "../include/browser/SizeIndex.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace FTB {
+
+// 后台线程与 UI 线程共享的状态；后台线程持有 shared_ptr，因此加载器可以先于线程销毁
+struct TreeSizeLoader::State {
+    std::string           prefix;   // 以 '/' 结尾的父目录
+    bool                  rescan = false;
+    SizeIndex*            index = nullptr;
+    std::atomic<bool>     cancel{false};
+    std::atomic<bool>     notify_armed{true};
+    std::function<void()> notify;
+
+    mutable std::mutex              mutex;
+    std::deque<std::string>         queue;     // 待统计的子目录
+    std::unordered_set<std::string> seen;      // 已排队过的子目录，enqueue 据此去重
+    std::vector<Result>             pending;
+    bool                            running = false;   // 后台线程是否在处理 queue
+    bool                            finished = false;
+};
+
+// 逐个取出 queue 中的子目录统计；队列取空时在同一把锁下清除 running 后退出，
+// 之后 enqueue 的名称由新线程处理，不会遗漏。finished 置位后不再访问 index 与 notify
+void TreeSizeLoader::run(std::shared_ptr<State> state) {
+    DiskUsage::Options options;
+    options.cancel = &state->cancel;
+    options.index = state->index;
+    options.refresh_index = state->rescan;
+    auto notify = [&state] {
+        if (state->notify && state->notify_armed.exchange(false)) state->notify();
+    };
+    for (;;) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->queue.empty()) break;
+            name = std::move(state->queue.front());
+            state->queue.pop_front();
+        }
+        auto report = DiskUsage::measure(state->prefix + name, options);
+        if (state->cancel.load()) return;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->pending.push_back(Result{std::move(name), report.total.apparent});
+        }
+        notify();
+    }
+    state->index->maybeSave();
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->queue.empty()) {
+            // 保存索引期间又有新名称入队：继续处理
+            std::thread(&TreeSizeLoader::run, std::move(state)).detach();
+            return;
+        }
+        state->running = false;
+        state->finished = true;
+    }
+}
+
+TreeSizeLoader::TreeSizeLoader(std::string path, std::vector<std::string> names, std::function<void()> notify,
+                               bool rescan, SizeIndex* index)
+    : path_(std::move(path)), state_(std::make_shared<State>()) {
+    state_->prefix = !path_.empty() && path_.back() == '/' ? path_ : path_ + "/";
+    state_->rescan = rescan;
+    state_->index = index ? index : &SizeIndex::instance();
+    state_->notify = std::move(notify);
+    enqueue(std::move(names));
+}
+
+TreeSizeLoader::~TreeSizeLoader() {
+    cancel();
+}
+
+void TreeSizeLoader::enqueue(std::vector<std::string> names) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    for (auto& name : names) {
+        if (state_->seen.insert(name).second) state_->queue.push_back(std::move(name));
+    }
+    if (state_->queue.empty()) {
+        state_->finished = !state_->running;
+        return;
+    }
+    state_->finished = false;
+    if (!state_->running) {
+        state_->running = true;
+        std::thread(&TreeSizeLoader::run, state_).detach();
+    }
+}
+
+bool TreeSizeLoader::finished() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->finished;
+}
+
+std::vector<TreeSizeLoader::Result> TreeSizeLoader::take() {
+    std::vector<Result> out;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(out, state_->pending);
+    }
+    state_->notify_armed.store(true);
+    return out;
+}
+
+void TreeSizeLoader::cancel() {
+    state_->cancel.store(true);
+}
+
+}  // namespace FTB
@@ -94,6 +94,8 @@ std::map<std::string, KeyBindings::PanelCommand> KeyBindings::InitCommandMap() {
     m["br"]         = PanelCommand::BatchRename;
     m["extract"]    = PanelCommand::Extract;
     m["ext"]        = PanelCommand::Extract;
+    m["rescan"]     = PanelCommand::RescanSizes;
+    m["du"]         = PanelCommand::RescanSizes;
     m["z"]          = PanelCommand::QuitWithCwd;
     m["exit"]       = PanelCommand::QuitWithCwd;
     m["quit"]       = PanelCommand::QuitWithCwd;
@@ -0,0 +1,291 @@
+#include "core/FuzzyMatcher.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+
+// ---- 字符类别 (决定边界加分) ----
+enum CharClass : uint8_t {
+    kWhite,
+    kNonWord,
+    kDelimiter,
+    kLower,
+    kUpper,
+    kLetter,   // 非 ASCII 字节 (UTF-8) 视为字母
+    kNumber,
+    kClassCount,
+};
+
+struct ClassTable {
+    uint8_t cls[256];
+    constexpr ClassTable() : cls() {
+        for (int c = 0; c < 256; ++c) {
+            if (c >= 'a' && c <= 'z') cls[c] = kLower;
+            else if (c >= 'A' && c <= 'Z') cls[c] = kUpper;
+            else if (c >= '0' && c <= '9') cls[c] = kNumber;
+            else if (c >= 0x80) cls[c] = kLetter;
+            else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') cls[c] = kWhite;
+            else if (c == '/' || c == ',' || c == ':' || c == ';' || c == '|') cls[c] = kDelimiter;
+            else cls[c] = kNonWord;
+        }
+    }
+};
+
+constexpr int BonusFor(int prev, int cur) {
+    if (cur > kDelimiter) {
+        if (prev == kWhite) return FuzzyPattern::kBonusBoundaryWhite;
+        if (prev == kDelimiter) return FuzzyPattern::kBonusBoundaryDelimiter;
+        if (prev == kNonWord) return FuzzyPattern::kBonusBoundary;
+    }
+    if ((prev == kLower && cur == kUpper) || (prev != kNumber && cur == kNumber)) {
+        return FuzzyPattern::kBonusCamel123;
+    }
+    if (cur == kNonWord || cur == kDelimiter) return FuzzyPattern::kBonusNonWord;
+    if (cur == kWhite) return FuzzyPattern::kBonusBoundaryWhite;
+    return 0;
+}
+
+struct BonusTable {
+    int8_t bonus[kClassCount][kClassCount];
+    constexpr BonusTable() : bonus() {
+        for (int p = 0; p < kClassCount; ++p)
+            for (int c = 0; c < kClassCount; ++c) bonus[p][c] = static_cast<int8_t>(BonusFor(p, c));
+    }
+};
+
+constexpr ClassTable kClasses;
+constexpr BonusTable kBonus;
+
+inline unsigned char Fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+// 字母按 (字节 | 0x20) 比较即可同时匹配大小写；其他字符必须精确相等
+inline unsigned char FoldMaskFor(unsigned char lowered) {
+    return (lowered >= 'a' && lowered <= 'z') ? 0x20 : 0;
+}
+
+// 在 [from, n) 中查找第一个等于 c（已转小写）的字符
+size_t FindFolded(const char* s, size_t n, size_t from, unsigned char c) {
+    const unsigned char fold = FoldMaskFor(c);
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(c));
+    const __m128i foldv = _mm_set1_epi8(static_cast<char>(fold));
+    for (; from + 16 <= n; from += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + from));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(chunk, foldv), needle)));
+        if (mask) return from + static_cast<size_t>(__builtin_ctz(mask));
+    }
+#endif
+    for (; from < n; ++from) {
+        if ((static_cast<unsigned char>(s[from]) | fold) == c) return from;
+    }
+    return npos;
+}
+
+// 在 [from, n) 中查找最后一个等于 c 的字符
+size_t FindLastFolded(const char* s, size_t n, size_t from, unsigned char c) {
+    const unsigned char fold = FoldMaskFor(c);
+    size_t end = n;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(c));
+    const __m128i foldv = _mm_set1_epi8(static_cast<char>(fold));
+    for (; end >= from + 16; end -= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + end - 16));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(chunk, foldv), needle)));
+        if (mask) return end - 16 + static_cast<size_t>(31 - __builtin_clz(mask));
+    }
+#endif
+    while (end > from) {
+        --end;
+        if ((static_cast<unsigned char>(s[end]) | fold) == c) return end;
+    }
+    return npos;
+}
+
+// 每个线程复用的打分缓冲，按窗口长度增长
+struct Scratch {
+    std::vector<size_t>        first;   // 每个查询字符最早可匹配的位置
+    std::vector<unsigned char> text;    // 窗口内转小写后的字符
+    std::vector<int>           bonus;
+    std::vector<int>           h[2];    // 滚动的两行得分
+    std::vector<int>           c[2];    // 滚动的两行连续匹配长度
+};
+
+}  // namespace
+
+FuzzyPattern::FuzzyPattern(std::string_view query) : query_(query) {
+    for (auto& ch : query_) ch = static_cast<char>(Fold(static_cast<unsigned char>(ch)));
+}
+
+bool FuzzyPattern::isSubsequence(std::string_view query, std::string_view text) {
+    size_t pos = 0;
+    for (char qc : query) {
+        pos = FindFolded(text.data(), text.size(), pos, Fold(static_cast<unsigned char>(qc)));
+        if (pos == npos) return false;
+        ++pos;
+    }
+    return true;
+}
+
+bool FuzzyPattern::matches(std::string_view text) const {
+    size_t pos = 0;
+    for (char qc : query_) {
+        pos = FindFolded(text.data(), text.size(), pos, static_cast<unsigned char>(qc));
+        if (pos == npos) return false;
+        ++pos;
+    }
+    return true;
+}
+
+int FuzzyPattern::score(std::string_view text) const {
+    const size_t m = query_.size();
+    const size_t n = text.size();
+    if (m == 0) return 0;
+    if (m > n) return kNoMatch;
+
+    thread_local Scratch s;
+    const auto* q = reinterpret_cast<const unsigned char*>(query_.data());
+
+    // 1. 预筛：按序找出每个查询字符最早的位置，不是子序列时直接返回
+    s.first.resize(m);
+    size_t pos = 0;
+    for (size_t j = 0; j < m; ++j) {
+        pos = FindFolded(text.data(), n, pos, q[j]);
+        if (pos == npos) return kNoMatch;
+        s.first[j] = pos++;
+    }
+
+    // 2. 打分窗口：首字符最早的位置到末字符最后的位置
+    const size_t base = s.first[0];
+    const size_t last = FindLastFolded(text.data(), n, s.first[m - 1], q[m - 1]);
+    const size_t w = last - base + 1;
+
+    s.text.resize(w);
+    s.bonus.resize(w);
+    // 路径开头视同跟在分隔符之后
+    const auto before = base > 0 ? static_cast<unsigned char>(text[base - 1]) : static_cast<unsigned char>('/');
+    int prev_class = kClasses.cls[before];
+    for (size_t k = 0; k < w; ++k) {
+        const auto ch = static_cast<unsigned char>(text[base + k]);
+        const int cls = kClasses.cls[ch];
+        s.text[k] = Fold(ch);
+        s.bonus[k] = kBonus.bonus[prev_class][cls];
+        prev_class = cls;
+    }
+    for (auto& row : s.h) row.resize(w);
+    for (auto& row : s.c) row.resize(w);
+
+    // 3. 首行：以此处为首字符，或沿用左侧更早的首字符并扣除间隔，取较优者
+    int best = 0;
+    {
+        int* h = s.h[0].data();
+        int* c = s.c[0].data();
+        int left = 0;
+        bool in_gap = false;
+        for (size_t k = 0; k < w; ++k) {
+            const int gap = std::max(left + (in_gap ? kScoreGapExtension : kScoreGapStart), 0);
+            const int start = s.text[k] == q[0] ? kScoreMatch + s.bonus[k] * kBonusFirstCharMultiplier : 0;
+            if (start > 0 && start >= gap) {
+                left = start;
+                c[k] = 1;
+                in_gap = false;
+            } else {
+                left = gap;
+                c[k] = 0;
+                in_gap = true;
+            }
+            h[k] = left;
+            if (m == 1) best = std::max(best, left);
+        }
+    }
+
+    // 4. 其余各行：匹配（对角线）或间隔（左侧）中取较优者
+    for (size_t j = 1; j < m; ++j) {
+        const int* ph = s.h[(j - 1) & 1].data();
+        const int* pc = s.c[(j - 1) & 1].data();
+        int* h = s.h[j & 1].data();
+        int* c = s.c[j & 1].data();
+        int left = 0;
+        bool in_gap = false;
+        for (size_t k = s.first[j] - base; k < w; ++k) {
+            int diag = 0;
+            const int gap = left + (in_gap ? kScoreGapExtension : kScoreGapStart);
+            int consecutive = 0;
+            if (s.text[k] == q[j]) {
+                diag = ph[k - 1] + kScoreMatch;
+                int b = s.bonus[k];
+                consecutive = pc[k - 1] + 1;
+                if (consecutive > 1) {
+                    // 连续匹配沿用首字符的加分；遇到更强的边界则从这里重新开始
+                    const int first_bonus = s.bonus[k - consecutive + 1];
+                    if (b >= kBonusBoundary && b > first_bonus) {
+                        consecutive = 1;
+                    } else {
+                        b = std::max(b, std::max(kBonusConsecutive, first_bonus));
+                    }
+                }
+                if (diag + b < gap) {
+                    diag += s.bonus[k];
+                    consecutive = 0;
+                } else {
+                    diag += b;
+                }
+            }
+            c[k] = consecutive;
+            in_gap = diag < gap;
+            left = std::max(std::max(diag, gap), 0);
+            h[k] = left;
+            if (j == m - 1) best = std::max(best, left);
+        }
+    }
+    return best;
+}
+
+// ---- FuzzyTopK ----
+
+bool FuzzyTopK::better(int a_score, std::string_view a, int b_score, std::string_view b) {
+    if (a_score != b_score) return a_score > b_score;
+    if (a.size() != b.size()) return a.size() < b.size();
+    return a < b;
+}
+
+namespace {
+struct ItemBetter {
+    bool operator()(const FuzzyTopK::Item& a, const FuzzyTopK::Item& b) const {
+        return FuzzyTopK::better(a.score, a.text, b.score, b.text);
+    }
+};
+}  // namespace
+
+bool FuzzyTopK::offer(int score, std::string_view text) {
+    if (capacity_ == 0) return false;
+    if (heap_.size() < capacity_) {
+        heap_.push_back(Item{score, std::string(text)});
+        std::push_heap(heap_.begin(), heap_.end(), ItemBetter{});
+        return true;
+    }
+    // 先与堆顶比较，被拒绝的候选不复制
+    const Item& worst = heap_.front();
+    if (!better(score, text, worst.score, worst.text)) return false;
+    std::pop_heap(heap_.begin(), heap_.end(), ItemBetter{});
+    heap_.back().score = score;
+    heap_.back().text.assign(text.data(), text.size());
+    std::push_heap(heap_.begin(), heap_.end(), ItemBetter{});
+    return true;
+}
+
+std::vector<FuzzyTopK::Item> FuzzyTopK::sorted() const {
+    std::vector<Item> out = heap_;
+    std::sort(out.begin(), out.end(), ItemBetter{});
+    return out;
+}
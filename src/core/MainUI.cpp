@@ -1,13 +1,16 @@
 #include "core/MainUI.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <filesystem>
 #include <mutex>
+#include <utility>
 #include <unistd.h>
 #include <ftxui/screen/terminal.hpp>
 
 #include "preview/PreviewCache.hpp"
+#include "browser/EntryTable.hpp"
 #include "browser/FileManager.hpp"
 #include "config/ConfigManager.hpp"
 #include "browser/SortMode.hpp"
@@ -18,7 +21,67 @@ namespace FTB {
 
 using namespace ftxui;
 
+namespace {
+
+// inotify 监听线程与 UI 线程之间的桥：只有当前显示的目录（当前列与父列）变化时才唤醒界面
+struct VisibleDirectories {
+    std::mutex                mutex;
+    std::string               current;
+    std::string               parent;
+    bool                      current_changed = false;
+    bool                      parent_changed = false;
+    ftxui::ScreenInteractive* screen = nullptr;
+};
+
+VisibleDirectories& visibleDirectories() {
+    static VisibleDirectories dirs;
+    return dirs;
+}
+
+void OnDirectoryChanged(const std::string& dir) {
+    auto& v = visibleDirectories();
+    ftxui::ScreenInteractive* screen = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(v.mutex);
+        if (dir == v.current) v.current_changed = true;
+        if (dir == v.parent) v.parent_changed = true;
+        if (!v.current_changed && !v.parent_changed) return;
+        screen = v.screen;
+    }
+    if (screen) screen->Post(Event::Custom);
+}
+
+// 记录当前显示的目录；目录切换时丢弃旧目录遗留的变更标记
+void PublishVisibleDirectories(const MainState& state) {
+    static std::once_flag once;
+    std::call_once(once, [] { FileManager::setDirectoryChangeListener(OnDirectoryChanged); });
+
+    auto& v = visibleDirectories();
+    std::lock_guard<std::mutex> lock(v.mutex);
+    v.screen = state.screen;
+    if (v.current != state.currentPath) {
+        v.current = state.currentPath;
+        v.current_changed = false;
+    }
+    if (v.parent != state.cached_parent_path) {
+        v.parent = state.cached_parent_path;
+        v.parent_changed = false;
+    }
+}
+
+bool TakeDirectoryChange(bool VisibleDirectories::*flag) {
+    auto& v = visibleDirectories();
+    std::lock_guard<std::mutex> lock(v.mutex);
+    return std::exchange(v.*flag, false);
+}
+
+}  // namespace
+
 void UpdatePathCache(MainState& state) {
+    // 父目录内容变化：丢弃规范路径缓存以重新获取父列条目
+    if (TakeDirectoryChange(&VisibleDirectories::parent_changed)) {
+        state.cached_canonical_path.clear();
+    }
     try {
         fs::path canon = fs::canonical(state.currentPath);
         std::string new_canonical = canon.string();
@@ -39,19 +102,14 @@ void UpdatePathCache(MainState& state) {
         }
 
         if (!parent.empty() && parent != canon) {
-            state.cached_parent_entries = FileManager::getDirectoryEntries(state.cached_parent_path, state.currentSortMode());
+            state.cached_parent_entries = FileManager::getEntryTable(state.cached_parent_path, state.currentSortMode());
         } else {
             state.cached_parent_entries.clear();
         }
 
         std::string currentDirName = canon.filename().string();
-        state.cached_parent_selected = -1;
-        for (int i = 0; i < static_cast<int>(state.cached_parent_entries.size()); ++i) {
-            if (state.cached_parent_entries[i].name == currentDirName) {
-                state.cached_parent_selected = i;
-                break;
-            }
-        }
+        size_t parent_pos = state.cached_parent_entries.find(currentDirName, state.currentSortMode());
+        state.cached_parent_selected = (parent_pos == EntryTable::npos) ? -1 : static_cast<int>(parent_pos);
     } catch (...) {
         state.cached_canonical_path = state.currentPath;
         state.cached_parent_path = "";
@@ -69,40 +127,280 @@ void UpdatePathCache(MainState& state) {
     }
 }
 
-void UpdateCurrentEntryCache(MainState& state) {
-    bool force_refresh = false;
-    try {
-        auto dir_mtime = fs::last_write_time(state.currentPath);
-        if (dir_mtime != state.cached_dir_mtime) {
-            force_refresh = true;
-            state.cached_dir_mtime = dir_mtime;
+// 进入未缓存目录时最多等待首批结果的时长，保证首帧有内容可画
+static constexpr auto kFirstPaintWait = std::chrono::milliseconds(30);
+
+// 由 cached_current_entries 重建名称列表与名称索引
+static void RebuildEntryIndex(MainState& state) {
+    const auto& entries = state.cached_current_entries;
+    state.allContents.clear();
+    state.allContents.reserve(entries.size());
+    state.cached_entry_index.clear();
+    state.cached_entry_index.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        state.allContents.emplace_back(entries.name(i));
+        state.cached_entry_index.emplace(state.allContents.back(), i);
+    }
+}
+
+static void SetCurrentEntries(MainState& state, EntryTable entries) {
+    state.cached_current_entries = std::move(entries);
+    state.loaded_entries_path = state.currentPath;
+    state.tree_sizes_applied = false;
+    RebuildEntryIndex(state);
+    if (!state.search_mode) {
+        state.filteredContents = state.allContents;
+    }
+}
+
+// 第 from 个条目被移到 to 后，只更新名称列表与索引中位于两者之间的部分
+static void MoveEntryIndex(MainState& state, size_t from, size_t to) {
+    if (from == to) return;
+    auto move_name = [from, to](std::vector<std::string>& names) {
+        std::string name = std::move(names[from]);
+        names.erase(names.begin() + static_cast<std::ptrdiff_t>(from));
+        names.insert(names.begin() + static_cast<std::ptrdiff_t>(to), std::move(name));
+    };
+    move_name(state.allContents);
+    if (!state.search_mode) move_name(state.filteredContents);
+    for (size_t i = std::min(from, to); i <= std::max(from, to); ++i) {
+        state.cached_entry_index[state.allContents[i]] = i;
+    }
+}
+
+// 将后台加载器发布的批次合并进当前列表。
+// 名称批次改变了条目位置，在本次合并的最后重建一次索引；只有元信息的批次不改变顺序，
+// 只需逐个移动类型变化的条目——百万条目的目录中，统计阶段每帧不再重建整个列表
+static void DrainDirectoryLoad(MainState& state) {
+    if (!state.dir_loader) return;
+    if (state.dir_loader->path() != state.currentPath) {
+        state.dir_loader.reset();
+        return;
+    }
+
+    auto update = state.dir_loader->take();
+    if (update.names.empty() && update.metadata.empty() && !update.finished) return;
+
+    // 用户已移动过光标时按名称保持选中项，避免新批次插入导致跳行
+    if (state.selected > 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
+        state.pending_select_name = state.filteredContents[state.selected];
+    }
+
+    SortMode mode = state.currentSortMode();
+    auto& entries = state.cached_current_entries;
+    bool reindex = false;
+
+    if (update.finished) {
+        entries = std::move(update.final_entries);
+        SortMode config_mode = SortModeFromString(ConfigManager::GetInstance()->GetConfig().style.sort_mode);
+        if (mode != config_mode) {
+            entries.sort(mode);
+        }
+        state.dir_loader.reset();
+        reindex = true;
+    } else {
+        // 大小/时间排序在元信息到齐前无法确定，流式阶段先按名称排列，完成时再整体排序
+        SortMode merge_mode = SortModeUsesMetadata(mode) ? SortMode::NameAsc : mode;
+        if (!update.names.empty()) {
+            entries.mergeSorted(std::move(update.names), merge_mode);
+            reindex = true;
+        }
+        // merge_mode 下按名称二分查找，不依赖尚未重建的索引
+        const auto& metadata = update.metadata;
+        for (size_t pos = 0; pos < metadata.size(); ++pos) {
+            size_t idx = entries.find(metadata.name(pos), merge_mode);
+            if (idx == EntryTable::npos) continue;
+            bool was_dir = entries.isDir(idx);
+            entries.copyMetadata(idx, metadata, pos);
+            if (was_dir == metadata.isDir(pos)) continue;
+            // 指向目录的符号链接：类型变化会改变排序位置，重新定位
+            size_t moved = entries.reposition(idx, merge_mode);
+            if (!reindex) MoveEntryIndex(state, idx, moved);
+        }
+    }
+
+    state.loaded_entries_path = state.currentPath;
+    state.tree_sizes_applied = false;
+    if (reindex) {
+        RebuildEntryIndex(state);
+        if (!state.search_mode) {
+            state.filteredContents = state.allContents;
         }
-    } catch (...) {
-        force_refresh = true;
     }
+}
+
+// 一次到达的结果超过此数时整体重排，而不是逐个移动
+static constexpr size_t kTreeSizeRepositionLimit = 64;
 
-    if (!force_refresh && state.currentPath == state.cached_current_path_for_entries) {
+static void StartTreeSizeLoader(MainState& state, std::vector<std::string> dirs) {
+    ftxui::ScreenInteractive* screen = state.screen;
+    state.tree_size_loader = std::make_shared<TreeSizeLoader>(
+        state.currentPath, std::move(dirs),
+        [screen] {
+            if (screen) screen->Post(Event::Custom);
+        },
+        state.tree_size_rescan);
+    state.tree_size_rescan = false;
+}
+
+// 子树大小排序：目录加载完成后在后台统计各子目录，结果到达后把目录移到按大小应处的位置。
+// 选中项按名称保持，列表在用户浏览时逐步变成类似 ncdu 的视图
+static void UpdateTreeSizes(MainState& state) {
+    SortMode mode = state.currentSortMode();
+    if (!SortModeUsesTreeSize(mode)) {
+        state.tree_size_loader.reset();
+        state.tree_sizes.clear();
+        state.tree_size_rescan = false;
         return;
     }
-    state.cached_current_path_for_entries = state.currentPath;
+    // 加载期间条目尚不完整，等最终结果到齐后再统计
+    if (state.dir_loader || state.loaded_entries_path != state.currentPath) return;
 
-    if (force_refresh) {
-        std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-        FileManager::lru_dir_cache->erase(state.currentPath);
-        FileManager::lru_entry_cache->erase(state.currentPath);
+    auto& entries = state.cached_current_entries;
+    auto list_dirs = [&entries](const std::unordered_map<std::string, uint64_t>& skip) {
+        std::vector<std::string> dirs;
+        for (size_t pos = 0; pos < entries.size(); ++pos) {
+            if (!entries.isDir(pos) || entries.isSymlink(pos)) continue;
+            std::string name(entries.name(pos));
+            if (skip.find(name) == skip.end()) dirs.push_back(std::move(name));
+        }
+        return dirs;
+    };
+
+    if (!state.tree_size_loader || state.tree_size_loader->path() != state.currentPath) {
+        state.tree_sizes.clear();
+        state.tree_sizes_applied = true;
+        StartTreeSizeLoader(state, list_dirs(state.tree_sizes));
+        return;
     }
 
-    state.cached_current_entries = FileManager::getDirectoryEntries(state.currentPath, state.currentSortMode());
-    state.allContents.clear();
-    for (const auto& e : state.cached_current_entries) {
-        state.allContents.push_back(e.name);
+    auto results = state.tree_size_loader->take();
+    if (results.empty() && state.tree_sizes_applied) return;
+
+    if (state.selected >= 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
+        state.pending_select_name = state.filteredContents[state.selected];
+    }
+
+    if (!state.tree_sizes_applied || results.size() > kTreeSizeRepositionLimit) {
+        // 条目表被重新加载（大小已清零）或结果较多：写回全部已知大小后整体排序
+        for (auto& r : results) state.tree_sizes[r.name] = r.size;
+        for (size_t pos = 0; pos < entries.size(); ++pos) {
+            if (!entries.isDir(pos) || entries.isSymlink(pos)) continue;
+            auto it = state.tree_sizes.find(std::string(entries.name(pos)));
+            if (it != state.tree_sizes.end()) entries.setTreeSize(pos, it->second);
+        }
+        entries.sort(mode);
+        // 重新加载后出现的新目录：追加到加载器（已排队的名称由加载器去重，统计已结束时重新启动）
+        if (!state.tree_sizes_applied) state.tree_size_loader->enqueue(list_dirs(state.tree_sizes));
+        state.tree_sizes_applied = true;
+    } else {
+        for (auto& r : results) {
+            state.tree_sizes[r.name] = r.size;
+            size_t pos = entries.find(r.name, mode);
+            if (pos == EntryTable::npos) continue;
+            entries.setTreeSize(pos, r.size);
+            entries.reposition(pos, mode);
+        }
     }
 
+    RebuildEntryIndex(state);
     if (!state.search_mode) {
         state.filteredContents = state.allContents;
     }
 }
 
+// 重新获取当前目录条目：命中缓存则同步填充，否则交给后台加载器
+static void ReloadCurrentEntries(MainState& state) {
+#ifdef FTB_ENABLE_SSH
+    if (state.ssh_connected) {
+        state.dir_loader.reset();
+        SetCurrentEntries(state, FileManager::getEntryTable(state.currentPath, state.currentSortMode()));
+        return;
+    }
+#endif
+
+    if (auto cached = FileManager::lru_entry_cache->get(state.currentPath)) {
+        state.dir_loader.reset();
+        // 当前列会被流式批次修改，取缓存快照的副本；缓存已按配置的排序模式排好，
+        // 仅在标签页使用独立排序时重排
+        EntryTable entries = *cached;
+        SortMode mode = state.currentSortMode();
+        if (mode != SortModeFromString(ConfigManager::GetInstance()->GetConfig().style.sort_mode)) {
+            entries.sort(mode);
+        }
+        SetCurrentEntries(state, std::move(entries));
+        return;
+    }
+
+    // 重载已显示的目录时保留旧列表直到新结果完整就绪；进入新目录则清空并流式填充
+    bool keep_current = (state.loaded_entries_path == state.currentPath);
+    ftxui::ScreenInteractive* screen = state.screen;
+    state.dir_loader = std::make_shared<DirectoryLoader>(
+        state.currentPath, !keep_current,
+        [screen] {
+            if (screen) screen->Post(Event::Custom);
+        });
+
+    if (!keep_current) {
+        state.pending_select_name.clear();
+        SetCurrentEntries(state, {});
+    }
+    state.dir_loader->waitForFirstResult(kFirstPaintWait);
+}
+
+// 回退方案：目录未被 inotify 监听时（SSH、监听数达到上限等）每帧比较目录 mtime
+static bool PollDirectoryMtime(MainState& state, bool path_changed, bool loading_here) {
+    bool force_refresh = false;
+    try {
+        auto dir_mtime = fs::last_write_time(state.currentPath);
+        // 加载进行中时暂不记录新时间戳，完成后的下一帧再据此重载
+        if (dir_mtime != state.cached_dir_mtime && !(loading_here && !path_changed)) {
+            // 切换目录只记录新目录的时间戳，不视为内容变化
+            force_refresh = !path_changed;
+            state.cached_dir_mtime = dir_mtime;
+        }
+    } catch (...) {
+        // 目录已不存在：清空一次列表
+        force_refresh = !path_changed && !loading_here && !state.cached_current_entries.empty();
+    }
+    return force_refresh;
+}
+
+void UpdateCurrentEntryCache(MainState& state) {
+    bool path_changed = (state.currentPath != state.cached_current_path_for_entries);
+    bool loading_here = state.dir_loader && state.dir_loader->path() == state.currentPath;
+    bool force_refresh = false;
+    bool watched = FileManager::isDirectoryWatched(state.currentPath);
+#ifdef FTB_ENABLE_SSH
+    watched = watched && !state.ssh_connected;
+#endif
+
+    PublishVisibleDirectories(state);
+    if (!watched) {
+        force_refresh = PollDirectoryMtime(state, path_changed, loading_here);
+    } else if (!path_changed && !loading_here &&
+               TakeDirectoryChange(&VisibleDirectories::current_changed)) {
+        // 缓存已由监听线程修补，直接取用；缓存被整体丢弃时 ReloadCurrentEntries 会静默重载
+        if (state.selected >= 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
+            state.pending_select_name = state.filteredContents[state.selected];
+        }
+        ReloadCurrentEntries(state);
+    }
+
+    if (force_refresh || path_changed) {
+        state.cached_current_path_for_entries = state.currentPath;
+        if (force_refresh) {
+            std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
+            FileManager::lru_dir_cache->erase(state.currentPath);
+            FileManager::lru_entry_cache->erase(state.currentPath);
+        }
+        ReloadCurrentEntries(state);
+    }
+
+    DrainDirectoryLoad(state);
+    UpdateTreeSizes(state);
+}
+
 void RefreshDirectoryContents(MainState& state) {
     state.cached_current_path_for_entries.clear();
     InvalidatePreviewCache();
@@ -111,7 +409,17 @@ void RefreshDirectoryContents(MainState& state) {
         FileManager::lru_dir_cache->erase(state.currentPath);
         FileManager::lru_entry_cache->erase(state.currentPath);
     }
-    state.allContents = FileManager::getDirectoryContents(state.currentPath);
+    UpdateCurrentEntryCache(state);
+    state.filteredContents = state.allContents;
+}
+
+void SyncCurrentEntries(MainState& state, const std::string& select_name) {
+    state.cached_current_path_for_entries.clear();
+    InvalidatePreviewCache();
+    if (!select_name.empty()) {
+        state.pending_select_name = select_name;
+    }
+    UpdateCurrentEntryCache(state);
     state.filteredContents = state.allContents;
 }
 
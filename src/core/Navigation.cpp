@@ -72,11 +72,11 @@ void NavigateToParent(MainState& state) {
         state.cached_canonical_path.clear();
         state.cached_current_path_for_entries.clear();
         InvalidatePreviewCache();
-        state.allContents = FileManager::getDirectoryContents(state.currentPath);
-        state.filteredContents = state.allContents;
         state.searchQuery.clear();
         state.selected = 0;
         state.batch_selected.clear();
+        UpdateCurrentEntryCache(state);
+        state.filteredContents = state.allContents;
     }
 }
 
@@ -130,12 +130,12 @@ void NavigateIntoSelected(MainState& state) {
         state.cached_canonical_path.clear();
         state.cached_current_path_for_entries.clear();
         InvalidatePreviewCache();
-        state.allContents = FileManager::getDirectoryContents(state.currentPath);
-        state.filteredContents = state.allContents;
         state.selected = 0;
         state.searchQuery.clear();
         state.current_page = 0;
         state.batch_selected.clear();
+        UpdateCurrentEntryCache(state);
+        state.filteredContents = state.allContents;
     }
 }
 
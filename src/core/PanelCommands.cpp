@@ -6,6 +6,7 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -26,6 +27,7 @@
 #include "config/ConfigManager.hpp"
 #include "browser/ClipboardManager.hpp"
 #include "browser/FileManager.hpp"
+#include "browser/FileSizeCalculator.hpp"
 #include "ops/OpenerManager.hpp"
 #include "dialog/OpenerPickerDialog.hpp"
 #include "dialog/OpenerInputDialog.hpp"
@@ -256,14 +258,12 @@ void OpenHexEditorForFile(MainState& state, const std::string& filePath) {
 }
 
 namespace {
-    const FileManager::DirEntryInfo* FindSelectedEntry(const MainState& state) {
+    std::optional<FileManager::DirEntryInfo> FindSelectedEntry(const MainState& state) {
         if (state.selected < 0 || state.selected >= static_cast<int>(state.filteredContents.size()))
-            return nullptr;
-        const std::string& sel_name = state.filteredContents[state.selected];
-        for (const auto& e : state.cached_current_entries) {
-            if (e.name == sel_name) return &e;
-        }
-        return nullptr;
+            return std::nullopt;
+        auto found = state.cached_entry_index.find(state.filteredContents[state.selected]);
+        if (found == state.cached_entry_index.end()) return std::nullopt;
+        return state.cached_current_entries.entry(found->second);
     }
 }
 
@@ -325,8 +325,17 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         state.panel_selected = 0;
         state.active_panel = ActivePanel::TaskPanel;
         break;
+    case FTB::KeyBindings::PanelCommand::RescanSizes:
+        // 不取用大小缓存与持久化索引重新统计当前目录；新结果覆盖索引中的旧记录
+        FileManager::invalidateSizeCaches(state.currentPath);
+        FileSizeCalculator::RequestRescan();
+        state.tree_size_rescan = true;
+        state.tree_size_loader.reset();
+        state.tree_sizes.clear();
+        StatusMessage::Show("Recounting folder sizes");
+        break;
     case FTB::KeyBindings::PanelCommand::Extract: {
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             std::string fullPath = (fs::path(state.currentPath) / entry->name).string();
             if (!IsArchiveFile(entry->name)) {
                 StatusMessage::Show("Not an archive file");
@@ -389,7 +398,7 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         std::string msg = FTB::MarkdownPreview::ShowSource()
             ? "Markdown preview: source mode"
             : "Markdown preview: rendered mode";
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             if (!FTB::MarkdownPreview::IsMarkdownFile(entry->name)) {
                 msg += " (not a markdown file)";
             }
@@ -402,7 +411,7 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         std::string msg = FTB::SpreadsheetPreview::ShowSource()
             ? "XLSX preview: source mode"
             : "XLSX preview: rendered mode";
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             if (!FTB::SpreadsheetPreview::IsSpreadsheetFile(entry->name)) {
                 msg += " (not a spreadsheet file)";
             }
@@ -419,7 +428,7 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         break;
     }
     case FTB::KeyBindings::PanelCommand::MediaPlay: {
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             std::string fullPath = (fs::path(state.currentPath) / entry->name).string();
             if (FTB::MediaPreview::IsMediaFile(entry->name)) {
                 FTB::MediaPreview::PlayFullscreen(fullPath, state.screen);
@@ -434,7 +443,7 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         std::string msg = FTB::PdfPreview::ShowSource()
             ? "PDF preview: source mode"
             : "PDF preview: rendered mode";
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             if (!FTB::PdfPreview::IsPdfFile(entry->name)) {
                 msg += " (not a PDF file)";
             }
@@ -447,7 +456,7 @@ void HandlePanelCommand(MainState& state, FTB::KeyBindings::PanelCommand cmd) {
         std::string msg = FTB::DocPreview::ShowSource()
             ? "DOC/DOCX preview: source mode"
             : "DOC/DOCX preview: rendered mode";
-        if (auto* entry = FindSelectedEntry(state)) {
+        if (auto entry = FindSelectedEntry(state)) {
             if (!FTB::DocPreview::IsDocFile(entry->name)) {
                 msg += " (not a DOC/DOCX file)";
             }
@@ -820,6 +829,7 @@ void RegisterPanelCommands(FTB::KeyBindings& keybindings, MainState& state) {
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::Tasks, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::Tasks); });
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::BatchRename, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::BatchRename); });
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::Extract, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::Extract); });
+    keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::RescanSizes, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::RescanSizes); });
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::MDToggleSource, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::MDToggleSource); });
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::XLSToggleSource, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::XLSToggleSource); });
     keybindings.RegisterCallback(FTB::KeyBindings::PanelCommand::MediaToggleSource, [&]() { HandlePanelCommand(state, FTB::KeyBindings::PanelCommand::MediaToggleSource); });
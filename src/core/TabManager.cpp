@@ -285,6 +285,11 @@ void TabManager::saveActiveTabState(MainState& state) {
     tab.searchQuery = std::move(state.searchQuery);
     tab.search_mode = state.search_mode;
     tab.cached_current_path_for_entries = std::move(state.cached_current_path_for_entries);
+    if (state.dir_loader) {
+        // 流式加载未完成时条目不完整，切回该标签时需要重新加载
+        tab.cached_current_path_for_entries.clear();
+        state.dir_loader.reset();
+    }
     tab.cached_parent_path = std::move(state.cached_parent_path);
     tab.cached_parent_display = std::move(state.cached_parent_display);
     tab.cached_canonical_path = std::move(state.cached_canonical_path);
@@ -350,6 +355,11 @@ void TabManager::loadTabState(MainState& state, int index) {
     state.cached_parent_entries = tab.cached_parent_entries;
     state.cached_current_entries = tab.cached_current_entries;
     state.directoryHistory = tab.directoryHistory;
+    state.loaded_entries_path = tab.currentPath;
+    state.cached_entry_index.clear();
+    for (size_t i = 0; i < state.cached_current_entries.size(); ++i) {
+        state.cached_entry_index.emplace(std::string(state.cached_current_entries.name(i)), i);
+    }
 
     if (!tab.isValid()) {
         state.currentPath = "/";
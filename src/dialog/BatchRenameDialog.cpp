@@ -183,22 +183,14 @@ bool HandleBatchRenameEvent(MainState& state, const Event& event) {
                 continue;
             }
 
-            if (FileManager::renameFileOrDirectory(old_path.string(), new_path.string())) {
+            if (FileManager::renameFileOrDirectory(old_path.string(), new_name)) {
                 renamed++;
             } else {
                 skipped++;
             }
         }
 
-        state.cached_current_path_for_entries.clear();
-        InvalidatePreviewCache();
-        {
-            std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-            FileManager::lru_dir_cache->erase(state.currentPath);
-            FileManager::lru_entry_cache->erase(state.currentPath);
-        }
-        state.allContents = FileManager::getDirectoryContents(state.currentPath);
-        state.filteredContents = state.allContents;
+        SyncCurrentEntries(state);
         state.batch_selected.clear();
         if (state.selected >= static_cast<int>(state.filteredContents.size())) {
             state.selected = std::max(0, static_cast<int>(state.filteredContents.size()) - 1);
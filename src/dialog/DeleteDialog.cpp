@@ -11,6 +11,51 @@ namespace FTB::UI {
 
 using namespace ftxui;
 
+namespace {
+
+// 删除目录 dir 中的非目录条目，每个子目录派生一个子任务继续删除其内容，由空闲工作线程窃取执行；
+// 目录本身留到全部子任务完成后由 removeEmptyTree 删除。只更新原子计数，current_file 由父任务设置
+bool deleteContents(const fs::path& dir, TaskContext& ctx) {
+    std::error_code ec;
+    bool ok = true;
+    for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+         !ec && it != end; it.increment(ec)) {
+        if (ctx.cancel.load()) return false;
+        fs::path path = it->path();
+        std::error_code st_ec;
+        if (fs::is_directory(it->symlink_status(st_ec))) {
+            ctx.spawn([path, &ctx] { return deleteContents(path, ctx); });
+            continue;
+        }
+        std::error_code rm_ec;
+        fs::remove(path, rm_ec);
+        if (rm_ec) ok = false;
+        ++ctx.progress.files_processed;
+    }
+    return ok && !ec;
+}
+
+// deleteContents 的子任务全部完成后只剩空目录：自底向上删除并计入进度
+bool removeEmptyTree(const fs::path& dir, TaskContext& ctx) {
+    std::error_code ec;
+    auto removed = fs::remove_all(dir, ec);
+    if (removed != static_cast<std::uintmax_t>(-1)) ctx.progress.files_processed += static_cast<int>(removed);
+    return !ec;
+}
+
+// 删除单个选中项：目录按子目录拆成子任务，单个大目录也能由多个工作线程并行删除
+bool deleteItem(const fs::path& p, TaskContext& ctx) {
+    std::error_code ec;
+    auto st = fs::symlink_status(p, ec);
+    if (ec) return true;   // 已不存在
+    if (fs::is_directory(st)) return deleteContents(p, ctx);
+    fs::remove(p, ec);
+    ++ctx.progress.files_processed;
+    return !ec;
+}
+
+}  // namespace
+
 Element RenderDeleteConfirmPanel(MainState& state, int tw, int /*th*/) {
     int pw = std::min(50, tw - 4);
 
@@ -106,7 +151,6 @@ bool HandleDeleteConfirmEvent(MainState& state, const Event& event) {
             return true;
         }
 
-        std::string parent = paths->at(0).parent_path().string();
         int64_t total = static_cast<int64_t>(paths->size());
         StatusMessage::Show("Deleting " + std::to_string(total) + " item(s)... (t: Tasks)");
 
@@ -114,7 +158,8 @@ bool HandleDeleteConfirmEvent(MainState& state, const Event& event) {
         req.title = "Delete " + std::to_string(total) + " item(s)";
         req.type = TaskType::Delete;
         req.priority = Priority::High;
-        req.work = [paths, parent](TaskContext& ctx) -> bool {
+        for (const auto& p : *paths) req.io_paths.push_back(p.string());
+        req.work = [paths](TaskContext& ctx) -> bool {
             int item_count = 0;
             for (const auto& p : *paths) {
                 std::error_code ec;
@@ -131,52 +176,34 @@ bool HandleDeleteConfirmEvent(MainState& state, const Event& event) {
             }
             ctx.progress.total_files = item_count;
 
-            bool ok = true;
-            std::error_code ec;
+            // 每个选中项作为一个子任务，目录内的每个子目录再派生子任务，由空闲工作线程并行删除
             for (const auto& p : *paths) {
-                if (ctx.cancel.load()) return false;
+                if (ctx.cancel.load()) break;
                 while (ctx.pause.load()) {
-                    if (ctx.cancel.load()) return false;
+                    if (ctx.cancel.load()) break;
                     std::this_thread::sleep_for(std::chrono::milliseconds(50));
                 }
+                if (ctx.cancel.load()) break;
                 ctx.progress.current_file = p.filename().string();
+                ctx.spawn([p, &ctx] { return deleteItem(p, ctx); });
+            }
+            bool ok = ctx.wait_subtasks();
+            if (ctx.cancel.load()) return false;
 
-                if (fs::is_directory(p)) {
-                    std::vector<fs::path> files;
-                    std::vector<fs::path> subdirs;
-                    for (auto it = fs::recursive_directory_iterator(
-                             p, fs::directory_options::skip_permission_denied, ec);
-                         it != fs::recursive_directory_iterator(); it.increment(ec)) {
-                        if (ctx.cancel.load()) return false;
-                        if (fs::is_regular_file(it->path()) || fs::is_symlink(it->path()))
-                            files.push_back(it->path());
-                        else if (fs::is_directory(it->path()))
-                            subdirs.push_back(it->path());
-                    }
-                    for (const auto& f : files) {
-                        if (ctx.cancel.load()) return false;
-                        fs::remove(f, ec);
-                        ++ctx.progress.files_processed;
-                    }
-                    for (auto it = subdirs.rbegin(); it != subdirs.rend(); ++it) {
-                        if (ctx.cancel.load()) return false;
-                        fs::remove(*it, ec);
-                        ++ctx.progress.files_processed;
-                    }
-                    fs::remove(p, ec);
-                    ++ctx.progress.files_processed;
-                    if (ec) ok = false;
-                } else if (fs::is_regular_file(p) || fs::is_symlink(p)) {
-                    fs::remove(p, ec);
-                    ++ctx.progress.files_processed;
-                    if (ec) ok = false;
-                }
+            // 文件均已删除，剩下各目录的空骨架
+            for (const auto& p : *paths) {
+                std::error_code st_ec;
+                if (fs::is_directory(fs::symlink_status(p, st_ec)) && !removeEmptyTree(p, ctx)) ok = false;
             }
 
             {
                 std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                FileManager::lru_dir_cache->erase(parent);
-                FileManager::lru_entry_cache->erase(parent);
+                for (const auto& p : *paths) {
+                    std::error_code exists_ec;
+                    if (!fs::exists(fs::symlink_status(p, exists_ec))) {
+                        FileManager::patchCacheOnRemove(p.string());
+                    }
+                }
             }
             return ok;
         };
@@ -7,6 +7,8 @@
 #include <chrono>
 
 #include <filesystem>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -17,54 +19,106 @@ namespace fs = std::filesystem;
 using namespace ftxui;
 
 namespace {
-    std::vector<FdResult> s_results;
+    std::vector<FdResult> s_results;   // 按得分排序的前 kMaxResults 个
+    size_t s_matched = 0;              // 匹配总数 (可能多于 s_results)
     bool s_loading = false;
-    int s_version = 0;
+    int s_version = 0;           // 每次新查询递增, 旧查询的结果不再写入
+    int s_results_version = 0;   // s_results 所属的查询
     int s_scroll = 0;
+    std::string s_selected_path;   // 用户移动过选中项时所选结果的路径; 为空表示选中随排名 (停在首项)
     std::mutex s_mutex;
+    std::shared_ptr<std::atomic<bool>> s_cancel;   // 进行中搜索的取消标记
+
+    // 连续输入时只搜索停顿后的查询
+    constexpr auto kDebounce = std::chrono::milliseconds(100);
+    // 只保留得分最高的结果, 其余匹配只计数
+    constexpr size_t kMaxResults = 500;
+
+    // 调用方持有 s_mutex
+    void CancelSearch() {
+        if (s_cancel) s_cancel->store(true);
+        s_cancel.reset();
+    }
+
+    // 搜索过程中每个快照都会整体替换 s_results, 按路径找回用户选中的结果 (调用方持有 s_mutex);
+    // 它已被挤出前 kMaxResults 个时停在原位置, 并改为跟随该位置上的结果
+    void FollowSelection(int& selected) {
+        if (s_selected_path.empty()) return;
+        for (size_t i = 0; i < s_results.size(); ++i) {
+            if (s_results[i].path == s_selected_path) {
+                selected = static_cast<int>(i);
+                return;
+            }
+        }
+        if (s_results.empty()) return;
+        selected = std::min(selected, static_cast<int>(s_results.size()) - 1);
+        s_selected_path = s_results[selected].path;
+    }
 
     void ResetState() {
         std::lock_guard<std::mutex> lock(s_mutex);
+        CancelSearch();
+        s_selected_path.clear();
         s_results.clear();
+        s_matched = 0;
         s_loading = false;
-        s_version = 0;
+        s_version++;
+        s_results_version = s_version;
         s_scroll = 0;
     }
 
-    void TriggerSearch(const std::string& query, const std::string& basePath) {
-        if (query.empty()) {
-            std::lock_guard<std::mutex> lock(s_mutex);
-            s_results.clear();
-            s_loading = false;
-            s_scroll = 0;
-            return;
-        }
-
-        s_version++;
-        int my_ver = s_version;
+    // 结果边遍历边按得分重排: 新查询的首个快照到达前保留上一次的结果, 避免输入时列表闪烁
+    void TriggerSearch(const std::string& query, const std::string& basePath,
+                       ftxui::ScreenInteractive* screen) {
+        int my_ver;
+        auto cancel = std::make_shared<std::atomic<bool>>(false);
         {
             std::lock_guard<std::mutex> lock(s_mutex);
-            if (s_loading) return;
+            CancelSearch();
+            my_ver = ++s_version;
+            s_selected_path.clear();
+            if (query.empty()) {
+                s_results.clear();
+                s_matched = 0;
+                s_results_version = my_ver;
+                s_loading = false;
+                s_scroll = 0;
+                return;
+            }
             s_loading = true;
+            s_cancel = cancel;
         }
 
-        std::thread([query, basePath, my_ver]() {
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            {
-                std::lock_guard<std::mutex> lock(s_mutex);
-                if (my_ver != s_version) { s_loading = false; return; }
-            }
-
-            auto results = SearchEngine::Search(query, basePath);
+        std::thread([query, basePath, my_ver, cancel, screen]() {
+            std::this_thread::sleep_for(kDebounce);
+            if (cancel->load()) return;
+
+            SearchEngine::Rank(query, basePath, kMaxResults,
+                               [&](std::vector<FdResult>&& top, size_t matched) {
+                {
+                    std::lock_guard<std::mutex> lock(s_mutex);
+                    if (my_ver != s_version) return;
+                    if (s_results_version != my_ver) {
+                        s_results_version = my_ver;
+                        s_scroll = 0;
+                    }
+                    s_results = std::move(top);
+                    s_matched = matched;
+                }
+                if (screen) screen->Post(Event::Custom);
+            }, cancel.get());
 
             {
                 std::lock_guard<std::mutex> lock(s_mutex);
-                if (my_ver == s_version) {
-                    s_results = std::move(results);
-                    s_scroll = 0;
+                if (my_ver != s_version) return;
+                if (s_results_version != my_ver) {
+                    s_results.clear();
+                    s_matched = 0;
+                    s_results_version = my_ver;
                 }
                 s_loading = false;
             }
+            if (screen) screen->Post(Event::Custom);
         }).detach();
     }
 }
@@ -86,19 +140,26 @@ namespace FTB::UI {
 Element RenderFuzzyFinderPanel(MainState& state, int tw, int th) {
     int pw = std::min(100, tw - 4);
 
+    // 结果在搜索过程中持续增长, 只复制可见的行
+    int visible_rows = std::max(3, std::min(th - 5, 22));
     std::vector<FdResult> results;
+    size_t total;
+    size_t matched;
     bool loading;
     {
         std::lock_guard<std::mutex> lock(s_mutex);
-        results = s_results;
+        FollowSelection(state.panel_selected);
+        if (state.panel_selected < s_scroll) s_scroll = state.panel_selected;
+        if (state.panel_selected >= s_scroll + visible_rows)
+            s_scroll = state.panel_selected - visible_rows + 1;
+        total = s_results.size();
+        matched = s_matched;
+        size_t begin = std::min(total, static_cast<size_t>(s_scroll));
+        size_t end = std::min(total, begin + static_cast<size_t>(visible_rows));
+        results.assign(s_results.begin() + begin, s_results.begin() + end);
         loading = s_loading;
     }
 
-    int visible_rows = std::max(3, std::min(th - 5, 22));
-    if (state.panel_selected < s_scroll) s_scroll = state.panel_selected;
-    if (state.panel_selected >= s_scroll + visible_rows)
-        s_scroll = state.panel_selected - visible_rows + 1;
-
     // === 输入行 (yazi 风格: ? 前缀) ===
     std::string input_str = state.panel_input;
     auto input_dom = hbox({
@@ -109,17 +170,16 @@ Element RenderFuzzyFinderPanel(MainState& state, int tw, int th) {
 
     // === 文件列表 (单列, 无预览) ===
     Elements list_items;
-    if (loading && results.empty()) {
+    if (loading && total == 0) {
         list_items.push_back(text("  searching...") | color(TC("dim")) | dim);
-    } else if (results.empty() && !state.panel_input.empty()) {
+    } else if (total == 0 && !state.panel_input.empty()) {
         list_items.push_back(text("  no results") | color(TC("dim")) | dim);
-    } else if (results.empty()) {
+    } else if (total == 0) {
         list_items.push_back(text("  type to search") | color(TC("dim")) | dim);
     } else {
-        int end_idx = std::min(s_scroll + visible_rows, static_cast<int>(results.size()));
-        for (int i = s_scroll; i < end_idx; ++i) {
-            const auto& r = results[i];
-            bool selected = (i == state.panel_selected);
+        for (size_t k = 0; k < results.size(); ++k) {
+            const auto& r = results[k];
+            bool selected = (s_scroll + static_cast<int>(k) == state.panel_selected);
 
             auto row = hbox({
                 text("  "),
@@ -135,15 +195,16 @@ Element RenderFuzzyFinderPanel(MainState& state, int tw, int th) {
 
     // === 计数 / 引擎 ===
     std::string count_str;
-    if (!results.empty()) {
-        count_str = std::to_string(state.panel_selected + 1) + "/" + std::to_string(results.size());
+    if (total > 0) {
+        count_str = std::to_string(state.panel_selected + 1) + "/" + std::to_string(total);
+        if (matched > total) count_str += " of " + std::to_string(matched);
     }
 
     auto bottom_bar = hbox({
         text(" ") | color(TC("dim")),
         text(count_str) | color(TC("dim")),
         filler(),
-        text(SearchEngine::HasExternal() ? " fdfind" : " builtin") | color(TC("dim")) | dim,
+        text(loading ? " searching..." : " builtin") | color(TC("dim")) | dim,
         text(" "),
     });
 
@@ -173,14 +234,18 @@ bool HandleFuzzyFinderEvent(MainState& state, const Event& event) {
     }
 
     if (event == Event::Return) {
-        std::vector<FdResult> results;
+        bool has_choice = false;
+        FdResult chosen;
         {
             std::lock_guard<std::mutex> lock(s_mutex);
-            results = s_results;
+            FollowSelection(state.panel_selected);
+            if (state.panel_selected >= 0 && state.panel_selected < static_cast<int>(s_results.size())) {
+                chosen = s_results[state.panel_selected];
+                has_choice = true;
+            }
         }
 
-        if (state.panel_selected >= 0 && state.panel_selected < static_cast<int>(results.size())) {
-            const auto& chosen = results[state.panel_selected];
+        if (has_choice) {
             fs::path fullPath = fs::path(state.currentPath) / chosen.path;
 
             // 搜索只返回文件, 直接导航到父目录
@@ -229,17 +294,23 @@ bool HandleFuzzyFinderEvent(MainState& state, const Event& event) {
     }
 
     if (event == Event::ArrowUp) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        FollowSelection(state.panel_selected);
         if (state.panel_selected > 0) state.panel_selected--;
         if (state.panel_selected < s_scroll) s_scroll = state.panel_selected;
+        if (state.panel_selected < static_cast<int>(s_results.size()))
+            s_selected_path = s_results[state.panel_selected].path;
         return true;
     }
 
     if (event == Event::ArrowDown) {
         std::lock_guard<std::mutex> lock(s_mutex);
+        FollowSelection(state.panel_selected);
         if (state.panel_selected + 1 < static_cast<int>(s_results.size())) {
             state.panel_selected++;
             if (state.panel_selected >= s_scroll + 1)
                 s_scroll = std::max(0, state.panel_selected);
+            s_selected_path = s_results[state.panel_selected].path;
         }
         return true;
     }
@@ -248,7 +319,7 @@ bool HandleFuzzyFinderEvent(MainState& state, const Event& event) {
     if (event.is_character()) {
         state.panel_input += event.character();
         state.panel_selected = 0;
-        TriggerSearch(state.panel_input, state.currentPath);
+        TriggerSearch(state.panel_input, state.currentPath, state.screen);
         return true;
     }
 
@@ -256,7 +327,7 @@ bool HandleFuzzyFinderEvent(MainState& state, const Event& event) {
         if (!state.panel_input.empty()) {
             state.panel_input.pop_back();
             state.panel_selected = 0;
-            TriggerSearch(state.panel_input, state.currentPath);
+            TriggerSearch(state.panel_input, state.currentPath, state.screen);
         }
         return true;
     }
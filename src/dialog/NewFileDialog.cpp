@@ -41,15 +41,7 @@ bool HandleNewFileEvent(MainState& state, const Event& event) {
         if (!state.panel_input.empty()) {
             fs::path newPath = fs::path(state.currentPath) / state.panel_input;
             if (FileManager::createFile(newPath.string())) {
-                state.cached_current_path_for_entries.clear();
-                InvalidatePreviewCache();
-                {
-                    std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                    FileManager::lru_dir_cache->erase(state.currentPath);
-                    FileManager::lru_entry_cache->erase(state.currentPath);
-                }
-                state.allContents = FileManager::getDirectoryContents(state.currentPath);
-                state.filteredContents = state.allContents;
+                SyncCurrentEntries(state, state.panel_input);
                 state.active_panel = ActivePanel::None;
                 state.panel_input.clear();
                 state.panel_message.clear();
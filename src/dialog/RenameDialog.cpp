@@ -48,17 +48,9 @@ bool HandleRenameEvent(MainState& state, const Event& event) {
     if (event == Event::Return) {
         if (state.selected >= 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
             fs::path oldPath = fs::path(state.currentPath) / state.filteredContents[state.selected];
-            fs::path newPath = fs::path(state.currentPath) / state.panel_input;
-            if (FileManager::renameFileOrDirectory(oldPath.string(), newPath.string())) {
-                state.cached_current_path_for_entries.clear();
-                InvalidatePreviewCache();
-                {
-                    std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                    FileManager::lru_dir_cache->erase(state.currentPath);
-                    FileManager::lru_entry_cache->erase(state.currentPath);
-                }
-                state.allContents = FileManager::getDirectoryContents(state.currentPath);
-                state.filteredContents = state.allContents;
+            // renameFileOrDirectory 接收的是新名称而非完整路径
+            if (FileManager::renameFileOrDirectory(oldPath.string(), state.panel_input)) {
+                SyncCurrentEntries(state, state.panel_input);
                 state.active_panel = ActivePanel::None;
                 state.panel_input.clear();
                 state.panel_message.clear();
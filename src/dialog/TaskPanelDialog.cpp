@@ -1,6 +1,11 @@
 #include "dialog/TaskPanelDialog.hpp"
 #include "browser/TaskSystem.hpp"
+#include "browser/ClipboardManager.hpp"
+#include "browser/CopyJournal.hpp"
+#include <chrono>
+#include <filesystem>
 #include <iomanip>
+#include <map>
 #include <sstream>
 
 namespace FTB::UI {
@@ -63,6 +68,18 @@ static std::string format_eta(double bytes_per_sec, uintmax_t remaining) {
     return oss.str();
 }
 
+// l 键依次切换的总速率上限（字节/秒），0 表示不限速
+static const uintmax_t kSpeedLimitPresets[] = {
+    0, 1ull << 20, 10ull << 20, 50ull << 20, 100ull << 20,
+};
+
+static uintmax_t next_speed_limit(uintmax_t current) {
+    for (uintmax_t preset : kSpeedLimitPresets) {
+        if (preset > current) return preset;
+    }
+    return 0;
+}
+
 // Unicode state icons (yazi-style)
 static const char* state_icon(TaskState s) {
     switch (s) {
@@ -99,6 +116,105 @@ static std::string task_type_str(TaskType t) {
     return "?";
 }
 
+// 进程被杀后留下进度日志、可以继续的复制 / 移动任务
+struct InterruptedTask {
+    std::string path;
+    FTB::CopyJournal::Header header;
+};
+
+// 列出日志要打开并 flock 每个文件，不能每次渲染都做：
+// 结果缓存起来，定时刷新；有任务结束（可能刚删掉或留下日志）或在面板里继续 / 丢弃后立即刷新
+static constexpr auto kInterruptedRefresh = std::chrono::seconds(2);
+
+struct InterruptedCache {
+    std::vector<InterruptedTask>          tasks;
+    std::chrono::steady_clock::time_point refreshed{};
+    size_t                                finished = 0;   // 上次刷新时已结束的任务数
+    bool                                  stale = true;
+};
+
+static InterruptedCache& interrupted_cache() {
+    static InterruptedCache cache;
+    return cache;
+}
+
+static void invalidate_interrupted_tasks() {
+    interrupted_cache().stale = true;
+}
+
+static const std::vector<InterruptedTask>& interrupted_tasks(const std::vector<TaskSnapshot>& snapshots) {
+    auto& cache = interrupted_cache();
+    size_t finished = 0;
+    for (const auto& snap : snapshots) {
+        if (snap.state != TaskState::Pending && snap.state != TaskState::Running &&
+            snap.state != TaskState::Paused)
+            ++finished;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!cache.stale && finished == cache.finished && now - cache.refreshed < kInterruptedRefresh) {
+        return cache.tasks;
+    }
+
+    // 日志头部只在第一次见到时读取；已不存在的日志随旧列表一起丢弃。
+    // 正在运行的任务持有日志锁，不会出现在这里
+    std::map<std::string, FTB::CopyJournal::Header> known;
+    for (auto& task : cache.tasks) known.emplace(task.path, std::move(task.header));
+    std::vector<InterruptedTask> result;
+    for (const auto& path : FTB::CopyJournal::pending()) {
+        auto it = known.find(path);
+        if (it != known.end()) {
+            result.push_back({path, std::move(it->second)});
+            continue;
+        }
+        FTB::CopyJournal::Header header;
+        if (FTB::CopyJournal::readHeader(path, header)) result.push_back({path, std::move(header)});
+    }
+    cache.tasks = std::move(result);
+    cache.refreshed = now;
+    cache.finished = finished;
+    cache.stale = false;
+    return cache.tasks;
+}
+
+static Element build_interrupted_entry(const InterruptedTask& task, bool selected) {
+    const auto& header = task.header;
+    std::string target;
+    if (!header.entries.empty()) {
+        target = std::filesystem::path(header.entries.front().dst).parent_path().string();
+    }
+
+    auto entry = vbox({
+        hbox({
+            text(" "),
+            text(" \u21BB") | color(TC("dim")),   // ↻
+            text(" ") | color(TC("dialog_fg")),
+            text(header.move ? "Move" : "Copy") | color(TC("dialog_fg")) | bold,
+            text(": " + header.title) | color(TC("dialog_fg")),
+            filler(),
+            text(" INTERRUPTED") | color(TC("error")) | bold,
+            text(" "),
+        }),
+        hbox({
+            text("  "),
+            text("-> " + target) | color(TC("dim")),
+            filler(),
+        }),
+        hbox({
+            text("  "),
+            text(format_size(header.total_bytes) + ", " + std::to_string(header.total_files) + " files")
+                | color(TC("dim")),
+            filler(),
+            text("r resume  x discard") | color(TC("dim")),
+            text(" "),
+        }),
+    });
+
+    if (selected) {
+        entry = entry | bgcolor(TC("selection_bg"));
+    }
+    return entry | flex_grow;
+}
+
 static Element build_task_entry(const TaskSnapshot& snap, bool selected) {
     float prog_ratio = 0.0f;
     if (snap.total_bytes > 0) {
@@ -216,6 +332,8 @@ static Element build_task_entry(const TaskSnapshot& snap, bool selected) {
 Element RenderTaskPanel(MainState& state, int tw, int th) {
     auto& ts = TaskSystem::getInstance();
     auto snapshots = ts.get_snapshot();
+    const auto& interrupted = interrupted_tasks(snapshots);
+    int task_count = static_cast<int>(snapshots.size());
 
     int pw = std::min(72, tw - 4);
 
@@ -224,13 +342,15 @@ Element RenderTaskPanel(MainState& state, int tw, int th) {
     // ── Header ──
     els.push_back(hbox({
         text(" Tasks") | color(TC("title")) | bold,
-        text(" (" + std::to_string(snapshots.size()) + ")") | color(TC("dim")),
+        text(" (" + std::to_string(snapshots.size() + interrupted.size()) + ")") | color(TC("dim")),
         filler(),
+        text(ts.get_speed_limit() > 0 ? "limit " + format_speed(static_cast<double>(ts.get_speed_limit())) + " "
+                                      : "no limit ") | color(TC("dim")),
     }));
     els.push_back(separator() | color(TC("dialog_border")));
 
     // ── Body ──
-    if (snapshots.empty()) {
+    if (snapshots.empty() && interrupted.empty()) {
         els.push_back(text(""));
         els.push_back(hbox({
             text("  "),
@@ -238,7 +358,8 @@ Element RenderTaskPanel(MainState& state, int tw, int th) {
         }));
         els.push_back(text(""));
     } else {
-        int total = static_cast<int>(snapshots.size());
+        // 中断的任务排在当前任务之后，共用选择与滚动
+        int total = task_count + static_cast<int>(interrupted.size());
         int scroll = state.panel_selected;
         if (scroll < 0) scroll = 0;
         if (scroll >= total) scroll = total - 1;
@@ -248,7 +369,11 @@ Element RenderTaskPanel(MainState& state, int tw, int th) {
         int end = std::min(total, start + max_visible);
 
         for (int i = start; i < end; ++i) {
-            els.push_back(build_task_entry(snapshots[i], i == scroll));
+            if (i < task_count) {
+                els.push_back(build_task_entry(snapshots[i], i == scroll));
+            } else {
+                els.push_back(build_interrupted_entry(interrupted[i - task_count], i == scroll));
+            }
             if (i < end - 1) {
                 els.push_back(text(""));  // spacer between tasks
             }
@@ -269,6 +394,8 @@ Element RenderTaskPanel(MainState& state, int tw, int th) {
     els.push_back(hbox({
         text(" x cancel") | color(TC("dim")) | dim,
         text("    space pause") | color(TC("dim")) | dim,
+        text("    l limit") | color(TC("dim")) | dim,
+        text("    r resume") | color(TC("dim")) | dim,
         text("    jk scroll") | color(TC("dim")) | dim,
         text("    esc close") | color(TC("dim")) | dim,
         filler(),
@@ -284,7 +411,9 @@ Element RenderTaskPanel(MainState& state, int tw, int th) {
 bool HandleTaskPanelEvent(MainState& state, const Event& event) {
     auto& ts = TaskSystem::getInstance();
     auto snapshots = ts.get_snapshot();
-    int total = static_cast<int>(snapshots.size());
+    const auto& interrupted = interrupted_tasks(snapshots);
+    int task_count = static_cast<int>(snapshots.size());
+    int total = task_count + static_cast<int>(interrupted.size());
 
     if (event == Event::Escape) {
         state.active_panel = ActivePanel::None;
@@ -292,6 +421,11 @@ bool HandleTaskPanelEvent(MainState& state, const Event& event) {
         return true;
     }
 
+    if (event == Event::Character('l')) {
+        ts.set_speed_limit(next_speed_limit(ts.get_speed_limit()));
+        return true;
+    }
+
     if (total == 0) return true;
 
     if (event == Event::ArrowUp || event == Event::Character('k')) {
@@ -303,8 +437,24 @@ bool HandleTaskPanelEvent(MainState& state, const Event& event) {
         return true;
     }
 
+    // 中断的任务：r 从日志继续，x 丢弃日志（已复制的文件保留）
+    if (state.panel_selected >= task_count && state.panel_selected < total) {
+        const auto& task = interrupted[state.panel_selected - task_count];
+        if (event == Event::Character('r')) {
+            ClipboardManager::getInstance().resume(task.path);
+            invalidate_interrupted_tasks();
+            return true;
+        }
+        if (event == Event::Character('x') || event == Event::Delete) {
+            if (auto journal = FTB::CopyJournal::open(task.path)) journal->remove();
+            invalidate_interrupted_tasks();
+            if (state.panel_selected >= total - 1 && state.panel_selected > 0) --state.panel_selected;
+            return true;
+        }
+    }
+
     if (event == Event::Character('x') || event == Event::Delete) {
-        if (state.panel_selected >= 0 && state.panel_selected < total) {
+        if (state.panel_selected >= 0 && state.panel_selected < task_count) {
             const auto& snap = snapshots[state.panel_selected];
             if (snap.state == TaskState::Running || snap.state == TaskState::Paused) {
                 ts.cancel(snap.id);
@@ -314,7 +464,7 @@ bool HandleTaskPanelEvent(MainState& state, const Event& event) {
     }
 
     if (event == Event::Character(' ') || event == Event::Character('p')) {
-        if (state.panel_selected >= 0 && state.panel_selected < total) {
+        if (state.panel_selected >= 0 && state.panel_selected < task_count) {
             const auto& snap = snapshots[state.panel_selected];
             if (snap.state == TaskState::Running) {
                 ts.pause(snap.id);
@@ -56,15 +56,7 @@ bool HandleFileOperationEvent(MainState& state, const Event& event) {
                 if (FileManager::moveToTrash(p))
                     success++;
             }
-            state.cached_current_path_for_entries.clear();
-            InvalidatePreviewCache();
-            {
-                std::lock_guard<std::mutex> lock(FileManager::cache_mutex);
-                FileManager::lru_dir_cache->erase(state.currentPath);
-                FileManager::lru_entry_cache->erase(state.currentPath);
-            }
-            UpdateCurrentEntryCache(state);
-            state.filteredContents = state.allContents;
+            SyncCurrentEntries(state);
             if (state.selected >= static_cast<int>(state.filteredContents.size()))
                 state.selected = std::max(0, static_cast<int>(state.filteredContents.size()) - 1);
             state.batch_selected.clear();
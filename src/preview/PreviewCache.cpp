@@ -5,7 +5,6 @@
 #include <algorithm>
 
 #include "config/ConfigManager.hpp"
-#include "browser/SortMode.hpp"
 
 namespace FTB {
 
@@ -24,7 +23,7 @@ void PreviewCache::Invalidate() {
     data_ = PreviewData{};
 }
 
-void PreviewCache::Update(const std::vector<FileManager::DirEntryInfo>& entries,
+void PreviewCache::Update(const EntryTable& entries,
                           int selected, const std::string& currentPath) {
     std::string new_key = currentPath + ":" + std::to_string(selected);
 
@@ -55,7 +54,7 @@ void PreviewCache::Update(const std::vector<FileManager::DirEntryInfo>& entries,
         return;
     }
 
-    const FileManager::DirEntryInfo& entry = entries[selected];
+    const FileManager::DirEntryInfo entry = entries.entry(static_cast<size_t>(selected));
     new_data.selectedName = entry.name;
     new_data.is_dir = entry.is_dir;
     new_data.exists = entry.exists;
@@ -83,19 +82,15 @@ void PreviewCache::EnsureDirLoaded(const std::string& dirPath) {
 
     std::thread([this, dirPath]() {
         try {
-            auto entries = FileManager::getDirectoryEntries(dirPath);
-            {
-                auto& cfg = FTB::ConfigManager::GetInstance()->GetConfig();
-                auto mode = FTB::SortModeFromString(cfg.style.sort_mode);
-                FTB::SortEntries(entries, mode);
-            }
+            // 缓存中的条目表已按配置排序，直接共享快照
+            auto entries = FileManager::getSharedEntryTable(dirPath);
             std::lock_guard<std::mutex> lock2(mutex_);
             if (data_.loaded_dir_path != dirPath) return;
             data_.dir_contents = std::move(entries);
             data_.dir_sorted = true;
         } catch (...) {
             std::lock_guard<std::mutex> lock2(mutex_);
-            if (data_.loaded_dir_path == dirPath) data_.dir_contents.clear();
+            if (data_.loaded_dir_path == dirPath) data_.dir_contents.reset();
         }
     }).detach();
 }
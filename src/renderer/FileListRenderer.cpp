@@ -1,40 +1,85 @@
 #include "core/MainUI.hpp"
 
 #include <algorithm>
+#include <cstdio>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ftxui/dom/elements.hpp>
 
 #include "config/ConfigManager.hpp"
+#include "browser/EntryTable.hpp"
 #include "browser/FileManager.hpp"
+#include "browser/SortMode.hpp"
 #include "renderer/TextSelection.hpp"
 
 namespace FTB {
 
 using namespace ftxui;
 
-Color GetEntryColor(const FileManager::DirEntryInfo& info) {
-    if (!info.is_dir && !info.is_symlink) {
-        auto dot_pos = info.name.rfind('.');
-        if (dot_pos != std::string::npos && dot_pos + 1 < info.name.size()) {
-            std::string ext = info.name.substr(dot_pos + 1);
+// 扩展名颜色优先，其次按类型取主题色
+static Color EntryColor(std::string_view name, bool is_dir, bool is_symlink,
+                        bool is_executable, bool is_hidden) {
+    if (!is_dir && !is_symlink) {
+        auto dot_pos = name.rfind('.');
+        if (dot_pos != std::string_view::npos && dot_pos + 1 < name.size()) {
+            std::string ext(name.substr(dot_pos + 1));
             Color ext_color = ConfigManager::GetInstance()->GetExtensionColor(ext);
             if (ext_color != ftxui::Color::Default)
                 return ext_color;
         }
     }
-    if (info.is_dir) return TC("directory");
-    if (info.is_symlink) return TC("link");
-    if (info.is_executable) return TC("executable");
-    if (info.is_hidden) return TC("hidden");
+    if (is_dir) return TC("directory");
+    if (is_symlink) return TC("link");
+    if (is_executable) return TC("executable");
+    if (is_hidden) return TC("hidden");
     return TC("file");
 }
 
-Element BuildFileItem(MainState&, int, bool is_selected, bool is_hovered,
+Color GetEntryColor(const FileManager::DirEntryInfo& info) {
+    return EntryColor(info.name, info.is_dir, info.is_symlink, info.is_executable, info.is_hidden);
+}
+
+Color GetEntryColor(const EntryTable& entries, size_t pos) {
+    return EntryColor(entries.name(pos), entries.isDir(pos), entries.isSymlink(pos),
+                      entries.isExecutable(pos), entries.isHidden(pos));
+}
+
+// 子树大小排序时行尾显示的大小（B/K/M/G，一位小数）
+static std::string FormatTreeSize(uint64_t bytes) {
+    static const char* const kUnits[] = {"B", "K", "M", "G", "T"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0])) {
+        value /= 1024.0;
+        ++unit;
+    }
+    char buf[32];
+    if (unit == 0) {
+        std::snprintf(buf, sizeof(buf), "%llu B", static_cast<unsigned long long>(bytes));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.1f %s", value, kUnits[unit]);
+    }
+    return buf;
+}
+
+Element BuildFileItem(MainState& state, int, bool is_selected, bool is_hovered,
                       const std::string& name, const FileManager::DirEntryInfo& info,
                       const std::string& search_q, bool is_batch_selected) {
     Color text_color = GetEntryColor(info);
 
+    // 子树大小排序：文件显示大小，目录在后台统计完成后显示
+    std::string size_text;
+    if (SortModeUsesTreeSize(state.currentSortMode()) && !info.stat_pending) {
+        if (!info.is_dir) {
+            size_text = FormatTreeSize(info.file_size);
+        } else if (state.tree_sizes.count(name)) {
+            size_text = FormatTreeSize(info.file_size);
+        } else if (!info.is_symlink) {
+            size_text = "...";
+        }
+    }
+
     auto& sel_style = ConfigManager::GetInstance()->GetConfig().ui.selection_style;
 
     Decorator item_style = nothing;
@@ -67,6 +112,9 @@ Element BuildFileItem(MainState&, int, bool is_selected, bool is_hovered,
     }
 
     auto build_row = [&](Element name_el) -> Element {
+        if (!size_text.empty()) {
+            name_el = hbox({name_el | flex, text(" " + size_text + " ") | color(TC("dim"))});
+        }
         if (is_selected && shaped_indicator) {
             const char* left_ch = (sel_style == "arrow") ? " \ue0b2" : " \ue0b6";
             const char* right_ch = (sel_style == "arrow") ? "\ue0b0 " : "\ue0b4 ";
@@ -113,9 +161,8 @@ Element BuildParentColumn(MainState& state) {
     for (int i = 0; i < static_cast<int>(parentEntriesRef.size()); ++i) {
         bool is_sel = (i == state.cached_parent_selected);
 
-        const FileManager::DirEntryInfo& entry = parentEntriesRef[i];
-
-        std::string line_text = "  " + entry.icon + " " + entry.name;
+        std::string line_text = "  " + parentEntriesRef.icon(i) + " ";
+        line_text += parentEntriesRef.name(i);
         g_parent_sel.lines.push_back(line_text);
 
         bool mouse_sel = false;
@@ -126,7 +173,7 @@ Element BuildParentColumn(MainState& state) {
             if (line_y >= sel_y1 && line_y <= sel_y2) mouse_sel = true;
         }
 
-        Color text_color = is_sel ? TC("selection_fg") : GetEntryColor(entry);
+        Color text_color = is_sel ? TC("selection_fg") : GetEntryColor(parentEntriesRef, i);
 
         Decorator style = nothing;
         if (is_sel || mouse_sel) {
@@ -153,8 +200,8 @@ Element BuildParentColumn(MainState& state) {
         items.push_back(
             hbox({
                 text("  "),
-                text(entry.icon + " "),
-                text(entry.name)
+                text(parentEntriesRef.icon(i) + " "),
+                text(std::string(parentEntriesRef.name(i)))
             }) | style | color(text_color)
         );
     }
@@ -184,6 +231,8 @@ Element BuildCurrentColumn(MainState& state) {
         }
     };
 
+    UpdateCurrentEntryCache(state);
+
     if (!state.searchQuery.empty()) {
         rebuild_filtered();
         state.current_page = 0;
@@ -191,6 +240,19 @@ Element BuildCurrentColumn(MainState& state) {
         rebuild_filtered();
     }
 
+    // 流式批次合并后恢复用户的选中项
+    if (!state.pending_select_name.empty()) {
+        auto it = std::find(state.filteredContents.begin(), state.filteredContents.end(),
+                            state.pending_select_name);
+        if (it != state.filteredContents.end()) {
+            state.selected = static_cast<int>(it - state.filteredContents.begin());
+        }
+        state.pending_select_name.clear();
+    }
+    if (state.selected >= static_cast<int>(state.filteredContents.size())) {
+        state.selected = std::max(0, static_cast<int>(state.filteredContents.size()) - 1);
+    }
+
     state.total_pages = (static_cast<int>(state.filteredContents.size()) + state.items_per_page - 1) / state.items_per_page;
     if (state.total_pages == 0) state.total_pages = 1;
     if (state.current_page >= state.total_pages) state.current_page = state.total_pages - 1;
@@ -211,15 +273,12 @@ Element BuildCurrentColumn(MainState& state) {
     bool shaped_indicator = (sel_cfg == "arrow" || sel_cfg == "rounded");
 
     Elements items;
-    UpdateCurrentEntryCache(state);
     for (int i = start_index; i < end_index; ++i) {
         const std::string& name = state.filteredContents[i];
-        FileManager::DirEntryInfo default_info;
-        const FileManager::DirEntryInfo* found = nullptr;
-        for (const auto& e : state.cached_current_entries) {
-            if (e.name == name) { found = &e; break; }
-        }
-        const FileManager::DirEntryInfo& info = found ? *found : default_info;
+        // 只展开可见行：图标、权限等字符串在此按需生成
+        auto found = state.cached_entry_index.find(name);
+        FileManager::DirEntryInfo info = found != state.cached_entry_index.end()
+            ? state.cached_current_entries.entry(found->second) : FileManager::DirEntryInfo();
 
         std::string indicator_str = (state.selected == i && !shaped_indicator) ? " > " : "   ";
         std::string line_text = indicator_str + info.icon + " " + name;
@@ -242,12 +301,16 @@ Element BuildCurrentColumn(MainState& state) {
         items.push_back(std::move(item));
     }
 
+    bool loading = state.dir_loader && state.dir_loader->streaming();
     if (items.empty()) {
-        items.push_back(text("  (empty)") | color(TC("dim")));
+        items.push_back(text(loading ? "  (loading...)" : "  (empty)") | color(TC("dim")));
     }
 
     UpdatePathCache(state);
     std::string displayPath = state.cached_canonical_path;
+    if (loading) {
+        displayPath += "  [" + std::to_string(state.dir_loader->loadedCount()) + " loaded...]";
+    }
 
     return vbox({
         text(" " + displayPath) | color(TC("path")) | bold,
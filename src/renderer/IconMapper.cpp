@@ -1408,7 +1408,8 @@ std::string GetFolderIcon(const std::filesystem::path& path) {
     return DEFAULT_FOLDER_ICON;
 }
 
-std::string GetFileIcon(const std::filesystem::path& path) {
+// exec_hint: -1 表示未知（需 stat 判断），0/1 为调用方已知的可执行位
+static std::string ResolveFileIcon(const std::filesystem::path& path, int exec_hint) {
     const auto filename = ToLower(path.filename().string());
     if (auto it = kExactFileIcons.find(filename); it != kExactFileIcons.end()) {
         return it->second;
@@ -1426,16 +1427,25 @@ std::string GetFileIcon(const std::filesystem::path& path) {
         return u8"\uf471 ";
     }
 
-    if (!path.has_extension() && IsExecutable(path)) {
+    if (!path.has_extension() && (exec_hint < 0 ? IsExecutable(path) : exec_hint > 0)) {
         return u8"\uf144 ";
     }
 
     return DEFAULT_FILE_ICON;
 }
 
+std::string GetFileIcon(const std::filesystem::path& path) {
+    return ResolveFileIcon(path, -1);
+}
+
 std::string GetIconForPath(const std::filesystem::path& path, bool is_directory) {
     return is_directory ? GetFolderIcon(path) : GetFileIcon(path);
 }
 
+std::string GetIconForEntry(const std::string& name, bool is_directory, bool is_executable) {
+    std::filesystem::path path(name);
+    return is_directory ? GetFolderIcon(path) : ResolveFileIcon(path, is_executable ? 1 : 0);
+}
+
 }  // namespace Icons
 }  // namespace FTB
@@ -259,12 +259,13 @@ Element BuildNormalStatusBar(MainState& state) {
 
     if (cfg.style.show_permissions && state.selected >= 0 && state.selected < static_cast<int>(state.filteredContents.size())) {
         const std::string& sel_name = state.filteredContents[state.selected];
-        for (const auto& e : state.cached_current_entries) {
-            if (e.name == sel_name && !e.permissions.empty()) {
+        auto found = state.cached_entry_index.find(sel_name);
+        if (found != state.cached_entry_index.end()) {
+            std::string permissions = state.cached_current_entries.permissions(found->second);
+            if (!permissions.empty()) {
                 right_segments.push_back(FTB::PowerlineSegmentRight(
-                    " " + e.permissions, status_bg, TC("syn_keyword"), TC("main_bg"), sb_cfg.use_bold, left_sep
+                    " " + permissions, status_bg, TC("syn_keyword"), TC("main_bg"), sb_cfg.use_bold, left_sep
                 ));
-                break;
             }
         }
     }
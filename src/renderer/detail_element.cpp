@@ -201,7 +201,7 @@ static void PushAnsiScrollable(Elements& info_elements,
     PushScrollableContent(info_elements, std::move(content), scroll_y, max_show);
 }
 
-Element CreateDetailElement(const std::vector<DirEntryInfo>& entries,
+Element CreateDetailElement(const EntryTable& entries,
                             int selected,
                             const std::string& currentPath,
                             int scroll_y,
@@ -381,7 +381,7 @@ Element CreateDetailElement(const std::vector<DirEntryInfo>& entries,
         cache.SyncDirData(data);
 
         info_elements.push_back(separator() | color(TC("main_border")));
-        if (data.dir_contents.empty()) {
+        if (!data.dir_contents || data.dir_contents->empty()) {
             if (data.dir_sorted) {
                 info_elements.push_back(text("  (empty)") | color(TC("dim")) | dim);
             } else {
@@ -389,19 +389,21 @@ Element CreateDetailElement(const std::vector<DirEntryInfo>& entries,
             }
         } else {
             int max_dir = cfg_preview.max_dir_entries;
-            int total_dir = static_cast<int>(data.dir_contents.size());
+            const auto& dir_contents = *data.dir_contents;
+            int total_dir = static_cast<int>(dir_contents.size());
             int limit = total_dir;
             if (max_dir > 0) limit = std::min(limit, max_dir);
             Elements dir_lines;
             for (int i = 0; i < limit; ++i) {
-                const auto& entry = data.dir_contents[i];
                 bool is_last = (i == limit - 1);
                 std::string branch = is_last ? u8"\u2514\u2500\u2500 " : u8"\u251C\u2500\u2500 ";
+                std::string label = " " + dir_contents.icon(i);
+                label += dir_contents.name(i);
                 Element name_el;
-                if (entry.is_dir) {
-                    name_el = text(" " + entry.icon + entry.name) | bgcolor(TC("directory")) | color(TC("main_bg")) | bold;
+                if (dir_contents.isDir(i)) {
+                    name_el = text(label) | bgcolor(TC("directory")) | color(TC("main_bg")) | bold;
                 } else {
-                    name_el = text(" " + entry.icon + entry.name) | color(GetEntryColor(entry));
+                    name_el = text(label) | color(GetEntryColor(dir_contents, i));
                 }
                 dir_lines.push_back(
                     hbox({
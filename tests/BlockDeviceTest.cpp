@@ -0,0 +1,68 @@
+// BlockDeviceTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/BlockDevice.hpp"
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using FTB::BlockDevice;
+
+class BlockDeviceTest : public FTB::Test::TempDirFixture<> {
+protected:
+    fs::path sysfs;   // 伪造的 /sys
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        sysfs = temp_dir;
+        fs::create_directories(sysfs / "dev" / "block");
+    }
+
+    // 按真实 sysfs 的布局伪造设备：/sys/dev/block/M:m -> ../../devices/<path>
+    void addDevice(unsigned maj, unsigned min, const std::string& path,
+                   int rotational, int removable, bool partition = false) {
+        fs::path dir = sysfs / "devices" / path;
+        fs::create_directories(dir);
+        fs::path disk = partition ? dir.parent_path() : dir;
+        fs::create_directories(disk / "queue");
+        std::ofstream(disk / "queue" / "rotational") << rotational << "\n";
+        std::ofstream(disk / "removable") << removable << "\n";
+        if (partition) std::ofstream(dir / "partition") << min << "\n";
+        fs::create_directory_symlink(fs::path("..") / ".." / "devices" / path,
+                                     sysfs / "dev" / "block" / (std::to_string(maj) + ":" + std::to_string(min)));
+    }
+
+    BlockDevice::Kind classify(unsigned maj, unsigned min) {
+        return BlockDevice::classify(makedev(maj, min), sysfs.string());
+    }
+};
+
+// 分区取所属磁盘的属性；USB 总线上的设备即使报告为非旋转也按可移动设备处理
+TEST_F(BlockDeviceTest, ClassifiesFromSysfs) {
+    addDevice(8, 0, "pci0/ata1/block/sda", 1, 0);
+    addDevice(8, 1, "pci0/ata1/block/sda/sda1", 1, 0, true);
+    addDevice(259, 0, "pci0/nvme/block/nvme0n1", 0, 0);
+    addDevice(8, 16, "pci0/usb1/1-1/block/sdb", 0, 0);
+    addDevice(11, 0, "pci0/ata2/block/sr0", 1, 1);
+
+    EXPECT_EQ(classify(8, 0), BlockDevice::Kind::Rotational);
+    EXPECT_EQ(classify(8, 1), BlockDevice::Kind::Rotational);
+    EXPECT_EQ(classify(259, 0), BlockDevice::Kind::SolidState);
+    EXPECT_EQ(classify(8, 16), BlockDevice::Kind::Removable);
+    EXPECT_EQ(classify(11, 0), BlockDevice::Kind::Removable);
+    EXPECT_EQ(classify(8, 32), BlockDevice::Kind::Unknown);   // sysfs 中不存在
+    EXPECT_EQ(classify(0, 45), BlockDevice::Kind::Unknown);   // 匿名设备
+}
+
+// 不存在的路径（复制目标）取最近的已存在上级目录所在设备
+TEST_F(BlockDeviceTest, DeviceOfMissingPathUsesParent) {
+    struct stat st{};
+    ASSERT_EQ(::stat(sysfs.c_str(), &st), 0);
+    EXPECT_EQ(BlockDevice::deviceOf(sysfs.string()), static_cast<uint64_t>(st.st_dev));
+    EXPECT_EQ(BlockDevice::deviceOf((sysfs / "missing" / "deeper").string()), static_cast<uint64_t>(st.st_dev));
+    EXPECT_EQ(BlockDevice::deviceOf(""), 0u);
+}
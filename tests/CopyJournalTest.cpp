@@ -0,0 +1,155 @@
+// CopyJournalTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/CopyJournal.hpp"
+#include "browser/TreeCopier.hpp"
+#include <unistd.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+using FTB::CopyJournal;
+
+class CopyJournalTest : public FTB::Test::TempDirFixture<> {
+protected:
+    fs::path journal_dir;
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        journal_dir = temp_dir / "journal";
+        fs::create_directories(journal_dir);
+    }
+
+    static void writeFile(const fs::path& p, const std::string& data) {
+        fs::create_directories(p.parent_path());
+        std::ofstream(p, std::ios::binary) << data;
+    }
+
+    static std::string readAll(const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    CopyJournal::Header makeHeader() {
+        CopyJournal::Header header;
+        header.title = "Copy 1 item(s)";
+        header.total_files = 3;
+        header.total_bytes = 300;
+        header.entries.push_back({(temp_dir / "src").string(), (temp_dir / "dst").string(), false});
+        return header;
+    }
+};
+
+// 记录写出后重新打开可查询；日志被持有期间不可恢复
+TEST_F(CopyJournalTest, RecordsSurviveReopen) {
+    writeFile(temp_dir / "src" / "a", std::string(100, 'a'));
+    writeFile(temp_dir / "dst" / "a", std::string(100, 'a'));
+    writeFile(temp_dir / "src" / "big", std::string(200, 'b'));
+    writeFile(temp_dir / "dst" / "big", std::string(150, 'b'));
+    const std::string odd = (temp_dir / "dst" / "line\nbreak\\x").string();
+
+    std::string path;
+    {
+        auto journal = CopyJournal::create(makeHeader(), journal_dir.string());
+        ASSERT_TRUE(journal);
+        path = journal->path();
+        EXPECT_TRUE(CopyJournal::pending(journal_dir.string()).empty());
+        EXPECT_FALSE(CopyJournal::open(path));
+
+        journal->markFile((temp_dir / "dst" / "a").string(), 100);
+        journal->markFile(odd, 7);
+        journal->markPartial((temp_dir / "dst" / "big").string(), 64);
+        journal->markPartial((temp_dir / "dst" / "big").string(), 180);
+        journal->markEntry(2, 5, 500);
+    }
+
+    ASSERT_EQ(CopyJournal::pending(journal_dir.string()), std::vector<std::string>{path});
+    CopyJournal::Header header;
+    ASSERT_TRUE(CopyJournal::readHeader(path, header));
+    EXPECT_EQ(header.title, "Copy 1 item(s)");
+    ASSERT_EQ(header.entries.size(), 1u);
+
+    auto journal = CopyJournal::open(path);
+    ASSERT_TRUE(journal);
+    uintmax_t size = 0;
+    EXPECT_TRUE(journal->completed((temp_dir / "src" / "a").string(), (temp_dir / "dst" / "a").string(), size));
+    EXPECT_EQ(size, 100u);
+    EXPECT_FALSE(journal->completed("/nonexistent", odd, size));
+    // 记录的偏移超过目标实际长度时取目标长度
+    EXPECT_EQ(journal->resumeOffset((temp_dir / "dst" / "big").string()), 150u);
+    EXPECT_EQ(journal->resumeOffset((temp_dir / "dst" / "a").string()), 0u);
+    int files = 0;
+    uintmax_t bytes = 0;
+    EXPECT_TRUE(journal->entryDone(2, files, bytes));
+    EXPECT_EQ(files, 5);
+    EXPECT_EQ(bytes, 500u);
+    EXPECT_FALSE(journal->entryDone(0, files, bytes));
+
+    journal->remove();
+    EXPECT_FALSE(fs::exists(path));
+}
+
+// 被截断的最后一行被忽略，之后追加的记录仍可读
+TEST_F(CopyJournalTest, IgnoresTornRecord) {
+    writeFile(temp_dir / "src" / "a", "xyz");
+    writeFile(temp_dir / "dst" / "a", "xyz");
+    std::string path;
+    {
+        auto journal = CopyJournal::create(makeHeader(), journal_dir.string());
+        ASSERT_TRUE(journal);
+        path = journal->path();
+    }
+    std::ofstream(path, std::ios::app) << "F 3 /half-writ";
+    {
+        auto journal = CopyJournal::open(path);
+        ASSERT_TRUE(journal);
+        journal->markFile((temp_dir / "dst" / "a").string(), 3);
+    }
+    auto journal = CopyJournal::open(path);
+    ASSERT_TRUE(journal);
+    uintmax_t size = 0;
+    EXPECT_TRUE(journal->completed((temp_dir / "src" / "a").string(), (temp_dir / "dst" / "a").string(), size));
+}
+
+// 恢复的目录复制跳过已完成的文件，从记录的偏移续传部分文件，其余正常复制
+TEST_F(CopyJournalTest, TreeCopierResumes) {
+    const std::string big(300000, 'q');
+    writeFile(temp_dir / "src" / "done.txt", "original");
+    writeFile(temp_dir / "src" / "sub" / "big.bin", big);
+    writeFile(temp_dir / "src" / "sub" / "new.txt", "fresh");
+
+    // 上次运行的结果：done.txt 已完成（内容故意不同，以确认没有被重新复制），
+    // big.bin 复制到 100000 字节后还写了一段不完整的尾部
+    writeFile(temp_dir / "dst" / "done.txt", "ORIGINAL");
+    writeFile(temp_dir / "dst" / "sub" / "big.bin", big.substr(0, 100000) + std::string(5000, '#'));
+    std::string path;
+    {
+        auto journal = CopyJournal::create(makeHeader(), journal_dir.string());
+        ASSERT_TRUE(journal);
+        path = journal->path();
+        journal->markFile((temp_dir / "dst" / "done.txt").string(), 8);
+        journal->markPartial((temp_dir / "dst" / "sub" / "big.bin").string(), 100000);
+    }
+
+    for (bool ring : {true, false}) {
+        auto journal = CopyJournal::open(path);
+        ASSERT_TRUE(journal);
+        Progress progress;
+        std::atomic<bool> cancel{false}, pause{false};
+        FTB::TreeCopier::Options options;
+        options.use_io_uring = ring;
+        options.journal = journal.get();
+        ASSERT_TRUE(FTB::TreeCopier::copy((temp_dir / "src").string(), (temp_dir / "dst").string(),
+                                          progress, cancel, pause, options));
+
+        EXPECT_EQ(readAll(temp_dir / "dst" / "done.txt"), "ORIGINAL");
+        EXPECT_EQ(readAll(temp_dir / "dst" / "sub" / "big.bin"), big);
+        EXPECT_EQ(readAll(temp_dir / "dst" / "sub" / "new.txt"), "fresh");
+        EXPECT_EQ(progress.bytes_processed.load(), 8u + big.size() + 5u);
+        EXPECT_EQ(progress.files_processed.load(), 4);   // sub/ + 3 个文件
+        fs::remove(temp_dir / "dst" / "sub" / "new.txt");
+    }
+}
@@ -0,0 +1,168 @@
+// DirScannerTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/DirScanner.hpp"
+#include "browser/FileManager.hpp"
+#include "browser/DirectoryLoader.hpp"
+#include "browser/StatFanout.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class DirScannerTest : public FTB::Test::TempDirFixture<> {};
+
+// 读取到的名称集合应与 directory_iterator 完全一致，且不包含 "." 与 ".."
+TEST_F(DirScannerTest, ReadAllMatchesDirectoryIterator) {
+    for (int i = 0; i < 3000; ++i)
+        std::ofstream(temp_dir / ("f" + std::to_string(i)));
+    fs::create_directory(temp_dir / "sub");
+
+    std::set<std::string> expected;
+    for (const auto& e : fs::directory_iterator(temp_dir))
+        expected.insert(e.path().filename().string());
+
+    std::set<std::string> actual;
+    for (const auto& e : FTB::DirScanner::readAll(temp_dir.string()))
+        actual.insert(e.name);
+
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(actual.count("."), 0u);
+    EXPECT_EQ(actual.count(".."), 0u);
+}
+
+TEST_F(DirScannerTest, StatAtReportsTypeAndSize) {
+    std::ofstream(temp_dir / "data.bin") << "hello";
+    fs::create_directory(temp_dir / "dir");
+    fs::create_symlink("data.bin", temp_dir / "link");
+
+    FTB::DirScanner scanner(temp_dir.string());
+    ASSERT_TRUE(scanner.ok());
+
+    FTB::EntryStat st;
+    ASSERT_TRUE(FTB::DirScanner::statAt(scanner.fd(), "data.bin",
+                                        FTB::DirScanner::kStatMode | FTB::DirScanner::kStatSize, st));
+    EXPECT_TRUE(S_ISREG(st.mode));
+    EXPECT_EQ(st.size, 5u);
+
+    ASSERT_TRUE(FTB::DirScanner::statAt(scanner.fd(), "dir", FTB::DirScanner::kStatType, st));
+    EXPECT_TRUE(S_ISDIR(st.mode));
+
+    ASSERT_TRUE(FTB::DirScanner::statAt(scanner.fd(), "link", FTB::DirScanner::kStatType, st));
+    EXPECT_TRUE(S_ISLNK(st.mode));
+    ASSERT_TRUE(FTB::DirScanner::statAt(scanner.fd(), "link",
+                                        FTB::DirScanner::kStatType | FTB::DirScanner::kStatSize,
+                                        st, /*follow=*/true));
+    EXPECT_TRUE(S_ISREG(st.mode));
+    EXPECT_EQ(st.size, 5u);
+}
+
+TEST_F(DirScannerTest, MissingDirectoryIsEmpty) {
+    FTB::DirScanner scanner((temp_dir / "missing").string());
+    EXPECT_FALSE(scanner.ok());
+    EXPECT_NE(scanner.error(), 0);
+    EXPECT_TRUE(FTB::DirScanner::readAll((temp_dir / "missing").string()).empty());
+}
+
+// getDirectoryEntries 应保留符号链接解析与权限字符串的原有语义
+TEST_F(DirScannerTest, DirectoryEntriesMetadata) {
+    std::ofstream(temp_dir / "a.txt") << "12345678";
+    fs::create_directory(temp_dir / "b");
+    fs::create_symlink("a.txt", temp_dir / "c");
+
+    auto entries = FileManager::getDirectoryEntries(temp_dir.string());
+    ASSERT_EQ(entries.size(), 3u);
+
+    auto find = [&](const std::string& name) {
+        return *std::find_if(entries.begin(), entries.end(),
+                             [&](const FileManager::DirEntryInfo& e) { return e.name == name; });
+    };
+
+    auto file = find("a.txt");
+    EXPECT_TRUE(file.is_regular);
+    EXPECT_EQ(file.file_size, 8u);
+    EXPECT_EQ(file.permissions[0], '-');
+    EXPECT_EQ(file.mod_time.size(), 16u);
+
+    auto dir = find("b");
+    EXPECT_TRUE(dir.is_dir);
+    EXPECT_EQ(dir.permissions[0], 'd');
+
+    auto link = find("c");
+    EXPECT_TRUE(link.is_symlink);
+    EXPECT_TRUE(link.is_regular);
+    EXPECT_EQ(link.file_size, 8u);
+    EXPECT_EQ(link.permissions[0], 'l');
+}
+
+// 并行分发后批次回调必须连续、按顺序覆盖全部条目
+TEST(StatFanoutTest, DeliversBatchesInOrder) {
+    const size_t count = FTB::StatFanout::kBatchSize * 20 + 17;
+    std::vector<size_t> values(count, 0);
+    size_t next_begin = 0;
+    FTB::StatFanout::run(
+        count,
+        [&](size_t i) { values[i] = i + 1; },
+        [&](size_t begin, size_t end) {
+            EXPECT_EQ(begin, next_begin);
+            for (size_t i = begin; i < end; ++i) EXPECT_EQ(values[i], i + 1);
+            next_begin = end;
+        });
+    EXPECT_EQ(next_begin, count);
+}
+
+// 流式加载：名称批次合计覆盖全部条目，且最终结果完整
+TEST_F(DirScannerTest, DirectoryLoaderStreamsAllEntries) {
+    const size_t count = FileManager::kNameChunkSize + 100;
+    for (size_t i = 0; i < count; ++i)
+        std::ofstream(temp_dir / ("f" + std::to_string(i)));
+
+    FTB::DirectoryLoader loader(temp_dir.string(), /*stream=*/true, nullptr);
+    size_t streamed = 0;
+    FTB::DirectoryLoader::Update update;
+    for (int i = 0; i < 500 && !update.finished; ++i) {
+        loader.waitForFirstResult(std::chrono::milliseconds(10));
+        update = loader.take();
+        streamed += update.names.size();
+        if (!update.finished) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_TRUE(update.finished);
+    EXPECT_EQ(streamed, count);
+    EXPECT_EQ(update.final_entries.size(), count);
+    for (size_t i = 0; i < update.final_entries.size(); ++i)
+        EXPECT_FALSE(update.final_entries.statPending(i));
+}
+
+// 读取名称期间取消：返回空表，不写缓存，也不留下目录监听
+TEST_F(DirScannerTest, CancelledLoadReleasesWatch) {
+    for (int i = 0; i < 10; ++i)
+        std::ofstream(temp_dir / ("f" + std::to_string(i)));
+    const std::string dir = temp_dir.string();
+
+    std::atomic<bool> cancel{true};
+    auto entries = FileManager::loadDirectoryEntries(dir, nullptr, nullptr, &cancel);
+
+    EXPECT_EQ(entries->size(), 0u);
+    EXPECT_FALSE(FileManager::lru_entry_cache->contains(dir));
+    EXPECT_FALSE(FileManager::isDirectoryWatched(dir));
+}
+
+// 写入缓存的表与返回值是同一份，不复制
+TEST_F(DirScannerTest, LoadedTableIsSharedWithCache) {
+    for (int i = 0; i < 10; ++i)
+        std::ofstream(temp_dir / ("f" + std::to_string(i)));
+    const std::string dir = temp_dir.string();
+
+    auto entries = FileManager::loadDirectoryEntries(dir, nullptr, nullptr);
+    auto cached = FileManager::lru_entry_cache->get(dir);
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(cached.get(), entries.get());
+    EXPECT_EQ(entries->size(), 10u);
+    FileManager::lru_entry_cache->erase(dir);
+}
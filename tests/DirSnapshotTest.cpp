@@ -0,0 +1,150 @@
+// DirSnapshotTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/DirSnapshot.hpp"
+#include "browser/DirScanner.hpp"
+#include "browser/EntryTable.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class DirSnapshotTest : public FTB::Test::TempDirFixture<> {
+protected:
+    fs::path tree;
+    std::string file;
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        tree = temp_dir / "tree";
+        fs::create_directories(tree / "sub");
+        file = (temp_dir / "snapshot.bin").string();
+    }
+
+    // 按 FileManager 的方式读取目录：先记录 DirStamp，再 getdents64 + lstat 补全
+    static std::shared_ptr<const FTB::EntryTable> scan(const fs::path& dir) {
+        FTB::EntryTable table;
+        FTB::DirStamp stamp;
+        EXPECT_TRUE(FTB::DirSnapshot::stampOf(dir.string(), stamp));
+        table.setDirStamp(stamp);
+        for (const auto& raw : FTB::DirScanner::readAll(dir.string())) {
+            size_t pos = table.appendPending(raw.name, raw.type);
+            struct stat st;
+            EXPECT_EQ(::lstat((dir / raw.name).c_str(), &st), 0);
+            table.setStat(pos, st.st_mode, st.st_mtime, st.st_size, 0);
+        }
+        table.sort(FTB::SortMode::NameAsc);
+        return std::make_shared<const FTB::EntryTable>(std::move(table));
+    }
+
+    // 把目录 mtime 推后一秒，保证变化可区分（部分文件系统的时间精度较粗）
+    static void bumpMtime(const fs::path& dir) {
+        struct stat st;
+        ASSERT_EQ(::stat(dir.c_str(), &st), 0);
+        struct timespec times[2] = {st.st_atim, st.st_mtim};
+        times[1].tv_sec += 1;
+        ASSERT_EQ(::utimensat(AT_FDCWD, dir.c_str(), times, 0), 0);
+    }
+};
+
+// 写入后映射读取，条目的名称与元信息逐一还原；名称中的 '|' 与换行不影响格式
+TEST_F(DirSnapshotTest, RoundTripsEntryTables) {
+    std::ofstream(tree / "a|b.txt") << "12345";
+    std::ofstream(tree / "line\nbreak") << "x";
+    std::ofstream(tree / ".hidden");
+    auto root = scan(tree);
+    auto sub = scan(tree / "sub");
+
+    ASSERT_TRUE(FTB::DirSnapshot::write(file, {{tree.string(), root}, {(tree / "sub").string(), sub}},
+                                        FTB::SortMode::NameAsc));
+    auto snapshot = FTB::DirSnapshot::open(file);
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->directoryCount(), 2u);
+    EXPECT_EQ(snapshot->sortMode(), FTB::SortMode::NameAsc);
+
+    auto loaded = snapshot->load(tree.string());
+    ASSERT_TRUE(loaded);
+    ASSERT_EQ(loaded->size(), root->size());
+    for (size_t i = 0; i < root->size(); ++i) {
+        EXPECT_EQ(loaded->name(i), root->name(i));
+        EXPECT_EQ(loaded->mode(i), root->mode(i));
+        EXPECT_EQ(loaded->fileSize(i), root->fileSize(i));
+        EXPECT_EQ(loaded->mtime(i), root->mtime(i));
+        EXPECT_EQ(loaded->isDir(i), root->isDir(i));
+        EXPECT_EQ(loaded->isHidden(i), root->isHidden(i));
+        EXPECT_EQ(loaded->icon(i), root->icon(i));
+    }
+    auto loaded_sub = snapshot->load((tree / "sub").string());
+    ASSERT_TRUE(loaded_sub);
+    EXPECT_TRUE(loaded_sub->empty());
+    EXPECT_FALSE(snapshot->load((temp_dir / "missing").string()));
+}
+
+// 目录内容变化后 mtime 不再一致，快照中的列表不可使用
+TEST_F(DirSnapshotTest, RejectsChangedDirectory) {
+    std::ofstream(tree / "old.txt");
+    ASSERT_TRUE(FTB::DirSnapshot::write(file, {{tree.string(), scan(tree)}}, FTB::SortMode::NameAsc));
+
+    // 保证 mtime 可区分（部分文件系统的时间精度较粗）
+    struct stat before;
+    ASSERT_EQ(::stat(tree.c_str(), &before), 0);
+    std::ofstream(tree / "new.txt");
+    struct timespec times[2] = {before.st_atim, before.st_mtim};
+    times[1].tv_sec += 1;
+    ASSERT_EQ(::utimensat(AT_FDCWD, tree.c_str(), times, 0), 0);
+
+    auto snapshot = FTB::DirSnapshot::open(file);
+    ASSERT_TRUE(snapshot);
+    EXPECT_FALSE(snapshot->load(tree.string()));
+}
+
+// 缓存中的列表读取后目录又有变化（尚未修补进缓存）：写入时跳过该目录，而不是配上当前的 mtime
+TEST_F(DirSnapshotTest, SkipsListingOlderThanDirectory) {
+    std::ofstream(tree / "old.txt");
+    auto stale = scan(tree);
+    bumpMtime(tree);
+    std::ofstream(tree / "new.txt");
+    bumpMtime(tree);
+
+    // 没有 DirStamp 的表（修补过的或 SFTP 的列表）同样被跳过
+    FTB::EntryTable unstamped = *scan(tree / "sub");
+    unstamped.setDirStamp({});
+
+    ASSERT_TRUE(FTB::DirSnapshot::write(file,
+                                        {{tree.string(), stale},
+                                         {(tree / "sub").string(),
+                                          std::make_shared<const FTB::EntryTable>(std::move(unstamped))}},
+                                        FTB::SortMode::NameAsc));
+    auto snapshot = FTB::DirSnapshot::open(file);
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->directoryCount(), 0u);
+    EXPECT_FALSE(snapshot->load(tree.string()));
+}
+
+// 截断或内容损坏的文件在 open 或 load 时被拒绝
+TEST_F(DirSnapshotTest, RejectsCorruptFile) {
+    std::ofstream(tree / "f.txt") << "data";
+    ASSERT_TRUE(FTB::DirSnapshot::write(file, {{tree.string(), scan(tree)}}, FTB::SortMode::NameAsc));
+    auto size = fs::file_size(file);
+
+    // 名称区中的一个字节：目录表完好，本目录的校验和不符
+    {
+        std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(size - 1));
+        f.put('#');
+    }
+    auto snapshot = FTB::DirSnapshot::open(file);
+    ASSERT_TRUE(snapshot);
+    EXPECT_FALSE(snapshot->load(tree.string()));
+
+    fs::resize_file(file, size / 2);
+    EXPECT_FALSE(FTB::DirSnapshot::open(file));
+
+    std::ofstream(file, std::ios::trunc) << "not a snapshot";
+    EXPECT_FALSE(FTB::DirSnapshot::open(file));
+}
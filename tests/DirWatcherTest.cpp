@@ -0,0 +1,239 @@
+// DirWatcherTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/DirWatcher.hpp"
+#include "browser/EntryTable.hpp"
+#include "browser/FileManager.hpp"
+#include "browser/SortMode.hpp"
+#include "config/ConfigManager.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class DirWatcherTest : public FTB::Test::TempDirFixture<> {
+protected:
+    void SetUp() override {
+        if (!FTB::DirWatcher::instance().available())
+            GTEST_SKIP() << "inotify unavailable";
+        TempDirFixture::SetUp();
+    }
+
+    void TearDown() override {
+        FileManager::setDirectoryChangeListener(nullptr);
+        if (!temp_dir.empty()) FileManager::lru_entry_cache->erase(temp_dir.string());
+        TempDirFixture::TearDown();
+    }
+
+    // 轮询直到 pred 成立或超时
+    template <typename Pred>
+    static bool waitFor(Pred pred) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (pred()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return pred();
+    }
+};
+
+// 新建、重命名、删除分别报告为 Created / Deleted
+TEST_F(DirWatcherTest, ReportsCreateRenameDelete) {
+    auto& watcher = FTB::DirWatcher::instance();
+    std::mutex mutex;
+    std::vector<FTB::DirWatcher::Change> seen;
+    size_t id = watcher.addListener([&](const std::string& dir, const std::vector<FTB::DirWatcher::Change>& changes) {
+        if (dir != temp_dir.string()) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(seen.end(), changes.begin(), changes.end());
+    });
+    ASSERT_TRUE(watcher.watch(temp_dir.string()));
+
+    auto has = [&](FTB::DirWatcher::Change::Kind kind, const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::any_of(seen.begin(), seen.end(), [&](const auto& c) {
+            return c.kind == kind && c.name == name;
+        });
+    };
+
+    std::ofstream(temp_dir / "a.txt") << "x";
+    EXPECT_TRUE(waitFor([&] { return has(FTB::DirWatcher::Change::Created, "a.txt"); }));
+    fs::rename(temp_dir / "a.txt", temp_dir / "b.txt");
+    EXPECT_TRUE(waitFor([&] { return has(FTB::DirWatcher::Change::Deleted, "a.txt"); }));
+    EXPECT_TRUE(waitFor([&] { return has(FTB::DirWatcher::Change::Created, "b.txt"); }));
+
+    watcher.unwatch(temp_dir.string());
+    watcher.removeListener(id);
+    EXPECT_FALSE(watcher.isWatched(temp_dir.string()));
+}
+
+// 缓存中的条目列表被增量修补，并通知变更回调
+TEST_F(DirWatcherTest, PatchesCachedEntries) {
+    std::ofstream(temp_dir / "keep.txt") << "1";
+    const std::string dir = temp_dir.string();
+
+    auto entries = FileManager::getDirectoryEntries(dir);
+    ASSERT_EQ(entries.size(), 1u);
+    ASSERT_TRUE(FileManager::isDirectoryWatched(dir));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int notified = 0;
+    FileManager::setDirectoryChangeListener([&](const std::string& changed) {
+        if (changed != dir) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        ++notified;
+        cv.notify_all();
+    });
+
+    std::ofstream(temp_dir / "new.txt") << "12345";
+    fs::remove(temp_dir / "keep.txt");
+
+    EXPECT_TRUE(waitFor([&] {
+        auto cached = FileManager::lru_entry_cache->get(dir);
+        return cached && cached->size() == 1 && cached->name(0) == "new.txt" &&
+               cached->fileSize(0) == 5;
+    }));
+
+    auto cached = FileManager::lru_entry_cache->get(dir);
+    ASSERT_TRUE(cached);
+    ASSERT_EQ(cached->size(), 1u);
+    EXPECT_EQ(cached->fileSize(0), 5u);
+    EXPECT_FALSE(cached->statPending(0));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return notified > 0; }));
+}
+
+// 本地重命名直接修补缓存中的有序列表，不依赖重新扫描
+TEST_F(DirWatcherTest, RenamePatchesSortedCache) {
+    for (const char* name : {"alpha", "charlie", "echo"})
+        std::ofstream(temp_dir / name) << name;
+    fs::create_directory(temp_dir / "zdir");
+    const std::string dir = temp_dir.string();
+    ASSERT_EQ(FileManager::getDirectoryEntries(dir, FTB::SortMode::NameAsc).size(), 4u);
+
+    ASSERT_TRUE(FileManager::renameFileOrDirectory((temp_dir / "echo").string(), "bravo"));
+
+    auto cached = FileManager::lru_entry_cache->get(dir);
+    ASSERT_TRUE(cached);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < cached->size(); ++i) names.emplace_back(cached->name(i));
+    EXPECT_EQ(names, (std::vector<std::string>{"zdir", "alpha", "bravo", "charlie"}));
+    EXPECT_EQ(cached->fileSize(2), 4u);
+}
+
+// patchCacheOn*：直接修补已缓存的条目表，不依赖 inotify，也不重新扫描目录
+class CachePatchTest : public FTB::Test::TempDirFixture<> {
+protected:
+    std::string dir;
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        dir = temp_dir.string();
+        for (const char* name : {"alpha", "charlie"})
+            std::ofstream(temp_dir / name) << name;
+        fs::create_directory(temp_dir / "zdir");
+    }
+
+    void TearDown() override {
+        FileManager::lru_entry_cache->erase(dir);
+        FileManager::lru_entry_cache->erase((temp_dir / "zdir").string());
+        TempDirFixture::TearDown();
+    }
+
+    static FTB::SortMode configMode() {
+        return FTB::SortModeFromString(FTB::ConfigManager::GetInstance()->GetConfig().style.sort_mode);
+    }
+
+    // 读取目录写入缓存，再加入一个磁盘上不存在的条目：修补后它仍在，说明没有重新扫描
+    void cacheWithMarker(const std::string& path) {
+        auto loaded = FileManager::loadDirectoryEntries(path, nullptr, nullptr);
+        ASSERT_FALSE(loaded->dirStamp().empty());
+        FTB::EntryTable table = *loaded;
+        FileManager::DirEntryInfo marker;
+        marker.name = "marker";
+        marker.is_regular = true;
+        marker.exists = true;
+        table.append(marker);
+        table.sort(configMode());
+        FileManager::lru_entry_cache->put(path, std::move(table));
+    }
+
+    static std::vector<std::string> cachedNames(const std::string& path) {
+        std::vector<std::string> names;
+        if (auto cached = FileManager::lru_entry_cache->get(path)) {
+            for (size_t i = 0; i < cached->size(); ++i) names.emplace_back(cached->name(i));
+        }
+        return names;
+    }
+};
+
+TEST_F(CachePatchTest, CreateInsertsInSortOrderAndDropsDirStamp) {
+    cacheWithMarker(dir);
+    auto before = FileManager::lru_entry_cache->get(dir);
+
+    std::ofstream(temp_dir / "bravo") << "12345";
+    fs::create_directory(temp_dir / "ydir");
+    FileManager::patchCacheOnCreate((temp_dir / "bravo").string());
+    FileManager::patchCacheOnCreate((temp_dir / "ydir").string());
+
+    EXPECT_EQ(cachedNames(dir), (std::vector<std::string>{"ydir", "zdir", "alpha", "bravo", "charlie", "marker"}));
+    auto cached = FileManager::lru_entry_cache->get(dir);
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(cached->fileSize(3), 5u);
+    EXPECT_FALSE(cached->statPending(3));
+    EXPECT_TRUE(cached->dirStamp().empty());
+    // 持有旧快照的读者不受影响
+    EXPECT_EQ(before->size(), 4u);
+}
+
+TEST_F(CachePatchTest, RemoveErasesEntry) {
+    cacheWithMarker(dir);
+    fs::remove(temp_dir / "charlie");
+    FileManager::patchCacheOnRemove((temp_dir / "charlie").string());
+
+    EXPECT_EQ(cachedNames(dir), (std::vector<std::string>{"zdir", "alpha", "marker"}));
+}
+
+TEST_F(CachePatchTest, RenameKeepsSortOrder) {
+    cacheWithMarker(dir);
+    fs::rename(temp_dir / "charlie", temp_dir / "aardvark");
+    FileManager::patchCacheOnRename((temp_dir / "charlie").string(), (temp_dir / "aardvark").string());
+
+    EXPECT_EQ(cachedNames(dir), (std::vector<std::string>{"zdir", "aardvark", "alpha", "marker"}));
+    EXPECT_TRUE(FileManager::lru_entry_cache->get(dir)->dirStamp().empty());
+}
+
+TEST_F(CachePatchTest, RenameAcrossDirectoriesPatchesBothParents) {
+    const std::string sub = (temp_dir / "zdir").string();
+    cacheWithMarker(dir);
+    cacheWithMarker(sub);
+    fs::rename(temp_dir / "alpha", temp_dir / "zdir" / "alpha");
+    FileManager::patchCacheOnRename((temp_dir / "alpha").string(), (temp_dir / "zdir" / "alpha").string());
+
+    EXPECT_EQ(cachedNames(dir), (std::vector<std::string>{"zdir", "charlie", "marker"}));
+    EXPECT_EQ(cachedNames(sub), (std::vector<std::string>{"alpha", "marker"}));
+}
+
+TEST_F(CachePatchTest, ModifyRefreshesMetadata) {
+    cacheWithMarker(dir);
+    std::ofstream(temp_dir / "alpha", std::ios::app) << "-longer";
+    FileManager::patchCacheOnModify((temp_dir / "alpha").string());
+
+    EXPECT_EQ(cachedNames(dir), (std::vector<std::string>{"zdir", "alpha", "charlie", "marker"}));
+    EXPECT_EQ(FileManager::lru_entry_cache->get(dir)->fileSize(1), 12u);
+}
+
+// 父目录未缓存时不做任何事
+TEST_F(CachePatchTest, UncachedParentIsLeftAlone) {
+    std::ofstream(temp_dir / "bravo") << "b";
+    FileManager::patchCacheOnCreate((temp_dir / "bravo").string());
+    EXPECT_FALSE(FileManager::lru_entry_cache->contains(dir));
+}
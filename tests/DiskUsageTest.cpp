@@ -0,0 +1,126 @@
+// DiskUsageTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/DiskUsage.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using FTB::DiskUsage;
+
+class DiskUsageTest : public FTB::Test::TempDirFixture<> {
+protected:
+
+    static void writeFile(const fs::path& p, size_t size) {
+        fs::create_directories(p.parent_path());
+        std::ofstream(p, std::ios::binary) << std::string(size, 'x');
+    }
+
+    // 与 du 相同的口径逐项累计占用空间：不跟随符号链接，同一 inode 只计一次
+    static uintmax_t diskOf(const fs::path& root) {
+        struct stat st;
+        ::lstat(root.c_str(), &st);
+        uintmax_t total = static_cast<uintmax_t>(st.st_blocks) * 512;
+        std::set<std::pair<dev_t, ino_t>> seen;
+        for (const auto& e : fs::recursive_directory_iterator(root)) {
+            ::lstat(e.path().c_str(), &st);
+            if (!S_ISDIR(st.st_mode) && st.st_nlink > 1 && !seen.insert({st.st_dev, st.st_ino}).second) continue;
+            total += static_cast<uintmax_t>(st.st_blocks) * 512;
+        }
+        return total;
+    }
+};
+
+// 硬链接只计一次，符号链接计链接本身而不跟随；按顶层条目给出子树合计
+TEST_F(DiskUsageTest, CountsHardlinksOnceAndSplitsByChild) {
+    writeFile(temp_dir / "a" / "one.bin", 1000);
+    writeFile(temp_dir / "a" / "deep" / "er" / "two.bin", 2000);
+    writeFile(temp_dir / "b" / "three.bin", 3000);
+    writeFile(temp_dir / "top.bin", 500);
+    fs::create_hard_link(temp_dir / "b" / "three.bin", temp_dir / "b" / "three_again.bin");
+    fs::create_symlink(temp_dir / "a", temp_dir / "link_to_a");
+    const uintmax_t link_size = fs::read_symlink(temp_dir / "link_to_a").string().size();
+
+    for (size_t threads : {size_t{1}, size_t{4}}) {
+        DiskUsage::Options options;
+        options.threads = threads;
+        options.per_child = true;
+        auto report = DiskUsage::measure(temp_dir.string(), options);
+        EXPECT_FALSE(report.cancelled);
+        EXPECT_EQ(report.total.apparent, 1000u + 2000u + 3000u + 500u + link_size);
+        EXPECT_EQ(report.total.files, 5u);      // 4 个文件（硬链接计一次）+ 1 个符号链接
+        EXPECT_EQ(report.total.dirs, 5u);       // 根、a、a/deep、a/deep/er、b
+        EXPECT_EQ(report.total.errors, 0u);
+        EXPECT_EQ(report.total.disk, diskOf(temp_dir));
+
+        ASSERT_EQ(report.children.size(), 4u);
+        for (const auto& child : report.children) {
+            if (child.name == "a") {
+                EXPECT_EQ(child.totals.apparent, 3000u);
+                EXPECT_EQ(child.totals.dirs, 3u);
+            } else if (child.name == "b") {
+                EXPECT_EQ(child.totals.apparent, 3000u);
+                EXPECT_EQ(child.totals.files, 1u);
+            } else if (child.name == "top.bin") {
+                EXPECT_EQ(child.totals.apparent, 500u);
+            } else if (child.name == "link_to_a") {
+                EXPECT_EQ(child.totals.apparent, link_size);
+            }
+        }
+
+        options.dedupe_hardlinks = false;
+        EXPECT_EQ(DiskUsage::measure(temp_dir.string(), options).total.apparent,
+                  1000u + 2000u + 3000u * 2 + 500u + link_size);
+    }
+}
+
+// 遍历中回报部分合计，最后一次等于最终结果；取消后提前返回
+TEST_F(DiskUsageTest, StreamsProgressAndCancels) {
+    for (int d = 0; d < 50; ++d) {
+        for (int f = 0; f < 20; ++f) {
+            writeFile(temp_dir / ("d" + std::to_string(d)) / ("sub" + std::to_string(f % 3)) / ("f" + std::to_string(f)), 10);
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<uintmax_t> seen;
+    DiskUsage::Options options;
+    options.threads = 4;
+    options.progress_interval = std::chrono::milliseconds(0);
+    options.on_progress = [&](const DiskUsage::Totals& partial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(partial.files);
+    };
+    auto report = DiskUsage::measure(temp_dir.string(), options);
+    EXPECT_EQ(report.total.files, 1000u);
+    EXPECT_EQ(report.total.apparent, 10000u);
+    ASSERT_GE(seen.size(), 2u);
+    EXPECT_EQ(seen.back(), 1000u);
+
+    std::atomic<bool> cancel{true};
+    options.cancel = &cancel;
+    options.on_progress = {};
+    report = DiskUsage::measure(temp_dir.string(), options);
+    EXPECT_TRUE(report.cancelled);
+    EXPECT_LT(report.total.files, 1000u);
+}
+
+// 根是文件时只统计它自己；不存在的路径记一个错误
+TEST_F(DiskUsageTest, FileRootAndMissingRoot) {
+    writeFile(temp_dir / "single", 1234);
+    auto report = DiskUsage::measure((temp_dir / "single").string());
+    EXPECT_EQ(report.total.apparent, 1234u);
+    EXPECT_EQ(report.total.files, 1u);
+    EXPECT_EQ(report.total.dirs, 0u);
+
+    report = DiskUsage::measure((temp_dir / "missing").string());
+    EXPECT_EQ(report.total.apparent, 0u);
+    EXPECT_EQ(report.total.errors, 1u);
+}
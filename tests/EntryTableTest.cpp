@@ -0,0 +1,146 @@
+// EntryTableTest.cpp
+#include "gtest/gtest.h"
+#include "browser/EntryTable.hpp"
+#include "browser/SortMode.hpp"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> namesOf(const FTB::EntryTable& table) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < table.size(); ++i) names.emplace_back(table.name(i));
+    return names;
+}
+
+}  // namespace
+
+// 待补全条目只有类型信息，setStat 后才格式化出权限与时间
+TEST(EntryTableTest, PendingRowsFillLazily) {
+    FTB::EntryTable table;
+    size_t pos = table.appendPending("run.sh", DT_REG);
+    EXPECT_TRUE(table.statPending(pos));
+    EXPECT_TRUE(table.isRegular(pos));
+    EXPECT_TRUE(table.permissions(pos).empty());
+    EXPECT_TRUE(table.modTime(pos).empty());
+
+    table.setStat(pos, S_IFREG | 0755, 0, 42, 0);
+    EXPECT_FALSE(table.statPending(pos));
+    EXPECT_TRUE(table.isExecutable(pos));
+    EXPECT_EQ(table.fileSize(pos), 42u);
+    EXPECT_EQ(table.permissions(pos), "-rwxr-xr-x");
+    EXPECT_FALSE(table.modTime(pos).empty());
+
+    // 指向目录的符号链接：类型取目标，大小不计
+    size_t link = table.appendPending("lnk", DT_LNK);
+    table.setStat(link, S_IFLNK | 0777, 0, 4096, S_IFDIR | 0755);
+    EXPECT_TRUE(table.isSymlink(link));
+    EXPECT_TRUE(table.isDir(link));
+    EXPECT_EQ(table.fileSize(link), 0u);
+    EXPECT_EQ(table.permissions(link)[0], 'l');
+}
+
+// 排序、查找、删除与重新定位只移动行号，与 DirEntryInfo 的排序结果一致
+TEST(EntryTableTest, OrderedOperationsMatchVectorSort) {
+    std::vector<FileManager::DirEntryInfo> entries;
+    FTB::EntryTable table;
+    const char* names[] = {"delta.txt", "Alpha.md", "zeta", "beta.txt", ".hidden", "gamma"};
+    for (size_t i = 0; i < 6; ++i) {
+        size_t pos = table.appendPending(names[i], i == 2 || i == 5 ? DT_DIR : DT_REG);
+        table.setStat(pos, (i == 2 || i == 5 ? S_IFDIR : S_IFREG) | 0644,
+                      static_cast<int64_t>(86400 + (i % 4) * 3600 + i * 60), (i * 37) % 100, 0);
+        entries.push_back(table.entry(pos));
+    }
+
+    for (auto mode : FTB::GetAllSortModes()) {
+        table.sort(mode);
+        auto expected = entries;
+        FTB::SortEntries(expected, mode);
+        std::vector<std::string> expected_names;
+        for (const auto& e : expected) expected_names.push_back(e.name);
+        EXPECT_EQ(namesOf(table), expected_names) << FTB::SortModeToString(mode);
+        for (const char* name : names) {
+            size_t pos = table.find(name, mode);
+            ASSERT_NE(pos, FTB::EntryTable::npos) << name;
+            EXPECT_EQ(table.name(pos), name);
+        }
+        EXPECT_EQ(table.find("missing", mode), FTB::EntryTable::npos);
+    }
+
+    table.sort(FTB::SortMode::NameAsc);
+    table.erase(table.find("zeta", FTB::SortMode::NameAsc));
+    size_t pos = table.appendPending("alpha2", DT_REG);
+    table.reposition(pos, FTB::SortMode::NameAsc);
+    EXPECT_EQ(namesOf(table),
+              (std::vector<std::string>{"gamma", ".hidden", "Alpha.md", "alpha2", "beta.txt", "delta.txt"}));
+}
+
+// 归并流式批次并在大量删除后压缩，位置语义保持不变
+TEST(EntryTableTest, MergeAndCompact) {
+    FTB::EntryTable table;
+    for (int i = 0; i < 600; i += 2) table.appendPending("f" + std::to_string(1000 + i), DT_REG);
+    table.sort(FTB::SortMode::NameAsc);
+
+    FTB::EntryTable chunk;
+    for (int i = 1; i < 600; i += 2) chunk.appendPending("f" + std::to_string(1000 + i), DT_REG);
+    table.mergeSorted(std::move(chunk), FTB::SortMode::NameAsc);
+    ASSERT_EQ(table.size(), 600u);
+    for (size_t i = 0; i < table.size(); ++i)
+        EXPECT_EQ(table.name(i), "f" + std::to_string(1000 + i));
+
+    for (int i = 0; i < 500; ++i) table.erase(0);
+    ASSERT_EQ(table.size(), 100u);
+    EXPECT_EQ(table.name(0), "f1500");
+    EXPECT_EQ(table.find("f1599", FTB::SortMode::NameAsc), 99u);
+    EXPECT_EQ(table.icon(0), FTB::IconText(FTB::InternIcon(table.icon(0))));
+}
+
+// 与 DirEntryInfo 互转（SFTP 条目没有原始 mode）
+TEST(EntryTableTest, RoundTripsDirEntryInfo) {
+    FileManager::DirEntryInfo info;
+    info.name = "remote.log";
+    info.is_regular = true;
+    info.exists = true;
+    info.file_size = 123;
+    info.mod_time = "2024-01-02 03:04";
+    info.icon = "X";
+    auto table = FTB::EntryTable::fromEntries({info});
+    auto back = table.entry(0);
+    EXPECT_EQ(back.name, info.name);
+    EXPECT_EQ(back.file_size, info.file_size);
+    EXPECT_EQ(back.mod_time, info.mod_time);
+    EXPECT_EQ(back.icon, info.icon);
+    EXPECT_TRUE(back.permissions.empty());
+    EXPECT_FALSE(back.stat_pending);
+}
+
+// 子树大小排序：目录与文件按大小混排，写入目录大小后 reposition 移到应处的位置
+TEST(EntryTableTest, TreeSizeOrderMixesDirectories) {
+    FTB::EntryTable table;
+    for (const char* name : {"big.iso", "small.txt"}) {
+        size_t pos = table.appendPending(name, DT_REG);
+        table.setStat(pos, S_IFREG | 0644, 0, name[0] == 'b' ? 5000 : 10, 0);
+    }
+    for (const char* name : {"photos", "src"}) {
+        size_t pos = table.appendPending(name, DT_DIR);
+        table.setStat(pos, S_IFDIR | 0755, 0, 4096, 0);
+    }
+    table.sort(FTB::SortMode::TreeSizeDesc);
+    EXPECT_EQ(namesOf(table), (std::vector<std::string>{"big.iso", "small.txt", "photos", "src"}));
+
+    size_t pos = table.find("photos", FTB::SortMode::TreeSizeDesc);
+    table.setTreeSize(pos, 90000);
+    EXPECT_EQ(table.reposition(pos, FTB::SortMode::TreeSizeDesc), 0u);
+    pos = table.find("src", FTB::SortMode::TreeSizeDesc);
+    table.setTreeSize(pos, 700);
+    EXPECT_EQ(table.reposition(pos, FTB::SortMode::TreeSizeDesc), 2u);
+    EXPECT_EQ(namesOf(table), (std::vector<std::string>{"photos", "big.iso", "src", "small.txt"}));
+    EXPECT_EQ(table.fileSize(0), 90000u);
+
+    table.sort(FTB::SortMode::TreeSizeAsc);
+    EXPECT_EQ(namesOf(table), (std::vector<std::string>{"small.txt", "src", "big.iso", "photos"}));
+    EXPECT_EQ(FTB::SortModeFromString(FTB::SortModeToString(FTB::SortMode::TreeSizeDesc)),
+              FTB::SortMode::TreeSizeDesc);
+}
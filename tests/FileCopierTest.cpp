@@ -0,0 +1,204 @@
+// FileCopierTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/FileCopier.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class FileCopierTest : public FTB::Test::TempDirFixture<> {
+protected:
+
+    static std::string readAll(const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        std::string data(static_cast<size_t>(fs::file_size(p)), '\0');
+        in.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return data;
+    }
+
+    // 跨越多个缓冲区的非周期内容
+    fs::path makeSource(size_t size) {
+        std::string data(size, '\0');
+        uint32_t x = 12345;
+        for (auto& c : data) {
+            x = x * 1103515245 + 12345;
+            c = static_cast<char>(x >> 24);
+        }
+        fs::path src = temp_dir / "src.bin";
+        std::ofstream(src, std::ios::binary) << data;
+        return src;
+    }
+};
+
+// 每种起始方式都得到相同的内容，进度回调累计的字节数等于文件大小
+TEST_F(FileCopierTest, EveryMethodCopiesContent) {
+    const size_t size = FTB::FileCopier::kBufferSize * 3 + 17;
+    auto src = makeSource(size);
+    const auto expected = readAll(src);
+
+    using Method = FTB::FileCopier::Method;
+    for (auto method : {Method::Reflink, Method::CopyFileRange, Method::Sendfile, Method::Buffered}) {
+        fs::path dst = temp_dir / (std::string("dst_") + FTB::FileCopier::methodName(method));
+        uintmax_t reported = 0;
+        auto result = FTB::FileCopier::copyFile(src.string(), dst.string(),
+            [&reported](uintmax_t bytes, bool) { reported += bytes; return true; }, method);
+        ASSERT_TRUE(result.ok) << FTB::FileCopier::methodName(method) << " errno " << result.error;
+        EXPECT_EQ(result.bytes, size);
+        EXPECT_EQ(reported, size);
+        EXPECT_EQ(readAll(dst), expected) << FTB::FileCopier::methodName(method);
+    }
+}
+
+// 目标已存在时被截断；权限位取自源文件
+TEST_F(FileCopierTest, TruncatesAndKeepsMode) {
+    auto src = makeSource(100);
+    ::chmod(src.c_str(), 0750);
+    fs::path dst = temp_dir / "dst";
+    std::ofstream(dst) << std::string(1000, 'x');
+
+    ASSERT_TRUE(FTB::FileCopier::copyFile(src.string(), dst.string()).ok);
+    EXPECT_EQ(fs::file_size(dst), 100u);
+
+    struct stat st;
+    fs::path fresh = temp_dir / "fresh";
+    ASSERT_TRUE(FTB::FileCopier::copyFile(src.string(), fresh.string()).ok);
+    ASSERT_EQ(::stat(fresh.c_str(), &st), 0);
+    EXPECT_EQ(st.st_mode & 0700, 0700u);
+}
+
+// 回调返回 false 时立即停止，结果标记为取消
+TEST_F(FileCopierTest, CallbackCancels) {
+    auto src = makeSource(FTB::FileCopier::kBufferSize * 4);
+    int calls = 0;
+    auto result = FTB::FileCopier::copyFile(src.string(), (temp_dir / "dst").string(),
+        [&calls](uintmax_t, bool) { return ++calls < 2; }, FTB::FileCopier::Method::Buffered);
+    EXPECT_FALSE(result.ok);
+    EXPECT_TRUE(result.cancelled);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(result.bytes, FTB::FileCopier::kBufferSize * 2);
+}
+
+// 空文件与不存在的源
+TEST_F(FileCopierTest, EmptyAndMissingSources) {
+    fs::path empty = temp_dir / "empty";
+    std::ofstream(empty).close();
+    auto result = FTB::FileCopier::copyFile(empty.string(), (temp_dir / "out").string());
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(fs::file_size(temp_dir / "out"), 0u);
+
+    result = FTB::FileCopier::copyFile((temp_dir / "missing").string(), (temp_dir / "out2").string());
+    EXPECT_FALSE(result.ok);
+    EXPECT_EQ(result.error, ENOENT);
+    EXPECT_FALSE(fs::exists(temp_dir / "out2"));
+}
+
+// 续传：保留目标的前 offset 字节，丢弃其后的内容并从该处继续；回调只报告新复制的部分
+TEST_F(FileCopierTest, ResumesAtOffset) {
+    const size_t size = FTB::FileCopier::kBufferSize * 2 + 5;
+    auto src = makeSource(size);
+    const auto expected = readAll(src);
+    fs::path dst = temp_dir / "dst";
+    std::ofstream(dst, std::ios::binary) << expected.substr(0, 1000) << std::string(70000, '#');
+
+    uintmax_t reported = 0;
+    auto result = FTB::FileCopier::copyFile(src.string(), dst.string(),
+        [&reported](uintmax_t bytes, bool) { reported += bytes; return true; },
+        FTB::FileCopier::Method::Reflink, FTB::FileCopier::kKernelChunk, 1000);
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.bytes, size);
+    EXPECT_EQ(reported, size - 1000);
+    EXPECT_EQ(readAll(dst), expected);
+}
+
+// 稀疏文件只复制数据区段：内容一致，目标保留空洞，回调按逻辑字节报告（含空洞）
+TEST_F(FileCopierTest, PreservesHoles) {
+    const uintmax_t size = 32u << 20;
+    fs::path src = temp_dir / "sparse.img";
+    {
+        std::ofstream out(src, std::ios::binary);
+        out.seekp(1 << 20);
+        out << std::string(4096, 'a');
+        out.seekp(20 << 20);
+        out << std::string(4096, 'b');
+    }
+    fs::resize_file(src, size);
+    struct stat st;
+    ASSERT_EQ(::stat(src.c_str(), &st), 0);
+    if (static_cast<uintmax_t>(st.st_blocks) * 512 >= size) GTEST_SKIP() << "filesystem has no holes";
+
+    using Method = FTB::FileCopier::Method;
+    for (auto method : {Method::CopyFileRange, Method::Buffered}) {
+        fs::path dst = temp_dir / (std::string("sparse_") + FTB::FileCopier::methodName(method));
+        uintmax_t data = 0, holes = 0;
+        auto result = FTB::FileCopier::copyFile(src.string(), dst.string(),
+            [&](uintmax_t bytes, bool hole) { (hole ? holes : data) += bytes; return true; }, method);
+        ASSERT_TRUE(result.ok) << FTB::FileCopier::methodName(method);
+        EXPECT_EQ(result.bytes, size);
+        EXPECT_EQ(data + holes, size);
+        EXPECT_EQ(result.holes, holes);
+        EXPECT_GT(holes, size / 2);
+        EXPECT_EQ(readAll(dst), readAll(src));
+
+        struct stat dst_st;
+        ASSERT_EQ(::stat(dst.c_str(), &dst_st), 0);
+        EXPECT_EQ(static_cast<uintmax_t>(dst_st.st_size), size);
+        EXPECT_LT(static_cast<uintmax_t>(dst_st.st_blocks) * 512, size / 4);
+    }
+}
+
+// 缓冲复制的块大小在 [kBufferSize, min(kMaxBufferSize, kernel_chunk)] 之间，内容不受档位变化影响
+TEST_F(FileCopierTest, BufferedChunkSizeStaysWithinLimits) {
+    const size_t size = (24u << 20) + 123;
+    auto src = makeSource(size);
+    const auto expected = readAll(src);
+
+    for (size_t limit : {FTB::FileCopier::kKernelChunk, size_t{128} << 10}) {
+        fs::path dst = temp_dir / ("dst_" + std::to_string(limit));
+        size_t smallest = SIZE_MAX, largest = 0;
+        uintmax_t reported = 0;
+        auto result = FTB::FileCopier::copyFile(src.string(), dst.string(),
+            [&](uintmax_t bytes, bool) {
+                reported += bytes;
+                if (reported < size) smallest = std::min(smallest, static_cast<size_t>(bytes));   // 最后一块可能不满
+                largest = std::max(largest, static_cast<size_t>(bytes));
+                return true;
+            },
+            FTB::FileCopier::Method::Buffered, limit);
+        ASSERT_TRUE(result.ok);
+        EXPECT_EQ(reported, size);
+        EXPECT_GE(smallest, FTB::FileCopier::kBufferSize);
+        EXPECT_LE(largest, std::min(FTB::FileCopier::kMaxBufferSize, limit));
+        EXPECT_EQ(readAll(dst), expected);
+    }
+}
+
+// 稠密文件复制前预分配目标：中途取消时已分配的块覆盖整个源长度，而文件长度只到已复制处
+TEST_F(FileCopierTest, PreallocatesDestination) {
+    const size_t size = 8u << 20;
+    auto src = makeSource(size);
+    {
+        // 文件系统不支持 fallocate 时跳过
+        int fd = ::open((temp_dir / "probe").c_str(), O_WRONLY | O_CREAT, 0600);
+        ASSERT_GE(fd, 0);
+        bool supported = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, 4096) == 0;
+        ::close(fd);
+        if (!supported) GTEST_SKIP() << "fallocate not supported";
+    }
+
+    fs::path dst = temp_dir / "dst";
+    auto result = FTB::FileCopier::copyFile(src.string(), dst.string(),
+        [](uintmax_t, bool) { return false; }, FTB::FileCopier::Method::Buffered);
+    EXPECT_TRUE(result.cancelled);
+    struct stat st;
+    ASSERT_EQ(::stat(dst.c_str(), &st), 0);
+    EXPECT_EQ(static_cast<uintmax_t>(st.st_size), result.bytes);
+    EXPECT_LT(result.bytes, size);
+    EXPECT_GE(static_cast<uintmax_t>(st.st_blocks) * 512, size);
+}
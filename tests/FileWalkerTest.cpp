@@ -0,0 +1,132 @@
+// FileWalkerTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/FileWalker.hpp"
+#include "browser/GitIgnore.hpp"
+#include "core/FuzzyFinder.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using FTB::FileWalker;
+using FTB::GitIgnore;
+
+class FileWalkerTest : public FTB::Test::TempDirFixture<> {
+protected:
+
+    static void writeFile(const fs::path& p, const std::string& content = "x") {
+        fs::create_directories(p.parent_path());
+        std::ofstream(p, std::ios::binary) << content;
+    }
+
+    static std::set<std::string> walk(const fs::path& root, FileWalker::Options options) {
+        std::mutex mutex;
+        std::set<std::string> seen;
+        FileWalker::walk(root.string(), options, [&](const FileWalker::Entry& e) {
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.insert(std::string(e.path) + (e.is_dir ? "/" : ""));
+        });
+        return seen;
+    }
+};
+
+TEST_F(FileWalkerTest, GlobMatchFollowsGitignoreRules) {
+    EXPECT_TRUE(GitIgnore::globMatch("*.o", "main.o"));
+    EXPECT_FALSE(GitIgnore::globMatch("*.o", "src/main.o"));
+    EXPECT_TRUE(GitIgnore::globMatch("**/gen", "a/b/gen"));
+    EXPECT_TRUE(GitIgnore::globMatch("**/gen", "gen"));
+    EXPECT_TRUE(GitIgnore::globMatch("docs/**/*.md", "docs/a/b/x.md"));
+    EXPECT_TRUE(GitIgnore::globMatch("docs/**/*.md", "docs/x.md"));
+    EXPECT_TRUE(GitIgnore::globMatch("out/**", "out/a/b"));
+    EXPECT_TRUE(GitIgnore::globMatch("file[0-9].?xt", "file7.txt"));
+    EXPECT_FALSE(GitIgnore::globMatch("file[!0-9].txt", "file7.txt"));
+    EXPECT_TRUE(GitIgnore::globMatch("\\*.txt", "*.txt"));
+    EXPECT_FALSE(GitIgnore::globMatch("\\*.txt", "a.txt"));
+}
+
+// 跳过隐藏条目与指定目录，遵循各层 .gitignore（含取反与只匹配目录的规则）
+TEST_F(FileWalkerTest, HonorsSkipDirsHiddenAndGitignore) {
+    writeFile(temp_dir / ".git" / "HEAD");
+    writeFile(temp_dir / ".gitignore", "*.log\n/out/\ncache/\n!keep.log\n");
+    writeFile(temp_dir / "src" / "main.cpp");
+    writeFile(temp_dir / "src" / "debug.log");
+    writeFile(temp_dir / "src" / "keep.log");
+    writeFile(temp_dir / "src" / ".gitignore", "gen_*\n");
+    writeFile(temp_dir / "src" / "gen_table.cpp");
+    writeFile(temp_dir / "src" / "cache" / "blob");
+    writeFile(temp_dir / "src" / "out" / "kept.txt");   // /out/ 只锚定在根目录
+    writeFile(temp_dir / "out" / "bin");
+    writeFile(temp_dir / "node_modules" / "pkg" / "index.js");
+    writeFile(temp_dir / ".hidden" / "secret");
+    writeFile(temp_dir / "cache");                       // cache/ 只匹配目录
+
+    const std::unordered_set<std::string> skip = {"node_modules"};
+    FileWalker::Options options;
+    options.threads = 3;
+    options.skip_dirs = &skip;
+    auto seen = walk(temp_dir, options);
+    EXPECT_EQ(seen, (std::set<std::string>{"src/", "src/main.cpp", "src/keep.log", "src/out/",
+                                           "src/out/kept.txt", "cache"}));
+
+    // 从子目录开始遍历时仍遵循仓库根的 .gitignore
+    seen = walk(temp_dir / "src", options);
+    EXPECT_EQ(seen, (std::set<std::string>{"main.cpp", "keep.log", "out/", "out/kept.txt"}));
+
+    options.honor_gitignore = false;
+    options.include_hidden = true;
+    seen = walk(temp_dir / "src", options);
+    EXPECT_TRUE(seen.count("debug.log"));
+    EXPECT_TRUE(seen.count("gen_table.cpp"));
+    EXPECT_TRUE(seen.count(".gitignore"));
+}
+
+TEST_F(FileWalkerTest, LimitsDepthAndCancels) {
+    writeFile(temp_dir / "a" / "b" / "c" / "deep.txt");
+    writeFile(temp_dir / "top.txt");
+
+    FileWalker::Options options;
+    options.max_depth = 2;
+    auto seen = walk(temp_dir, options);
+    EXPECT_EQ(seen, (std::set<std::string>{"a/", "a/b/", "top.txt"}));
+
+    std::atomic<bool> cancel{true};
+    options.cancel = &cancel;
+    EXPECT_FALSE(FileWalker::walk(temp_dir.string(), options, [](const FileWalker::Entry&) {}));
+}
+
+// 搜索结果分批交出，合并后与一次性搜索一致；目录本身不作为结果
+TEST_F(FileWalkerTest, SearchStreamsFuzzyMatches) {
+    for (int d = 0; d < 20; ++d) {
+        for (int f = 0; f < 30; ++f) {
+            writeFile(temp_dir / ("dir" + std::to_string(d)) / ("report_" + std::to_string(f) + ".txt"));
+            writeFile(temp_dir / ("dir" + std::to_string(d)) / ("other_" + std::to_string(f) + ".bin"));
+        }
+    }
+    writeFile(temp_dir / "build" / "report_x.txt");   // 构建目录被跳过
+
+    std::mutex mutex;
+    size_t batches = 0;
+    std::vector<std::string> streamed;
+    SearchEngine::Stream("RPTtxt", temp_dir.string(), [&](std::vector<FdResult>&& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++batches;
+        for (auto& r : batch) streamed.push_back(std::move(r.path));
+    });
+    EXPECT_EQ(streamed.size(), 600u);
+    EXPECT_GE(batches, 2u);   // 首个结果单独交出
+
+    auto all = SearchEngine::Search("RPTtxt", temp_dir.string());
+    std::vector<std::string> collected;
+    for (auto& r : all) collected.push_back(r.path);
+    std::sort(streamed.begin(), streamed.end());
+    std::sort(collected.begin(), collected.end());
+    EXPECT_EQ(streamed, collected);
+    EXPECT_TRUE(SearchEngine::Search("", temp_dir.string()).empty());
+}
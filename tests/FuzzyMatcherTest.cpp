@@ -0,0 +1,135 @@
+// FuzzyMatcherTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "core/FuzzyMatcher.hpp"
+#include "core/FuzzyFinder.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool NaiveSubsequence(const std::string& query, const std::string& text) {
+    size_t qi = 0;
+    for (size_t i = 0; i < text.size() && qi < query.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[i])) ==
+            std::tolower(static_cast<unsigned char>(query[qi])))
+            ++qi;
+    }
+    return qi == query.size();
+}
+
+}  // namespace
+
+// SIMD 预筛与逐字符比较的结果一致（跨 16 字节块、大小写、'@' 与 '`' 这类只差 0x20 的非字母）
+TEST(FuzzyMatcherTest, PrefilterAgreesWithNaiveSubsequence) {
+    static const char kAlphabet[] = "abcXYZ019/_.-@`[{ ";
+    std::mt19937 rng(42);
+    auto random_string = [&](size_t len) {
+        std::string s;
+        for (size_t i = 0; i < len; ++i) s += kAlphabet[rng() % (sizeof(kAlphabet) - 1)];
+        return s;
+    };
+    for (int round = 0; round < 5000; ++round) {
+        std::string text = random_string(rng() % 70);
+        std::string query = random_string(1 + rng() % 5);
+        FuzzyPattern pattern(query);
+        const bool expected = NaiveSubsequence(query, text);
+        ASSERT_EQ(pattern.matches(text), expected) << query << " in " << text;
+        ASSERT_EQ(pattern.score(text) != FuzzyPattern::kNoMatch, expected) << query << " in " << text;
+        ASSERT_EQ(FuzzyMatch(query, text), expected);
+    }
+    EXPECT_FALSE(FuzzyMatch("@", std::string(40, '`')));
+    EXPECT_TRUE(FuzzyMatch("Q", std::string(40, 'x') + "q"));
+}
+
+// 边界、路径分隔符、camelCase 与连续匹配得分更高
+TEST(FuzzyMatcherTest, ScoresBoundariesAndRuns) {
+    auto score = [](const char* query, const char* text) { return FuzzyPattern(query).score(text); };
+
+    EXPECT_GT(score("main", "src/main.cpp"), score("main", "src/m_a_i_n.cpp"));
+    EXPECT_GT(score("fm", "src/FileManager.cpp"), score("fm", "src/firmware.cpp"));
+    EXPECT_GT(score("fb", "foo/bar"), score("fb", "fxxbxx"));
+    EXPECT_GT(score("rd", "src/README.md"), score("rd", "src/order.txt"));
+    EXPECT_GT(score("cfg", "config/cfg.json"), score("cfg", "config/config.json"));
+
+    // 窗口内取最优对齐，而不是最早的贪心对齐
+    EXPECT_GT(score("ab", "a_____b_ab"), score("ab", "a_____b"));
+
+    EXPECT_EQ(score("xyz", "abc"), FuzzyPattern::kNoMatch);
+    EXPECT_EQ(score("abcd", "abc"), FuzzyPattern::kNoMatch);
+    EXPECT_EQ(score("", "abc"), 0);
+    EXPECT_GE(score("a", "a"), FuzzyPattern::kScoreMatch);
+}
+
+TEST(FuzzyMatcherTest, TopKKeepsBestCandidates) {
+    FuzzyTopK top(3);
+    EXPECT_EQ(top.threshold(), FuzzyPattern::kNoMatch);
+    EXPECT_TRUE(top.offer(10, "ten"));
+    EXPECT_TRUE(top.offer(50, "fifty"));
+    EXPECT_TRUE(top.offer(30, "thirty"));
+    EXPECT_TRUE(top.full());
+    EXPECT_EQ(top.threshold(), 10);
+    EXPECT_FALSE(top.offer(5, "five"));
+    EXPECT_TRUE(top.offer(40, "forty"));
+    EXPECT_EQ(top.threshold(), 30);
+    // 同分时较短的路径优先
+    EXPECT_TRUE(top.offer(30, "x30"));
+    EXPECT_FALSE(top.offer(30, "longer30"));
+
+    auto sorted = top.sorted();
+    ASSERT_EQ(sorted.size(), 3u);
+    EXPECT_EQ(sorted[0].text, "fifty");
+    EXPECT_EQ(sorted[1].text, "forty");
+    EXPECT_EQ(sorted[2].text, "x30");
+
+    FuzzyTopK none(0);
+    EXPECT_FALSE(none.offer(100, "x"));
+}
+
+// Rank 的最终快照与 Search 排序后的前 limit 个结果一致
+TEST(FuzzyMatcherTest, RankReturnsBestMatchesOfSearch) {
+    fs::path dir = FTB::Test::MakeTempDir("fuzzymatcher");
+    for (int d = 0; d < 10; ++d) {
+        for (int f = 0; f < 20; ++f) {
+            fs::path p = dir / ("pkg" + std::to_string(d)) / ("widget_" + std::to_string(f) + ".cpp");
+            fs::create_directories(p.parent_path());
+            std::ofstream(p) << "x";
+        }
+    }
+    fs::create_directories(dir / "src");
+    std::ofstream(dir / "src" / "Widget.cpp") << "x";
+
+    auto all = SearchEngine::Search("widget", dir.string());
+    ASSERT_EQ(all.size(), 201u);
+    EXPECT_EQ(all.front().path, "src/Widget.cpp");
+    for (size_t i = 1; i < all.size(); ++i) EXPECT_GE(all[i - 1].score, all[i].score);
+
+    std::mutex mutex;
+    std::vector<FdResult> last;
+    size_t matched = 0;
+    size_t snapshots = 0;
+    SearchEngine::Rank("widget", dir.string(), 5, [&](std::vector<FdResult>&& top, size_t m) {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_LE(top.size(), 5u);
+        last = std::move(top);
+        matched = m;
+        ++snapshots;
+    });
+    EXPECT_GE(snapshots, 1u);
+    EXPECT_EQ(matched, 201u);
+    ASSERT_EQ(last.size(), 5u);
+    for (size_t i = 0; i < last.size(); ++i) {
+        EXPECT_EQ(last[i].path, all[i].path);
+        EXPECT_EQ(last[i].score, all[i].score);
+    }
+    fs::remove_all(dir);
+}
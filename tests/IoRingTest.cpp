@@ -0,0 +1,112 @@
+// IoRingTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/IoRing.hpp"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using FTB::IoRing;
+
+// 参数：是否尝试使用 io_uring（false 为同步模式）
+class IoRingTest : public FTB::Test::TempDirFixture<::testing::TestWithParam<bool>> {
+protected:
+
+    static std::map<uint64_t, int> byUserData(const std::vector<IoRing::Completion>& done) {
+        std::map<uint64_t, int> out;
+        for (const auto& c : done) out[c.user_data] = c.result;
+        return out;
+    }
+};
+
+TEST_P(IoRingTest, ModeFollowsAvailability) {
+    IoRing ring(8, GetParam());
+    EXPECT_EQ(ring.active(), GetParam() && IoRing::available());
+    if (!ring.active()) {
+        EXPECT_FALSE(ring.supports(IoRing::Op::Read));
+    }
+}
+
+// open → write → read → close → statx → unlink 的完整往返
+TEST_P(IoRingTest, RoundTripsEveryOperation) {
+    IoRing ring(8, GetParam());
+    std::vector<IoRing::Completion> done;
+    const std::string path = (temp_dir / "file").string();
+
+    ring.push(IoRing::openAt(IoRing::kCwd, path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0640, 1));
+    ASSERT_EQ(ring.drain(done), 1u);
+    int fd = done[0].result;
+    ASSERT_GE(fd, 0);
+
+    const std::string payload = "hello io_uring";
+    ring.push(IoRing::write(fd, payload.data(), static_cast<unsigned>(payload.size()), 0, 2));
+    done.clear();
+    ring.drain(done);
+    EXPECT_EQ(byUserData(done)[2], static_cast<int>(payload.size()));
+
+    std::string back(payload.size(), '\0');
+    ring.push(IoRing::read(fd, back.data(), static_cast<unsigned>(back.size()), 0, 3));
+    done.clear();
+    ring.drain(done);
+    EXPECT_EQ(byUserData(done)[3], static_cast<int>(payload.size()));
+    EXPECT_EQ(back, payload);
+
+    struct statx stx;
+    ring.push(IoRing::close(fd, 4));
+    ring.push(IoRing::statx(IoRing::kCwd, path.c_str(), 0, STATX_SIZE | STATX_MODE, &stx, 5));
+    done.clear();
+    ring.drain(done);
+    auto results = byUserData(done);
+    EXPECT_EQ(results[4], 0);
+    EXPECT_EQ(results[5], 0);
+    EXPECT_EQ(stx.stx_size, payload.size());
+    EXPECT_EQ(stx.stx_mode & 0777u, 0640u);
+
+    ring.push(IoRing::unlinkAt(IoRing::kCwd, path.c_str(), 0, 6));
+    ring.push(IoRing::unlinkAt(IoRing::kCwd, path.c_str(), 0, 7));
+    done.clear();
+    ring.drain(done);
+    results = byUserData(done);
+    // 两次删除同一文件：一次成功、一次 ENOENT（顺序不保证）
+    EXPECT_EQ(std::min(results[6], results[7]), -ENOENT);
+    EXPECT_EQ(std::max(results[6], results[7]), 0);
+    EXPECT_FALSE(fs::exists(path));
+}
+
+// 请求数远超队列深度时自动分批提交，每个请求恰好完成一次
+TEST_P(IoRingTest, OverflowsQueueDepth) {
+    constexpr int kFiles = 300;
+    std::vector<std::string> paths;
+    for (int i = 0; i < kFiles; ++i) {
+        paths.push_back((temp_dir / ("f" + std::to_string(i))).string());
+        std::ofstream(paths.back()) << std::string(static_cast<size_t>(i), 'x');
+    }
+
+    IoRing ring(4, GetParam());
+    std::vector<struct statx> stats(kFiles);
+    std::vector<IoRing::Completion> done;
+    for (int i = 0; i < kFiles; ++i) {
+        ring.push(IoRing::statx(IoRing::kCwd, paths[i].c_str(), 0, STATX_SIZE, &stats[i], i));
+        if (i % 50 == 0) ring.wait(done, 0);
+    }
+    ring.drain(done);
+    EXPECT_EQ(ring.pending(), 0u);
+    ASSERT_EQ(done.size(), static_cast<size_t>(kFiles));
+    auto results = byUserData(done);
+    ASSERT_EQ(results.size(), static_cast<size_t>(kFiles));
+    for (int i = 0; i < kFiles; ++i) {
+        EXPECT_EQ(results[i], 0);
+        EXPECT_EQ(stats[i].stx_size, static_cast<uint64_t>(i));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, IoRingTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                             return info.param ? "Ring" : "Sync";
+                         });
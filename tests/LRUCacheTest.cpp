@@ -0,0 +1,109 @@
+// LRUCacheTest.cpp
+#include "gtest/gtest.h"
+#include "utils/LRUCache.hpp"
+#include <string>
+#include <vector>
+
+// 命中返回同一份快照，不拷贝值
+TEST(SharedLRUCacheTest, HitsShareSnapshot) {
+    FTB::SharedLRUCache<std::string, std::vector<int>> cache(4);
+    cache.put("a", std::vector<int>(1000, 7));
+
+    auto first = cache.get("a");
+    auto second = cache.get("a");
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(first->size(), 1000u);
+    EXPECT_FALSE(cache.get("missing"));
+}
+
+// 持有的快照在条目被替换或删除后仍然有效
+TEST(SharedLRUCacheTest, SnapshotOutlivesReplacement) {
+    FTB::SharedLRUCache<std::string, std::string> cache(4);
+    cache.put("k", std::string("old"));
+    auto held = cache.get("k");
+
+    cache.put("k", std::string("new"));
+    EXPECT_EQ(*held, "old");
+    EXPECT_EQ(*cache.get("k"), "new");
+
+    cache.erase("k");
+    EXPECT_EQ(*held, "old");
+    EXPECT_FALSE(cache.contains("k"));
+}
+
+// 命中过的项在驱逐时得到第二次机会
+TEST(LRUCacheTest, GetProtectsFromEviction) {
+    FTB::LRUCache<std::string, int> cache(3);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.put("c", 3);
+    ASSERT_TRUE(cache.get("a").has_value());
+
+    cache.put("d", 4);
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+    EXPECT_TRUE(cache.contains("d"));
+}
+
+// 字节预算限制总占用，超过预算的单项不缓存
+TEST(LRUCacheTest, ByteBudgetEvicts) {
+    FTB::LRUCache<std::string, std::string> cache(16);
+    cache.set_max_bytes(4096);
+    for (int i = 0; i < 5; ++i) {
+        cache.put("k" + std::to_string(i), std::string(1500, 'x'));
+    }
+    auto stats = cache.get_stats();
+    EXPECT_LE(stats.bytes, 4096u);
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.evictions, 3u);
+    EXPECT_TRUE(cache.contains("k4"));
+
+    cache.put("huge", std::string(8192, 'x'));
+    EXPECT_FALSE(cache.contains("huge"));
+}
+
+// 命中、未命中与驱逐按分片统计
+TEST(LRUCacheTest, PerShardCounters) {
+    FTB::LRUCache<std::string, int> cache(1000);
+    for (int i = 0; i < 100; ++i) cache.put(std::to_string(i), i);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(cache.get(std::to_string(i)).value_or(-1), i);
+    EXPECT_FALSE(cache.get("missing").has_value());
+
+    auto stats = cache.get_stats();
+    EXPECT_GT(stats.shards.size(), 1u);
+    size_t hits = 0, misses = 0, size = 0;
+    for (const auto& shard : stats.shards) {
+        hits += shard.hits;
+        misses += shard.misses;
+        size += shard.size;
+    }
+    EXPECT_EQ(hits, 100u);
+    EXPECT_EQ(misses, 1u);
+    EXPECT_EQ(size, 100u);
+    EXPECT_EQ(stats.hits, hits);
+}
+
+// 准入过滤下，一次性扫描不会挤掉反复访问的项
+TEST(LRUCacheTest, AdmissionFilterResistsScans) {
+    FTB::LRUCache<std::string, int> cache(20);
+    cache.set_admission_filter(true);
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            auto key = "hot" + std::to_string(i);
+            if (!cache.get(key)) cache.put(key, i);
+        }
+    }
+    for (int i = 0; i < 200; ++i) {
+        auto key = "scan" + std::to_string(i);
+        if (!cache.get(key)) cache.put(key, i);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(cache.contains("hot" + std::to_string(i))) << i;
+    }
+    auto stats = cache.get_stats();
+    EXPECT_LE(stats.size, 20u);
+    EXPECT_GT(stats.rejections, 0u);
+}
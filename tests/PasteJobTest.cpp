@@ -0,0 +1,198 @@
+// PasteJobTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/PasteJob.hpp"
+#include "utils/FilesystemUtil.hpp"
+#include <sys/stat.h>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+class PasteJobTest : public FTB::Test::TempDirFixture<> {
+protected:
+    fs::path src;
+    fs::path dst;
+    Progress progress;
+    std::atomic<bool> cancel{false};
+    std::atomic<bool> pause{false};
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        src = temp_dir / "src";
+        dst = temp_dir / "dst";
+        fs::create_directories(src);
+        fs::create_directories(dst);
+    }
+
+    static void write(const fs::path& p, const std::string& content) {
+        fs::create_directories(p.parent_path());
+        std::ofstream(p, std::ios::binary) << content;
+    }
+
+    static std::string read(const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    static ino_t inode(const fs::path& p) {
+        struct stat st{};
+        return ::lstat(p.c_str(), &st) == 0 ? st.st_ino : 0;
+    }
+};
+
+// 目标已存在时不覆盖，返回 EEXIST；replace 时覆盖
+TEST_F(PasteJobTest, RenameNoReplaceRefusesExistingTarget) {
+    write(src / "a.txt", "new");
+    write(dst / "a.txt", "old");
+
+    EXPECT_EQ(FTB::renameNoReplace(src / "a.txt", dst / "a.txt"), EEXIST);
+    EXPECT_EQ(read(src / "a.txt"), "new");
+    EXPECT_EQ(read(dst / "a.txt"), "old");
+
+    EXPECT_EQ(FTB::renameNoReplace(src / "a.txt", dst / "a.txt", true), 0);
+    EXPECT_FALSE(fs::exists(src / "a.txt"));
+    EXPECT_EQ(read(dst / "a.txt"), "new");
+
+    EXPECT_EQ(FTB::renameNoReplace(src / "missing", dst / "missing"), ENOENT);
+}
+
+// 同一设备的剪切直接改名：inode 不变，不计字节
+TEST_F(PasteJobTest, SameDeviceMoveRenamesWithoutCopying) {
+    write(src / "file.txt", "payload");
+    write(src / "tree" / "inner" / "f.txt", "inner");
+    const ino_t file_ino = inode(src / "file.txt");
+    const ino_t tree_ino = inode(src / "tree");
+
+    auto plan = FTB::PasteJob::collect({(src / "file.txt").string(), (src / "tree").string()}, dst,
+                                       false, true);
+    ASSERT_EQ(plan.entries.size(), 2u);
+    EXPECT_TRUE(plan.entries[0].rename);
+    EXPECT_TRUE(plan.entries[1].rename);
+    EXPECT_EQ(plan.total_files, 2);
+    EXPECT_EQ(plan.total_bytes, 0u);
+
+    FTB::PasteJob::Options options;
+    options.cut = true;
+    ASSERT_TRUE(FTB::PasteJob::run(plan.entries, options, progress, cancel, pause));
+
+    EXPECT_EQ(inode(dst / "file.txt"), file_ino);
+    EXPECT_EQ(inode(dst / "tree"), tree_ino);
+    EXPECT_EQ(read(dst / "tree" / "inner" / "f.txt"), "inner");
+    EXPECT_FALSE(fs::exists(src / "file.txt"));
+    EXPECT_FALSE(fs::exists(src / "tree"));
+    EXPECT_TRUE(plan.entries[0].moved);
+    EXPECT_TRUE(plan.entries[1].moved);
+    EXPECT_EQ(progress.files_processed.load(), 2);
+    EXPECT_EQ(progress.bytes_processed.load(), 0u);
+}
+
+// 改名返回 EXDEV 时退回复制后删除，并补上字节统计
+TEST_F(PasteJobTest, CrossDeviceMoveFallsBackToCopyAndDelete) {
+    write(src / "file.txt", "payload");
+    write(src / "tree" / "inner" / "f.txt", "inner");
+
+    auto plan = FTB::PasteJob::collect({(src / "file.txt").string(), (src / "tree").string()}, dst,
+                                       false, true);
+    ASSERT_EQ(plan.entries.size(), 2u);
+
+    int rename_calls = 0;
+    FTB::PasteJob::Options options;
+    options.cut = true;
+    options.rename = [&](const fs::path&, const fs::path&, bool) {
+        ++rename_calls;
+        return EXDEV;
+    };
+    progress.total_files = plan.total_files;
+    progress.total_bytes = plan.total_bytes;
+    ASSERT_TRUE(FTB::PasteJob::run(plan.entries, options, progress, cancel, pause));
+
+    EXPECT_EQ(rename_calls, 2);
+    EXPECT_EQ(read(dst / "file.txt"), "payload");
+    EXPECT_EQ(read(dst / "tree" / "inner" / "f.txt"), "inner");
+    EXPECT_FALSE(fs::exists(src / "file.txt"));
+    EXPECT_FALSE(fs::exists(src / "tree"));
+    EXPECT_TRUE(plan.entries[0].moved);
+    EXPECT_TRUE(plan.entries[1].moved);
+    EXPECT_EQ(progress.total_bytes.load(), 7u + 5u);
+    EXPECT_EQ(progress.bytes_processed.load(), 7u + 5u);
+}
+
+// 失败清理只删除复制出来的目标；已移走的条目目标是唯一副本，保留
+TEST_F(PasteJobTest, CleanupSkipsMovedEntries) {
+    write(src / "copied.txt", "copy");
+    write(dst / "copied.txt", "copy");
+    write(dst / "moved.txt", "only copy");
+
+    std::vector<FTB::PasteJob::Entry> entries;
+    entries.push_back({src / "copied.txt", dst / "copied.txt", false, false});
+    entries.push_back({src / "moved.txt", dst / "moved.txt", true, true});
+    FTB::PasteJob::cleanup(entries);
+
+    EXPECT_FALSE(fs::exists(dst / "copied.txt"));
+    EXPECT_TRUE(fs::exists(src / "copied.txt"));
+    EXPECT_EQ(read(dst / "moved.txt"), "only copy");
+}
+
+// 取消后已完成的条目保留 moved 标记，清理不会删掉它们
+TEST_F(PasteJobTest, CancelledMoveKeepsCompletedEntries) {
+    write(src / "first.txt", "1");
+    write(src / "second.txt", "2");
+    auto plan = FTB::PasteJob::collect({(src / "first.txt").string(), (src / "second.txt").string()}, dst,
+                                       false, true);
+    ASSERT_EQ(plan.entries.size(), 2u);
+
+    FTB::PasteJob::Options options;
+    options.cut = true;
+    options.rename = [&](const fs::path& from, const fs::path& to, bool replace) {
+        int err = FTB::renameNoReplace(from, to, replace);
+        cancel = true;
+        return err;
+    };
+    EXPECT_FALSE(FTB::PasteJob::run(plan.entries, options, progress, cancel, pause));
+    EXPECT_TRUE(plan.entries[0].moved);
+    EXPECT_FALSE(plan.entries[1].moved);
+
+    FTB::PasteJob::cleanup(plan.entries);
+    EXPECT_EQ(read(dst / "first.txt"), "1");
+    EXPECT_EQ(read(src / "second.txt"), "2");
+}
+
+// collect() 之后目标位置出现同名文件：改名为不冲突的名称，不覆盖也不删除它
+TEST_F(PasteJobTest, MoveDoesNotClobberTargetCreatedAfterCollect) {
+    write(src / "file.txt", "moved");
+    auto plan = FTB::PasteJob::collect({(src / "file.txt").string()}, dst, false, true);
+    ASSERT_EQ(plan.entries.size(), 1u);
+    ASSERT_TRUE(plan.entries[0].rename);
+    write(dst / "file.txt", "other");
+
+    FTB::PasteJob::Options options;
+    options.cut = true;
+    ASSERT_TRUE(FTB::PasteJob::run(plan.entries, options, progress, cancel, pause));
+
+    EXPECT_EQ(read(dst / "file.txt"), "other");
+    EXPECT_EQ(plan.entries[0].dst, dst / "file (1).txt");
+    EXPECT_EQ(read(dst / "file (1).txt"), "moved");
+    EXPECT_FALSE(fs::exists(src / "file.txt"));
+}
+
+// 改名遇到 EXDEV 以外的错误时整条失败，不退回复制，清理也不会删除已存在的目标
+TEST_F(PasteJobTest, RenameErrorFailsWithoutCopying) {
+    write(src / "file.txt", "moved");
+    auto plan = FTB::PasteJob::collect({(src / "file.txt").string()}, dst, false, true);
+    ASSERT_EQ(plan.entries.size(), 1u);
+    write(dst / "file.txt", "other");
+
+    FTB::PasteJob::Options options;
+    options.cut = true;
+    options.rename = [](const fs::path&, const fs::path&, bool) { return EACCES; };
+    EXPECT_FALSE(FTB::PasteJob::run(plan.entries, options, progress, cancel, pause));
+    FTB::PasteJob::cleanup(plan.entries);
+
+    EXPECT_EQ(read(dst / "file.txt"), "other");
+    EXPECT_EQ(read(src / "file.txt"), "moved");
+    EXPECT_FALSE(plan.entries[0].moved);
+}
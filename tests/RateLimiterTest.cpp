@@ -0,0 +1,151 @@
+// RateLimiterTest.cpp
+#include "gtest/gtest.h"
+#include "browser/RateLimiter.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using FTB::RateLimiter;
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 不限速时立即放行，仅反映取消标志
+TEST(RateLimiterTest, UnlimitedPassesThrough) {
+    RateLimiter limiter;
+    std::atomic<bool> cancel{false};
+    int flow = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < 1000; ++i) EXPECT_TRUE(limiter.acquire(&flow, 1u << 30, cancel));
+    EXPECT_LT(secondsSince(start), 0.5);
+    cancel = true;
+    EXPECT_FALSE(limiter.acquire(&flow, 1, cancel));
+    EXPECT_EQ(limiter.chunkHint(8u << 20), 8u << 20);
+}
+
+// 手动推进的时钟：令牌只随测试推进的时间补充，结果与调度和机器负载无关
+class ManualClock {
+public:
+    RateLimiter::Clock::time_point now() const {
+        return RateLimiter::Clock::time_point(std::chrono::nanoseconds(ns_.load()));
+    }
+    void advance(double seconds) { ns_ += static_cast<int64_t>(seconds * 1e9); }
+    RateLimiter::NowFn fn() {
+        return [this] { return now(); };
+    }
+
+private:
+    std::atomic<int64_t> ns_{1000000000};
+};
+
+// 等待 pred 成立，最多 5 秒
+template <typename Pred>
+static bool waitFor(Pred pred) {
+    auto start = Clock::now();
+    while (!pred()) {
+        if (secondsSince(start) > 5.0) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 突发额度之后余额转负，请求等到补充的令牌使余额回正才放行
+TEST(RateLimiterTest, SmoothsToRate) {
+    ManualClock clock;
+    RateLimiter limiter(clock.fn());
+    const uintmax_t rate = 8u << 20;
+    limiter.setRate(rate);
+    EXPECT_EQ(limiter.chunkHint(8u << 20), rate / 10);
+
+    std::atomic<bool> cancel{false};
+    int flow = 0;
+    const uintmax_t chunk = 256u << 10;
+    const auto burst = static_cast<uintmax_t>(rate * RateLimiter::kBurstSeconds);
+    // 时钟不动：余额非负时放行，最后一次把余额扣到 -chunk
+    for (uintmax_t done = 0; done <= burst; done += chunk) ASSERT_TRUE(limiter.acquire(&flow, chunk, cancel));
+
+    std::atomic<bool> granted{false};
+    std::thread waiter([&] { granted = limiter.acquire(&flow, chunk, cancel); });
+    ASSERT_TRUE(waitFor([&] { return limiter.waiting() == 1; }));
+
+    // 欠额需要 chunk / rate 秒补足；差 1 ms 时仍在等待
+    const double deficit = static_cast<double>(chunk) / static_cast<double>(rate);
+    clock.advance(deficit - 0.001);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(granted.load());
+    EXPECT_EQ(limiter.waiting(), 1u);
+
+    clock.advance(0.002);
+    waiter.join();
+    EXPECT_TRUE(granted.load());
+    EXPECT_EQ(limiter.waiting(), 0u);
+}
+
+// 块大小与线程数不同的两个任务按字节平分带宽
+TEST(RateLimiterTest, SharesFairlyBetweenFlows) {
+    ManualClock clock;
+    RateLimiter limiter(clock.fn());
+    const uintmax_t rate = 1u << 30;
+    limiter.setRate(rate);
+    std::atomic<bool> cancel{false};
+    std::atomic<uintmax_t> big_bytes{0}, small_bytes{0};
+    int big_flow = 0, small_flow = 0, warm_flow = 0;
+
+    // 用掉突发额度并欠 1 字节，之后每个请求都要等测试推进时钟
+    const auto burst = static_cast<uintmax_t>(rate * RateLimiter::kBurstSeconds);
+    ASSERT_TRUE(limiter.acquire(&warm_flow, burst + 1, cancel));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.emplace_back([&] {
+            while (limiter.acquire(&big_flow, 1u << 20, cancel)) big_bytes += 1u << 20;
+        });
+    }
+    threads.emplace_back([&] {
+        while (limiter.acquire(&small_flow, 64u << 10, cancel)) small_bytes += 64u << 10;
+    });
+
+    // 每步只补足上一个放行请求的欠额（另加几字节抵消时钟取整），
+    // 并等所有线程重新排队：每步恰好按虚拟时间放行队首一个请求
+    uintmax_t owed = 1;
+    for (int i = 0; i < 512; ++i) {
+        ASSERT_TRUE(waitFor([&] { return limiter.waiting() == 4; }));
+        uintmax_t before = big_bytes + small_bytes;
+        clock.advance(static_cast<double>(owed + 4) / static_cast<double>(rate));
+        ASSERT_TRUE(waitFor([&] { return big_bytes + small_bytes != before; }));
+        owed = big_bytes + small_bytes - before;
+    }
+    cancel = true;
+    for (auto& t : threads) t.join();
+    uintmax_t big = big_bytes, small = small_bytes;
+
+    double ratio = static_cast<double>(big) / static_cast<double>(small);
+    EXPECT_GT(ratio, 0.8) << big << " vs " << small;
+    EXPECT_LT(ratio, 1.25) << big << " vs " << small;
+}
+
+// 等待中的请求在取消后尽快返回 false
+TEST(RateLimiterTest, CancelWakesWaiter) {
+    RateLimiter limiter;
+    limiter.setRate(1024);
+    std::atomic<bool> cancel{false};
+    int flow = 0;
+    ASSERT_TRUE(limiter.acquire(&flow, 1u << 20, cancel));   // 欠下约 17 分钟的额度
+
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        cancel = true;
+    });
+    auto start = Clock::now();
+    EXPECT_FALSE(limiter.acquire(&flow, 1, cancel));
+    EXPECT_LT(secondsSince(start), 1.0);
+    canceller.join();
+
+    // 关闭限速后立即放行
+    limiter.setRate(0);
+    std::atomic<bool> fresh{false};
+    EXPECT_TRUE(limiter.acquire(&flow, 1u << 20, fresh));
+}
@@ -0,0 +1,206 @@
+// SizeIndexTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/DiskUsage.hpp"
+#include "browser/SizeIndex.hpp"
+#include "browser/TreeCopier.hpp"
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using FTB::DiskUsage;
+using FTB::SizeIndex;
+
+class SizeIndexTest : public FTB::Test::TempDirFixture<> {
+protected:
+    fs::path tree;
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        tree = temp_dir / "tree";
+        fs::create_directories(tree);
+    }
+
+    static void writeFile(const fs::path& p, size_t size) {
+        fs::create_directories(p.parent_path());
+        std::ofstream(p, std::ios::binary) << std::string(size, 'x');
+    }
+
+    // 刚修改过的目录不会写入索引，把所有目录的 mtime 调到一小时前
+    void ageDirectories() {
+        const auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+        fs::last_write_time(tree, past);
+        for (const auto& e : fs::recursive_directory_iterator(tree)) {
+            if (e.is_directory() && !e.is_symlink()) fs::last_write_time(e.path(), past);
+        }
+    }
+
+    DiskUsage::Report measure(SizeIndex* index) {
+        DiskUsage::Options options;
+        options.threads = 2;
+        options.index = index;
+        return DiskUsage::measure(tree.string(), options);
+    }
+};
+
+// 第二次统计复用所有目录，结果不变；只有变化的目录被重新扫描
+TEST_F(SizeIndexTest, ReusesUnchangedDirectories) {
+    writeFile(tree / "a" / "one.bin", 1000);
+    writeFile(tree / "a" / "deep" / "two.bin", 2000);
+    writeFile(tree / "b" / "three.bin", 3000);
+    writeFile(tree / "top.bin", 500);
+    ageDirectories();
+
+    SizeIndex index((temp_dir / "index").string());
+    auto first = measure(&index);
+    EXPECT_EQ(first.reused_dirs, 0u);
+    EXPECT_EQ(index.size(), 4u);   // 根、a、a/deep、b
+
+    auto second = measure(&index);
+    EXPECT_EQ(second.reused_dirs, 4u);
+    EXPECT_EQ(second.total.apparent, first.total.apparent);
+    EXPECT_EQ(second.total.disk, first.total.disk);
+    EXPECT_EQ(second.total.files, first.total.files);
+    EXPECT_EQ(second.total.dirs, first.total.dirs);
+
+    // 深处目录变化不影响上层的 mtime，仍然被发现
+    writeFile(tree / "a" / "deep" / "new.bin", 700);
+    auto third = measure(&index);
+    EXPECT_EQ(third.reused_dirs, 3u);
+    EXPECT_EQ(third.total.apparent, first.total.apparent + 700);
+    EXPECT_EQ(third.total.files, first.total.files + 1);
+    EXPECT_EQ(third.total.apparent, measure(nullptr).total.apparent);
+}
+
+// 复用的记录仍参与硬链接去重
+TEST_F(SizeIndexTest, ReusedHardlinksCountedOnce) {
+    writeFile(tree / "a" / "data.bin", 4000);
+    fs::create_directories(tree / "b");
+    fs::create_hard_link(tree / "a" / "data.bin", tree / "b" / "data_link.bin");
+    ageDirectories();
+
+    SizeIndex index((temp_dir / "index").string());
+    auto first = measure(&index);
+    auto second = measure(&index);
+    EXPECT_EQ(second.reused_dirs, 3u);
+    EXPECT_EQ(first.total.apparent, 4000u);
+    EXPECT_EQ(second.total.apparent, 4000u);
+    EXPECT_EQ(second.total.files, 1u);
+}
+
+// 保存后重新加载得到相同记录；损坏的文件被拒绝且索引为空
+TEST_F(SizeIndexTest, SaveLoadAndRejectCorruptFile) {
+    const std::string path = (temp_dir / "cfg" / "size-index").string();
+    SizeIndex::Record record;
+    record.mtime_sec = 1700000000;
+    record.mtime_nsec = 123;
+    record.apparent = 42;
+    record.disk = 4096;
+    record.files = 3;
+    record.linked.push_back({77, 10, 4096});
+    {
+        SizeIndex index(path);
+        index.store(1, 2, record);
+        ASSERT_TRUE(index.save());
+    }
+
+    SizeIndex loaded(path);
+    ASSERT_TRUE(loaded.load());
+    SizeIndex::Record out;
+    EXPECT_FALSE(loaded.lookup(1, 2, 1700000000, 124, out));
+    ASSERT_TRUE(loaded.lookup(1, 2, 1700000000, 123, out));
+    EXPECT_EQ(out.apparent, 42u);
+    EXPECT_EQ(out.disk, 4096u);
+    EXPECT_EQ(out.files, 3u);
+    ASSERT_EQ(out.linked.size(), 1u);
+    EXPECT_EQ(out.linked[0].ino, 77u);
+
+    fs::resize_file(path, fs::file_size(path) - 5);
+    EXPECT_FALSE(loaded.load());
+    EXPECT_EQ(loaded.size(), 0u);
+}
+
+// 原地覆盖文件不改变目录 mtime：forget() 或 refresh_index 之后才得到新大小
+TEST_F(SizeIndexTest, ForgetAndRefreshPickUpInPlaceRewrites) {
+    writeFile(tree / "a" / "data.bin", 1000);
+    writeFile(tree / "b" / "other.bin", 200);
+    ageDirectories();
+
+    SizeIndex index((temp_dir / "index").string());
+    EXPECT_EQ(measure(&index).total.apparent, 1200u);
+    writeFile(tree / "a" / "data.bin", 5000);
+    writeFile(tree / "b" / "other.bin", 300);
+    EXPECT_EQ(measure(&index).total.apparent, 1200u);   // 记录仍与 mtime 一致
+
+    index.forget((tree / "a").string());
+    auto after_forget = measure(&index);
+    EXPECT_EQ(after_forget.reused_dirs, 2u);   // 根与 b
+    EXPECT_EQ(after_forget.total.apparent, 5200u);
+
+    DiskUsage::Options options;
+    options.index = &index;
+    options.refresh_index = true;
+    auto refreshed = DiskUsage::measure(tree.string(), options);
+    EXPECT_EQ(refreshed.reused_dirs, 0u);
+    EXPECT_EQ(refreshed.total.apparent, 5300u);
+    // 刷新写回的记录之后照常复用
+    auto reused = measure(&index);
+    EXPECT_EQ(reused.reused_dirs, 3u);
+    EXPECT_EQ(reused.total.apparent, 5300u);
+}
+
+// 覆盖复制到已有目录树后，TreeCopier 移除写入过的目标目录的记录
+TEST_F(SizeIndexTest, TreeCopierForgetsOverwrittenDirectories) {
+    writeFile(tree / "a" / "data.bin", 100);
+    writeFile(tree / "top.bin", 10);
+    ageDirectories();
+    SizeIndex index((temp_dir / "index").string());
+    EXPECT_EQ(measure(&index).total.apparent, 110u);
+
+    const fs::path src = temp_dir / "src";
+    writeFile(src / "a" / "data.bin", 4000);
+    writeFile(src / "top.bin", 20);
+    Progress progress;
+    std::atomic<bool> cancel{false}, pause{false};
+    FTB::TreeCopier::Options options;
+    options.index = &index;
+    ASSERT_TRUE(FTB::TreeCopier::copy(src.string(), tree.string(), progress, cancel, pause, options));
+
+    auto after = measure(&index);
+    EXPECT_EQ(after.reused_dirs, 0u);
+    EXPECT_EQ(after.total.apparent, 4020u);
+}
+
+// 记录只在写入后 kMaxAgeDays 天内取用，取用不会延长期限，过期记录在保存时丢弃
+TEST_F(SizeIndexTest, ExpiresRecordsByScanDate) {
+    const std::string path = (temp_dir / "size-index").string();
+    SizeIndex::Record record;
+    record.mtime_sec = 1700000000;
+    record.apparent = 42;
+    {
+        SizeIndex index(path);
+        index.store(1, 2, record);
+        index.store(1, 3, record);
+        ASSERT_TRUE(index.save());
+    }
+    // 把第一条记录的写入日期改为 1970 年：跳过头部与 dev、ino、mtime 字段
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(8 + 4 + 4 + 8 + 8 + 8 + 8 + 4);
+        const uint32_t day = 0;
+        f.write(reinterpret_cast<const char*>(&day), sizeof(day));
+    }
+
+    SizeIndex loaded(path);
+    ASSERT_TRUE(loaded.load());
+    EXPECT_EQ(loaded.size(), 2u);
+    SizeIndex::Record out;
+    int live = loaded.lookup(1, 2, 1700000000, 0, out) + loaded.lookup(1, 3, 1700000000, 0, out);
+    EXPECT_EQ(live, 1);
+    ASSERT_TRUE(loaded.save());
+    EXPECT_EQ(loaded.size(), 1u);
+}
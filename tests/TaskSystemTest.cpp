@@ -0,0 +1,312 @@
+// TaskSystemTest.cpp
+#include "gtest/gtest.h"
+#include "browser/TaskSystem.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// 收集任务结束状态，等待指定数量的任务结束
+class Completion {
+public:
+    TaskCallback callback() {
+        return [this](const std::string&, TaskState state) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            states_.push_back(state);
+            cv_.notify_all();
+        };
+    }
+
+    bool waitFor(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(10)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, timeout, [&] { return states_.size() >= count; });
+    }
+
+    std::vector<TaskState> states() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return states_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<TaskState> states_;
+};
+
+// 以指定工作线程数重启单例
+void restart(size_t workers) {
+    auto& ts = TaskSystem::getInstance();
+    ts.stop();
+    ts.set_max_workers(workers);
+    ts.start();
+}
+
+// 提交一个阻塞直到 gate 置位的任务，占住一个工作线程
+std::string submitBlocker(std::atomic<bool>& gate, std::atomic<bool>& started, Completion& done) {
+    TaskRequest req;
+    req.title = "blocker";
+    req.type = TaskType::Copy;
+    req.priority = Priority::High;
+    req.work = [&gate, &started](TaskContext&) {
+        started = true;
+        while (!gate.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return true;
+    };
+    req.callback = done.callback();
+    return TaskSystem::getInstance().submit(std::move(req));
+}
+
+}  // namespace
+
+class TaskSystemTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        auto& ts = TaskSystem::getInstance();
+        ts.set_aging_interval(std::chrono::milliseconds(5000));
+        restart(4);
+    }
+};
+
+// 子任务被空闲工作线程窃取并行执行，父任务等待全部完成
+TEST_F(TaskSystemTest, SubtasksRunInParallel) {
+    restart(4);
+    Completion done;
+    std::atomic<int> ran{0};
+    std::atomic<int> concurrent{0}, peak{0};
+
+    TaskRequest req;
+    req.title = "parent";
+    req.type = TaskType::Delete;
+    req.work = [&](TaskContext& ctx) {
+        for (int i = 0; i < 4; ++i) {
+            ctx.spawn([&] {
+                int now = ++concurrent;
+                int seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                --concurrent;
+                ++ran;
+                return true;
+            });
+        }
+        return ctx.wait_subtasks();
+    };
+    req.callback = done.callback();
+
+    auto start = Clock::now();
+    TaskSystem::getInstance().submit(std::move(req));
+    ASSERT_TRUE(done.waitFor(1));
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    EXPECT_EQ(ran.load(), 4);
+    EXPECT_GE(peak.load(), 2);
+    EXPECT_LT(elapsed, 0.6);
+    EXPECT_EQ(done.states()[0], TaskState::Completed);
+}
+
+// 子任务失败或抛出异常时父任务失败；未显式等待的子任务也在父任务结束前完成
+TEST_F(TaskSystemTest, SubtaskFailureFailsParent) {
+    restart(2);
+    Completion done;
+    std::atomic<int> ran{0};
+
+    TaskRequest failing;
+    failing.title = "failing";
+    failing.type = TaskType::Copy;
+    failing.work = [&](TaskContext& ctx) {
+        ctx.spawn([&] { ++ran; return true; });
+        ctx.spawn([&] { ++ran; return false; });
+        ctx.spawn([&]() -> bool { ++ran; throw std::runtime_error("boom"); });
+        return true;
+    };
+    failing.callback = done.callback();
+    TaskSystem::getInstance().submit(std::move(failing));
+    ASSERT_TRUE(done.waitFor(1));
+    EXPECT_EQ(ran.load(), 3);
+    EXPECT_EQ(done.states()[0], TaskState::Failed);
+}
+
+// 子任务可以继续派生子任务（如删除时每个子目录一个）：wait_subtasks 等到整棵树都完成
+TEST_F(TaskSystemTest, SubtasksCanSpawnSubtasks) {
+    restart(4);
+    Completion done;
+    std::atomic<int> ran{0};
+    bool all_done_after_wait = true;
+
+    TaskRequest req;
+    req.title = "tree";
+    req.type = TaskType::Delete;
+    req.work = [&](TaskContext& ctx) {
+        std::function<bool(int)> visit = [&](int depth) {
+            if (depth < 3) {
+                for (int i = 0; i < 3; ++i) ctx.spawn([&visit, depth] { return visit(depth + 1); });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++ran;
+            return true;
+        };
+        ctx.spawn([&visit] { return visit(0); });
+        bool ok = ctx.wait_subtasks();
+        all_done_after_wait = ran.load() == 1 + 3 + 9 + 27;
+        return ok;
+    };
+    req.callback = done.callback();
+    TaskSystem::getInstance().submit(std::move(req));
+    ASSERT_TRUE(done.waitFor(1));
+    EXPECT_TRUE(all_done_after_wait);
+    EXPECT_EQ(ran.load(), 40);
+    EXPECT_EQ(done.states()[0], TaskState::Completed);
+}
+
+// 工作线程全忙时，等待足够久的 Low 任务先于新提交的 High 任务执行
+TEST_F(TaskSystemTest, AgingPromotesWaitingTasks) {
+    restart(1);
+    auto& ts = TaskSystem::getInstance();
+    ts.set_aging_interval(std::chrono::milliseconds(20));
+
+    Completion done;
+    std::atomic<bool> gate{false}, started{false};
+    submitBlocker(gate, started, done);
+    while (!started.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto submitNamed = [&](const std::string& name, Priority priority) {
+        TaskRequest req;
+        req.title = name;
+        req.type = TaskType::Copy;
+        req.priority = priority;
+        req.work = [&, name](TaskContext&) {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(name);
+            return true;
+        };
+        req.callback = done.callback();
+        ts.submit(std::move(req));
+    };
+
+    submitNamed("low", Priority::Low);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    submitNamed("high", Priority::High);
+    EXPECT_EQ(ts.queue_depth(), 2u);
+
+    gate = true;
+    ASSERT_TRUE(done.waitFor(3));
+    ASSERT_EQ(order.size(), 2u);
+    EXPECT_EQ(order[0], "low");
+    EXPECT_EQ(order[1], "high");
+    EXPECT_EQ(ts.queue_depth(), 0u);
+}
+
+// 未到老化间隔时仍按基础优先级调度
+TEST_F(TaskSystemTest, PriorityOrderWithoutAging) {
+    restart(1);
+    auto& ts = TaskSystem::getInstance();
+    ts.set_aging_interval(std::chrono::milliseconds(60000));
+
+    Completion done;
+    std::atomic<bool> gate{false}, started{false};
+    submitBlocker(gate, started, done);
+    while (!started.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::mutex order_mutex;
+    std::vector<Priority> order;
+    for (Priority priority : {Priority::Low, Priority::Normal, Priority::High}) {
+        TaskRequest req;
+        req.title = "task";
+        req.type = TaskType::Copy;
+        req.priority = priority;
+        req.work = [&, priority](TaskContext&) {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(priority);
+            return true;
+        };
+        req.callback = done.callback();
+        ts.submit(std::move(req));
+    }
+
+    // 排队中的任务出现在快照中，状态为 Pending
+    size_t pending = 0;
+    for (const auto& snap : ts.get_snapshot()) {
+        if (snap.title == "task" && snap.state == TaskState::Pending) ++pending;
+    }
+    EXPECT_EQ(pending, 3u);
+
+    gate = true;
+    ASSERT_TRUE(done.waitFor(4));
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0], Priority::High);
+    EXPECT_EQ(order[1], Priority::Normal);
+    EXPECT_EQ(order[2], Priority::Low);
+}
+
+// 不在 TaskSystem 中运行的上下文同步执行子任务
+TEST_F(TaskSystemTest, SpawnOutsideSchedulerRunsInline) {
+    Progress progress;
+    std::atomic<bool> cancel{false}, pause{false};
+    TaskContext ctx{progress, cancel, pause};
+    int ran = 0;
+    ctx.spawn([&] { ++ran; return true; });
+    EXPECT_EQ(ran, 1);
+    EXPECT_TRUE(ctx.wait_subtasks());
+    ctx.spawn([&] { ++ran; return false; });
+    EXPECT_FALSE(ctx.wait_subtasks());
+    EXPECT_TRUE(ctx.wait_subtasks());
+}
+
+// 同一设备上的任务按设备上限排队，不涉及该设备的任务照常并行
+TEST_F(TaskSystemTest, DeviceLimitSerializesSameDevice) {
+    restart(4);
+    auto& ts = TaskSystem::getInstance();
+    const std::string dir = std::filesystem::temp_directory_path().string();
+    const uint64_t dev = FTB::BlockDevice::deviceOf(dir);
+    ASSERT_NE(dev, 0u);
+    ts.set_device_limit(dev, 1);
+
+    Completion done;
+    std::atomic<int> concurrent{0}, peak{0};
+    std::atomic<bool> other_ran{false};
+    for (int i = 0; i < 3; ++i) {
+        TaskRequest req;
+        req.title = "same-device";
+        req.type = TaskType::Copy;
+        req.io_paths = {dir, dir + "/missing-target"};
+        req.work = [&](TaskContext&) {
+            int now = ++concurrent;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            --concurrent;
+            return true;
+        };
+        req.callback = done.callback();
+        ts.submit(std::move(req));
+    }
+
+    TaskRequest other;
+    other.title = "no-device";
+    other.type = TaskType::Copy;
+    other.work = [&](TaskContext&) {
+        other_ran = concurrent.load() > 0;
+        return true;
+    };
+    other.callback = done.callback();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ts.submit(std::move(other));
+
+    ASSERT_TRUE(done.waitFor(4));
+    ts.set_device_limit(dev, 0);
+    EXPECT_EQ(peak.load(), 1);
+    EXPECT_TRUE(other_ran.load());
+    EXPECT_EQ(ts.queue_depth(), 0u);
+}
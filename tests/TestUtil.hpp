@@ -0,0 +1,50 @@
+#ifndef FTB_TEST_UTIL_HPP
+#define FTB_TEST_UTIL_HPP
+
+#include "gtest/gtest.h"
+#include <unistd.h>
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+namespace FTB::Test {
+
+// 在系统临时目录下创建唯一的工作目录：进程号 + 当前用例名 + 序号，
+// 同一进程中前缀相同的不同套件、参数化用例之间也不会冲突
+inline std::filesystem::path MakeTempDir(const std::string& tag) {
+    static std::atomic<unsigned> counter{0};
+    std::string name = "ftb_" + tag + "_" + std::to_string(::getpid());
+    if (const auto* info = ::testing::UnitTest::GetInstance()->current_test_info()) {
+        name += std::string("_") + info->test_suite_name() + "_" + info->name();
+    }
+    name += "_" + std::to_string(counter.fetch_add(1));
+    for (auto& c : name) {
+        if (c == '/') c = '_';
+    }
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// 每个用例使用独立临时目录 temp_dir 的测试夹具；Base 可为 ::testing::TestWithParam<T>
+template <typename Base = ::testing::Test>
+class TempDirFixture : public Base {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = MakeTempDir("test");
+    }
+
+    void TearDown() override {
+        if (!temp_dir.empty()) {
+            std::error_code ec;
+            std::filesystem::remove_all(temp_dir, ec);
+        }
+    }
+};
+
+}  // namespace FTB::Test
+
+#endif  // FTB_TEST_UTIL_HPP
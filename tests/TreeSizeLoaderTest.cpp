@@ -0,0 +1,123 @@
+// TreeSizeLoaderTest.cpp
+#include "gtest/gtest.h"
+#include "TestUtil.hpp"
+#include "browser/SizeIndex.hpp"
+#include "browser/TreeSizeLoader.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+using FTB::SizeIndex;
+using FTB::TreeSizeLoader;
+
+class TreeSizeLoaderTest : public FTB::Test::TempDirFixture<> {
+protected:
+    std::unique_ptr<SizeIndex> index;
+
+    void SetUp() override {
+        TempDirFixture::SetUp();
+        index = std::make_unique<SizeIndex>((temp_dir / "size-index").string());
+        fs::create_directories(temp_dir / "tree");
+    }
+
+    void TearDown() override {
+        index->clear();
+        index.reset();
+        TempDirFixture::TearDown();
+    }
+
+    fs::path tree() const { return temp_dir / "tree"; }
+
+    void makeDir(const std::string& name, size_t bytes) {
+        fs::create_directories(tree() / name);
+        std::ofstream(tree() / name / "f", std::ios::binary) << std::string(bytes, 'x');
+    }
+
+    // 取走结果直到加载器完成且没有剩余结果，或超时
+    static std::map<std::string, uint64_t> drain(TreeSizeLoader& loader) {
+        std::map<std::string, uint64_t> sizes;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline) {
+            bool done = loader.finished();
+            for (auto& r : loader.take()) sizes[r.name] = r.size;
+            if (done) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return sizes;
+    }
+};
+
+TEST_F(TreeSizeLoaderTest, MeasuresEachDirectory) {
+    makeDir("a", 10);
+    makeDir("b", 20);
+
+    TreeSizeLoader loader(tree().string(), {"a", "b"}, nullptr, false, index.get());
+    auto sizes = drain(loader);
+
+    EXPECT_TRUE(loader.finished());
+    ASSERT_EQ(sizes.size(), 2u);
+    EXPECT_EQ(sizes["a"], 10u);
+    EXPECT_EQ(sizes["b"], 20u);
+}
+
+// 统计结束后追加的目录重新启动后台线程；已排队过的名称不再统计
+TEST_F(TreeSizeLoaderTest, EnqueueAfterFinishRestarts) {
+    makeDir("a", 10);
+    TreeSizeLoader loader(tree().string(), {"a"}, nullptr, false, index.get());
+    auto first = drain(loader);
+    ASSERT_TRUE(loader.finished());
+    EXPECT_EQ(first.size(), 1u);
+
+    makeDir("b", 30);
+    loader.enqueue({"a", "b"});
+    EXPECT_FALSE(loader.finished());
+    auto second = drain(loader);
+
+    EXPECT_TRUE(loader.finished());
+    ASSERT_EQ(second.size(), 1u);
+    EXPECT_EQ(second["b"], 30u);
+}
+
+// 统计期间追加的目录由同一轮处理，结果到达时发出通知
+TEST_F(TreeSizeLoaderTest, EnqueueWhileRunningIsMeasured) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 50; ++i) {
+        names.push_back("d" + std::to_string(i));
+        makeDir(names.back(), static_cast<size_t>(i));
+    }
+    makeDir("late", 7);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int notified = 0;
+    TreeSizeLoader loader(tree().string(), names, [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++notified;
+        cv.notify_all();
+    }, false, index.get());
+    loader.enqueue({"late", "d0"});
+
+    std::map<std::string, uint64_t> sizes;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(100), [&] { return notified > 0; });
+            notified = 0;
+        }
+        bool done = loader.finished();
+        for (auto& r : loader.take()) sizes[r.name] = r.size;
+        if (done) break;
+    }
+
+    EXPECT_TRUE(loader.finished());
+    EXPECT_EQ(sizes.size(), 51u);
+    EXPECT_EQ(sizes["late"], 7u);
+    EXPECT_EQ(sizes["d49"], 49u);
+}